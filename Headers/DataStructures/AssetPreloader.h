@@ -0,0 +1,88 @@
+#pragma once
+#include "stdafx.h"
+#include "DataStructures/CookedMesh.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Name: AssetPreloader
+// Description: Loads the meshes and images of a scene on worker threads while the scene
+//  file is being read, so only the GL uploads are left for the main thread.
+//  preloadScene() collects every .obj and image path of the scene file and starts the
+//  workers on them, in the order they appear. When a Mesh or a Texture is created, it
+//  takes the result for its file instead of loading it: if the file is still waiting for a
+//  worker, the main thread loads it itself rather than waiting.
+//  Meshes are opened from their cooked files (cooking them if they're out of date), images
+//  are decoded with stb_image. Files that weren't preloaded, and everything once parallel
+//  loading is disabled, are loaded on the main thread as before.
+//  Results that aren't taken during the scene load are kept for objects created later
+//  (e.g. Rockets) until the next scene is preloaded.
+class AssetPreloader final
+{
+public:
+    // Decoded image, as returned by stbi_load. Whoever takes it frees the pixels with stbi_image_free.
+    struct sImage
+    {
+        unsigned char* pPixels;
+        int iWidth, iHeight, iComponents;
+    };
+
+    static AssetPreloader* getInstance();
+    ~AssetPreloader();
+
+    // Start loading the assets referenced by a scene file.
+    void preloadScene(const string& sSceneFile);
+
+    // Wait for the workers to finish once the scene has been created.
+    void finishScene();
+
+    // Take the preloaded result of a file. Returns false if the file wasn't preloaded, otherwise
+    //  pMesh is null or pImage->pPixels is nullptr if it failed to load.
+    bool takeMesh(const string& sFileName, unique_ptr<CookedMesh>* pMesh);
+    bool takeImage(const string& sFileName, sImage* pImage);
+
+    static void setParallelLoadingEnabled(bool bEnabled) { m_bParallelLoadingEnabled = bEnabled; }
+    static bool useParallelLoading() { return m_bParallelLoadingEnabled; }
+
+    // Times loading the assets of a scene file on the main thread and on the workers.
+    static void runBenchmark(const string& sSceneFile);
+
+private:
+    static AssetPreloader* m_pInstance;
+    AssetPreloader();                                           // Singleton Implementation
+    AssetPreloader(const AssetPreloader* pCopy);                // Copy Constructor Overload
+    AssetPreloader& operator=(const AssetPreloader* pCopy);     // Assignment Operator overload
+
+    enum eJobState
+    {
+        JOB_PENDING = 0,
+        JOB_RUNNING,
+        JOB_DONE
+    };
+
+    struct sJob
+    {
+        bool bMesh;
+        string sFileName;
+        atomic<int> iState;
+        unique_ptr<CookedMesh> pMesh;
+        sImage sLoadedImage;
+    };
+
+    static void collectSceneAssets(const string& sSceneFile, vector<string>* pFiles);
+    static void runJob(sJob* pJob);
+    void startJobs(const vector<string>& pFiles);
+    void workerLoop();
+    sJob* claimResult(const string& sFileName);
+    void clear();
+
+    vector<unique_ptr<sJob>> m_pJobs;                   // In the order they're handed out to the workers
+    unordered_map<string, sJob*> m_pUntakenJobs;        // File Name -> Job whose result hasn't been taken
+    vector<thread> m_pWorkers;
+    atomic<unsigned int> m_iNextJob;
+    mutex m_pJobMutex;
+    condition_variable m_pJobFinished;
+
+    static bool m_bParallelLoadingEnabled;
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include "stdafx.h"
+#include "DataStructures/MappedFile.h"
+#include "DataStructures/ObjParser.h"
+
+// Name: CookedMesh
+// Description: Versioned binary form of a parsed .obj file, stored next to it as
+//  "<file>.cooked". It holds everything Mesh needs to upload the mesh: the interleaved
+//  vertex data, the triangle indices, the positions (for physics), the bounds and the
+//  .mtl material, so loading it is a memory map and a couple of buffer uploads.
+//  A cooked file is only used if it was cooked from the current source: the size and
+//  modification time of the .obj have to match, or if only the time differs (fresh
+//  checkout), its hash; the new time is then stored in the cooked file so the source is
+//  only hashed once after it's touched. Edits to the .mtl alone aren't detected; delete the cooked file
+//  or bump COOKED_MESH_VERSION when the parser output changes.
+//  Meshes are optimized for the vertex cache when cooked, and their normals and uvs are
+//  quantized unless quantization is disabled (see MeshOptimizer). Their lower detail
+//  levels are generated at the same time and stored after the indices of the full mesh.
+//  Layout: sHeader, positions, vertex data, indices of every level, diffuse map path,
+//  specular map path.
+class CookedMesh final
+{
+public:
+    CookedMesh();
+
+    static string getCookedFileName(const string& sSourceFile);
+
+    // Map the cooked file of sSourceFile, false if it's missing or out of date.
+    bool open(const string& sSourceFile);
+
+    // Optimize a parsed .obj, cook it in memory and write it next to the source.
+    //  The data is available through the getters even if it couldn't be written.
+    bool cook(ObjParser* pParser, const string& sSourceFile);
+
+    // Cooked meshes of the other vertex format are treated as out of date.
+    static void setQuantizationEnabled(bool bEnabled) { m_bQuantizationEnabled = bEnabled; }
+
+    // Cooks every .obj file below sDirectory.
+    static void cookDirectory(const string& sDirectory);
+
+    // Times loading the cooked files below sDirectory, cooking any that are out of date.
+    static void runBenchmark(const string& sDirectory);
+
+    // Mesh Data, valid while the CookedMesh is open.
+    const vec3* getPositions() const;
+    unsigned int getPositionCount() const { return m_pHeader->iPositionCount; }
+    const void* getVertexData() const;
+    unsigned int getVertexDataSize() const { return m_pHeader->iVertexDataSize; }   // In bytes
+    const unsigned int* getIndices() const;                                                 // All levels
+    unsigned int getIndexCount() const { return m_pHeader->iLodIndexCounts[0]; }            // Full mesh only
+    unsigned int getTotalIndexCount() const { return m_pHeader->iIndexCount; }
+    unsigned int getLodCount() const { return m_pHeader->iLodCount; }
+    unsigned int getLodIndexCount(unsigned int iLod) const { return m_pHeader->iLodIndexCounts[iLod]; }
+    bool hasNormals() const;
+    bool hasUVs() const;
+    bool isQuantized() const;
+    const vec3& getMinimum() const { return m_pHeader->vMinimum; }
+    const vec3& getMaximum() const { return m_pHeader->vMaximum; }
+
+    // Copies the .mtl material, false if the source had no material library.
+    bool getMaterial(ObjParser::sMaterial* pMaterial) const;
+
+private:
+    CookedMesh(const CookedMesh& pCopy);
+    CookedMesh& operator=(const CookedMesh& pRHS);
+
+    struct sHeader
+    {
+        unsigned int iMagic, iVersion;
+        unsigned long long iSourceSize, iSourceHash;
+        long long iSourceTimestamp;
+        unsigned int iFlags;
+        unsigned int iPositionCount, iVertexDataSize, iIndexCount;  // Element counts, bytes for the vertex data
+        unsigned int iLodCount, iLodIndexCounts[MAX_MESH_LODS];     // iIndexCount is their sum
+        vec3 vMinimum, vMaximum;
+        vec3 vDiffuseColor, vSpecularColor;
+        float fShininess;
+        unsigned int iDiffuseMapLength, iSpecularMapLength;
+    };
+
+    bool mapFile(const string& sCookedFile);
+    bool validate(const string& sSourceFile, long long* iSourceTimestamp);
+    size_t getExpectedSize() const;
+    const unsigned char* getBlob(size_t iOffset) const { return m_pData + sizeof(sHeader) + iOffset; }
+
+    MappedFile m_pFile;
+    vector<unsigned char> m_pCookedData;    // Backing memory of freshly cooked meshes
+    const unsigned char* m_pData;
+    size_t m_iSize;
+    const sHeader* m_pHeader;
+
+    static bool m_bQuantizationEnabled;
+};
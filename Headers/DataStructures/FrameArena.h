@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+#include <queue>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Name: FrameArena
+// Description: Linear (bump) allocator for transient containers that only live for the
+//  duration of a single frame. Allocations advance an offset into a pre-allocated block and
+//  individual frees are ignored; the whole block is reclaimed at once when reset() is called
+//  at the start of each frame by the GameManager.
+//  If the arena runs out of space, allocations fall back to the global heap and are counted
+//  as overflows so the arena size can be tuned.
+//  The FrameArena also keeps a count of global heap allocations made through operator new
+//  so that per-frame allocation regressions are visible.
+//  Not thread-safe: only intended to be used from the main (game loop) thread.
+class FrameArena final
+{
+public:
+    static FrameArena* getInstance();
+    ~FrameArena();
+
+    // Allocation Functions
+    void* allocate(size_t iBytes, size_t iAlignment);
+    void deallocate(void* pMemory, size_t iBytes);
+    bool owns(const void* pMemory) const;
+
+    // Reclaims all arena memory. Called once per frame; no frame containers may be alive at this point.
+    void reset();
+
+    // Statistics
+    size_t getCapacity() const { return m_iCapacity; }
+    size_t getBytesUsed() const { return m_iOffset; }
+    size_t getLastFrameBytesUsed() const { return m_iLastFrameBytesUsed; }
+    size_t getPeakBytesUsed() const { return m_iPeakBytesUsed; }
+    unsigned int getLastFrameOverflows() const { return m_iLastFrameOverflows; }
+    unsigned int getLastFrameHeapAllocations() const { return m_iLastFrameHeapAllocations; }
+    static unsigned long long getTotalHeapAllocations();
+
+private:
+    static FrameArena* m_pInstance;
+    FrameArena();                                       // Singleton Implementation
+    FrameArena(const FrameArena* pCopy);                // Copy Constructor Overload
+    FrameArena& operator=(const FrameArena* pCopy);     // Assignment Operator overload
+
+    char* m_pBuffer;
+    size_t m_iCapacity, m_iOffset;
+    size_t m_iLastFrameBytesUsed, m_iPeakBytesUsed;
+    unsigned int m_iOverflows, m_iLastFrameOverflows;
+    unsigned int m_iLiveAllocations;
+    unsigned int m_iLastFrameHeapAllocations;
+    unsigned long long m_iHeapAllocationsAtReset;
+};
+
+/*
+    STL compatible allocator that allocates from the FrameArena.
+    Containers using this allocator must not outlive the frame they were created in.
+*/
+template <class T>
+class FrameAllocator
+{
+public:
+    typedef T value_type;
+
+    FrameAllocator() noexcept {}
+    template <class U>
+    FrameAllocator(const FrameAllocator<U>&) noexcept {}
+
+    T* allocate(size_t iCount)
+    {
+        return static_cast<T*>(FrameArena::getInstance()->allocate(iCount * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* pMemory, size_t iCount) noexcept
+    {
+        FrameArena::getInstance()->deallocate(pMemory, iCount * sizeof(T));
+    }
+
+    template <class U>
+    bool operator==(const FrameAllocator<U>&) const noexcept { return true; }
+    template <class U>
+    bool operator!=(const FrameAllocator<U>&) const noexcept { return false; }
+};
+
+/* Frame Container Typedefs */
+template <class T>
+using frame_vector = vector<T, FrameAllocator<T>>;
+template <class T>
+using frame_deque = deque<T, FrameAllocator<T>>;
+template <class T>
+using frame_queue = queue<T, frame_deque<T>>;
+typedef basic_string<char, char_traits<char>, FrameAllocator<char>> frame_string;
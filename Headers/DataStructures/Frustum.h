@@ -0,0 +1,65 @@
+#pragma once
+#include "stdafx.h"
+
+// Name: sFrustum
+// Description: Planes of a view frustum in world space, for culling what can't be seen
+//  before it's drawn. The planes are extracted from a projection * view matrix
+//  (Gribb/Hartmann) and point inwards, so a point is inside when it's in front of all six.
+//  The tests are conservative: a box near a corner of the frustum may pass without
+//  being visible, but nothing visible is rejected.
+struct sFrustum
+{
+    vec4 vPlanes[6];    // Left, Right, Bottom, Top, Near, Far: xyz is the normal, w the distance
+
+    void setViewProjection(const mat4* m4ViewProjection)
+    {
+        const mat4& m4Matrix = *m4ViewProjection;
+        vec4 vRows[4];
+        for (int i = 0; i < 4; ++i)
+            vRows[i] = vec4(m4Matrix[0][i], m4Matrix[1][i], m4Matrix[2][i], m4Matrix[3][i]);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            vPlanes[i * 2] = vRows[3] + vRows[i];
+            vPlanes[(i * 2) + 1] = vRows[3] - vRows[i];
+        }
+        for (vec4& vPlane : vPlanes)
+            vPlane /= length(vec3(vPlane));
+    }
+
+    // Axis aligned box in world space.
+    bool intersectsBox(const vec3* vMinimum, const vec3* vMaximum) const
+    {
+        for (const vec4& vPlane : vPlanes)
+        {
+            // Corner of the box furthest along the plane normal
+            vec3 vCorner(vPlane.x > 0.0f ? vMaximum->x : vMinimum->x,
+                         vPlane.y > 0.0f ? vMaximum->y : vMinimum->y,
+                         vPlane.z > 0.0f ? vMaximum->z : vMinimum->z);
+            if (dot(vec3(vPlane), vCorner) + vPlane.w < 0.0f)
+                return false;
+        }
+        return true;
+    }
+
+    bool intersectsSphere(const vec3* vCenter, float fRadius) const
+    {
+        for (const vec4& vPlane : vPlanes)
+        {
+            if (dot(vec3(vPlane), *vCenter) + vPlane.w < -fRadius)
+                return false;
+        }
+        return true;
+    }
+
+    // World space bounds of a model space box placed by m4Transform.
+    static void transformBox(const mat4* m4Transform, const vec3* vMinimum, const vec3* vMaximum, vec3* pMinimum, vec3* pMaximum)
+    {
+        vec3 vCenter = vec3(*m4Transform * vec4((*vMinimum + *vMaximum) * 0.5f, 1.0f));
+        vec3 vExtents = (*vMaximum - *vMinimum) * 0.5f;
+        mat3 m3Rotation = mat3(*m4Transform);
+        vec3 vWorldExtents = abs(m3Rotation[0]) * vExtents.x + abs(m3Rotation[1]) * vExtents.y + abs(m3Rotation[2]) * vExtents.z;
+        *pMinimum = vCenter - vWorldExtents;
+        *pMaximum = vCenter + vWorldExtents;
+    }
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include "stdafx.h"
+
+// Name: GpuTimer
+// Description: Measures how long the GPU takes to execute the GL commands issued between
+//  begin() and end(), with GL_TIME_ELAPSED queries. The results arrive a few frames later,
+//  so finished intervals are collected without waiting and added to running totals.
+//  Only one interval can be timed at a time, and the intervals of different timers
+//  can't overlap either: GL allows a single active GL_TIME_ELAPSED query.
+class GpuTimer final
+{
+public:
+    GpuTimer();
+    ~GpuTimer();
+
+    void begin();
+    void end();
+
+    // Adds the finished intervals to the totals. bWait blocks until every interval ended is finished.
+    void collect(bool bWait = false);
+
+    // Intervals collected since the last reset and their total duration in milliseconds.
+    unsigned int getIntervals() const { return m_iIntervals; }
+    double getMilliseconds() const { return m_fMilliseconds; }
+    void resetTotals() { m_iIntervals = 0; m_fMilliseconds = 0.0; }
+
+private:
+    GpuTimer(const GpuTimer& pCopy);
+    GpuTimer& operator=(const GpuTimer& pRHS);
+
+    // Queries of the intervals ended but not collected, oldest first, and the queries free for reuse.
+    vector<GLuint> m_pPendingQueries, m_pFreeQueries;
+    GLuint m_iActiveQuery;
+
+    unsigned int m_iIntervals;
+    double m_fMilliseconds;
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include "stdafx.h"
+
+// Name: sInterpolatedTransform
+// Description: Rigid transform of the last two simulation steps so objects can be drawn
+//  in between steps. The simulation runs at a fixed rate independently of the frame rate,
+//  so at render time each object is drawn at getTransform(fAlpha), where fAlpha is the
+//  fraction of a step that has elapsed since the last step.
+struct sInterpolatedTransform
+{
+    vec3 vPreviousPosition, vCurrentPosition;
+    quat qPreviousRotation, qCurrentRotation;
+
+    // Snap to a transform without interpolating from the previous one (spawning, teleporting).
+    void reset(const mat4* m4Transform)
+    {
+        vCurrentPosition = vPreviousPosition = vec3((*m4Transform)[3]);
+        qCurrentRotation = qPreviousRotation = quat_cast(mat3(*m4Transform));
+    }
+
+    // Push the transform of a new simulation step.
+    void step(const mat4* m4Transform)
+    {
+        vPreviousPosition = vCurrentPosition;
+        qPreviousRotation = qCurrentRotation;
+        vCurrentPosition = vec3((*m4Transform)[3]);
+        qCurrentRotation = quat_cast(mat3(*m4Transform));
+    }
+
+    // Transform between the previous step (fAlpha = 0) and the current step (fAlpha = 1).
+    mat4 getTransform(float fAlpha) const
+    {
+        mat4 m4Transform = mat4_cast(slerp(qPreviousRotation, qCurrentRotation, fAlpha));
+        m4Transform[3] = vec4(mix(vPreviousPosition, vCurrentPosition, fAlpha), 1.0f);
+        return m4Transform;
+    }
+};
@@ -0,0 +1,125 @@
+#pragma once
+#include "stdafx.h"
+
+/************************\
+ * Forward Declarations *
+\************************/
+class LightingComponent;
+
+// Name: LightClusters
+// Description: Clustered forward lighting. The view frustum is split into a grid of
+//  clusters (froxels): CLUSTER_X by CLUSTER_Y screen tiles, each cut into CLUSTER_Z depth
+//  slices that grow exponentially with distance. Once per view, every point and spot light
+//  is tested against the clusters it could touch and each cluster gets a list of the lights
+//  reaching it, so a fragment only shades the lights of its own cluster. The views of a
+//  frame (one per screen) are built together and stored one after the other.
+//  The lists are built on the CPU (there are no compute shaders in GL 4.1) and stored in
+//  three Texture Buffers:
+//      LightData       RGBA32F: the lights in view space. A point light is 2 texels:
+//                          (position, range), (color * power, 0)
+//                      a spot light is 3 texels:
+//                          (position, cos phi), (direction, cos cutoff), (color, 0)
+//      LightClusters   RG32UI: per cluster, the offset of its list in LightIndices and
+//                          (point lights << 16) | spot lights
+//      LightIndices    R32UI: offsets of the lights in LightData, point lights first.
+//  Besides the Lighting Components of the scene, short-lived lights (rockets, explosions)
+//  are queued with queuePointLight each time the environment is interpolated.
+class LightClusters final
+{
+public:
+    // Cluster grid dimensions
+    static const unsigned int CLUSTER_X = 16;
+    static const unsigned int CLUSTER_Y = 8;
+    static const unsigned int CLUSTER_Z = 24;
+    static const unsigned int CLUSTER_COUNT = CLUSTER_X * CLUSTER_Y * CLUSTER_Z;
+
+    // Texture Buffers
+    enum eBuffer
+    {
+        LIGHT_DATA = 0,
+        CLUSTER_DATA,
+        LIGHT_INDICES,
+        MAX_BUFFERS
+    };
+
+    LightClusters();
+    ~LightClusters();
+
+    // Creates the Texture Buffers; requires a GL context.
+    void initialize();
+
+    // Adds a point light to the frames drawn until the queue is cleared.
+    void queuePointLight(const vec3* vPosition, const vec3* vColor, float fPower);
+    void clearQueuedLights() { m_pQueuedLights.clear(); }
+
+    // Collects the point and spot lights of the frame: the Lighting Components given and the queued lights.
+    void gatherLights(const vector< LightingComponent* >* pLights);
+
+    // Assigns the lights to the clusters of every view and uploads the lists.
+    void buildClusters(const mat4* pProjections, const mat4* pModelViews, unsigned int iViewCount, int iWidth, int iHeight);
+
+    // Uniform values for the shaders: clusters along each axis and
+    //  (tile width in pixels, tile height in pixels, slice scale, slice bias)
+    //  where the slice of a fragment is log(depth) * scale - bias.
+    const uvec4& getClusterCounts() const { return m_vClusterCounts; }
+    const vec4& getClusterScale() const { return m_vClusterScale; }
+    unsigned int getNumPointLights() const { return static_cast<unsigned int>(m_pPointLights.size()); }
+    unsigned int getNumSpotLights() const { return static_cast<unsigned int>(m_pSpotLights.size()); }
+
+    // Name of a Texture Buffer texture; it's bound to the unit matching its name.
+    GLuint getTexture(eBuffer eBuffer) const { return m_pTextures[eBuffer]; }
+
+    // Statistics of the last views built: assignments per view and the longest list of any cluster
+    unsigned int getLastAssignments() const { return m_iLastAssignments; }
+    unsigned int getLastMaxLightsPerCluster() const { return m_iLastMaxLightsPerCluster; }
+
+private:
+    LightClusters(const LightClusters& pCopy);
+    LightClusters& operator=(const LightClusters& pRHS);
+
+    struct sPointLight
+    {
+        vec3 vPosition;
+        vec3 vColor;        // Color * Power
+        float fRange;       // Distance at which the light fades out completely
+    };
+
+    struct sSpotLight
+    {
+        vec3 vPosition;
+        vec3 vDirection;    // Normalized
+        vec3 vColor;
+        float fCosPhi, fCosCutoff;
+    };
+
+    void addPointLight(const vec3* vPosition, const vec3* vColor, float fPower);
+    void updateClusterBounds(const mat4* m4Projection, int iWidth, int iHeight);
+    void buildView(unsigned int iView, const mat4* m4ModelView);
+    void assignPointLight(unsigned int iTexel, const vec3* vCenter, float fRadius);
+    void assignSpotLight(unsigned int iTexel, const vec3* vApex, const vec3* vDirection, float fCosPhi);
+    float getSliceDepth(unsigned int iSlice) const;
+    unsigned int getSlice(float fDepth) const;
+    unsigned int getTile(float fNDC, unsigned int iAxis) const;
+    void upload(eBuffer eBuffer, const void* pData, GLsizeiptr iSize);
+
+    // World space lights of the frame and the queued lights
+    vector<sPointLight> m_pPointLights, m_pQueuedLights;
+    vector<sSpotLight> m_pSpotLights;
+
+    // View space bounds of every cluster, for the projection and viewport they were computed for
+    vec3 m_pClusterMin[CLUSTER_COUNT], m_pClusterMax[CLUSTER_COUNT];
+    vec4 m_pClusterSpheres[CLUSTER_COUNT];  // Bounding sphere of each cluster: center, radius
+    mat4 m_m4BoundsProjection;
+    int m_iBoundsWidth, m_iBoundsHeight;
+    float m_fNear, m_fFar;
+
+    // Lists of the views being built, kept to avoid allocating each frame
+    vector<vec4> m_pLightTexels;
+    vector<uvec2> m_pAssignments;           // (cluster, light texel), point lights first
+    vector<GLuint> m_pPointCounts, m_pSpotCounts, m_pClusterData, m_pLightIndices;
+
+    uvec4 m_vClusterCounts;
+    vec4 m_vClusterScale;
+    GLuint m_pBuffers[MAX_BUFFERS], m_pTextures[MAX_BUFFERS];
+    unsigned int m_iLastAssignments, m_iLastMaxLightsPerCluster;
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+using namespace std;
+
+// Name: MappedFile
+// Description: Read-only memory mapping of a whole file. The contents are paged in by the
+//  OS on demand instead of being copied through a stream, which makes it the cheapest way
+//  to read large asset files that are parsed in a single pass.
+//  The mapping stays valid until close() is called or the MappedFile is destroyed.
+class MappedFile final
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    bool open(const string& sFileName);
+    void close();
+    bool isOpen() const { return nullptr != m_pData || m_bOpenEmpty; }
+
+    const char* getData() const { return m_pData; }
+    size_t getSize() const { return m_iSize; }
+
+private:
+    MappedFile(const MappedFile& pCopy);
+    MappedFile& operator=(const MappedFile& pRHS);
+
+    const char* m_pData;
+    size_t m_iSize;
+    bool m_bOpenEmpty;  // Empty files can't be mapped but are still valid.
+
+#ifdef _WIN32
+    void* m_pFileHandle;
+    void* m_pMappingHandle;
+#endif
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include "stdafx.h"
+
+// Detail levels a mesh can have, including the full mesh.
+#define MAX_MESH_LODS 4
+
+// Name: ObjParser
+// Description: Single pass parser for Wavefront .obj files and the .mtl libraries they
+//  reference.
+//  The file is memory mapped and scanned once with hand-rolled number parsing. Every
+//  distinct position/uv/normal index triplet referenced by a face becomes one vertex;
+//  triplets are deduplicated through an open addressing table keyed on the integer indices
+//  themselves, so no strings are built and distinct triplets never compare equal.
+//  Polygons are triangulated as fans. Once parsed, the vertices are available as
+//  interleaved position[, normal][, uv] floats ready to be uploaded.
+//  Lower detail levels are only built on request (see generateLods), as index lists into
+//  the same vertices.
+//  All buffers keep their capacity between parses.
+class ObjParser final
+{
+public:
+    // Material read from a .mtl library. Texture paths are resolved relative to the library.
+    struct sMaterial
+    {
+        string sName;
+        vec3 vDiffuseColor;     // Kd
+        vec3 vSpecularColor;    // Ks
+        float fShininess;       // Ns
+        string sDiffuseMap;     // map_Kd
+        string sSpecularMap;    // map_Ks
+    };
+
+    ObjParser();
+
+    bool parse(const string& sFileName);
+    void clear();
+
+    // Reorder the parsed triangles and vertices for the vertex cache and vertex fetches.
+    void optimize();
+
+    // Simplify the parsed triangles into up to MAX_MESH_LODS - 1 lower detail levels, each
+    //  about half the triangles of the previous one. Levels that wouldn't save enough
+    //  aren't built, so small meshes may have none.
+    void generateLods();
+
+    // Raw data as listed in the file.
+    const vector<vec3>& getPositions() const { return m_pPositions; }
+    const vector<vec3>& getNormals() const { return m_pNormals; }
+    const vector<vec2>& getUVs() const { return m_pUVs; }
+
+    // Deduplicated vertices and the triangle indices into them.
+    const vector<float>& getVertexData() const { return m_pVertexData; }
+    const vector<unsigned int>& getIndices() const { return m_pIndices; }
+    unsigned int getVertexCount() const { return static_cast<unsigned int>(m_pVertexKeys.size()); }
+    bool hasNormals() const { return !m_pNormals.empty(); }
+    bool hasUVs() const { return !m_pUVs.empty(); }
+
+    // Detail levels, 0 is the full mesh. The indices of levels 1 and up are concatenated.
+    unsigned int getLodCount() const { return static_cast<unsigned int>(m_pLodIndexCounts.size()) + 1; }
+    unsigned int getLodIndexCount(unsigned int iLod) const { return (0 == iLod) ? static_cast<unsigned int>(m_pIndices.size()) : m_pLodIndexCounts[iLod - 1]; }
+    const vector<unsigned int>& getLodIndices() const { return m_pLodIndices; }
+
+    // Bounds of all positions in the file.
+    const vec3& getMinimum() const { return m_vMinimum; }
+    const vec3& getMaximum() const { return m_vMaximum; }
+
+    // Material of the first usemtl statement, or the first material of the library if the
+    //  faces don't use one. nullptr if the file has no material library.
+    const sMaterial* getMaterial() const;
+
+    // Collects the .obj files below sDirectory, sorted by name.
+    static void findObjFiles(const string& sDirectory, vector<string>* pFiles);
+
+    // Parses every .obj file below sDirectory and reports the load times.
+    static void runBenchmark(const string& sDirectory);
+
+    // Reports the ACMR and vertex size of every .obj file below sDirectory before and after optimizing.
+    static void runOptimizationReport(const string& sDirectory);
+
+private:
+    // Zero based indices of one face vertex, -1 where the index is missing.
+    struct sVertexKey
+    {
+        int iPosition, iUV, iNormal;
+        bool operator==(const sVertexKey& sOther) const
+        {
+            return iPosition == sOther.iPosition && iUV == sOther.iUV && iNormal == sOther.iNormal;
+        }
+    };
+
+    bool parseFace(const char** pCursor, const char* pEnd);
+    unsigned int findOrAddVertex(const sVertexKey& sKey);
+    void growVertexTable();
+    bool hasValidVertices() const;
+    void buildVertexData();
+    bool parseMaterialLibrary(const string& sFileName);
+
+    vector<vec3> m_pPositions, m_pNormals;
+    vector<vec2> m_pUVs;
+    vector<sVertexKey> m_pVertexKeys;       // One per unique vertex
+    vector<unsigned int> m_pVertexTable;    // Open addressing table of indices into m_pVertexKeys
+    vector<unsigned int> m_pFaceVertices;   // Scratch list of the vertices of the current face
+    vector<unsigned int> m_pIndices;
+    vector<unsigned int> m_pLodIndices, m_pLodIndexCounts;
+    vector<float> m_pVertexData;
+    vec3 m_vMinimum, m_vMaximum;
+
+    vector<sMaterial> m_pMaterials;
+    string m_sUsedMaterial;
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include "stdafx.h"
+#include "ShaderManager.h"
+
+/************************\
+ * Forward Declarations *
+\************************/
+class RenderComponent;
+class Texture;
+
+// Name: RenderQueue
+// Description: Draws the Render Components of a pass in an order that keeps GL state changes
+//  to a minimum, and drops the state changes that wouldn't change anything.
+//  Each component is queued with a 64-bit sort key, most significant first:
+//      pass (4) | shader (6) | texture (16) | mesh (16) | depth (22)
+//  so components sharing a program are drawn together, then those sharing a texture, and
+//  the depth only orders draws of otherwise identical state front to back. Blended components
+//  are drawn after the opaque ones, back to front:
+//      pass (4) | inverted depth (22) | shader (6) | texture (16) | mesh (16)
+//  The components bind their program, Vertex Array and textures through the queue while it's
+//  drawing. Nothing else may change those bindings until draw() returns; the filter forgets
+//  everything it knows at the start of each draw() because other code binds in between.
+class RenderQueue final
+{
+public:
+    enum ePass
+    {
+        OPAQUE_PASS = 0,
+        BLENDED_PASS
+    };
+
+    // Samplers of a Mesh Material.
+    enum eSampler
+    {
+        DIFFUSE_SAMPLER = 0,
+        SPECULAR_SAMPLER,
+        SAMPLER_COUNT
+    };
+
+    RenderQueue();
+
+    // Queue a component for the next draw(). fDepth is its distance to the viewer.
+    void push(RenderComponent* pComponent, ePass ePass, ShaderManager::eShaderType eShader,
+              GLuint iTexture, GLuint iMesh, float fDepth);
+
+    // Sort the queued components, render them and empty the queue.
+    void draw();
+
+    // Redundant state filter, only valid inside draw().
+    void useProgram(GLuint iProgram);
+    void bindVertexArray(GLuint iVertexArray);
+    void bindSampler(ShaderManager::eShaderType eShader, eSampler eSampler, Texture* pTexture);
+
+    // State changes issued and avoided in the last frame; call once a frame before drawing.
+    void beginFrame();
+    unsigned int getLastFrameStateChanges() const { return m_iLastFrameStateChanges; }
+    unsigned int getLastFrameStateChangesAvoided() const { return m_iLastFrameStateChangesAvoided; }
+
+private:
+    RenderQueue(const RenderQueue& pCopy);
+    RenderQueue& operator=(const RenderQueue& pRHS);
+
+    struct sItem
+    {
+        uint64_t iKey;
+        RenderComponent* pComponent;
+    };
+
+    void resetState();
+    void unbindTextures();
+
+    vector<sItem> m_pItems;
+
+    // Bindings known to be current. Textures are bound to the unit matching their name.
+    GLuint m_iBoundProgram, m_iBoundVertexArray;
+    bool m_bProgramKnown, m_bVertexArrayKnown;
+    vector<GLuint> m_pBoundTextures;                                // Texture bound to each unit
+    GLuint m_pSamplerTextures[ShaderManager::MAX_SHDRS][SAMPLER_COUNT];     // Texture each sampler uniform points at, 0 if unknown
+
+    unsigned int m_iStateChanges, m_iStateChangesAvoided;
+    unsigned int m_iLastFrameStateChanges, m_iLastFrameStateChangesAvoided;
+};
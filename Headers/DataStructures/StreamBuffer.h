@@ -0,0 +1,68 @@
+#pragma once
+#include "stdafx.h"
+
+// Number of regions a persistently mapped StreamBuffer cycles through.
+#define STREAM_BUFFER_REGIONS   3
+
+// Name: StreamBuffer
+// Description: Vertex buffer for data that is rewritten by the CPU every frame (instance
+//  transforms, particles, billboards).
+//  When ARB_buffer_storage is available the buffer is allocated once with room for
+//  STREAM_BUFFER_REGIONS copies of the data and stays persistently mapped. Each write goes
+//  to the next region while the GPU may still be reading the previous ones; a fence is placed
+//  on a region once drawing from it has been issued, and is only waited on when the CPU wraps
+//  around to that region again.
+//  Otherwise (GL 3.3 drivers) the buffer has a single region which is orphaned and mapped
+//  again for every write, so its previous contents are lost.
+//  Draw calls have to read from getReadOffset(), which changes with every write.
+class StreamBuffer final
+{
+public:
+    StreamBuffer();
+    ~StreamBuffer();
+
+    // (Re)allocates the buffer with iRegionSize bytes per region. Previous contents are discarded
+    //  and the buffer name may change, so vertex attributes have to be set up again afterwards.
+    void initialize(GLsizeiptr iRegionSize);
+    void release();
+    bool isInitialized() const { return 0 != m_iBuffer; }
+
+    /*
+        Writing: beginWrite() returns the start of the region to write to, blocking only if the GPU
+        is still reading it. endWrite() makes the written region the one that is read from.
+        If keepsContents() is true, the region still holds the data that was last written to it,
+        otherwise the whole region has to be written.
+    */
+    void* beginWrite();
+    void endWrite();
+    bool keepsContents() const { return m_bPersistent; }
+    unsigned int getNextRegion() const { return (m_iReadRegion + 1) % m_iRegionCount; }
+
+    // Buffer Information
+    GLuint getBuffer() const { return m_iBuffer; }
+    GLsizeiptr getRegionSize() const { return m_iRegionSize; }
+    GLintptr getReadOffset() const { return m_iReadRegion * m_iRegionSize; }
+
+    // Persistent mapping can be disabled from the command line to exercise the fallback path.
+    static void setPersistentMappingEnabled(bool bEnabled) { m_bPersistentMappingEnabled = bEnabled; }
+    static bool usePersistentMapping();
+
+    // Number of writes that had to wait for the GPU since the program started.
+    static unsigned int getTotalStalls() { return m_iTotalStalls; }
+
+private:
+    StreamBuffer(const StreamBuffer& pCopy);
+    StreamBuffer& operator=(const StreamBuffer& pRHS);
+
+    void waitForRegion(unsigned int iRegion);
+
+    GLuint m_iBuffer;
+    GLsizeiptr m_iRegionSize;
+    unsigned char* m_pMappedData;   // Persistent mapping of all regions
+    GLsync m_pFences[STREAM_BUFFER_REGIONS];
+    unsigned int m_iReadRegion, m_iWriteRegion, m_iRegionCount;
+    bool m_bPersistent;
+
+    static bool m_bPersistentMappingEnabled;
+    static unsigned int m_iTotalStalls;
+};
@@ -0,0 +1,117 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+// Name: WorldSnapshot
+// Description: Compact, versioned binary blob of the game state.
+//  Game objects serialize themselves into the snapshot with write*() and restore themselves
+//  in the same order with read*(). Only trivially copyable values may be written; they are
+//  stored as raw bytes in the native layout, so a snapshot is only valid for the build and
+//  match that produced it.
+//  The underlying buffer keeps its capacity between captures so a snapshot can be taken
+//  every frame without allocating.
+class WorldSnapshot final
+{
+public:
+    WorldSnapshot();
+
+    // Writing: beginWrite() clears the blob and writes the header, endWrite() finalizes it.
+    void beginWrite();
+    void endWrite();
+
+    template <class T>
+    void write(const T& value)
+    {
+        static_assert(is_trivially_copyable<T>::value, "WorldSnapshot only stores trivially copyable values.");
+        writeBytes(&value, sizeof(T));
+    }
+
+    template <class T>
+    void writeArray(const T* pValues, unsigned int iCount)
+    {
+        static_assert(is_trivially_copyable<T>::value, "WorldSnapshot only stores trivially copyable values.");
+        writeBytes(pValues, sizeof(T) * iCount);
+    }
+
+    // Writes the size of the vector followed by its contents.
+    template <class T>
+    void writeVector(const vector<T>& vValues)
+    {
+        write(static_cast<unsigned int>(vValues.size()));
+        writeArray(vValues.data(), static_cast<unsigned int>(vValues.size()));
+    }
+
+    // Reading: beginRead() validates the header and rewinds to the start of the data.
+    //  Every read returns false once the blob is exhausted or invalid.
+    bool beginRead();
+
+    template <class T>
+    bool read(T* pValue)
+    {
+        static_assert(is_trivially_copyable<T>::value, "WorldSnapshot only stores trivially copyable values.");
+        return readBytes(pValue, sizeof(T));
+    }
+
+    template <class T>
+    bool readArray(T* pValues, unsigned int iCount)
+    {
+        static_assert(is_trivially_copyable<T>::value, "WorldSnapshot only stores trivially copyable values.");
+        return readBytes(pValues, sizeof(T) * iCount);
+    }
+
+    template <class T>
+    bool readVector(vector<T>* pValues)
+    {
+        unsigned int iCount = 0;
+        if (!read(&iCount) || (m_iReadOffset + (sizeof(T) * iCount)) > m_vData.size())
+            return false;
+        pValues->resize(iCount);
+        return readArray(pValues->data(), iCount);
+    }
+
+    // Blob Information
+    bool isEmpty() const { return m_vData.empty(); }
+    size_t getSize() const { return m_vData.size(); }
+    const unsigned char* getData() const { return m_vData.data(); }
+
+    // Saving/Loading to disk
+    bool saveToFile(const string& sFileName) const;
+    bool loadFromFile(const string& sFileName);
+
+private:
+    // Header at the start of every snapshot.
+    struct sHeader
+    {
+        unsigned int iMagic;
+        unsigned int iVersion;
+        unsigned int iPayloadSize;  // Number of bytes following the header
+    };
+
+    void writeBytes(const void* pSource, size_t iBytes)
+    {
+        size_t iOffset = m_vData.size();
+        m_vData.resize(iOffset + iBytes);
+        memcpy(m_vData.data() + iOffset, pSource, iBytes);
+    }
+
+    bool readBytes(void* pDestination, size_t iBytes)
+    {
+        if (!m_bReadValid || (m_iReadOffset + iBytes) > m_vData.size())
+        {
+            m_bReadValid = false;
+            return false;
+        }
+        memcpy(pDestination, m_vData.data() + m_iReadOffset, iBytes);
+        m_iReadOffset += iBytes;
+        return true;
+    }
+
+    vector<unsigned char> m_vData;
+    size_t m_iReadOffset;
+    bool m_bReadValid;
+};
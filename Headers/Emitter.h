@@ -1,23 +1,25 @@
 #pragma once
 #include "EntityHeaders/Entity.h"
 #include "EntityComponentHeaders/RenderComponent.h"
+#include "ParticlePool.h"
 
 /*************************************************
  * Name: Emitter
  * Description: Maintains data for Emitter such as
  *              Number, position and duration of particles
+ *              The particles themselves live in the ParticlePool
+ *              of the EmitterEngine, in the batch of the Emitter's color.
 \**************************************************/
 class Emitter
 {
 public:
     // Default Constructor and Destructor.
-    Emitter(const vec3* vPosition);
+    Emitter(const vec3* vPosition, ParticlePool* pParticlePool);
     virtual ~Emitter();
 
     // Functions to initialize and update Emitter.
     void initializeEmitter(unsigned int iMaxParticles, const vec3* vEmitterNormal, const vec3* vColor, float fAngleFromNormal, float fDefaultDuration, float fRadius, bool bExplosion);
     bool update(float fDelta);
-    void draw();
 
     // Function to signal EmitterEngine that Emitter is finished.
     bool readyToDelete() const { return m_bReadyToDelete; }
@@ -27,21 +29,11 @@ private:
     unsigned int m_iMaxNumParticles, m_iCurrNumParticles;
     vec3 m_vPosition, m_vEmitterNormal, m_vOrthogonalVec;
     float m_fAngleFromNormal, m_fDefaultDuration, m_fRadius;
+    float m_fTimeSinceLastSpawn;            // Every particle is gone once this reaches the particle duration
     bool m_bReadyToDelete;
-    GLuint m_iVertexArray, m_iVertexBuffer;
-    // Particle information
-    struct sParticleInformation
-    {
-        vec3 vPosition, vVelocity, vForce;
-        float fDuration;
-    };
 
-    // List of Particles
-    vector<unique_ptr<sParticleInformation>> m_pParticleList;
-    vector< vec3 > m_pPositions;
-
-    Texture*    m_pDiffuseTexture;
-    Mesh*       m_pBillboardMesh;
+    ParticlePool*   m_pParticlePool;
+    unsigned int    m_iParticleBatch;
 
     // Private Functions
     void spawnNewParticle();
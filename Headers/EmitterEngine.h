@@ -2,6 +2,7 @@
 
 #include "stdafx.h"
 #include "Emitter.h"
+#include "DataStructures/LightClusters.h"
 
 /*******************************************************
  * Name: Emitter Engine
@@ -22,6 +23,10 @@ public:
 
     // Update and Render Functionality
     void update(float fDelta);
+    void uploadEmitters();
+
+    // Queue the lights of the explosions going on.
+    void queueExplosionLights(LightClusters* pLightClusters) const;
     void renderEmitters();
 
     // Generate a new Emitter with the given parameters
@@ -43,5 +48,17 @@ private:
 
     // Emitters bank
     vector<unique_ptr<Emitter>> m_pEmitters;
+
+    // Particles of every Emitter, drawn in one call per texture
+    ParticlePool m_sParticlePool;
+
+    // Flash of light of an explosion, fading out over its duration
+    struct sExplosionLight
+    {
+        vec3 vPosition;
+        vec3 vColor;
+        float fTimeLeft;
+    };
+    vector<sExplosionLight> m_pExplosionLights;
 };
 
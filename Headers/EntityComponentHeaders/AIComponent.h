@@ -68,8 +68,8 @@ private:
         MODE_EVADE
     };
     vec2 seekPointsAI[8];
-    vector<uvec2> getSeekPath();
-    vector<uvec2> getChasePath() const;
+    void getSeekPath(vector<uvec2>* pPath);
+    void getChasePath(vector<uvec2>* pPath) const;
 
     void updateBotAndTargetLocations(const HovercraftEntity *target, const HovercraftEntity *bot);
     void determinePath();
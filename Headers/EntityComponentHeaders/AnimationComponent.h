@@ -12,6 +12,7 @@ using namespace SpriteSheetDatabase;
  * Forward Declarations *
 \************************/
 class Entity;
+class WorldSnapshot;
 
 /************************************************************
 * Name: AnimationComponent
@@ -40,12 +41,16 @@ public:
     void animateToNextFrame();
     void setWorldTransform(const mat4* pWorldTransform) { m_m4WorldTransform = *pWorldTransform; }
 
+    // Snapshots of the Billboard Animation
+    void writeBillboardSnapshot(WorldSnapshot* pSnapshot) const;
+    bool readBillboardSnapshot(WorldSnapshot* pSnapshot);
+
 private: 
     // Private Copy Constructor and Assignment operator overload.
     AnimationComponent(const AnimationComponent* pCopy);
     AnimationComponent& operator=(const AnimationComponent& pRHS);
 
-    void pickRandomSprite(vec2* vReturnUV);
+    unsigned int pickRandomSprite();
     void updateBillboard(float fTimeInSeconds);
     void updateAnimation(float fTimeInSeconds);
 
@@ -64,7 +69,7 @@ private:
     unsigned int m_iCurrFrame, m_iNextFrame;
     float m_fInterpolationK;
     bool m_bBillboardAnimation, m_bAnimating;
-    string m_sMeshInstanceHandle;
+    unsigned int m_iMeshInstanceHandle;
     mat4 generateTransformationMatrix(const sKeyFrame* pKeyFrame);
     void setUpNextFrame();
 
@@ -78,5 +83,5 @@ private:
     vec2 m_vSpriteHxW, m_vSpriteHxWBorder;
     int m_iNumSpritesX, m_iNumSpritesY;
     float m_fBillboardHeight, m_fBillboardWidth;
-    float m_fAnimTime, m_fDuration;
+    float m_fAnimTime, m_fDuration;     // For Billboards, the Anim Time is the clock they're animated by
 };
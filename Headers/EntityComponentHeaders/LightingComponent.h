@@ -38,9 +38,13 @@ public:
                                         float fPosition, float fNearPlane, float fFarPlane, unsigned int iShadowHeight, unsigned int iShadowWidth, float fShadowFrame);
     void initializeAsSpotLight(const vec3* vPosition, const vec3* vColor, const vec3* vDirection, float fPhi, float fSoftPhi);
 
-    // Shadow Map functionality
-    void setupShadowFBO() const;
+    // Shadow Map functionality. The Directional Light keeps the depth of the static scene in a separate
+    //  map: setupStaticShadowFBO prepares drawing it, and setupShadowFBO can start the shadow map of
+    //  the frame from a copy of it so only the moving shadow casters are drawn every frame.
+    void setupStaticShadowFBO() const;
+    void setupShadowFBO(bool bFromStaticShadows = false) const;
     void setupPMVMatrices();
+    const mat4& getLightSpaceMatrix() const { return m_m4LightSpaceMatrix; }   // Projection * View of the shadow pass
     void setupShadowUniforms( unsigned int iSpotLightIndex = 0) const;
 
     // Returns light information for storing in Shader
@@ -79,5 +83,6 @@ private:
 
     // Shadow Map Variables
     Texture* m_pShadowMap;
-    GLuint m_iFrameBuffer;
+    Texture* m_pStaticShadowMap;
+    GLuint m_iFrameBuffer, m_iStaticFrameBuffer;
 };
@@ -6,6 +6,11 @@ For collisions
 #include "Physics/PhysicsManager.h"
 #include "Mesh.h"
 
+/************************\
+ * Forward Declarations *
+\************************/
+class WorldSnapshot;
+
 /**************************************************************
  * Name: PhysicsComponent
  * Written by: James Cote Austin Eaton, Evan Quan
@@ -40,6 +45,7 @@ public:
     void initializeRocket(const char* sName, const mat4* m4Transform, const vec3* vVelocity, float fBBLength);
     void flagForRemoval(string sHashKey);
     void removeInstance(string sHashKey);
+    void removeAllInstances();
     void scaleInstance(string sHashKey, float fScale);
     vec3 getLinearVelocity();
     quat getRotation();
@@ -51,7 +57,8 @@ public:
     void jumpVehicle();
     // this function will allow Entities to retrieve the Transform Matrix required to modify their mesh.
     void getTransformMatrix(mat4* pReturnTransformMatrix);
-    void getTransformMatrix(string sHashKey, mat4* pReturnTransformMatrix);
+    void getTransformMatrix(const string& sHashKey, mat4* pReturnTransformMatrix);
+    vec3 getLinearVelocity(const string& sHashKey);
     glm::vec3 PhysicsComponent::getPosition();
     PxTransform getGlobalPose();
 
@@ -65,6 +72,10 @@ public:
 
     bool isDashing() const { return m_bIsDashing; }
     bool isInAir;
+
+    // Snapshots of the Vehicle Body
+    void writeSnapshot(WorldSnapshot* pSnapshot) const;
+    bool readSnapshot(WorldSnapshot* pSnapshot);
 private:
     float lastDeltaTime = 0;
     float m_fMaxSpeed;
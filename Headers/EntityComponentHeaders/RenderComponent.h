@@ -13,6 +13,7 @@
 // Forward Declarations
 class EntityManager;
 class Mesh;
+class RenderQueue;
 
 class RenderComponent
     : public EntityComponent
@@ -22,8 +23,10 @@ public:
                     ShaderManager::eShaderType eType, GLenum eMode);
     virtual ~RenderComponent();
 
-    // render will call the GPU to draw the bound data.
-    void render();
+    // Queue the component for the current pass, then render will call the GPU to draw the bound data.
+    //  Bindings go through the Render Queue so the ones already current are skipped.
+    void enqueue(RenderQueue* pRenderQueue);
+    void render(RenderQueue* pRenderQueue);
 
     // Inherited update frunction from EntityComponent
     void update(float fTimeInSeconds);
@@ -35,11 +38,20 @@ public:
     // Check to see if this render component should be rendered for shadows.
     bool castsShadows() { return m_bRenderShadows; }
 
+    // Check to see if this render component can be rendered for every screen at once.
+    bool canDrawViewsTogether() const;
+
 private:
     // Private Copy Constructor and Assignment operator overload.
     RenderComponent(const RenderComponent* pCopy);
     RenderComponent& operator=(const RenderComponent& pRHS);
 
+    // Level of Detail to draw in the current view.
+    unsigned int selectLod();
+
+    // Draws the Terrain Chunks of a chunked Mesh that are in view, iViews views at once.
+    void renderChunks(GLsizei iInstances, GLsizei iViews);
+
     // Private Variables
     GLenum m_eMode;
     GLsizei m_iCount;
@@ -48,4 +60,5 @@ private:
     ShaderManager* m_pShdrMngr;
     EntityManager* m_pEntityManager;
     ShaderManager::eShaderType m_eShaderType;
+    unsigned int m_iLodLevels[MAX_VIEW_COUNT];      // Level of Detail last drawn in each view
 };
@@ -18,6 +18,15 @@ public:
     // Entit
     virtual void reinitialize() {}
 
+    /*
+        Update anything drawn from the simulation to a point between the last
+        two simulation steps. Called once per frame after the simulation has
+        been stepped.
+
+        @param fAlpha   fraction of a simulation step since the last step, [0, 1)
+    */
+    virtual void interpolate(float fAlpha) {}
+
     // Getters/Setters
     vec3 getPosition() const { return m_vPosition; }
     int getID() const { return m_iID; }
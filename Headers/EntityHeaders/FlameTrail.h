@@ -6,6 +6,9 @@
 #include "EntityComponentHeaders/PhysicsComponent.h"
 #include "DataStructures/SpriteSheetDatabase.h"
 
+// Forward Declarations
+class WorldSnapshot;
+
 // Name: InteractableEntity
 // Written by: James Cote
 // Description: General Entity for objects that players can interact with.
@@ -31,6 +34,9 @@ public:
 
     void handleCollision(Entity* pOther, unsigned int iColliderMsg, unsigned int iVictimMsg);
 
+    // Snapshots of all live flames
+    void writeSnapshot(WorldSnapshot* pSnapshot) const;
+    bool readSnapshot(WorldSnapshot* pSnapshot);
 
 private:
     float                                   m_fHeight,
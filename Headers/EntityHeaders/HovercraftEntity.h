@@ -6,6 +6,7 @@
 #include "EntityComponentHeaders/CameraComponent.h"
 #include "SpatialDataMap.h"
 #include "GameStats.h"
+#include "DataStructures/InterpolatedTransform.h"
 
 /************************\
  * Forward Declarations *
@@ -15,6 +16,7 @@ class Rocket;
 class Spikes;
 class AnimationComponent;
 class SoundManager;
+class WorldSnapshot;
 
 /***********\
  * Defines *
@@ -46,6 +48,7 @@ public:
 
     // Implementation of inherited functionality
     void update(float fTimeInSeconds);
+    void interpolate(float fAlpha);
 
     // Signifies to this HoverCraft that they were hit by a damaging attack.
     void getHitBy(eHovercraft attacker, eAbility ability);
@@ -165,6 +168,10 @@ public:
     eAbility getLastAbilityBot();
 
     vec3 getColor() const { return m_vColor; }
+
+    // Snapshots of the hovercraft state, including its rockets and flames
+    void writeSnapshot(WorldSnapshot* pSnapshot) const;
+    bool readSnapshot(WorldSnapshot* pSnapshot);
 private:
     eHovercraft lastAttacker;
     eAbility lastAbility;
@@ -195,6 +202,7 @@ private:
     // Private Variables
     int activeCameraIndex;
     Mesh *m_pMesh, *m_pSpikesMesh;
+    unsigned int m_iMeshInstance;   // Handle of the hovercraft's instance in m_pMesh
     SpatialDataMap* m_pSpatialMap;
     RenderComponent *m_pRenderComponent, *m_pSpikesRenderComponent;
     CameraComponent* m_pActiveCameraComponent;
@@ -217,6 +225,12 @@ private:
     vec3 m_vCurrentCameraPosition;
     quat m_qCurrentCameraRotation;
 
+    // Hovercraft and camera state of the previous simulation step, for interpolated drawing
+    sInterpolatedTransform m_sTransform;
+    vec3 m_vPreviousCameraPosition;
+    quat m_qPreviousCameraRotation;
+    void resetInterpolation();
+
     // Private Functions
     void updateCameraLookAts(float fTimeInSeconds);
     void updateCameraPosition(float fTimeInSeconds);
@@ -6,10 +6,12 @@
 #include "EntityComponentHeaders/PhysicsComponent.h"
 #include "PxPhysicsAPI.h"
 #include "PxFoundation.h"
+#include "DataStructures/InterpolatedTransform.h"
 
 
 // Forward Declarations
 class EmitterEngine;
+class WorldSnapshot;
 
 // Name: InteractableEntity
 // Written by: James Cote
@@ -43,6 +45,7 @@ public:
                     const string& sShaderType,
                     float fScale);
     void update(float fTimeInSeconds);
+    void interpolate(float fAlpha);
     void handleCollision(Entity* pOther, unsigned int iColliderMsg, unsigned int iVictimMsg);
     void getSpatialDimensions(vec3* pNegativeCorner, vec3* pPositiveCorner) const;
 
@@ -56,13 +59,26 @@ public:
 
     void explode(unsigned int iVictimMsg);
 
+    // Snapshots of all live rockets
+    void writeSnapshot(WorldSnapshot* pSnapshot) const;
+    bool readSnapshot(WorldSnapshot* pSnapshot);
+
 private:
+    // Drawing information of a single rocket
+    struct sRocketInstance
+    {
+        sInterpolatedTransform  sTransform;     // Last two steps of the rocket
+        unsigned int            iMeshInstance;  // Handle of the rocket's instance in m_pMesh
+    };
+
     EmitterEngine*                          m_pEmitterEngine;
     vector<string>                          m_pReferenceList;
+    unordered_map<string, sRocketInstance>  m_pRocketInstances;
     unsigned int                            m_iRocketID;
     unsigned int getNewRocketID()           { return ++m_iRocketID; }
     vec3                                    m_vExplosionColor;
 
+    void addRocket(unsigned int iRocketIndex, const mat4* m4InitialTransform, const vec3* vVelocity, float fBBLength);
     void removeFromScene(unsigned int iVictimMsg, bool shouldExplode);
 
     // @Override
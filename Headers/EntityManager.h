@@ -5,6 +5,8 @@
 #include "Physics/PhysicsManager.h"
 #include "SpatialDataMap.h"
 #include "UserInterface/UserInterface.h"
+#include "DataStructures/Frustum.h"
+#include "DataStructures/RenderQueue.h"
 
 /************************\
  * Forward Declarations *
@@ -25,6 +27,7 @@ class PointLight;
 class DirectionalLight;
 class SpotLight;
 class Texture;
+class WorldSnapshot;
 
 // Environment Manager
 // Manages all objects in an environment
@@ -88,7 +91,52 @@ public:
     void purgeEnvironment();
     void setupRender();
     void renderEnvironment(unsigned int iPlayer);
+
+    // Split screen: the opaque Render Components of every screen can be culled and drawn once for all of them,
+    //  into a layered Frame Buffer with a layer per screen. renderEnvironment then only draws what's left
+    //  of each screen. It can be disabled from the command line to draw every screen on its own.
+    static void setMultiViewEnabled(bool bEnabled) { m_bMultiViewEnabled = bEnabled; }
+    static bool useMultiView() { return m_bMultiViewEnabled; }
+    bool canRenderViewsTogether() const;
+    void renderViewsTogether();
     void updateEnvironment(std::chrono::duration<double> fSecondsSinceLastFrame);
+
+    // The environment is simulated in fixed steps, independently of the frame rate.
+    void setSimulationRate(unsigned int iStepsPerSecond);
+    unsigned int getLastFrameSimulationSteps() const { return m_iLastFrameSimulationSteps; }
+
+    // View being rendered, for Level of Detail selection and culling. The pixel scale is the height in
+    //  pixels of one unit at a distance of one unit. MULTI_VIEW draws getViewCount cameras at once,
+    //  otherwise there's a single one.
+    unsigned int getCurrentView() const { return m_iCurrentView; }
+    unsigned int getViewCount() const { return m_iViewCount; }
+    const vec3& getViewPosition(unsigned int iCamera) const { return m_pViewPositions[iCamera]; }
+    float getViewPixelScale(unsigned int iCamera) const { return m_pViewPixelScales[iCamera]; }
+    const sFrustum* getViewFrusta() const { return m_pViewFrusta; }
+    const int* getViewCells() const { return m_pViewCells; }           // Potentially Visible Set cell of each camera, -1 if not culled with it
+
+    // Triangles drawn per frame, including the shadow pass.
+    void addDrawnTriangles(unsigned int iTriangles) { m_iFrameTriangles += iTriangles; }
+    unsigned int getLastFrameTriangles() const { return m_iLastFrameTriangles; }
+
+    // Draw calls issued and Instances culled per view in a frame. The shadow pass is SHADOW_VIEW.
+    void addDrawCall() { ++m_iViewDrawCalls[m_iCurrentView]; }
+    void addCulledInstances(unsigned int iInstances) { m_iViewCulledInstances[m_iCurrentView] += iInstances; }
+    unsigned int getLastFrameDrawCalls(unsigned int iView) const { return m_iLastViewDrawCalls[iView]; }
+    unsigned int getLastFrameCulledInstances(unsigned int iView) const { return m_iLastViewCulledInstances[iView]; }
+    const RenderQueue& getRenderQueue() const { return m_sRenderQueue; }
+
+    // Shadows of Static Meshes are drawn into a cached shadow map, only redrawn when they change, so the
+    //  shadow pass of a frame only draws the moving casters. The cache can be disabled from the command
+    //  line to compare with drawing every caster each frame.
+    static void setStaticShadowCacheEnabled(bool bEnabled) { m_bStaticShadowCacheEnabled = bEnabled; }
+    static bool useStaticShadowCache() { return m_bStaticShadowCacheEnabled; }
+
+    // The screens skip what the arena hides from their camera, see the Potentially Visible Set of the
+    //  Spatial Data Map. It can be disabled from the command line to compare the draw calls.
+    static void setOcclusionCullingEnabled(bool bEnabled) { m_bOcclusionCullingEnabled = bEnabled; }
+    static bool useOcclusionCulling() { return m_bOcclusionCullingEnabled; }
+    unsigned int getStaticShadowRedraws() const { return m_iStaticShadowRedraws; }
     
     // The command handler can get all the players to directly communicate to.
     HovercraftEntity* getHovercraft(eHovercraft hovercraft) const;
@@ -106,6 +154,14 @@ public:
     const vector<HovercraftEntity*>* getBotList() const
         { return &m_pBotEntityList; }
 
+    // World Snapshots: capture and restore the state of the current match.
+    void captureSnapshot(WorldSnapshot* pSnapshot) const;
+    bool restoreSnapshot(WorldSnapshot* pSnapshot);
+#ifndef NDEBUG
+    void debugCaptureSnapshot();
+    void debugRestoreSnapshot();
+#endif
+
 private:
     EntityManager();
     EntityManager(const EntityManager* pCopy);
@@ -114,7 +170,40 @@ private:
     // Entity Managing
     int m_iEntityIDPool, m_iComponentIDPool;
     int m_iHeight, m_iWidth;
-    duration<float> m_fGameTime;
+    duration<float> m_fGameTime;            // Time not yet simulated
+    duration<float> m_fSimulationStep;      // Duration of a single simulation step
+    unsigned int m_iLastFrameSimulationSteps;
+    unsigned int m_iCurrentView, m_iViewCount;
+    vec3 m_pViewPositions[MAX_PLAYER_COUNT];
+    float m_pViewPixelScales[MAX_PLAYER_COUNT];
+    sFrustum m_pViewFrusta[MAX_PLAYER_COUNT];
+    int m_pViewCells[MAX_PLAYER_COUNT];
+    static bool m_bOcclusionCullingEnabled;
+    // Cameras of the screens, set up once per frame
+    unsigned int m_iScreenCount;
+    mat4 m_pScreenProjections[MAX_PLAYER_COUNT], m_pScreenModelViews[MAX_PLAYER_COUNT];
+    bool m_bViewsDrawnTogether;             // The opaque Render Components of every screen are drawn already
+    static bool m_bMultiViewEnabled;
+    unsigned int m_iFrameTriangles, m_iLastFrameTriangles;
+    unsigned int m_iViewDrawCalls[MAX_VIEW_COUNT], m_iLastViewDrawCalls[MAX_VIEW_COUNT];
+    unsigned int m_iViewCulledInstances[MAX_VIEW_COUNT], m_iLastViewCulledInstances[MAX_VIEW_COUNT];
+    RenderQueue m_sRenderQueue;             // Sorts the Render Components of each pass by state
+
+    // Shadow casters drawn by the current shadow pass
+    enum eShadowCasters
+    {
+        ALL_SHADOW_CASTERS = 0,
+        STATIC_SHADOW_CASTERS,
+        DYNAMIC_SHADOW_CASTERS
+    };
+    eShadowCasters m_eShadowCasters;
+    bool m_bStaticShadowsValid;
+    unsigned int m_iStaticShadowRevision;   // Revision of the Static Mesh Instances in the Static Shadow Map
+    mat4 m_m4StaticShadowLightSpace;        // Light the Static Shadow Map was drawn from
+    unsigned int m_iStaticShadowRedraws;
+    static bool m_bStaticShadowCacheEnabled;
+    void stepEnvironment(float fTimeInSeconds);
+    void interpolateEnvironment(float fAlpha);
     inline int getNewEntityID() { return ++m_iEntityIDPool; }
     inline int getNewComponentID() { return ++m_iComponentIDPool; }
 
@@ -160,10 +249,13 @@ private:
     
     // Private Functions
     void doRender();
+    void renderShadows(LightingComponent* pDirectionalLightComponent);
     void resetFBO();
     void renderAxis();
     void renderSkyBox();
     void setCameraPMVMatrices(unsigned int iPlayer);
+    void setupScreenCameras();
+    void setViewCamera(unsigned int iCamera, const mat4* pProjectionMatrix, const mat4* pModelViewMatrix);
 
     // Camera
     bool m_bUseDebugCamera;
@@ -180,5 +272,10 @@ private:
     // Skybox information
     Texture* m_pCubeMapTexture;
     GLuint m_iSkyBoxVertArray, m_iSkyBoxVertBuffer;
+
+#ifndef NDEBUG
+    // Quick save/load snapshot for reproducing bugs.
+    unique_ptr<WorldSnapshot> m_pDebugSnapshot;
+#endif
 };
 
@@ -58,6 +58,9 @@ enum eFixedCommand
     COMMAND_DEBUG_TOGGLE_DEBUG_CAMERA,
     COMMAND_DEBUG_TOGGLE_DRAW_BOUNDING_BOXES,
     COMMAND_DEBUG_TOGGLE_DRAW_SPATIAL_MAP,
+    COMMAND_DEBUG_TOGGLE_FRAME_STATS,
+    COMMAND_DEBUG_CAPTURE_SNAPSHOT,
+    COMMAND_DEBUG_RESTORE_SNAPSHOT,
     COMMAND_DEBUG_SET_UI_DISPLAY_COUNT_0,
     COMMAND_DEBUG_SET_UI_DISPLAY_COUNT_1,
     COMMAND_DEBUG_SET_UI_DISPLAY_COUNT_2,
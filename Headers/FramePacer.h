@@ -0,0 +1,72 @@
+#pragma once
+#include "stdafx.h"
+
+// Name: FramePacer
+// Description: Holds the game loop to a target frame rate without burning a core.
+//  A sleep wakes up late by up to a scheduler tick, so the pacer sleeps until shortly
+//  before the next frame is due and spins for the last fraction of a millisecond.
+//  The spin margin follows how late the sleeps have been waking up.
+//  With vsync, the buffer swap waits for the display instead: the swap interval is set
+//  to the number of refreshes per frame of the target rate and the pacer doesn't sleep.
+//  The time of every frame is sorted into a histogram for the frame stats.
+class FramePacer final
+{
+public:
+    // Target frame rates
+    enum eTargetRate
+    {
+        RATE_30 = 0,
+        RATE_60,
+        RATE_120,
+        RATE_UNCAPPED,
+        TARGET_RATE_COUNT
+    };
+
+    // Frame time histogram: frames shorter than each bound, in milliseconds, the last bucket holds the rest
+    static const unsigned int HISTOGRAM_BUCKETS = 8;
+
+    FramePacer();
+    ~FramePacer();
+
+    // Sets the swap interval of the current GL context and starts pacing from now.
+    void initialize();
+
+    // Blocks until the next frame is due and records the time of the frame that just ended.
+    void waitForNextFrame();
+
+    // Command line settings, applied on initialize.
+    static bool setTargetRate(const string& sRate);
+    static eTargetRate getTargetRate() { return m_eTargetRate; }
+    static void setVSyncEnabled(bool bEnabled) { m_bVSyncEnabled = bEnabled; }
+    static bool useVSync() { return m_bVSyncEnabled; }
+    static const char* getTargetRateName(eTargetRate eRate);
+
+    // Statistics since the last reset: frames per histogram bucket and time spent sleeping and spinning in milliseconds.
+    const unsigned int* getHistogram() const { return m_pHistogram; }
+    static float getHistogramBound(unsigned int iBucket);
+    unsigned int getFrames() const { return m_iFrames; }
+    double getSleepMilliseconds() const { return m_fSleepMilliseconds; }
+    double getSpinMilliseconds() const { return m_fSpinMilliseconds; }
+    double getSpinMarginMilliseconds() const { return duration<double, milli>(m_pSpinMargin).count(); }
+    void resetTotals();
+
+private:
+    FramePacer(const FramePacer& pCopy);
+    FramePacer& operator=(const FramePacer& pRHS);
+
+    void recordFrame(steady_clock::time_point pFrameStart);
+
+    static eTargetRate m_eTargetRate;
+    static bool m_bVSyncEnabled;
+
+    // Whether the pacer sleeps: not when uncapped or when the swap waits for vsync
+    bool m_bPacing;
+    bool m_bTimerPeriodSet;
+    steady_clock::duration m_pFramePeriod;
+    steady_clock::duration m_pSpinMargin;
+    steady_clock::time_point m_pNextFrame, m_pLastFrameStart;
+
+    unsigned int m_pHistogram[HISTOGRAM_BUCKETS];
+    unsigned int m_iFrames;
+    double m_fSleepMilliseconds, m_fSpinMilliseconds;
+};
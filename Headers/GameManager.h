@@ -3,6 +3,8 @@
 /* INCLUDES */
 #include "stdafx.h"
 #include "EntityHeaders/Camera.h"
+#include "DataStructures/GpuTimer.h"
+#include "FramePacer.h"
 #include <time.h>
 
 // Forward Declarations
@@ -13,6 +15,7 @@ class ShaderManager;
 class UserInterfaceManager;
 class GameInterface;
 class GameStats;
+class InputRecorder;
 class Texture;
 class SoundManager;
 
@@ -23,6 +26,21 @@ class SoundManager;
 class GameManager final
 {
 public:
+    /*
+        Bloom quality tiers. BLOOM_GAUSSIAN is a full resolution separable
+        Gaussian blur; the other tiers downsample the bright colours into a
+        mip chain starting at half resolution and upsample it back, one level
+        deeper (and wider) per tier.
+    */
+    enum eBloomQuality
+    {
+        BLOOM_GAUSSIAN = 0,
+        BLOOM_LOW,          // 1/2 and 1/4 resolution
+        BLOOM_MEDIUM,       // down to 1/8 resolution
+        BLOOM_HIGH,         // down to 1/16 resolution
+        BLOOM_QUALITY_COUNT
+    };
+
     static GameManager* getInstance(GLFWwindow *rWindow);
     static GameManager* getInstance();
     ~GameManager();
@@ -61,10 +79,45 @@ public:
 
     void flagWindowToClose() { glfwSetWindowShouldClose(m_pWindow, GL_TRUE); }
 
+    // Bloom quality of the frame buffers generated from now on, by name (gaussian, low, medium or high).
+    static bool setBloomQuality(const string& sQuality);
+    static eBloomQuality getBloomQuality() { return m_eBloomQuality; }
+    void runBloomBenchmark();
+
+    /*
+        Stages of drawScene timed by the render benchmark: setting up the
+        frame, drawing the screens together, drawing each screen, blurring the
+        bloom and compositing the screens (or drawing the menus).
+    */
+    enum eRenderStage
+    {
+        STAGE_SETUP = 0,
+        STAGE_VIEWS_TOGETHER,
+        STAGE_SCREENS,
+        STAGE_BLOOM,
+        STAGE_COMPOSITE,
+        RENDER_STAGE_COUNT
+    };
+
+    /*
+        Headless mode draws to a Frame Buffer instead of a window, which is
+        created hidden: set before the Game Manager is created. The frame dump
+        file is where the render benchmark writes its last frame.
+    */
+    static void setHeadless(bool bHeadless) { m_bHeadless = bHeadless; }
+    static bool isHeadless() { return m_bHeadless; }
+    static void setFrameDumpFile(const string& sFileName) { m_sFrameDumpFile = sFileName; }
+    void runRenderBenchmark(unsigned int iPlayers, unsigned int iFrames);
+
     vec3 getPlayerColor(eHovercraft player) const { return (int)m_vPlayerColors.size() > (int)player ? m_vPlayerColors.at(player) : vec3(1.0f); }
     vec3 getBotColor(eHovercraft bot) const { return m_vBotColors.empty() ? vec3(1.0f) : m_vBotColors.at(bot - MAX_PLAYER_COUNT); }
     vec3 getHovercraftColor(eHovercraft hovercraft) const { return hovercraft <= HOVERCRAFT_PLAYER_4 ? getPlayerColor(hovercraft) : getBotColor(hovercraft); }
 
+#ifndef NDEBUG
+    // Debug Frame Statistics
+    void toggleFrameStats() { m_bReportFrameStats = !m_bReportFrameStats; }
+#endif
+
 private:
     // For Singleton Implementation
     GameManager(GLFWwindow* rWindow); 
@@ -88,6 +141,7 @@ private:
 
     // Time
     void updateTime();
+    void updateInput();
     void checkIfStartedGameOver();
     void updateInGame();
     void checkIfShouldEndGame();
@@ -107,16 +161,59 @@ private:
         {
             GLuint iFBO;
             Texture* pBuffer;
-        } pPingPongBuffers[2];
+        } pPingPongBuffers[2];           // Gaussian blur only
+        sPingPongBuffer sBloomBuffer;       // Half resolution bloom of the mip chain tiers
     };
     vector< sRenderBlock > m_pFrameBufferTextures;
     void generateSplitScreen(unsigned int iPlayer);
     void cleanupFrameBuffers();
     void generateFrameBuffer(unsigned int iPlayer);
+    void generateColorTarget(sRenderBlock::sPingPongBuffer* pTarget, int iWidth, int iHeight,
+                             unsigned int iPlayer, unsigned int iBufferNum);
+    void deleteColorTarget(sRenderBlock::sPingPongBuffer* pTarget);
+
+    /*
+        Layered Frame Buffer the screens are drawn to together, with a layer per
+        screen: see EntityManager::renderViewsTogether. Each layer is then copied
+        to the Frame Buffer of its screen, where the rest of the screen is drawn.
+        Only generated once the screens are drawn together.
+    */
+    struct sMultiViewBuffer
+    {
+        GLuint iFrameBuffer, iReadFrameBuffer;  // Layered, and for reading a single layer
+        GLuint pTextures[3];                    // Color, Bright Color, Depth and Stencil
+        unsigned int iLayers;
+    } m_sMultiViewBuffer;
+    void generateMultiViewBuffer(unsigned int iLayers);
+    void deleteMultiViewBuffer();
+    void renderViewsTogether();
+
+    // Headless mode: the Frame Buffer the frames are drawn to in place of the window's
+    static bool m_bHeadless;
+    static string m_sFrameDumpFile;
+    GLuint m_iScreenFrameBuffer, m_pScreenRenderBuffers[2];    // Color, Depth and Stencil
+    void generateScreenFrameBuffer();
+    bool dumpFrame(const string& sFileName) const;
+
+    // CPU time spent issuing each stage of drawScene while the render benchmark runs, in milliseconds
+    bool m_bTimeRenderStages;
+    double m_pRenderStageTimes[RENDER_STAGE_COUNT];
+    high_resolution_clock::time_point m_pRenderStageStart;
+    void endRenderStage(eRenderStage eStage);
 
     // Blur Rendering variables
     GLuint m_iBlurVAO, m_iBlurVBO;
+    static eBloomQuality m_eBloomQuality;
+    /*
+        Levels of the mip chain below half resolution. The screens are bloomed
+        one after the other, so they share these; only the half resolution
+        level that holds the result belongs to each screen.
+    */
+    vector< sRenderBlock::sPingPongBuffer > m_pBloomMips;
+    void renderBloom();
     void blurBloomBuffer(unsigned int iScreen);
+    void renderBloomMipChain(unsigned int iScreen);
+    Texture* getBloomTexture(unsigned int iScreen) const;
 
     // Map Rendering variables
     vector< vec3 > m_vPositions, m_vColors;
@@ -131,23 +228,6 @@ private:
     GLFWwindow* m_pWindow;
 
     // Update Variables
-    /*
-        The time since graphics have been initialized.
-        This is tracked to ensure that all values update correctly for every
-        frame update.
-
-        Unit: seconds
-    */
-    duration<float> m_fFrameTime;
-    /*
-        This depends the rate at which the window is re-rendered.
-        Since it is costly to re-render the window, it is locked to re-render
-        at a fixed rate, even if the enviroment updates at a faster rate.
-
-        Unit: seconds
-    */
-    duration<float> m_fMaxDeltaTime;
-
     /*
         Difference in time from this frame and the last.
         Needed for updating all the entities every frame.
@@ -173,8 +253,10 @@ private:
     MenuManager*            m_pMenuManager;
     AIManager*              m_pAIManager;
     GameTime                m_pTimer;
+    FramePacer              m_pFramePacer;
     GameStats*              m_pGameStats;
     PhysicsManager*         m_pPhysicsManager;
+    InputRecorder*          m_pInputRecorder;
     /*
         All UserInterface's are managed by the UserInterfaceManager. However,
         the GameInterface is treated differently and is updated differently.
@@ -232,4 +314,19 @@ private:
 
     vector<vec3> m_vPlayerColors;
     vector<vec3> m_vBotColors;
+
+#ifndef NDEBUG
+    /*
+        Per-frame statistics, accumulated and reported to the console once
+        per second while enabled.
+    */
+    void reportFrameStats();
+    bool m_bReportFrameStats;
+    float m_fFrameStatsTime;
+    unsigned int m_iFrameStatsFrames;
+    unsigned int m_iFrameStatsHeapAllocations, m_iFrameStatsMaxHeapAllocations;
+    double m_fFrameStatsSubmitTime;             // CPU milliseconds spent issuing GL calls for the drawn frames
+    unsigned int m_iFrameStatsDrawnFrames;
+    GpuTimer m_sBloomTimer;                     // GPU time of the bloom of every screen, per drawn frame
+#endif
 };
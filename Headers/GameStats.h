@@ -39,6 +39,7 @@ struct EndGameStat
 
 class GameInterface;
 class HovercraftEntity;
+class WorldSnapshot;
 /*
     Stores and calculates all in-game stats.
 
@@ -237,6 +238,10 @@ public:
     vector<eHovercraft> getScoreLeaders() const { return m_eScoreLeaders; }
     eHovercraft getScoreLeader() const { return m_eScoreLeaders.empty() ? HOVERCRAFT_PLAYER_1 : m_eScoreLeaders.at(0); }
 
+    // Snapshots of the in-game stat tables
+    void writeSnapshot(WorldSnapshot* pSnapshot) const;
+    bool readSnapshot(WorldSnapshot* pSnapshot);
+
 private:
     GameStats(int iWidth, int iHeight);
     static GameStats* m_pInstance;
@@ -276,6 +281,8 @@ private:
     efficiency.
     */
     int stats[MAX_HOVERCRAFT_COUNT][HOVERCRAFTSTAT_COUNT];
+    static const unsigned int STAT_TABLE_SIZE = sizeof(stats) / sizeof(stats[0][0]);     // Every stat of every hovercraft
+    static_assert(STAT_TABLE_SIZE == (MAX_HOVERCRAFT_COUNT) * HOVERCRAFTSTAT_COUNT, "The stat table must hold a row for every hovercraft");
 
     int globalStats[GLOBALSTAT_COUNT];
 
@@ -3,12 +3,6 @@
 
 using namespace std::chrono;
 
-/*
-Typedef for 1/60th of a second: (60 fps)
-This is used to determine the frame rate for rendering updates.
-*/
-typedef duration<long, std::ratio<1, 60>> sixtieth_of_a_sec;
-
 /***********************************************************
  * GameTime Class: Maintains the Time for the game logic.
  * Written by: James Cote, Evan Quan
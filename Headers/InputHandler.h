@@ -187,4 +187,7 @@ private:
 
     // Joysticks
     void updateJoystickButtonStates(int joystick);
+
+    // Records and replays the keyboard and joystick states.
+    friend class InputRecorder;
 };
@@ -0,0 +1,78 @@
+#pragma once
+#include "stdafx.h"
+#include <fstream>
+
+/*
+    Records everything that can make two runs of the game play differently
+    into a binary log, and plays that log back.
+
+    While recording, the random seed is written once, then every frame the
+    frame delta time, the keyboard state and the joystick state that the
+    menus are about to process.
+    While replaying, live input is ignored and the InputHandler and frame
+    time are driven from the log instead, so the same session plays out
+    identically regardless of how long each frame actually takes to render.
+    This makes it possible to replay the same match through profiling builds
+    and compare frame times between commits.
+
+    Record/replay is started from the command line:
+        --record <file>
+        --replay <file>
+*/
+class InputRecorder final
+{
+public:
+    static InputRecorder* getInstance();
+    ~InputRecorder();
+
+    bool startRecording(const string& sFileName);
+    bool startReplay(const string& sFileName);
+    void stop();
+
+    bool isRecording() const { return RECORDER_RECORDING == m_eMode; }
+    bool isReplaying() const { return RECORDER_REPLAYING == m_eMode; }
+    bool isActive() const { return RECORDER_IDLE != m_eMode; }
+
+    // Seed for every random number generator in the game while recording or replaying.
+    unsigned int getRandomSeed() const { return m_iRandomSeed; }
+
+    // Record the input of the current frame. Called after the joysticks have been polled.
+    void recordFrame(double fFrameDeltaTime);
+    /*
+        Load the input of the next frame into the InputHandler.
+
+        @param fWallDeltaTime           real time the last frame took, for the replay statistics
+        @param[out] fReturnDeltaTime    recorded frame time to simulate this frame with
+        @return false once the log has been fully replayed
+    */
+    bool replayFrame(double fWallDeltaTime, double* fReturnDeltaTime);
+
+private:
+    static InputRecorder* m_pInstance;
+    InputRecorder();                                        // Singleton Implementation
+    InputRecorder(const InputRecorder* pCopy);              // Copy Constructor Overload
+    InputRecorder& operator=(const InputRecorder* pCopy);   // Assignment Operator overload
+
+    enum eRecorderMode
+    {
+        RECORDER_IDLE,
+        RECORDER_RECORDING,
+        RECORDER_REPLAYING,
+    } m_eMode;
+
+    void seedRandomGenerators();
+    void reportReplay() const;
+
+    unsigned int m_iRandomSeed;
+    fstream m_pLogFile;
+
+    /*
+        Axes values of the replayed joysticks. The InputHandler points to these
+        instead of the axes arrays owned by GLFW while replaying.
+    */
+    float m_fReplayAxes[MAX_PLAYER_COUNT][MAX_AXES_COUNT];
+
+    // Statistics
+    unsigned int m_iFrameCount;
+    double m_fTotalWallTime, m_fMaxWallTime;
+};
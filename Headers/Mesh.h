@@ -3,6 +3,20 @@
 #include "ShaderManager.h"
 #include "Texture.h"
 #include "DataStructures/ObjectInfo.h"
+#include "DataStructures/CookedMesh.h"
+#include "DataStructures/StreamBuffer.h"
+#include "DataStructures/Frustum.h"
+
+// Returned for Instance Handles that don't refer to an Instance.
+#define INVALID_INSTANCE_HANDLE 0xFFFFFFFF
+
+// Detail levels of each Terrain Chunk; level L uses every (2^L)th vertex of the heightmap.
+#define TERRAIN_LOD_LEVELS 4
+
+/************************\
+ * Forward Declarations *
+\************************/
+class RenderQueue;
 
 //////////////////////////////////////////////////////////////////
 // Name: Mesh.h
@@ -23,14 +37,25 @@ private:
     void genSphere(float fRadius, vec3 vPosition, string sHashKey);
     void genCube(float fHeight, float fWidth, float fDepth, vec3 vPosition, string sHashKey);
     void genBillboard();
+    void buildTerrainChunks(int iTilesX, int iTilesY, float fGridSize, float fSkirtDepth);
     void initalizeVBOs();
-    void initalizeVBOs(const vector<float>* vVNData, bool bUsingNormals, bool bUsingUVs);
+    void initalizeVBOs(const void* pVNData, size_t iVNDataSize, bool bUsingNormals, bool bUsingUVs, bool bQuantized = false);
     void gatherVNData(vector<float>* vVNData, bool* bUsingNormals, bool* bUsingUVs);
     bool loadObj(const string& sFileName);
-    void loadObjectInfo(const ObjectInfo* pObjectProperties, string sHashKey);
+    void loadObjectInfo(const ObjectInfo* pObjectProperties);
     void loadMaterial(const ObjectInfo::Material* pMaterial);
-    void loadBoundingBox(const ObjectInfo::BoundingBox* pBoundingBox, const vec3* vStartingPosition, string sHashKey);
-    void loadInstanceBuffer();
+    void loadObjMaterial(const ObjParser::sMaterial* pMaterial);
+    void loadLods(const CookedMesh* pCookedMesh);
+    void loadBoundingBox(const ObjectInfo::BoundingBox* pBoundingBox);
+    unsigned int storeInstance(const mat4* m4ScaledTransform, const mat4* m4BBTransform);
+    void markInstanceDirty(unsigned int iSlot);
+    void markAllInstancesDirty();
+    void uploadInstances();
+    void writeInstanceStream(StreamBuffer* pStream, GLuint iVertexArray, GLuint iStartIndex, const vector<mat4>* pTransforms, unsigned int iRegion);
+    void computeBoundingSphere();
+    vec4 getInstanceBounds(const mat4* m4ScaledTransform) const;
+    void uploadBillboards();
+    void initializeBillboardStream();
 
     // function to generate a quaternion to rotate from y-axis normal to specified normal
     mat4 getRotationMat4ToNormal(const vec3* vNormal);
@@ -42,19 +67,18 @@ private:
         Texture* m_pSpecularMap;
         float fShininess;
     } m_sRenderMaterial;
+    bool m_bDefaultMaterial;    // No diffuse map or color was given, so the .mtl material of the mesh may be used.
 
     // The Bounding Box Drawing information
     struct sBoundingBox
     {
         // BoundingBox Variables
-        //vector<mat4>            pInstances;
-        unordered_map<string, mat4> pInstanceMap;
         vector<vec3>                pVertices;
         vector< unsigned int>       pIndices;
         GLuint                      iVertexBuffer,
-                                    iInstancedBuffer,
                                     iVertexArray,
                                     iIndicesBuffer;
+        StreamBuffer                sInstanceStream;    // Written together with the Instance Stream of the Mesh
         vec3                        m_vNegativeOffset, m_vPositiveOffset; // Specifies the dimensions of the Spacial cube for the Bounding Box.
         eBoundingBoxTypes           eType;
 
@@ -65,52 +89,121 @@ private:
         void deleteBuffers();   // Deletes the VAO and VBOs used by the Mesh's Bounding Box
         void initVBOs();        // Initializes VBOs for the Bounding Box.
 
-        // Loads a new transformation Instance into the Instance buffer
-        void loadInstance(const mat4* pTransform, string sHashKey);
-        void updateInstance(const mat4* pTransform, string sHashKey);
-        void removeInstance(string sHashKey);
-        void loadInstanceBuffer();
-
         // Generation Functions
         void generateCubicBox(float fHeight, float fWidth, float fDepth);
         void generateCubicBox(const vec3* vNegativeOffset, const vec3* vPositiveOffset);
     } m_sBoundingBox;
 
-    // Adds an Instance for Bounding Box Drawing
-    void addBBInstance(const mat4* m4Transformation, string sHashKey);
-
     // Mesh Information and GPU VAO/VBOs
     vector<unsigned int>        m_pIndices;
     vector< vec3 >              m_pVertices,
                                 m_pNormals;
     vector< vec2 >              m_pUVs;
     GLuint                      m_iVertexBuffer,
-                                m_iInstancedBuffer,
                                 m_iIndicesBuffer,
                                 m_iVertexArray;
+    StreamBuffer                m_sInstanceStream;
 
     // Spatial Information for Mesh
     vec3 m_vNegativeOffset, m_vPositiveOffset;
 
+    // Level of Detail: ranges of the Index Buffer, the full mesh first. Empty if the Mesh only has the full mesh.
+    struct sLodLevel
+    {
+        GLsizei iIndexCount;
+        GLintptr iIndexOffset;  // In bytes
+    };
+    vector<sLodLevel>           m_pLodLevels;
+
+    // Bounding Sphere of the unscaled Mesh, for Level of Detail and culling. A radius of 0 means the Mesh has no
+    //  vertices to bound (e.g. Billboards) and is never culled.
+    vec3                        m_vBoundingCenter;
+    float                       m_fBoundingRadius;
+
+    /*
+        Terrain Chunks: planes are split into square chunks of the heightmap so each
+        chunk can be culled and drawn at its own level of detail. Every level of
+        every chunk is a range of the Index Buffer, and includes skirts hanging
+        below the chunk edges that hide the cracks between neighbouring chunks
+        drawn at different levels.
+    */
+    struct sTerrainChunk
+    {
+        vec3 vMinimum, vMaximum;                        // Bounds in model space, including the skirts
+        sLodLevel pLevels[TERRAIN_LOD_LEVELS];
+    };
+    vector<sTerrainChunk>       m_pTerrainChunks;
+    float                       m_fTerrainChunkSize;    // Width of a full chunk
+
     string                      m_sManagerKey;          // Used as key for finding Mesh in MeshManager
     ShaderManager*              m_pShdrMngr;            // Pointer to Shader Manager for GPU/Shader Interaction
-    unordered_map<string, mat4> m_m4InstanceMap;        // Map for handled Instance Management among multiple objects
+    unordered_map<string, unsigned int> m_pInstanceKeys;    // Hash Key -> Instance Handle for Instances added by Hash Key
     bool                        m_bStaticMesh;          // Boolean to differentiate between Static and Dynamic Meshes (one is updated on load, others are updated frequently)
+    static unsigned int         m_iStaticInstanceRevision;  // Incremented whenever an Instance of any Static Mesh changes
     mat4                        m_m4ScaleMatrix;        // Scale Matrix that is set on load for any updates that need to maintain the scale of the mesh.
 
-    // Billboard Information
+    /*
+        Instance Information
+        Instance transforms are stored densely in draw order and addressed by stable
+        integer handles through the Handle -> Slot table. Removing an instance moves
+        the last instance into its slot. Modified slots are tracked as a dirty range
+        per region of the Instance Stream; once per frame, if anything changed, the
+        dirty range of the next region is written to it by uploadInstances().
+    */
+    vector<mat4>                m_pInstanceTransforms;      // Scaled transforms, uploaded to the Instance Buffer
+    vector<mat4>                m_pBBInstanceTransforms;    // Unscaled transforms for the Bounding Box, same slots as above
+    vector<vec4>                m_pInstanceBounds;          // World Bounding Sphere of each Instance (center, radius), same slots as above
+    vector<unsigned int>        m_pInstanceSlotHandles;     // Handle of the Instance stored in each slot
+    vector<unsigned int>        m_pInstanceHandleSlots;     // Slot of each Handle, INVALID_INSTANCE_HANDLE if the Handle is free
+    vector<unsigned int>        m_pFreeInstanceHandles;     // Handles available for reuse
+    unsigned int                m_iDirtyBegin[STREAM_BUFFER_REGIONS],   // Range of slots [Begin, End) modified since
+                                m_iDirtyEnd[STREAM_BUFFER_REGIONS];     //  each region was last written
+    bool                        m_bInstancesChanged;        // Instances have changed since the last upload
+    unsigned int                m_iInstanceCapacity;        // Number of Instances the Instance Streams can currently hold
+
+    /*
+        Culling
+        Each view writes the transforms of the Instances in its frustum to its own
+        Visible Stream and draws those. Each Visible Stream is written once per frame,
+        so it cycles through its regions without waiting on the other views.
+        If every Instance is visible, the Instance Stream is drawn as is.
+    */
+    mutable StreamBuffer        m_sVisibleStreams[MAX_VIEW_COUNT];
+    mutable unsigned int        m_iVisibleCapacity[MAX_VIEW_COUNT];    // Number of Instances each Visible Stream can hold
+    mutable vector<mat4>        m_pVisibleTransforms;       // Scratch list of the visible Instances
+    mutable bool                m_bDrawingVisibleStream;    // The Instance Attributes point at a Visible Stream
+    mutable GLuint              m_iInstanceDivisor;         // Views each Instance is drawn for, see setInstanceDivisor
+
+    /*
+        Billboard Information
+        Billboards are written once when they're added. The billboard shader picks
+        the sprite and shrinks the Billboard from the Billboard Time of the Mesh, so
+        nothing is updated per Billboard while they're alive. Expired Billboards are
+        skipped by the shader until the list is uploaded again.
+    */
     struct sBillboardInfo
     {
         vec3 vPosition, vNormal, vColor;
-        vec2 vUVStart, vUVEnd, vDimensions;
-        float fDuration;
+        vec2 vDimensions;
+        vec2 vSpriteCounts;     // Sprites across and down the sprite sheet
+        vec2 vUVBorder;         // Border left out around each sprite
+        float fStartFrame;      // Sprite shown when added, counted across then down the sheet
+        float fSpawnTime, fDuration;
     };
     vector<sBillboardInfo> m_pBillboardList;
+    float m_fBillboardTime;             // Time Billboards are added and animated at, advanced by the AnimationComponent
+    StreamBuffer m_sBillboardStream;
+    unsigned int m_iBillboardCapacity;  // Number of Billboards the Billboard Stream can currently hold
+    bool m_bBillboardsChanged;          // Billboards have changed since the last upload
+    GLint m_iFirstVertex;               // First Billboard to draw from the Billboard Stream
 
     // Billboard Functionality -> Only accessable within AnimationComponent
     void updateBillboardVBO();
-    unsigned int addBillboard(const vec3* vPosition, const vec3* vNormal, const vec3* vColor, const vec2* vUVStart, const vec2* vUVEnd, float fHeight, float fWidth, float fDuration);
+    unsigned int addBillboard(const vec3* vPosition, const vec3* vNormal, const vec3* vColor, const vec2* vSpriteCounts, const vec2* vUVBorder,
+                              unsigned int iStartFrame, float fHeight, float fWidth, float fDuration);
     void flushBillboards();
+    void removeExpiredBillboards();
+    void setBillboardTime(float fTime);
 
     // Friend Class: MeshManager to create Meshes.
     friend class MeshManager;
@@ -120,11 +213,11 @@ private:
     struct manager_cookie {};
 
 public:
-    explicit Mesh(const string &sFileName, bool bStaticMesh, float fScale, const ObjectInfo* pObjectProperties, string sHashKey, manager_cookie);
+    explicit Mesh(const string &sFileName, bool bStaticMesh, float fScale, const ObjectInfo* pObjectProperties, manager_cookie);
     virtual ~Mesh();
 
     // Get Information for drawing elements.
-    GLuint getNumInstances() const { return m_m4InstanceMap.size(); }
+    GLuint getNumInstances() const { return m_pInstanceTransforms.size(); }
     GLuint getCount() const {
         if (!m_pIndices.empty())                // Using Indices takes priority
             return m_pIndices.size();
@@ -136,13 +229,53 @@ public:
 
     // Checks for Render Component
     bool usingIndices() const { return !m_pIndices.empty(); }
-    bool usingInstanced() const { return 0 != m_iInstancedBuffer; }
+    bool usingInstanced() const { return m_sInstanceStream.isInitialized(); }
+    GLint getFirstVertex() const { return m_iFirstVertex; }
+    bool usingBillboards() const { return m_sBillboardStream.isInitialized(); }
+    float getBillboardTime() const { return m_fBillboardTime; }
+
+    // Level of Detail, 0 being the full Mesh. Each level is drawn as getLodIndexCount indices from getLodIndexOffset in the Index Buffer.
+    unsigned int getLodCount() const { return m_pLodLevels.empty() ? 1 : static_cast<unsigned int>(m_pLodLevels.size()); }
+    GLsizei getLodIndexCount(unsigned int iLod) const { return m_pLodLevels.empty() ? getCount() : m_pLodLevels[iLod].iIndexCount; }
+    const void* getLodIndexOffset(unsigned int iLod) const { return m_pLodLevels.empty() ? nullptr : reinterpret_cast<const void*>(m_pLodLevels[iLod].iIndexOffset); }
+    float getLargestProjectedSize(const vec3* vViewPosition, float fPixelsPerUnit) const;  // Diameter in pixels of the Instance nearest to the viewer
+    float getNearestInstanceDistance(const vec3* vViewPosition) const;                      // Distance to the nearest Instance bounds, for draw order
+
+    // Culls the Instances against the frustums and Potentially Visible Set cells of the views drawn and points the
+    //  Instance Attributes at the visible ones. Returns the number of Instances to draw. Meshes that can't be culled
+    //  are always drawn whole.
+    bool usingCulling() const { return m_fBoundingRadius > 0.0f && usingInstanced() && !isChunked(); }
+    GLsizei cullInstances(const sFrustum* pFrusta, const int* pViewCells, unsigned int iFrustumCount, unsigned int iView) const;
+
+    // Draws each Instance for iViews views in a row, see the Views block of the shaders. 1 for a single view.
+    void setInstanceDivisor(GLuint iViews) const;
+
+    // Static Meshes only change when the scene is loaded; anything cached from them (the static shadow map)
+    //  is valid as long as the revision stays the same.
+    bool isStaticMesh() const { return m_bStaticMesh; }
+    static unsigned int getStaticInstanceRevision() { return m_iStaticInstanceRevision; }
+
+    // Terrain Chunks, drawn one by one instead of the whole Index Buffer. A chunk is visible if it's in the
+    //  frustum for any Instance; fDistance receives the distance from the viewer to the nearest of those.
+    bool isChunked() const { return !m_pTerrainChunks.empty(); }
+    unsigned int getChunkCount() const { return static_cast<unsigned int>(m_pTerrainChunks.size()); }
+    float getChunkSize() const { return m_fTerrainChunkSize; }
+    GLsizei getChunkIndexCount(unsigned int iChunk, unsigned int iLod) const { return m_pTerrainChunks[iChunk].pLevels[iLod].iIndexCount; }
+    const void* getChunkIndexOffset(unsigned int iChunk, unsigned int iLod) const { return reinterpret_cast<const void*>(m_pTerrainChunks[iChunk].pLevels[iLod].iIndexOffset); }
+    bool getChunkVisibility(unsigned int iChunk, const sFrustum* pFrustum, const vec3* vViewPosition, float* fDistance) const;
 
     // Function to add a new Instance Matrix for the Mesh. If the Mesh is dynamic, it will replace the current instance, static will add a new instance.
-    void addInstance(const vec3* vPosition, const vec3* vNormal, float fScale, string sHashKey);    // Specify particular components and a transformation matrix will be generated
-    void addInstance(const mat4* m4Transform, string sHashKey);                                             // Add an Instance with a given HashKey
+    //  Objects that update their instance every frame should hold on to the returned handle and use the handle overloads.
+    unsigned int addInstance(const vec3* vPosition, const vec3* vNormal, float fScale, string sHashKey);    // Specify particular components and a transformation matrix will be generated
+    unsigned int addInstance(const mat4* m4Transform, string sHashKey);                                     // Add an Instance with a given HashKey
+    unsigned int addInstance(const mat4* m4Transform);                                                      // Add an Instance and return its Handle
     void updateInstance(const mat4* m4Transform, string sHashKey);                                          // Updates a Transformation matrix at a given hashkey.
+    void updateInstance(const mat4* m4Transform, unsigned int iHandle);                                     // Updates the Transformation matrix of a given handle.
     void removeInstance(string sHashKey);                                                                   // Removes a transformation matrix at a given hashkey.
+    void removeInstance(unsigned int iHandle);                                                              // Removes the transformation matrix of a given handle.
+
+    // Writes the Instances and Billboards modified since the last call to their Stream Buffers. Called once per frame before rendering.
+    void uploadStreams();
 
     // Getters for Mesh Data
     const vector<vec3>& getVertices() const         { return m_pVertices; }
@@ -152,9 +285,9 @@ public:
     GLuint getVertexArray() const { return m_iVertexArray; }
     void getSpatialDimensions(vec3* pNegativeOffset, vec3* pPositiveOffset);    // Get Spatial Dimensions for the Mesh/BoundingBox.
 
-    // Functionality for Binding and Unbinding Textures
-    void bindTextures(ShaderManager::eShaderType eShaderType) const ;
-    void unbindTextures() const;
+    // Binds the Material through the Render Queue drawing the Mesh; textures are left bound for the next Mesh using them.
+    void bindTextures(ShaderManager::eShaderType eShaderType, RenderQueue* pRenderQueue) const;
+    GLuint getDiffuseTextureID() const { return m_sRenderMaterial.m_pDiffuseMap->getTextureID(); }
 
     // Bounding Box Functionality
     void generateCubicBoundingBox(float fHeight, float fWidth, float fDepth) { m_sBoundingBox.generateCubicBox(fHeight, fWidth, fDepth); }
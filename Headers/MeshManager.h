@@ -16,6 +16,7 @@ public:
     Mesh* generateSphereMesh(bool bStaticMesh, float fRadius, const ObjectInfo* pObjectProperties, string sHashKey);
     Mesh* generateCubeMesh(bool bStaticMesh, float fHeight, float fWidth, float fDepth, const ObjectInfo* pObjectProperties, string sHashKey);
     Mesh* generateBillboardMesh(const ObjectInfo* pObjectProperties, const void* pOwnerHandle );
+    void uploadStreams();
     void unloadAllMeshes();
 
 private:
@@ -0,0 +1,76 @@
+#pragma once
+#include "stdafx.h"
+#include "DataStructures/StreamBuffer.h"
+
+/************************\
+ * Forward Declarations *
+\************************/
+class Texture;
+
+/*************************************************
+ * Name: ParticlePool
+ * Description: Storage for the particles of every Emitter. Particles are
+ *              grouped into batches by texture, and each batch is stored
+ *              as separate arrays per component (structure of arrays) so
+ *              integration runs as straight loops over contiguous floats
+ *              that the compiler can vectorize. A particle that dies is
+ *              replaced by the last particle of its batch.
+ *              All positions are written to a single Stream Buffer once
+ *              per frame and every batch is drawn with one draw call.
+\**************************************************/
+class ParticlePool final
+{
+public:
+    ParticlePool();
+    ~ParticlePool();
+
+    // Batch to spawn the particles drawn with a texture in, created on first use.
+    unsigned int getBatch(Texture* pTexture);
+
+    // Spawn a particle; its initial force is its velocity.
+    void spawnParticle(unsigned int iBatch, const vec3* vPosition, const vec3* vVelocity, float fDuration);
+
+    // Integrate all particles and remove the ones whose duration has run out.
+    void update(float fDelta);
+
+    // Write the particle positions to the GPU, once per frame before drawing.
+    void upload();
+    void draw();
+
+    void clear();
+    unsigned int getParticleCount() const;
+
+    // Times updating the pool with increasing numbers of simultaneous explosions.
+    static void runBenchmark();
+
+private:
+    ParticlePool(const ParticlePool& pCopy);
+    ParticlePool& operator=(const ParticlePool& pRHS);
+
+    // Components of a particle, each stored in its own array.
+    enum eComponent
+    {
+        POSITION_X = 0, POSITION_Y, POSITION_Z,
+        VELOCITY_X, VELOCITY_Y, VELOCITY_Z,
+        FORCE_X, FORCE_Y, FORCE_Z,
+        DURATION,
+        COMPONENT_COUNT
+    };
+
+    struct sBatch
+    {
+        Texture* pTexture;
+        vector<float> pComponents[COMPONENT_COUNT];
+        unsigned int iCount;
+        GLint iFirstVertex;     // Position of the batch in the Position Stream
+        GLsizei iDrawCount;     // Number of positions written by the last upload()
+    };
+
+    void updateBatch(sBatch* pBatch, float fDelta);
+    void initializePositionStream();
+
+    vector<sBatch> m_pBatches;
+    StreamBuffer m_sPositionStream;
+    GLuint m_iVertexArray;
+    unsigned int m_iStreamCapacity;     // Number of positions the Position Stream can currently hold
+};
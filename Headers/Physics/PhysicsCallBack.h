@@ -11,13 +11,24 @@
 /*
     Handles the collisions between objects in the game world.
 
+    Contacts reported by PhysX during fetchResults() are only recorded into a
+    compact event buffer. They are deduplicated and dispatched to the
+    EntityManager in a single batch by dispatchCollisions() once the
+    simulation step has completed, so no gameplay runs inside the PhysX
+    callback.
+
     @author Austin Eaton
     @author Evan Quan
 */
 class PhysicsCallBack : public physx::PxSimulationEventCallback {
 public:
+    PhysicsCallBack();
+
     void initObjects(physx::PxRigidDynamic *body1, physx::PxRigidDynamic *body2);
 
+    // Dispatches all collisions recorded since the last dispatch. Called after fetchResults().
+    void dispatchCollisions();
+
     // PxSimulationEventCallback functions
     // These are necessary for collision events
     // Reference: https://docs.nvidia.com/gameworks/content/gameworkslibrary/physx/apireference/files/classPxSimulationEventCallback.html
@@ -30,4 +41,22 @@ public:
 private:
     PxRigidDynamic *m_pBody1 = NULL;
     PxRigidDynamic *m_pBody2 = NULL;
+
+    /*
+        A single recorded contact, parsed from the actor names ("<Entity ID> <Message>").
+    */
+    struct sCollisionEvent
+    {
+        int iColliderID, iCollidedID;
+        unsigned int iColliderMsg, iCollidedMsg;
+
+        bool operator==(const sCollisionEvent& sOther) const
+        {
+            return iColliderID == sOther.iColliderID && iCollidedID == sOther.iCollidedID &&
+                   iColliderMsg == sOther.iColliderMsg && iCollidedMsg == sOther.iCollidedMsg;
+        }
+    };
+    vector<sCollisionEvent> m_vCollisionEvents;     // Capacity is kept between steps.
+
+    static bool parseActorName(const char* cName, int* iReturnID, unsigned int* iReturnMsg);
 };
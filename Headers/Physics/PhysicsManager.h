@@ -14,6 +14,7 @@
 
 // Forward Declaration
 class Mesh;
+class PhysicsCallBack;
 
 #define WHEEL_COUNT 4
 /***************************************************************
@@ -78,7 +79,7 @@ private:
     std::vector<physx::PxTriangleMesh*> triangleMeshes;
     std::vector<physx::PxShape*> shapes;
 
-    PxSimulationEventCallback *cb;
+    PhysicsCallBack *cb;            // Records collisions during a step, dispatches them after the step.
     std::vector<physx::PxVehicleNoDrive *> vehicles;
     std::vector<physx::PxRigidStatic *> staticObjects;
     std::vector<physx::PxRigidDynamic *> dynamicObjects;
@@ -109,7 +110,6 @@ private:
     // Private Variables
     bool m_bInteractive;            // Not sure what this is for, but maybe set it on initialization and maintain it over
                                     // the longevity of the Physics Manager? 
-    float m_fTimeSinceLastUpdate;   // Increments every update to track how long since last Physics Update.
     // Moving these from Constructor to Here to privatize these variables used by the Physics
     //    manager
     physx::PxDefaultAllocator*      gAllocator;
@@ -8,6 +8,7 @@
 class Rocket;
 class Mesh;
 class EntityManager;
+class AssetPreloader;
 
 // Solely Generates Objects and assigns IDs to them.
 class SceneLoader final
@@ -39,6 +40,7 @@ private:
     SceneLoader( SceneLoader* pCopy );
     static SceneLoader* m_pInstance;
     EntityManager* m_pEntityManager;
+    AssetPreloader* m_pAssetPreloader;
 
     vector<vec3> m_vSpawnPoints;
 
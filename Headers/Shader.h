@@ -39,6 +39,10 @@ public:
     GLuint getProgram() { return m_uiProgram; }
     GLint fetchVarLocation(const GLchar* sVarName) { return glGetUniformLocation(m_uiProgram, sVarName); }
 
+    // Location of a uniform from the table built when the program was linked, ERR_CODE if it isn't active.
+    //  Arrays can be found by their name with or without "[0]".
+    GLint getUniformLocation(const string& sVarName) const;
+
 private:
     GLuint m_uiShader[ MAX_PARTS ];
     string m_uiShaderLocations[ MAX_PARTS ];
@@ -46,9 +50,11 @@ private:
     // Shader Variables
     GLuint  m_uiProgram;
     bool    m_bInitialized;
+    unordered_map<string, GLint> m_pUniformLocations;    // Name -> Location of every active uniform outside a block
 
     // Protected Functions for Setting up Shaders
     string LoadSource( int iShaderType, bool* bError);
     GLuint CompileShader(GLenum shaderType, const string &source, bool* bError);
     GLuint LinkProgram( bool* bError);
+    void cacheUniformLocations();
 };
@@ -4,11 +4,17 @@
 #include "stdafx.h"
 #include "Shader.h"
 #include "EntityComponentHeaders/LightingComponent.h"
+#include "DataStructures/LightClusters.h"
 
 // Class: Shader Manager
 // Purpose: Manages all the Shaders used by every Assignment.  Manages Uniform variable
 //          manipulation and properly initializes and destroys created Shaders.
-// Current Issues: Uniform variables hard-coded.
+//          Uniform locations are looked up once when the shaders are linked. Uniforms
+//          set on every draw are named by an eUniform handle instead of a string, and
+//          are written with glProgramUniform so the bound program is left alone.
+//          Camera matrices and lights live in std140 Uniform Buffers written once per
+//          view and once per frame respectively. Point and Spot Lights are stored in
+//          per-cluster lists (see LightClusters) rebuilt for every view.
 // Written by: James Coté
 class ShaderManager final
 {
@@ -30,10 +36,31 @@ public:
         SPLIT_SCREEN_SHDR,
         BLUR_SHDR,
         TRON_SHDR,
+        BLOOM_DOWNSAMPLE_SHDR,
+        BLOOM_UPSAMPLE_SHDR,
         MAX_SHDRS
     };
     const static unordered_map<string, eShaderType> pShaderTypeMap;
 
+    // Handles of the uniforms set while drawing, resolved for every shader at link time.
+    enum eUniform
+    {
+        MATERIAL_DIFFUSE = 0,
+        MATERIAL_SPECULAR,
+        MATERIAL_SHININESS,
+        BILLBOARD_TIME,
+        DEBUG_COLOR,
+        BLUR_HORIZONTAL,
+        BLUR_TEXTURE,
+        HDR_BUFFER,
+        BLOOM_BUFFER,
+        UI_TEXT,
+        UI_TEXT_COLOR,
+        UI_IS_IMAGE,
+        UI_BACKGROUND_IMAGE,
+        MAX_UNIFORMS
+    };
+
     // Singleton implementation and Destructor
     static ShaderManager* getInstance();
     ~ShaderManager();
@@ -45,6 +72,14 @@ public:
     void setDirectionalModelMatrix(const mat4* pDirModelMat);
     void setSpotLightModelMatrices(const mat4* pSpotLightMat, unsigned int iIndex);
     void setLightsInUniformBuffer(const LightingComponent* pDirectionalLight, const vector< LightingComponent* >* pPointLights );
+    void setLightClusters(const mat4* pProjMats, const mat4* pModelViewMats, unsigned int iViewCount, int iWidth, int iHeight);
+    LightClusters* getLightClusters() { return &m_sLightClusters; }
+
+    // Cameras of the views drawn together by the next draws (up to MAX_PLAYER_COUNT), and the index
+    //  of the first one in the Light Clusters.
+    void setViewMatrices(const mat4* pProjMats, const mat4* pModelViewMats, unsigned int iViewCount, int iClusterView);
+    static bool supportsLayeredViews();
+    static bool isMultiViewShader(eShaderType eType);
 
     // Get the specified program for using shaders for rendering
     GLuint getProgram(eShaderType eType) { return m_pShader[eType].getProgram(); }
@@ -53,20 +88,34 @@ public:
     // Setup Buffers and Arrays in GPU
     GLuint genVertexBuffer( GLuint iVertArray, const void* pData, GLsizeiptr pSize, GLenum usage );
     void setAttrib(GLuint iVertArray, GLuint iSpecifiedIndex,
-                     GLint iChunkSize, GLsizei iStride, const void *pOffset);
+                     GLint iChunkSize, GLsizei iStride, const void *pOffset,
+                     GLenum eType = GL_FLOAT, GLboolean bNormalized = GL_FALSE);
     GLuint genIndicesBuffer( GLuint iVertArray,
                              const void* pData, GLsizeiptr pSize, GLenum usage );
     GLuint genInstanceBuffer(GLuint iVertArray, GLuint iStartIndex, const void* pData, GLsizeiptr pSize, GLenum usage);
+    void setInstanceAttribs(GLuint iVertArray, GLuint iStartIndex, GLuint iInstanceBuffer, GLintptr iOffset);
 
     // Shader Uniform Variable Manipulation
-    void setUnifromMatrix4x4( eShaderType eType, string sVarName, const mat4* pResultingMatrix );
-    void setUniformVec3( eShaderType eType, string sVarName, const glm::vec3* pValue );
-    void setUniformVec4( eShaderType eType, string sVarName, const vec4* pValue );
-    void setUniformFloat(eShaderType eType, string sVarName, float fVal);
-    void setUniformInt( eShaderType eType, string sVarName, int iVal, unsigned int iIndex = 0);
-    void setUniformIntAll(string sVarName, int iVal, unsigned int iIndex = 0);
-    void setUniformBool( eShaderType eType, string sVarName, bool bVal );
-    void toggleUniformBool( eShaderType eType, string sVarName );
+    void setUnifromMatrix4x4( eShaderType eType, const string& sVarName, const mat4* pResultingMatrix );
+    void setUniformVec3( eShaderType eType, const string& sVarName, const glm::vec3* pValue );
+    void setUniformVec4( eShaderType eType, const string& sVarName, const vec4* pValue );
+    void setUniformFloat(eShaderType eType, const string& sVarName, float fVal);
+    void setUniformInt( eShaderType eType, const string& sVarName, int iVal, unsigned int iIndex = 0);
+    void setUniformIntAll(const string& sVarName, int iVal, unsigned int iIndex = 0);
+    void setUniformBool( eShaderType eType, const string& sVarName, bool bVal );
+    void toggleUniformBool( eShaderType eType, const string& sVarName );
+
+    // Same as above for the uniforms with a handle; no lookup at all.
+    void setUniformVec3(eShaderType eType, eUniform eVar, const vec3* pValue);
+    void setUniformVec4(eShaderType eType, eUniform eVar, const vec4* pValue);
+    void setUniformFloat(eShaderType eType, eUniform eVar, float fVal);
+    void setUniformInt(eShaderType eType, eUniform eVar, int iVal, unsigned int iIndex = 0);
+    void setUniformBool(eShaderType eType, eUniform eVar, bool bVal);
+
+    // The uniform cache can be disabled from the command line to measure the cost of looking
+    //  up every uniform and switching programs to set it, as before.
+    static void setUniformCacheEnabled(bool bEnabled) { m_bUniformCacheEnabled = bEnabled; }
+    static bool useUniformCache() { return m_bUniformCacheEnabled; }
 
 private:
     // Singleton Implementation
@@ -74,7 +123,19 @@ private:
     ShaderManager( const ShaderManager* pCopy );
     static ShaderManager* m_pInstance;
 
-    GLuint m_iMatricesBuffer, m_iLightsBuffer;
+    // Location of a uniform, from the cache or from the driver if the cache is disabled.
+    GLint getUniformLocation(eShaderType eType, const string& sVarName);
+    GLint getUniformLocation(eShaderType eType, eUniform eVar);
+
+    // Calls fnWrite(iProgram, iLocation) to set a uniform of a shader if it exists.
+    template <class WriteFunction>
+    void writeUniform(eShaderType eType, GLint iLocation, WriteFunction fnWrite);
+
+    GLuint m_iMatricesBuffer, m_iLightsBuffer, m_iViewsBuffer;
+    GLint m_pUniformLocations[MAX_SHDRS][MAX_UNIFORMS];
+    vector<unsigned char> m_pLightBlock;    // Contents of the Lights Buffer, to skip uploads that change nothing
+    LightClusters m_sLightClusters;
+    static bool m_bUniformCacheEnabled;
 
     // Should only be initialized once.
     bool m_bInitialized;
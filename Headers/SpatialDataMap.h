@@ -35,9 +35,14 @@ public:
     bool isInitialized() { return m_bIsInitialized; }
     vector<vec2> aStarSearch(vec2 player, vec2 dest);
     bool getMapIndices(const Entity* vEntity, unsigned int* iXMin, unsigned int* iXMax, unsigned int* iYMin, unsigned int* iYMax); // Returns the Map Indices from a given Entity.
+
+    // Potentially Visible Set, baked when the Static Map is populated: the cell a camera sees from (-1 if
+    //  it can't be culled) and whether a bounding sphere (center, radius) may be seen from it.
+    int getVisibilityCell(const vec3* vViewPosition) const;
+    bool isPotentiallyVisible(int iViewCell, const vec4* vBoundingSphere) const;
     float getTileSize() const {return m_fTileSize;}
     glm::vec2 getWorldOffset() { return m_vOriginPos; }
-    vector<uvec2> getShortestPath(uvec2 playerMin, uvec2 playerMax, uvec2 destMin, uvec2 destMax);
+    void getShortestPath(uvec2 playerMin, uvec2 playerMax, uvec2 destMin, uvec2 destMax, vector<uvec2>* pReturnPath);
 private:
     float evaluateDistance(const vec2* pos1, const vec2* pos2) const;
     static SpatialDataMap* m_pInstance;
@@ -85,6 +90,12 @@ private:
     void getVectToPos(const vec3* vWorldPosition, vec2* vToPos);
     void computeNewDynamicPosition(const Entity* vEntity, const vec3* vNewPos);
     void addSquareIndices(vector<unsigned int>* pIndicesBuffer, unsigned int iXIndex, unsigned int iYIndex);
+    void computeVisibility();
+    bool traceVisibility(const vec2* vStart, const vec2* vEnd, const vector<bool>* pOccluders) const;
+
+    // Whether each pair of cells can see each other: row (x * m_iMaxY + y) holds what's visible from cell (x, y).
+    vector<bool> m_pVisibleCells;
+    bool m_bVisibilityBaked;
     bool getNearestCar(int currID, vector<int> IDs, vec2 &minPos);
 #ifdef _DEBUG
     // data for debug rendering
@@ -34,9 +34,10 @@ public:
     void setTexParameter(GLenum eTexEnum, GLint iParam);
     void setTexParameterfv(GLenum eTexEnum, const GLfloat* pParams);
     void genMipMaps();
-    void bindTexture( ShaderManager::eShaderType eType, string sVarName, unsigned int iIndex = 0 );  // Binds Texture to Specified Shader
-    void bindTextureAsCubeMap(ShaderManager::eShaderType eType, string sVarName);
-    void bindTextureAllShaders(string sVarName, unsigned int iIndex = 0);                                      // Binds Texture to all Shaders
+    void bindTexture( ShaderManager::eShaderType eType, const string& sVarName, unsigned int iIndex = 0 );  // Binds Texture to Specified Shader
+    void bindTexture( ShaderManager::eShaderType eType, ShaderManager::eUniform eVar, unsigned int iIndex = 0 );
+    void bindTextureAsCubeMap(ShaderManager::eShaderType eType, const string& sVarName);
+    void bindTextureAllShaders(const string& sVarName, unsigned int iIndex = 0);                                      // Binds Texture to all Shaders
     void bindToFrameBuffer(GLuint iFrameBuffer, GLenum eAttachment, GLenum eTexTarget, GLint iLevel);
     void unbindTexture();
 
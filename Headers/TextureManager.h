@@ -42,7 +42,7 @@ public:
     unordered_map<UserInterface::eImage, Texture*> loadTextures(const unordered_map<UserInterface::eImage, string> &mFiles, const string &sDirectory);
     Texture* loadCubeMap(const vector<string>* sFileNames);
     Texture* genTexture(const vec4* vColor);
-    Texture* genDepthBuffer(unsigned int iWidth, unsigned int iHeight);
+    Texture* genDepthBuffer(unsigned int iWidth, unsigned int iHeight, const string& sName = "DepthBuffer");  // Depth Buffers of the same size and name are shared
     Texture* genFrameBufferTexture(unsigned int iWidth, unsigned int iHeight, unsigned int iPlayer, unsigned int iBufferNum);
     void unloadTexture(Texture** pTexture);
     void unloadAllTextures();
@@ -170,6 +170,18 @@ namespace FuncUtils
     */
     int random(int range);
 
+    /*
+        Get the generator used by random() so its state can be saved.
+        @return the random number generator
+    */
+    const std::mt19937& getRandomGenerator();
+
+    /*
+        Restore the state of the generator used by random().
+        @param generator    state to restore
+    */
+    void setRandomGenerator(const std::mt19937& generator);
+
     /*
         Convert a float to string, given a specified number of decimal places.
 
@@ -0,0 +1,65 @@
+#pragma once
+
+/* INCLUDES */
+#include <vector>
+#include <glm/glm.hpp>
+
+/*
+    Mesh processing run when a mesh is cooked, to make indexed triangle lists
+    cheaper to draw:
+        - Triangles are reordered so consecutive triangles share vertices that
+          are still in the post-transform cache (Forsyth's algorithm).
+        - Vertices are reordered in the order they are first referenced, so
+          vertex fetches walk the vertex buffer linearly.
+        - Normals and UVs can be packed as 10:10:10:2 snorm and half floats.
+        - Lower detail levels can be generated by quadric error simplification.
+
+    ACMR (average cache miss ratio) is the number of vertex shader invocations
+    per triangle for a FIFO cache: 3.0 is the worst case, 0.5 the ideal for a
+    regular grid.
+*/
+using namespace std;
+using namespace glm;
+namespace MeshOptimizer
+{
+    // Reorder the triangles of an indexed triangle list for the post-transform cache.
+    void optimizeVertexCache(vector<unsigned int>* pIndices, unsigned int iVertexCount);
+
+    /*
+        Renumber the vertices in the order the indices first reference them.
+        pNewOrder receives the old index of each new vertex; vertices that
+        aren't referenced are dropped.
+    */
+    void optimizeVertexFetch(vector<unsigned int>* pIndices, unsigned int iVertexCount, vector<unsigned int>* pNewOrder);
+
+    /*
+        Simplify an indexed triangle list to about iTargetIndexCount indices
+        by collapsing edges onto their neighbours in order of quadric error.
+        The result indexes the same vertices as pIndices, so it can share
+        their vertex buffer.
+            pPositions          positions of the mesh, shared by vertices with
+                                different normals or uvs
+            pVertexPositions    index into pPositions of each vertex
+            pVertexData         interleaved vertex data, iVertexStride floats
+                                per vertex, the position first. Used to pick the
+                                vertex with the closest attributes when a corner
+                                is moved to another position.
+            fMaxError           largest error allowed for a collapse, relative
+                                to the size of the mesh
+            pOutput             receives the simplified triangle list
+        Borders and non-manifold edges are kept in place.
+    */
+    void simplify(const vector<unsigned int>& pIndices, const vector<vec3>& pPositions,
+                  const vector<unsigned int>& pVertexPositions, const float* pVertexData, unsigned int iVertexStride,
+                  unsigned int iTargetIndexCount, float fMaxError, vector<unsigned int>* pOutput);
+
+    // Average number of cache misses per triangle for a FIFO cache of iCacheSize vertices.
+    float computeACMR(const vector<unsigned int>& pIndices, unsigned int iVertexCount, unsigned int iCacheSize);
+
+    /*
+        Pack interleaved position[, normal][, uv] floats (as built by ObjParser)
+        as float positions, GL_INT_2_10_10_10_REV normals and GL_HALF_FLOAT uvs.
+    */
+    void quantizeVertices(const float* pVertexData, unsigned int iVertexCount, bool bNormals, bool bUVs, vector<unsigned char>* pOutput);
+    unsigned int getQuantizedStride(bool bNormals, bool bUVs);
+}
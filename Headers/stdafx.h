@@ -51,6 +51,7 @@
 
 // Custom Data Structures
 #include "DataStructures/Bag.h"
+#include "DataStructures/FrameArena.h"
 
 // Function Utilities
 #include "Utils/FuncUtils.h"
@@ -86,6 +87,9 @@ using namespace physx;
 #define MIN_BOT_COUNT       0
 #define MAX_BOT_COUNT       4
 #define MAX_HOVERCRAFT_COUNT MAX_PLAYER_COUNT + MAX_BOT_COUNT
+#define SHADOW_VIEW         MAX_PLAYER_COUNT        // Views culled separately: one per player, the shadow pass
+#define MULTI_VIEW          (MAX_PLAYER_COUNT + 1)  //  and every player at once when the screens are drawn together
+#define MAX_VIEW_COUNT      (MAX_PLAYER_COUNT + 2)
 #define XBOX_CONTROLLER     "Xbox"
 #define EMPTY_CONTROLLER    "Empty Controller"
 
@@ -113,6 +117,7 @@ using namespace physx;
 #define AXIS_RIGHT_STICK_Y       3
 #define AXIS_LEFT_TRIGGER        4
 #define AXIS_RIGHT_TRIGGER       5
+#define MAX_AXES_COUNT           6
 
 #define PS4_MASK                 0x80000000
 #define PS4_BUTTON_X             1
@@ -171,12 +176,15 @@ const std::unordered_map<string, eBoundingBoxTypes> BOUNDING_BOX_MAP =
 };
 
 /* Manager Defines */
+#define ASSET_PRELOADER     AssetPreloader::getInstance()
 #define MENU_MANAGER        MenuManager::getInstance()
 #define EMITTER_ENGINE      EmitterEngine::getInstance()
 #define ENTITY_MANAGER      EntityManager::getInstance()
+#define FRAME_ARENA         FrameArena::getInstance()
 #define GAME_MANAGER        GameManager::getInstance()
 #define GAME_STATS          GameStats::getInstance()
 #define INPUT_HANDLER       InputHandler::getInstance()
+#define INPUT_RECORDER      InputRecorder::getInstance()
 #define MESH_MANAGER        MeshManager::getInstance()
 #define PHYSICS_MANAGER     PhysicsManager::getInstance()
 #define SCENE_LOADER        SceneLoader::getInstance()
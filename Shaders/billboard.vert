@@ -11,10 +11,18 @@ layout (std140, binding = 0) uniform Matrices
 layout (location = 0) in vec3 vertex;
 layout (location = 1) in vec3 normal;
 layout (location = 2) in vec3 color;
-layout (location = 3) in vec2 uvStart;
-layout (location = 4) in vec2 uvEnd;
-layout (location = 5) in vec2 Dimensions;
-layout (location = 6) in float Duration;
+layout (location = 3) in vec2 Dimensions;
+layout (location = 4) in vec2 SpriteCounts;
+layout (location = 5) in vec2 UVBorder;
+layout (location = 6) in float StartFrame;
+layout (location = 7) in float SpawnTime;
+layout (location = 8) in float Duration;
+
+// Time of the Billboard's Mesh, in the same clock as SpawnTime
+uniform float fTime;
+
+// Sprites are animated at 60 frames per second
+const float FRAME_TIME = 1.0 / 60.0;
 
 out vec3 vNormal;
 out vec3 vTinge;
@@ -39,13 +47,19 @@ void main(void)
 	// Send Tinge Color to mod image
 	vTinge = color;
 	
-	// Send Duration to the geometry shader.
-	fDuration = Duration;
+	// Send the remaining Duration to the geometry shader.
+	float fAge = fTime - SpawnTime;
+	fDuration = Duration - fAge;
 	
 	// Pass Dimensions to Geometry Shader
 	vDimensions = Dimensions;
-	vUVStart = uvStart;
-	vUVEnd = uvEnd;
+	
+	// Step through the sprite sheet from the starting sprite, across then down, wrapping at the end.
+	float fFrame = mod(StartFrame + floor(fAge / FRAME_TIME), SpriteCounts.x * SpriteCounts.y);
+	vec2 vSprite = vec2(mod(fFrame, SpriteCounts.x), floor(fFrame / SpriteCounts.x));
+	vec2 vSpriteSize = 1.0 / SpriteCounts;
+	vUVStart = (vSprite * vSpriteSize) + UVBorder;
+	vUVEnd = ((vSprite + 1.0) * vSpriteSize) - UVBorder;
 	
 	// Pass Fragment Position.
     gl_Position = vec4( vertex, 1.0 );
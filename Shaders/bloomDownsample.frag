@@ -0,0 +1,31 @@
+// Downsample of the bloom mip chain: each texel is a weighted average of five overlapping
+//	2x2 boxes of the level above (13 bilinear taps), which keeps bright specks from flickering
+//	as they move. From "Next Generation Post Processing in Call of Duty: Advanced Warfare".
+
+uniform sampler2D mTexture;
+
+void main(void)
+{
+	vec2 vTexel = 1.0 / textureSize(mTexture, 0); // size of a texel of the level above
+
+	vec3 a = texture(mTexture, TexCoords + vTexel * vec2(-2.0,  2.0)).rgb;
+	vec3 b = texture(mTexture, TexCoords + vTexel * vec2( 0.0,  2.0)).rgb;
+	vec3 c = texture(mTexture, TexCoords + vTexel * vec2( 2.0,  2.0)).rgb;
+	vec3 d = texture(mTexture, TexCoords + vTexel * vec2(-2.0,  0.0)).rgb;
+	vec3 e = texture(mTexture, TexCoords).rgb;
+	vec3 f = texture(mTexture, TexCoords + vTexel * vec2( 2.0,  0.0)).rgb;
+	vec3 g = texture(mTexture, TexCoords + vTexel * vec2(-2.0, -2.0)).rgb;
+	vec3 h = texture(mTexture, TexCoords + vTexel * vec2( 0.0, -2.0)).rgb;
+	vec3 i = texture(mTexture, TexCoords + vTexel * vec2( 2.0, -2.0)).rgb;
+	vec3 j = texture(mTexture, TexCoords + vTexel * vec2(-1.0,  1.0)).rgb;
+	vec3 k = texture(mTexture, TexCoords + vTexel * vec2( 1.0,  1.0)).rgb;
+	vec3 l = texture(mTexture, TexCoords + vTexel * vec2(-1.0, -1.0)).rgb;
+	vec3 m = texture(mTexture, TexCoords + vTexel * vec2( 1.0, -1.0)).rgb;
+
+	// The centre box counts for half, the four corner boxes for an eighth each.
+	vec3 vResult = (j + k + l + m) * 0.125;
+	vResult += (a + c + g + i) * 0.03125;
+	vResult += (b + d + f + h) * 0.0625;
+	vResult += e * 0.125;
+	vFragColor = vec4(vResult, 1.0);
+}
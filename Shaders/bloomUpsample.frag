@@ -0,0 +1,20 @@
+// Upsample of the bloom mip chain: a 3x3 tent filter over the smaller level, blended into
+//	the level below it by the caller so every level of the chain adds to the glow.
+
+uniform sampler2D mTexture;
+
+void main(void)
+{
+	vec2 vTexel = 1.0 / textureSize(mTexture, 0); // size of a texel of the level sampled
+
+	vec3 vResult = texture(mTexture, TexCoords).rgb * 4.0;
+	vResult += texture(mTexture, TexCoords + vTexel * vec2( 0.0,  1.0)).rgb * 2.0;
+	vResult += texture(mTexture, TexCoords + vTexel * vec2(-1.0,  0.0)).rgb * 2.0;
+	vResult += texture(mTexture, TexCoords + vTexel * vec2( 1.0,  0.0)).rgb * 2.0;
+	vResult += texture(mTexture, TexCoords + vTexel * vec2( 0.0, -1.0)).rgb * 2.0;
+	vResult += texture(mTexture, TexCoords + vTexel * vec2(-1.0,  1.0)).rgb;
+	vResult += texture(mTexture, TexCoords + vTexel * vec2( 1.0,  1.0)).rgb;
+	vResult += texture(mTexture, TexCoords + vTexel * vec2(-1.0, -1.0)).rgb;
+	vResult += texture(mTexture, TexCoords + vTexel * vec2( 1.0, -1.0)).rgb;
+	vFragColor = vec4(vResult / 16.0, 1.0);
+}
@@ -19,15 +19,22 @@ out vec2 TexCoords;
 
 void main(void)
 {
+	// View of the Instance, see the Views block
+	int iView = gl_InstanceID % iViewCount;
+	mat4 m4ModelView = pViewModelviews[iView];
+
 	vec3 vPositionModelSpace = (translation * vec4( vertex, 1.0 )).xyz;
-	vec4 vPositionCameraSpace = modelview * vec4(vPositionModelSpace, 1.0);
+	vec4 vPositionCameraSpace = m4ModelView * vec4(vPositionModelSpace, 1.0);
 	vec3 P = vPositionCameraSpace.xyz/vPositionCameraSpace.w;
 	
 	TexCoords = uv;
 	
 	// Normal Matrix to correct Normal in camera space
-	mat3 m3NormalMatrix = transpose( inverse( mat3( modelview ) ) );
+	mat3 m3NormalMatrix = transpose( inverse( mat3( m4ModelView ) ) );
 	vNormalInCameraSpace = normalize( m3NormalMatrix * normal );
 	V = normalize( -P );
-    gl_Position = projection * vPositionCameraSpace;
+    gl_Position = pViewProjections[iView] * vPositionCameraSpace;
+#if defined(GL_ARB_shader_viewport_layer_array) || defined(GL_AMD_vertex_shader_layer)
+	gl_Layer = iView;
+#endif
 }
@@ -20,13 +20,8 @@ void main(void)
 	if( usingDirectionalLight )
 		vColorLinear += CalcDirLight( pDirectionalLight, fs_in.NormalVector, fs_in.ToCamera, fs_in.FragPosDirLightSpace );
 		
-	// add Point Light contributions
-	for( int i = 0; i < numPointLights; i++ )
-		vColorLinear += CalcPointLight( pPointLights[i], fs_in.NormalVector, fs_in.vFragPosition, fs_in.ToCamera );
-	
-	// add Spot Light contributions
-	for( int i = 0; i < numSpotLights; i++ )
-		vColorLinear += CalcSpotLight( pSpotLights[i], fs_in.NormalVector, fs_in.vFragPosition, fs_in.ToCamera );
+	// add Point and Spot Light contributions of the fragment's cluster
+	vColorLinear += CalcClusterLights( fs_in.NormalVector, fs_in.vFragPosition, fs_in.ToCamera );
 	
 	// Calculate the final vFragColor of the fragment
     vFragColor = vec4(vColorLinear, 1.0);
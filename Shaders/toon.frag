@@ -13,10 +13,13 @@ uniform sampler2D gSampler;
 void main(void)
 {
 	vec2 UV;
-	vec3 vLightPos = usingDirectionalLight ? -pDirectionalLight.vDirection : pPointLights[0].vPosition;
-	vec4 lightCameraSpace = modelview * vec4(vLightPos, 1.0);
+	vec4 lightCameraSpace = pViewModelviews[gl_Layer] * vec4(-pDirectionalLight.vDirection, 1.0);
 	lightCameraSpace /= lightCameraSpace.w;
 
+	// Without a Directional Light, use the first Point Light of the view; it's already in camera space.
+	if( !usingDirectionalLight )
+		lightCameraSpace = vec4(texelFetch(LightData, getClusterView() * (numPointLights * 2 + numSpotLights * 3)).xyz, 1.0);
+
 	vec3 ToLightVector = normalize(lightCameraSpace.xyz - vFragPos);
 	
 	// Calculate UVs for Orientation-Based Texture Mapping
@@ -20,15 +20,22 @@ out vec3 vFragPos;
 
 void main(void)
 {
+	// View of the Instance, see the Views block
+	int iView = gl_InstanceID % iViewCount;
+	mat4 m4ModelView = pViewModelviews[iView];
+
 	vec3 positionModelSpace = ( translate * vec4(vertex, 1.0) ).xyz;
-    vec4 positionCameraSpace = modelview * vec4(positionModelSpace, 1.0);
+    vec4 positionCameraSpace = m4ModelView * vec4(positionModelSpace, 1.0);
 	vFragPos = positionCameraSpace.xyz/positionCameraSpace.w;
 	
 	// create the Normal Matrix to correct Normal into camera space
-	mat3 normalMatrix = transpose(inverse(mat3(modelview)));
+	mat3 normalMatrix = transpose(inverse(mat3(m4ModelView)));
 	NormalVector = normalize( normalMatrix * normal );
 	
 	ToCameraVector = normalize( - vFragPos);
 	
-    gl_Position = projection * positionCameraSpace;    
+    gl_Position = pViewProjections[iView] * positionCameraSpace;
+#if defined(GL_ARB_shader_viewport_layer_array) || defined(GL_AMD_vertex_shader_layer)
+	gl_Layer = iView;
+#endif
 }
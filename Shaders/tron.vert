@@ -27,12 +27,16 @@ out vec2 TexCoords;
 
 void main(void)
 {
+	// View of the Instance, see the Views block
+	int iView = gl_InstanceID % iViewCount;
+	mat4 m4ModelView = pViewModelviews[iView];
+
 	vec3 positionModelSpace = ( translate * vec4(vertex, 1.0) ).xyz;
-    vec4 positionCameraSpace = modelview * vec4(positionModelSpace, 1.0);
+    vec4 positionCameraSpace = m4ModelView * vec4(positionModelSpace, 1.0);
 	vec3 P = positionCameraSpace.xyz/positionCameraSpace.w;
 	
 	// create the Normal Matrix to correct Normal into camera space
-	mat3 normalMatrix = transpose(inverse(mat3(modelview)));
+	mat3 normalMatrix = transpose(inverse(mat3(m4ModelView)));
 	vs_out.NormalVector = normalize( normalMatrix * normal );
 	
 	vs_out.ToCamera = normalize( - P);
@@ -44,10 +48,13 @@ void main(void)
 		vs_out.FragPosDirLightSpace = dirLightSpaceMat * vec4(positionModelSpace, 1.0);
 	
 	// Calculate the Spot Light Fragment for Shadows
-	for( int i = 0; i < numSpotLights; ++i )
+	for( int i = 0; i < min(numSpotLights, 4); ++i )
 		vs_out.FragPosSpotLightSpace[i] = spotLightSpaceMat[i] * vec4(positionModelSpace, 1.0);
 	
 	TexCoords = uv;
 	
-    gl_Position = projection * positionCameraSpace;    
+    gl_Position = pViewProjections[iView] * positionCameraSpace;
+#if defined(GL_ARB_shader_viewport_layer_array) || defined(GL_AMD_vertex_shader_layer)
+	gl_Layer = iView;
+#endif
 }
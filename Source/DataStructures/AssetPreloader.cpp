@@ -0,0 +1,284 @@
+#include "DataStructures/AssetPreloader.h"
+#include "stb_image.h"
+#include <cfloat>
+#include <chrono>
+#include <sstream>
+#include <unordered_set>
+
+/***********\
+ * Defines *
+\***********/
+#define MAX_WORKER_THREADS      8
+// Loads of the scene per mode in the benchmark; the fastest one is reported.
+#define BENCHMARK_ITERATIONS    3
+
+// Extensions of the files that are preloaded
+const string MESH_EXTENSION = ".obj";
+const string IMAGE_EXTENSIONS[] = { ".png", ".jpg", ".jpeg", ".tga", ".bmp" };
+
+// Static Variables
+AssetPreloader* AssetPreloader::m_pInstance = nullptr;
+bool AssetPreloader::m_bParallelLoadingEnabled = true;
+
+static bool endsWith(const string& sString, const string& sSuffix)
+{
+    return sString.size() >= sSuffix.size() &&
+           0 == sString.compare(sString.size() - sSuffix.size(), sSuffix.size(), sSuffix);
+}
+
+// Leave a core for the main thread, it runs the jobs it needs before the workers get to them.
+static unsigned int getWorkerCount()
+{
+    return std::min(std::max(thread::hardware_concurrency(), 1u) - 1, static_cast<unsigned int>(MAX_WORKER_THREADS));
+}
+
+static bool isImageFile(const string& sFileName)
+{
+    for (const string& sExtension : IMAGE_EXTENSIONS)
+    {
+        if (endsWith(sFileName, sExtension))
+            return true;
+    }
+    return false;
+}
+
+AssetPreloader* AssetPreloader::getInstance()
+{
+    if (nullptr == m_pInstance)
+        m_pInstance = new AssetPreloader();
+    return m_pInstance;
+}
+
+// Default Constructor
+AssetPreloader::AssetPreloader()
+{
+    m_iNextJob = 0;
+}
+
+// Destructor: waits for the workers and frees anything that wasn't taken.
+AssetPreloader::~AssetPreloader()
+{
+    finishScene();
+    clear();
+    m_pInstance = nullptr;
+}
+
+/*
+    Collect the mesh and image paths referenced by a scene file, in order and
+    without duplicates. Any token with a known extension is a path; commented
+    lines are skipped.
+*/
+void AssetPreloader::collectSceneAssets(const string& sSceneFile, vector<string>* pFiles)
+{
+    ifstream pSceneFile(sSceneFile);
+    unordered_set<string> pSeen;
+    string sLine, sToken;
+
+    pFiles->clear();
+    while (getline(pSceneFile, sLine))
+    {
+        size_t iStart = sLine.find_first_not_of(" \t\r");
+        if (string::npos == iStart || '#' == sLine[iStart])
+            continue;
+
+        istringstream sStream(sLine);
+        while (sStream >> sToken)
+        {
+            if ((endsWith(sToken, MESH_EXTENSION) || isImageFile(sToken)) && pSeen.insert(sToken).second)
+                pFiles->push_back(sToken);
+        }
+    }
+}
+
+// Load the file of a job. Runs on the worker threads and the main thread.
+void AssetPreloader::runJob(sJob* pJob)
+{
+    if (pJob->bMesh)
+    {
+        pJob->pMesh = make_unique<CookedMesh>();
+        if (!pJob->pMesh->open(pJob->sFileName))
+        {
+            ObjParser pParser;
+            if (pParser.parse(pJob->sFileName))
+                pJob->pMesh->cook(&pParser, pJob->sFileName);
+            else
+                pJob->pMesh.reset();
+        }
+    }
+    else
+    {
+        sImage& sLoadedImage = pJob->sLoadedImage;
+        sLoadedImage.pPixels = stbi_load(pJob->sFileName.c_str(), &sLoadedImage.iWidth, &sLoadedImage.iHeight,
+                                         &sLoadedImage.iComponents, 0);
+    }
+}
+
+/*
+    Start loading a scene's assets on the worker threads. Results of the
+    previous scene that were never taken are dropped.
+
+    @param sSceneFile   scene about to be loaded by the SceneLoader
+*/
+void AssetPreloader::preloadScene(const string& sSceneFile)
+{
+    vector<string> pFiles;
+
+    finishScene();
+    clear();
+    if (!m_bParallelLoadingEnabled)
+        return;
+
+    collectSceneAssets(sSceneFile, &pFiles);
+    startJobs(pFiles);
+}
+
+void AssetPreloader::startJobs(const vector<string>& pFiles)
+{
+    for (const string& sFile : pFiles)
+    {
+        unique_ptr<sJob> pJob = make_unique<sJob>();
+        pJob->bMesh = endsWith(sFile, MESH_EXTENSION);
+        pJob->sFileName = sFile;
+        pJob->iState = JOB_PENDING;
+        pJob->sLoadedImage.pPixels = nullptr;
+        m_pUntakenJobs[sFile] = pJob.get();
+        m_pJobs.push_back(move(pJob));
+    }
+
+    unsigned int iThreadCount = std::min(getWorkerCount(), static_cast<unsigned int>(m_pJobs.size()));
+    m_iNextJob = 0;
+    for (unsigned int i = 0; i < iThreadCount; ++i)
+        m_pWorkers.emplace_back(&AssetPreloader::workerLoop, this);
+}
+
+// Run the jobs in order until there are none left.
+void AssetPreloader::workerLoop()
+{
+    unsigned int iJob;
+    while ((iJob = m_iNextJob++) < m_pJobs.size())
+    {
+        sJob* pJob = m_pJobs[iJob].get();
+        int iExpected = JOB_PENDING;
+        if (pJob->iState.compare_exchange_strong(iExpected, JOB_RUNNING))
+        {
+            runJob(pJob);
+            {
+                lock_guard<mutex> pLock(m_pJobMutex);
+                pJob->iState = JOB_DONE;
+            }
+            m_pJobFinished.notify_all();
+        }
+    }
+}
+
+// Wait for the workers; afterwards every job is done.
+void AssetPreloader::finishScene()
+{
+    for (thread& pWorker : m_pWorkers)
+        pWorker.join();
+    m_pWorkers.clear();
+}
+
+// Frees the results that weren't taken.
+void AssetPreloader::clear()
+{
+    for (unique_ptr<sJob>& pJob : m_pJobs)
+        stbi_image_free(pJob->sLoadedImage.pPixels);
+    m_pJobs.clear();
+    m_pUntakenJobs.clear();
+}
+
+/*
+    Find the job of a file and make sure it's done: run it here if no worker
+    has started it yet, otherwise wait for the worker.
+
+    @return nullptr if the file wasn't preloaded or was already taken
+*/
+AssetPreloader::sJob* AssetPreloader::claimResult(const string& sFileName)
+{
+    unordered_map<string, sJob*>::iterator pIter = m_pUntakenJobs.find(sFileName);
+    if (m_pUntakenJobs.end() == pIter)
+        return nullptr;
+
+    sJob* pJob = pIter->second;
+    int iExpected = JOB_PENDING;
+    m_pUntakenJobs.erase(pIter);
+    if (pJob->iState.compare_exchange_strong(iExpected, JOB_RUNNING))
+    {
+        runJob(pJob);
+        pJob->iState = JOB_DONE;
+    }
+    else
+    {
+        unique_lock<mutex> pLock(m_pJobMutex);
+        m_pJobFinished.wait(pLock, [pJob] { return JOB_DONE == pJob->iState; });
+    }
+
+    return pJob;
+}
+
+bool AssetPreloader::takeMesh(const string& sFileName, unique_ptr<CookedMesh>* pMesh)
+{
+    sJob* pJob = claimResult(sFileName);
+    if (nullptr == pJob || !pJob->bMesh)
+        return false;
+
+    *pMesh = move(pJob->pMesh);
+    return true;
+}
+
+bool AssetPreloader::takeImage(const string& sFileName, sImage* pImage)
+{
+    sJob* pJob = claimResult(sFileName);
+    if (nullptr == pJob || pJob->bMesh)
+        return false;
+
+    *pImage = pJob->sLoadedImage;
+    pJob->sLoadedImage.pPixels = nullptr;
+    return true;
+}
+
+/*
+    Print the time it takes to load every asset of a scene on the main thread
+    alone and on the workers. GL uploads aren't included, they stay on the main
+    thread either way.
+
+    @param sSceneFile   scene to load the assets of, e.g. "Scenes/release.scene"
+*/
+void AssetPreloader::runBenchmark(const string& sSceneFile)
+{
+    typedef chrono::high_resolution_clock clock;
+    AssetPreloader* pPreloader = getInstance();
+    vector<string> pFiles;
+    double fSerialTime = DBL_MAX, fParallelTime = DBL_MAX;
+
+    collectSceneAssets(sSceneFile, &pFiles);
+    for (unsigned int i = 0; i < BENCHMARK_ITERATIONS; ++i)
+    {
+        // Serial: every job on this thread
+        clock::time_point pStart = clock::now();
+        for (const string& sFile : pFiles)
+        {
+            sJob sSerialJob;
+            sSerialJob.bMesh = endsWith(sFile, MESH_EXTENSION);
+            sSerialJob.sFileName = sFile;
+            sSerialJob.sLoadedImage.pPixels = nullptr;
+            runJob(&sSerialJob);
+            stbi_image_free(sSerialJob.sLoadedImage.pPixels);
+        }
+        fSerialTime = std::min(fSerialTime, chrono::duration<double, milli>(clock::now() - pStart).count());
+
+        // Parallel: taken in order, as the SceneLoader would
+        pStart = clock::now();
+        pPreloader->startJobs(pFiles);
+        for (const string& sFile : pFiles)
+            pPreloader->claimResult(sFile);
+        pPreloader->finishScene();
+        fParallelTime = std::min(fParallelTime, chrono::duration<double, milli>(clock::now() - pStart).count());
+        pPreloader->clear();
+    }
+
+    cout << sSceneFile << ": " << pFiles.size() << " meshes and images" << endl
+         << "Serial:   " << fSerialTime << " ms" << endl
+         << "Parallel: " << fParallelTime << " ms (" << getWorkerCount() << " workers and the main thread)" << endl;
+}
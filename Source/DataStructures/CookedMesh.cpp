@@ -0,0 +1,354 @@
+#include "DataStructures/CookedMesh.h"
+#include "Utils/MeshOptimizer.h"
+#include <chrono>
+#include <numeric>
+#include <sys/stat.h>
+
+/***********\
+ * Defines *
+\***********/
+#define COOKED_MESH_MAGIC       0x4D435648  // "HVCM" in little endian
+// Increment whenever the layout or the ObjParser output changes.
+#define COOKED_MESH_VERSION     3
+#define COOKED_EXTENSION        ".cooked"
+// Loads per file in the benchmark; the fastest one is reported.
+#define BENCHMARK_ITERATIONS    5
+
+// Header Flags
+#define COOKED_NORMALS          0x1
+#define COOKED_UVS              0x2
+#define COOKED_MATERIAL         0x4
+#define COOKED_QUANTIZED        0x8
+
+// Static Variables
+bool CookedMesh::m_bQuantizationEnabled = true;
+
+/*
+    Size and modification time of a file.
+
+    @return false if the file doesn't exist
+*/
+static bool getFileInfo(const string& sFileName, unsigned long long* iSize, long long* iTimestamp)
+{
+    struct stat sFileStats;
+    if (0 != stat(sFileName.c_str(), &sFileStats))
+        return false;
+
+    *iSize = static_cast<unsigned long long>(sFileStats.st_size);
+    *iTimestamp = static_cast<long long>(sFileStats.st_mtime);
+    return true;
+}
+
+// 64-bit FNV-1a hash of the contents of a file.
+static unsigned long long hashFile(const string& sFileName)
+{
+    MappedFile pFile;
+    unsigned long long iHash = 14695981039346656037ull;
+    if (pFile.open(sFileName))
+    {
+        for (size_t i = 0; i < pFile.getSize(); ++i)
+            iHash = (iHash ^ static_cast<unsigned char>(pFile.getData()[i])) * 1099511628211ull;
+    }
+    return iHash;
+}
+
+template <class T>
+static void appendBlob(vector<unsigned char>* pData, const T* pValues, size_t iCount)
+{
+    const unsigned char* pBytes = reinterpret_cast<const unsigned char*>(pValues);
+    pData->insert(pData->end(), pBytes, pBytes + (sizeof(T) * iCount));
+}
+
+// Default Constructor
+CookedMesh::CookedMesh()
+{
+    m_pData = nullptr;
+    m_iSize = 0;
+    m_pHeader = nullptr;
+}
+
+string CookedMesh::getCookedFileName(const string& sSourceFile)
+{
+    return sSourceFile + COOKED_EXTENSION;
+}
+
+/*
+    Map the cooked file of a source .obj file.
+
+    @param sSourceFile  .obj file the mesh was cooked from
+    @return true if the cooked file exists and is up to date
+*/
+bool CookedMesh::open(const string& sSourceFile)
+{
+    string sCookedFile = getCookedFileName(sSourceFile);
+    struct stat sFileStats;
+    long long iSourceTimestamp;
+    bool bReturnValue;
+
+    // Quietly check for the cooked file first, it doesn't exist on the first launch.
+    if (0 != stat(sCookedFile.c_str(), &sFileStats) || !mapFile(sCookedFile))
+        return false;
+
+    bReturnValue = validate(sSourceFile, &iSourceTimestamp);
+
+    // The source only matched by its hash: store its new time so the next launches are back to
+    //  comparing times. The mapping locks the file on Windows, so it's closed for the write.
+    if (bReturnValue && iSourceTimestamp != m_pHeader->iSourceTimestamp)
+    {
+        m_pFile.close();
+        fstream pFile(sCookedFile, ios::in | ios::out | ios::binary);
+        if (pFile.is_open())
+        {
+            pFile.seekp(offsetof(sHeader, iSourceTimestamp));
+            pFile.write(reinterpret_cast<const char*>(&iSourceTimestamp), sizeof(iSourceTimestamp));
+        }
+        pFile.close();
+        bReturnValue = mapFile(sCookedFile) && getExpectedSize() == m_iSize;
+    }
+
+    if (!bReturnValue)
+    {
+        m_pFile.close();
+        m_pData = nullptr;
+        m_iSize = 0;
+        m_pHeader = nullptr;
+    }
+
+    return bReturnValue;
+}
+
+// Map a cooked file and point the header at it.
+bool CookedMesh::mapFile(const string& sCookedFile)
+{
+    if (!m_pFile.open(sCookedFile))
+        return false;
+
+    m_pData = reinterpret_cast<const unsigned char*>(m_pFile.getData());
+    m_iSize = m_pFile.getSize();
+    m_pHeader = reinterpret_cast<const sHeader*>(m_pData);
+    return true;
+}
+
+/*
+    Check the header and that the cooked data was generated from the current source.
+
+    @param iSourceTimestamp     returns the modification time of the source
+*/
+bool CookedMesh::validate(const string& sSourceFile, long long* iSourceTimestamp)
+{
+    unsigned long long iSourceSize;
+
+    if (m_iSize < sizeof(sHeader) ||
+        COOKED_MESH_MAGIC != m_pHeader->iMagic ||
+        COOKED_MESH_VERSION != m_pHeader->iVersion ||
+        0 == m_pHeader->iLodCount || m_pHeader->iLodCount > MAX_MESH_LODS ||
+        m_pHeader->iIndexCount != accumulate(m_pHeader->iLodIndexCounts, m_pHeader->iLodIndexCounts + m_pHeader->iLodCount, 0u) ||
+        getExpectedSize() != m_iSize ||
+        m_bQuantizationEnabled != isQuantized())
+        return false;
+
+    if (!getFileInfo(sSourceFile, &iSourceSize, iSourceTimestamp) || iSourceSize != m_pHeader->iSourceSize)
+        return false;
+
+    // Timestamps change on checkout without the contents changing, fall back to the hash.
+    return *iSourceTimestamp == m_pHeader->iSourceTimestamp || hashFile(sSourceFile) == m_pHeader->iSourceHash;
+}
+
+// Size of the file described by the header.
+size_t CookedMesh::getExpectedSize() const
+{
+    return sizeof(sHeader) +
+           (sizeof(vec3) * m_pHeader->iPositionCount) +
+           m_pHeader->iVertexDataSize +
+           (sizeof(unsigned int) * m_pHeader->iIndexCount) +
+           m_pHeader->iDiffuseMapLength + m_pHeader->iSpecularMapLength;
+}
+
+/*
+    Optimize a parsed .obj file for drawing, build its cooked data and save it
+    next to the source.
+
+    @param pParser      that parsed sSourceFile successfully, is optimized and simplified
+    @param sSourceFile  .obj file that was parsed
+    @return true if the cooked file was written
+*/
+bool CookedMesh::cook(ObjParser* pParser, const string& sSourceFile)
+{
+    const ObjParser::sMaterial* pMaterial = pParser->getMaterial();
+    vector<unsigned char> pQuantizedData;
+    sHeader sNewHeader;
+    bool bReturnValue;
+
+    pParser->optimize();
+    pParser->generateLods();
+    if (m_bQuantizationEnabled)
+        MeshOptimizer::quantizeVertices(pParser->getVertexData().data(), pParser->getVertexCount(),
+                                        pParser->hasNormals(), pParser->hasUVs(), &pQuantizedData);
+
+    memset(&sNewHeader, 0, sizeof(sHeader));
+    sNewHeader.iMagic = COOKED_MESH_MAGIC;
+    sNewHeader.iVersion = COOKED_MESH_VERSION;
+    getFileInfo(sSourceFile, &sNewHeader.iSourceSize, &sNewHeader.iSourceTimestamp);
+    sNewHeader.iSourceHash = hashFile(sSourceFile);
+    sNewHeader.iFlags = (pParser->hasNormals() ? COOKED_NORMALS : 0) |
+                        (pParser->hasUVs() ? COOKED_UVS : 0) |
+                        (nullptr != pMaterial ? COOKED_MATERIAL : 0) |
+                        (m_bQuantizationEnabled ? COOKED_QUANTIZED : 0);
+    sNewHeader.iPositionCount = static_cast<unsigned int>(pParser->getPositions().size());
+    sNewHeader.iVertexDataSize = static_cast<unsigned int>(m_bQuantizationEnabled ? pQuantizedData.size()
+                                                                                  : (pParser->getVertexData().size() * sizeof(float)));
+    sNewHeader.iLodCount = pParser->getLodCount();
+    for (unsigned int i = 0; i < sNewHeader.iLodCount; ++i)
+        sNewHeader.iLodIndexCounts[i] = pParser->getLodIndexCount(i);
+    sNewHeader.iIndexCount = static_cast<unsigned int>(pParser->getIndices().size() + pParser->getLodIndices().size());
+    sNewHeader.vMinimum = pParser->getMinimum();
+    sNewHeader.vMaximum = pParser->getMaximum();
+    if (nullptr != pMaterial)
+    {
+        sNewHeader.vDiffuseColor = pMaterial->vDiffuseColor;
+        sNewHeader.vSpecularColor = pMaterial->vSpecularColor;
+        sNewHeader.fShininess = pMaterial->fShininess;
+        sNewHeader.iDiffuseMapLength = static_cast<unsigned int>(pMaterial->sDiffuseMap.size());
+        sNewHeader.iSpecularMapLength = static_cast<unsigned int>(pMaterial->sSpecularMap.size());
+    }
+
+    // Write Blobs
+    m_pFile.close();
+    m_pCookedData.clear();
+    m_pCookedData.reserve(sizeof(sHeader) + (sizeof(vec3) * sNewHeader.iPositionCount) +
+                          sNewHeader.iVertexDataSize +
+                          (sizeof(unsigned int) * sNewHeader.iIndexCount));
+    appendBlob(&m_pCookedData, &sNewHeader, 1);
+    appendBlob(&m_pCookedData, pParser->getPositions().data(), sNewHeader.iPositionCount);
+    if (m_bQuantizationEnabled)
+        appendBlob(&m_pCookedData, pQuantizedData.data(), pQuantizedData.size());
+    else
+        appendBlob(&m_pCookedData, pParser->getVertexData().data(), pParser->getVertexData().size());
+    appendBlob(&m_pCookedData, pParser->getIndices().data(), pParser->getIndices().size());
+    appendBlob(&m_pCookedData, pParser->getLodIndices().data(), pParser->getLodIndices().size());
+    if (nullptr != pMaterial)
+    {
+        appendBlob(&m_pCookedData, pMaterial->sDiffuseMap.data(), sNewHeader.iDiffuseMapLength);
+        appendBlob(&m_pCookedData, pMaterial->sSpecularMap.data(), sNewHeader.iSpecularMapLength);
+    }
+
+    m_pData = m_pCookedData.data();
+    m_iSize = m_pCookedData.size();
+    m_pHeader = reinterpret_cast<const sHeader*>(m_pData);
+
+    // Save to disk for the next launch.
+    ofstream pFile(getCookedFileName(sSourceFile), ios::out | ios::binary | ios::trunc);
+    bReturnValue = pFile.is_open() && pFile.write(reinterpret_cast<const char*>(m_pData), m_iSize).good();
+    if (!bReturnValue)
+        cout << "CookedMesh: unable to write \"" << getCookedFileName(sSourceFile) << "\"." << endl;
+
+    return bReturnValue;
+}
+
+const vec3* CookedMesh::getPositions() const
+{
+    return reinterpret_cast<const vec3*>(getBlob(0));
+}
+
+const void* CookedMesh::getVertexData() const
+{
+    return getBlob(sizeof(vec3) * m_pHeader->iPositionCount);
+}
+
+const unsigned int* CookedMesh::getIndices() const
+{
+    return reinterpret_cast<const unsigned int*>(getBlob((sizeof(vec3) * m_pHeader->iPositionCount) +
+                                                         m_pHeader->iVertexDataSize));
+}
+
+bool CookedMesh::hasNormals() const
+{
+    return 0 != (m_pHeader->iFlags & COOKED_NORMALS);
+}
+
+bool CookedMesh::hasUVs() const
+{
+    return 0 != (m_pHeader->iFlags & COOKED_UVS);
+}
+
+bool CookedMesh::isQuantized() const
+{
+    return 0 != (m_pHeader->iFlags & COOKED_QUANTIZED);
+}
+
+bool CookedMesh::getMaterial(ObjParser::sMaterial* pMaterial) const
+{
+    if (0 == (m_pHeader->iFlags & COOKED_MATERIAL))
+        return false;
+
+    const char* pMaps = reinterpret_cast<const char*>(getIndices() + m_pHeader->iIndexCount);
+    pMaterial->sName.clear();
+    pMaterial->vDiffuseColor = m_pHeader->vDiffuseColor;
+    pMaterial->vSpecularColor = m_pHeader->vSpecularColor;
+    pMaterial->fShininess = m_pHeader->fShininess;
+    pMaterial->sDiffuseMap.assign(pMaps, m_pHeader->iDiffuseMapLength);
+    pMaterial->sSpecularMap.assign(pMaps + m_pHeader->iDiffuseMapLength, m_pHeader->iSpecularMapLength);
+    return true;
+}
+
+/*
+    Cook every .obj file below a directory, so the first launch doesn't have to.
+
+    @param sDirectory   to search for .obj files, e.g. "models"
+*/
+void CookedMesh::cookDirectory(const string& sDirectory)
+{
+    ObjParser pParser;
+    vector<string> pFiles;
+
+    ObjParser::findObjFiles(sDirectory, &pFiles);
+    for (const string& sFile : pFiles)
+    {
+        CookedMesh pCookedMesh;
+        if (pParser.parse(sFile) && pCookedMesh.cook(&pParser, sFile))
+            cout << "Cooked " << sFile << " (" << (pCookedMesh.m_iSize / 1024) << " KB)" << endl;
+    }
+}
+
+/*
+    Print the time it takes to open and read each cooked mesh below a directory,
+    which is what replaces parsing the .obj file on load.
+
+    @param sDirectory   to search for .obj files, e.g. "models"
+*/
+void CookedMesh::runBenchmark(const string& sDirectory)
+{
+    typedef chrono::high_resolution_clock clock;
+    ObjParser pParser;
+    vector<string> pFiles;
+    double fTotalTime = 0.0;
+
+    ObjParser::findObjFiles(sDirectory, &pFiles);
+    for (const string& sFile : pFiles)
+    {
+        CookedMesh pCookedMesh;
+        if (!pCookedMesh.open(sFile) && !(pParser.parse(sFile) && pCookedMesh.cook(&pParser, sFile)))
+            continue;
+
+        double fBestTime = DBL_MAX;
+        unsigned int iSum = 0;
+        for (unsigned int i = 0; i < BENCHMARK_ITERATIONS; ++i)
+        {
+            // Read the data as an upload would, mapping alone doesn't load anything.
+            //  The sum is printed so the reads can't be optimized away.
+            CookedMesh pTimedMesh;
+            clock::time_point pStart = clock::now();
+            if (pTimedMesh.open(sFile))
+            {
+                const unsigned char* pBytes = static_cast<const unsigned char*>(pTimedMesh.getVertexData());
+                iSum = accumulate(pBytes, pBytes + pTimedMesh.getVertexDataSize(), 0u);
+            }
+            fBestTime = std::min(fBestTime, chrono::duration<double, milli>(clock::now() - pStart).count());
+        }
+
+        fTotalTime += fBestTime;
+        cout << getCookedFileName(sFile) << ": " << fBestTime << " ms | byte sum: " << iSum << endl;
+    }
+
+    cout << "Opened " << pFiles.size() << " cooked meshes in " << fTotalTime << " ms" << endl;
+}
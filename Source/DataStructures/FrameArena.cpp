@@ -0,0 +1,184 @@
+#include "DataStructures/FrameArena.h"
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+/***********\
+ * Defines *
+\***********/
+#define FRAME_ARENA_CAPACITY    (1 << 20)   // 1 MB
+#define FRAME_ARENA_ALIGNMENT   16
+
+/********************************\
+ * Global Heap Allocation Count *
+\********************************/
+// Constant initialized, so it is valid even for allocations made during static initialization.
+static atomic<unsigned long long> s_iHeapAllocations(0);
+
+/*
+    Global operator new/delete replacements so every heap allocation made by the program can be
+    counted. The FrameArena samples this counter on reset() to report allocations per frame.
+*/
+void* operator new(size_t iSize)
+{
+    s_iHeapAllocations.fetch_add(1, memory_order_relaxed);
+    void* pMemory = malloc(0 == iSize ? 1 : iSize);
+    if (nullptr == pMemory)
+        throw bad_alloc();
+    return pMemory;
+}
+
+void* operator new[](size_t iSize)
+{
+    return operator new(iSize);
+}
+
+void* operator new(size_t iSize, const nothrow_t&) noexcept
+{
+    s_iHeapAllocations.fetch_add(1, memory_order_relaxed);
+    return malloc(0 == iSize ? 1 : iSize);
+}
+
+void* operator new[](size_t iSize, const nothrow_t& sTag) noexcept
+{
+    return operator new(iSize, sTag);
+}
+
+void operator delete(void* pMemory) noexcept
+{
+    free(pMemory);
+}
+
+void operator delete[](void* pMemory) noexcept
+{
+    free(pMemory);
+}
+
+void operator delete(void* pMemory, size_t) noexcept
+{
+    free(pMemory);
+}
+
+void operator delete[](void* pMemory, size_t) noexcept
+{
+    free(pMemory);
+}
+
+/****************************\
+ * Singleton Implementation *
+\****************************/
+FrameArena* FrameArena::m_pInstance = nullptr;
+
+FrameArena* FrameArena::getInstance()
+{
+    if (nullptr == m_pInstance)
+        m_pInstance = new FrameArena();
+    return m_pInstance;
+}
+
+// Default Constructor: Allocates the backing block once up front.
+FrameArena::FrameArena()
+{
+    m_iCapacity = FRAME_ARENA_CAPACITY;
+    m_pBuffer = static_cast<char*>(malloc(m_iCapacity));
+    if (nullptr == m_pBuffer)
+        m_iCapacity = 0;    // Every allocation will overflow to the heap.
+
+    m_iOffset = 0;
+    m_iLastFrameBytesUsed = m_iPeakBytesUsed = 0;
+    m_iOverflows = m_iLastFrameOverflows = 0;
+    m_iLiveAllocations = 0;
+    m_iLastFrameHeapAllocations = 0;
+    m_iHeapAllocationsAtReset = getTotalHeapAllocations();
+}
+
+FrameArena::~FrameArena()
+{
+    free(m_pBuffer);
+    m_pInstance = nullptr;
+}
+
+/*
+    Allocate a block of memory from the arena. Falls back to the global heap
+    if the arena doesn't have enough space left for this frame.
+
+    @param iBytes       number of bytes to allocate
+    @param iAlignment   required alignment of the returned block
+    @return a block of at least iBytes bytes
+*/
+void* FrameArena::allocate(size_t iBytes, size_t iAlignment)
+{
+    if (iAlignment < FRAME_ARENA_ALIGNMENT)
+        iAlignment = FRAME_ARENA_ALIGNMENT;
+
+    size_t iStart = (m_iOffset + (iAlignment - 1)) & ~(iAlignment - 1);
+    if (nullptr != m_pBuffer && iStart + iBytes <= m_iCapacity)
+    {
+        m_iOffset = iStart + iBytes;
+        if (m_iOffset > m_iPeakBytesUsed)
+            m_iPeakBytesUsed = m_iOffset;
+        ++m_iLiveAllocations;
+        return m_pBuffer + iStart;
+    }
+
+    // Arena is full: use the heap for this allocation.
+    ++m_iOverflows;
+    return ::operator new(iBytes);
+}
+
+/*
+    Return a block to the arena. Arena blocks are only reclaimed on reset(), except
+    for the most recent allocation which is rewound so that a growing vector can reuse
+    its old space. Blocks that overflowed to the heap are freed immediately.
+*/
+void FrameArena::deallocate(void* pMemory, size_t iBytes)
+{
+    if (nullptr == pMemory)
+        return;
+
+    if (owns(pMemory))
+    {
+        char* pBlock = static_cast<char*>(pMemory);
+        if (pBlock + iBytes == m_pBuffer + m_iOffset)
+            m_iOffset = pBlock - m_pBuffer;
+        assert(m_iLiveAllocations > 0);
+        --m_iLiveAllocations;
+    }
+    else
+        ::operator delete(pMemory);
+}
+
+// Returns whether the given memory lies within the arena block.
+bool FrameArena::owns(const void* pMemory) const
+{
+    const char* pBlock = static_cast<const char*>(pMemory);
+    return nullptr != m_pBuffer && pBlock >= m_pBuffer && pBlock < m_pBuffer + m_iCapacity;
+}
+
+/*
+    Reclaims all the arena memory and samples the per-frame statistics.
+    Called by the GameManager at the start of every frame.
+*/
+void FrameArena::reset()
+{
+    // A frame container outlived its frame; its memory is about to be reused.
+    assert(0 == m_iLiveAllocations);
+
+    unsigned long long iHeapAllocations = getTotalHeapAllocations();
+    m_iLastFrameHeapAllocations = static_cast<unsigned int>(iHeapAllocations - m_iHeapAllocationsAtReset);
+    m_iHeapAllocationsAtReset = iHeapAllocations;
+
+    m_iLastFrameBytesUsed = m_iOffset;
+    m_iLastFrameOverflows = m_iOverflows;
+    m_iOffset = 0;
+    m_iOverflows = 0;
+    m_iLiveAllocations = 0;
+}
+
+// Total number of global heap allocations made since the program started.
+unsigned long long FrameArena::getTotalHeapAllocations()
+{
+    return s_iHeapAllocations.load(memory_order_relaxed);
+}
@@ -0,0 +1,73 @@
+#include "DataStructures/GpuTimer.h"
+
+// Default Constructor
+GpuTimer::GpuTimer()
+{
+    m_iActiveQuery = 0;
+    resetTotals();
+}
+
+// Destructor
+GpuTimer::~GpuTimer()
+{
+    if (0 != m_iActiveQuery)
+        glEndQuery(GL_TIME_ELAPSED);
+
+    m_pFreeQueries.insert(m_pFreeQueries.end(), m_pPendingQueries.begin(), m_pPendingQueries.end());
+    if (0 != m_iActiveQuery)
+        m_pFreeQueries.push_back(m_iActiveQuery);
+    if (!m_pFreeQueries.empty())
+        glDeleteQueries(static_cast<GLsizei>(m_pFreeQueries.size()), m_pFreeQueries.data());
+}
+
+void GpuTimer::begin()
+{
+    assert(0 == m_iActiveQuery);
+
+    if (m_pFreeQueries.empty())
+        glGenQueries(1, &m_iActiveQuery);
+    else
+    {
+        m_iActiveQuery = m_pFreeQueries.back();
+        m_pFreeQueries.pop_back();
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, m_iActiveQuery);
+}
+
+void GpuTimer::end()
+{
+    assert(0 != m_iActiveQuery);
+
+    glEndQuery(GL_TIME_ELAPSED);
+    m_pPendingQueries.push_back(m_iActiveQuery);
+    m_iActiveQuery = 0;
+}
+
+/*
+    The GPU finishes the queries in the order they were issued, so stop at the
+    first one that isn't available yet.
+*/
+void GpuTimer::collect(bool bWait)
+{
+    unsigned int iCollected = 0;
+
+    for (; iCollected < m_pPendingQueries.size(); ++iCollected)
+    {
+        GLuint iQuery = m_pPendingQueries[iCollected];
+        GLuint iAvailable = GL_TRUE;
+        GLuint64 iNanoseconds = 0;
+
+        if (!bWait)
+            glGetQueryObjectuiv(iQuery, GL_QUERY_RESULT_AVAILABLE, &iAvailable);
+        if (GL_FALSE == iAvailable)
+            break;
+
+        glGetQueryObjectui64v(iQuery, GL_QUERY_RESULT, &iNanoseconds);
+        m_fMilliseconds += static_cast<double>(iNanoseconds) / 1000000.0;
+        ++m_iIntervals;
+        m_pFreeQueries.push_back(iQuery);
+    }
+
+    m_pPendingQueries.erase(m_pPendingQueries.begin(), m_pPendingQueries.begin() + iCollected);
+}
@@ -0,0 +1,363 @@
+#include "DataStructures/LightClusters.h"
+#include "EntityComponentHeaders/LightingComponent.h"
+
+/***********\
+ * Defines *
+\***********/
+// A point light fades out where it would add less than this much to a surface
+#define POINT_LIGHT_CUTOFF      0.1f
+#define POINT_LIGHT_PARAMS      3
+#define SPOT_LIGHT_PARAMS       4
+
+// Texel formats of the Texture Buffers, by eBuffer
+const GLenum BUFFER_FORMATS[LightClusters::MAX_BUFFERS] = { GL_RGBA32F, GL_RG32UI, GL_R32UI };
+
+static unsigned int getClusterIndex(unsigned int iX, unsigned int iY, unsigned int iZ)
+{
+    return iX + (LightClusters::CLUSTER_X * (iY + (LightClusters::CLUSTER_Y * iZ)));
+}
+
+// Default Constructor
+LightClusters::LightClusters()
+{
+    m_iBoundsWidth = m_iBoundsHeight = 0;
+    m_fNear = m_fFar = 0.0f;
+    m_vClusterCounts = uvec4(CLUSTER_X, CLUSTER_Y, CLUSTER_Z, 0);
+    m_vClusterScale = vec4(1.0f);
+    m_iLastAssignments = m_iLastMaxLightsPerCluster = 0;
+    memset(m_pBuffers, 0, sizeof(m_pBuffers));
+    memset(m_pTextures, 0, sizeof(m_pTextures));
+}
+
+// Destructor
+LightClusters::~LightClusters()
+{
+    if (0 != m_pTextures[LIGHT_DATA])
+    {
+        glDeleteTextures(MAX_BUFFERS, m_pTextures);
+        glDeleteBuffers(MAX_BUFFERS, m_pBuffers);
+    }
+}
+
+/*
+    Create each Texture Buffer with a single empty texel and bind its texture
+    to the unit matching its name, where it stays for good.
+*/
+void LightClusters::initialize()
+{
+    const GLuint pEmpty[4] = {};
+
+    glGenBuffers(MAX_BUFFERS, m_pBuffers);
+    glGenTextures(MAX_BUFFERS, m_pTextures);
+    for (unsigned int i = 0; i < MAX_BUFFERS; ++i)
+    {
+        glBindBuffer(GL_TEXTURE_BUFFER, m_pBuffers[i]);
+        glBufferData(GL_TEXTURE_BUFFER, sizeof(pEmpty), pEmpty, GL_STREAM_DRAW);
+        glActiveTexture(GL_TEXTURE0 + m_pTextures[i]);
+        glBindTexture(GL_TEXTURE_BUFFER, m_pTextures[i]);
+        glTexBuffer(GL_TEXTURE_BUFFER, BUFFER_FORMATS[i], m_pBuffers[i]);
+    }
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightClusters::queuePointLight(const vec3* vPosition, const vec3* vColor, float fPower)
+{
+    m_pQueuedLights.emplace_back();
+    m_pQueuedLights.back().vPosition = *vPosition;
+    m_pQueuedLights.back().vColor = *vColor * fPower;
+    m_pQueuedLights.back().fRange = 0.0f;
+}
+
+/*
+    Point lights have no range of their own: their contribution falls off with
+    1/distance. The range is where that drops below POINT_LIGHT_CUTOFF, and the
+    shader fades the light out smoothly before it.
+*/
+void LightClusters::addPointLight(const vec3* vPosition, const vec3* vColor, float fPower)
+{
+    sPointLight sNewLight;
+    sNewLight.vPosition = *vPosition;
+    sNewLight.vColor = *vColor * fPower;
+    sNewLight.fRange = std::max(sNewLight.vColor.r, std::max(sNewLight.vColor.g, sNewLight.vColor.b)) / POINT_LIGHT_CUTOFF;
+
+    if (sNewLight.fRange > 0.0f)
+        m_pPointLights.push_back(sNewLight);
+}
+
+void LightClusters::gatherLights(const vector< LightingComponent* >* pLights)
+{
+    const vector< vec4 >* pLightData = nullptr;
+
+    m_pPointLights.clear();
+    m_pSpotLights.clear();
+
+    for (LightingComponent* pLight : *pLights)
+    {
+        pLightData = pLight->getLightInformation();
+        if (LightingComponent::eLightType::POINT_LIGHT == pLight->getType())
+        {
+            // Power, Position, Color
+            assert(pLightData->size() == POINT_LIGHT_PARAMS);
+            vec3 vPosition = vec3((*pLightData)[1]);
+            vec3 vColor = vec3((*pLightData)[2]);
+            addPointLight(&vPosition, &vColor, (*pLightData)[0].x);
+        }
+        else if (LightingComponent::eLightType::SPOTLIGHT == pLight->getType())
+        {
+            // (Cos Phi, Cos Cutoff), Position, Direction, Color
+            assert(pLightData->size() == SPOT_LIGHT_PARAMS);
+            sSpotLight sNewLight;
+            sNewLight.fCosPhi = (*pLightData)[0].x;
+            sNewLight.fCosCutoff = (*pLightData)[0].y;
+            sNewLight.vPosition = vec3((*pLightData)[1]);
+            sNewLight.vDirection = normalize(vec3((*pLightData)[2]));
+            sNewLight.vColor = vec3((*pLightData)[3]);
+            m_pSpotLights.push_back(sNewLight);
+        }
+    }
+
+    for (const sPointLight& sQueuedLight : m_pQueuedLights)
+        addPointLight(&sQueuedLight.vPosition, &sQueuedLight.vColor, 1.0f);
+}
+
+// Depth at which a slice starts; slices grow exponentially from the near to the far plane.
+float LightClusters::getSliceDepth(unsigned int iSlice) const
+{
+    return m_fNear * pow(m_fFar / m_fNear, static_cast<float>(iSlice) / CLUSTER_Z);
+}
+
+// Same as the shader: log(depth) * scale - bias
+unsigned int LightClusters::getSlice(float fDepth) const
+{
+    float fSlice = (log(std::max(fDepth, m_fNear)) * m_vClusterScale.z) - m_vClusterScale.w;
+    return static_cast<unsigned int>(glm::clamp(fSlice, 0.0f, static_cast<float>(CLUSTER_Z - 1)));
+}
+
+// Tile of a normalized device coordinate along x (iAxis = 0) or y (iAxis = 1).
+unsigned int LightClusters::getTile(float fNDC, unsigned int iAxis) const
+{
+    float fPixels = static_cast<float>(0 == iAxis ? m_iBoundsWidth : m_iBoundsHeight);
+    float fTiles = static_cast<float>(m_vClusterCounts[iAxis]);
+    float fTile = ((fNDC * 0.5f) + 0.5f) * fPixels / m_vClusterScale[iAxis];
+    return static_cast<unsigned int>(glm::clamp(fTile, 0.0f, fTiles - 1.0f));
+}
+
+/*
+    Compute the view space bounds of every cluster for a projection and
+    viewport size. They only change when the window is resized or the field of
+    view changes, so they're kept until then.
+*/
+void LightClusters::updateClusterBounds(const mat4* m4Projection, int iWidth, int iHeight)
+{
+    if (*m4Projection == m_m4BoundsProjection && iWidth == m_iBoundsWidth && iHeight == m_iBoundsHeight)
+        return;
+
+    const mat4& m4Proj = *m4Projection;
+    m_m4BoundsProjection = m4Proj;
+    m_iBoundsWidth = std::max(iWidth, 1);
+    m_iBoundsHeight = std::max(iHeight, 1);
+
+    // Near and Far planes of a perspective projection
+    m_fNear = m4Proj[3][2] / (m4Proj[2][2] - 1.0f);
+    m_fFar = m4Proj[3][2] / (m4Proj[2][2] + 1.0f);
+
+    float fLogRange = log(m_fFar / m_fNear);
+    m_vClusterScale = vec4(ceil(static_cast<float>(m_iBoundsWidth) / CLUSTER_X),
+                           ceil(static_cast<float>(m_iBoundsHeight) / CLUSTER_Y),
+                           CLUSTER_Z / fLogRange,
+                           (CLUSTER_Z * log(m_fNear)) / fLogRange);
+
+    for (unsigned int iZ = 0; iZ < CLUSTER_Z; ++iZ)
+    {
+        float pDepths[2] = { getSliceDepth(iZ), getSliceDepth(iZ + 1) };
+        for (unsigned int iY = 0; iY < CLUSTER_Y; ++iY)
+        {
+            float pNDCY[2] = { ((2.0f * iY * m_vClusterScale.y) / m_iBoundsHeight) - 1.0f,
+                               ((2.0f * (iY + 1) * m_vClusterScale.y) / m_iBoundsHeight) - 1.0f };
+            for (unsigned int iX = 0; iX < CLUSTER_X; ++iX)
+            {
+                float pNDCX[2] = { ((2.0f * iX * m_vClusterScale.x) / m_iBoundsWidth) - 1.0f,
+                                   ((2.0f * (iX + 1) * m_vClusterScale.x) / m_iBoundsWidth) - 1.0f };
+                vec3 vMin = vec3(numeric_limits<float>::max(), numeric_limits<float>::max(), -pDepths[1]);
+                vec3 vMax = vec3(-numeric_limits<float>::max(), -numeric_limits<float>::max(), -pDepths[0]);
+
+                // The corners of the tile at the front and back of the slice
+                for (float fDepth : pDepths)
+                {
+                    for (unsigned int i = 0; i < 2; ++i)
+                    {
+                        float fX = (pNDCX[i] + m4Proj[2][0]) * fDepth / m4Proj[0][0];
+                        float fY = (pNDCY[i] + m4Proj[2][1]) * fDepth / m4Proj[1][1];
+                        vMin = vec3(std::min(vMin.x, fX), std::min(vMin.y, fY), vMin.z);
+                        vMax = vec3(std::max(vMax.x, fX), std::max(vMax.y, fY), vMax.z);
+                    }
+                }
+
+                unsigned int iCluster = getClusterIndex(iX, iY, iZ);
+                m_pClusterMin[iCluster] = vMin;
+                m_pClusterMax[iCluster] = vMax;
+                m_pClusterSpheres[iCluster] = vec4((vMin + vMax) * 0.5f, length(vMax - vMin) * 0.5f);
+            }
+        }
+    }
+}
+
+/*
+    Find the range of clusters the bounding box of the sphere projects onto,
+    then test the sphere against each of their boxes.
+*/
+void LightClusters::assignPointLight(unsigned int iTexel, const vec3* vCenter, float fRadius)
+{
+    float fMinDepth = -vCenter->z - fRadius;
+    float fMaxDepth = -vCenter->z + fRadius;
+    if (fMaxDepth < m_fNear || fMinDepth > m_fFar)
+        return;
+    fMinDepth = std::max(fMinDepth, m_fNear);
+    fMaxDepth = std::min(fMaxDepth, m_fFar);
+
+    // Extremes of the projected box: a side is furthest out at the nearest or furthest depth.
+    const mat4& m4Proj = m_m4BoundsProjection;
+    float pNDCX[4], pNDCY[4];
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        float fDepth = (i & 1) ? fMaxDepth : fMinDepth;
+        float fSide = (i & 2) ? fRadius : -fRadius;
+        pNDCX[i] = ((vCenter->x + fSide) * m4Proj[0][0] / fDepth) - m4Proj[2][0];
+        pNDCY[i] = ((vCenter->y + fSide) * m4Proj[1][1] / fDepth) - m4Proj[2][1];
+    }
+
+    unsigned int iMinX = getTile(*std::min_element(pNDCX, pNDCX + 4), 0), iMaxX = getTile(*std::max_element(pNDCX, pNDCX + 4), 0);
+    unsigned int iMinY = getTile(*std::min_element(pNDCY, pNDCY + 4), 1), iMaxY = getTile(*std::max_element(pNDCY, pNDCY + 4), 1);
+    unsigned int iMinZ = getSlice(fMinDepth), iMaxZ = getSlice(fMaxDepth);
+    float fRadiusSq = fRadius * fRadius;
+
+    for (unsigned int iZ = iMinZ; iZ <= iMaxZ; ++iZ)
+    {
+        for (unsigned int iY = iMinY; iY <= iMaxY; ++iY)
+        {
+            for (unsigned int iX = iMinX; iX <= iMaxX; ++iX)
+            {
+                unsigned int iCluster = getClusterIndex(iX, iY, iZ);
+                vec3 vClosest = clamp(*vCenter, m_pClusterMin[iCluster], m_pClusterMax[iCluster]);
+                vec3 vOffset = vClosest - *vCenter;
+                if (dot(vOffset, vOffset) <= fRadiusSq)
+                    m_pAssignments.push_back(uvec2(iCluster, iTexel));
+            }
+        }
+    }
+}
+
+/*
+    Spot lights reach infinitely far, so they're tested against the bounding
+    sphere of every cluster: the sphere is outside the cone if its distance to
+    the cone's side or to the plane behind the apex is larger than its radius.
+*/
+void LightClusters::assignSpotLight(unsigned int iTexel, const vec3* vApex, const vec3* vDirection, float fCosPhi)
+{
+    float fSinPhi = sqrt(std::max(1.0f - (fCosPhi * fCosPhi), 0.0f));
+
+    for (unsigned int iCluster = 0; iCluster < CLUSTER_COUNT; ++iCluster)
+    {
+        const vec4& vSphere = m_pClusterSpheres[iCluster];
+        vec3 vToCenter = vec3(vSphere) - *vApex;
+        float fAlongAxis = dot(vToCenter, *vDirection);
+        float fFromAxis = sqrt(std::max(dot(vToCenter, vToCenter) - (fAlongAxis * fAlongAxis), 0.0f));
+        float fToSide = (fCosPhi * fFromAxis) - (fAlongAxis * fSinPhi);
+
+        if (fCosPhi <= 0.0f || (fToSide <= vSphere.w && fAlongAxis >= -vSphere.w))
+            m_pAssignments.push_back(uvec2(iCluster, iTexel));
+    }
+}
+
+// Re-specify the storage of a Texture Buffer with new contents, so the previous contents can still be read by earlier draws.
+void LightClusters::upload(eBuffer eBuffer, const void* pData, GLsizeiptr iSize)
+{
+    glBindBuffer(GL_TEXTURE_BUFFER, m_pBuffers[eBuffer]);
+    glBufferData(GL_TEXTURE_BUFFER, iSize, pData, GL_STREAM_DRAW);
+}
+
+/*
+    Build the clusters of every view, one after the other in the same lists,
+    and upload them all at once. The views of a frame share a viewport size,
+    and usually a projection, so the cluster bounds are kept between them.
+*/
+void LightClusters::buildClusters(const mat4* pProjections, const mat4* pModelViews, unsigned int iViewCount, int iWidth, int iHeight)
+{
+    m_pLightTexels.clear();
+    m_pClusterData.resize(CLUSTER_COUNT * 2 * std::max(iViewCount, 1u));
+    m_pLightIndices.clear();
+    m_iLastAssignments = m_iLastMaxLightsPerCluster = 0;
+
+    for (unsigned int iView = 0; iView < iViewCount; ++iView)
+    {
+        updateClusterBounds(&pProjections[iView], iWidth, iHeight);
+        buildView(iView, &pModelViews[iView]);
+    }
+    m_iLastAssignments /= std::max(iViewCount, 1u);
+
+    if (m_pLightTexels.empty())
+        m_pLightTexels.push_back(vec4(0.0f));
+    if (m_pLightIndices.empty())
+        m_pLightIndices.push_back(0);
+    upload(LIGHT_DATA, m_pLightTexels.data(), m_pLightTexels.size() * sizeof(vec4));
+    upload(CLUSTER_DATA, m_pClusterData.data(), m_pClusterData.size() * sizeof(GLuint));
+    upload(LIGHT_INDICES, m_pLightIndices.data(), m_pLightIndices.size() * sizeof(GLuint));
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+/*
+    Transform the lights of the frame into a view, assign them to the clusters
+    they reach and append the light lists of its clusters. Every view adds the
+    same number of light texels, so a shader finds the lights of a view from
+    the light counts alone.
+*/
+void LightClusters::buildView(unsigned int iView, const mat4* m4ModelView)
+{
+    mat3 m3Rotation = mat3(*m4ModelView);
+    GLuint iFirstSpotTexel, iOffset = static_cast<GLuint>(m_pLightIndices.size());
+    GLuint* pClusterData = m_pClusterData.data() + (iView * CLUSTER_COUNT * 2);
+
+    m_pAssignments.clear();
+
+    for (const sPointLight& sLight : m_pPointLights)
+    {
+        GLuint iTexel = static_cast<GLuint>(m_pLightTexels.size());
+        vec3 vPosition = vec3(*m4ModelView * vec4(sLight.vPosition, 1.0f));
+        m_pLightTexels.push_back(vec4(vPosition, sLight.fRange));
+        m_pLightTexels.push_back(vec4(sLight.vColor, 0.0f));
+        assignPointLight(iTexel, &vPosition, sLight.fRange);
+    }
+    iFirstSpotTexel = static_cast<GLuint>(m_pLightTexels.size());
+    for (const sSpotLight& sLight : m_pSpotLights)
+    {
+        GLuint iTexel = static_cast<GLuint>(m_pLightTexels.size());
+        vec3 vPosition = vec3(*m4ModelView * vec4(sLight.vPosition, 1.0f));
+        vec3 vDirection = m3Rotation * sLight.vDirection;
+        m_pLightTexels.push_back(vec4(vPosition, sLight.fCosPhi));
+        m_pLightTexels.push_back(vec4(vDirection, sLight.fCosCutoff));
+        m_pLightTexels.push_back(vec4(sLight.vColor, 0.0f));
+        assignSpotLight(iTexel, &vPosition, &vDirection, sLight.fCosPhi);
+    }
+
+    // Count the lights of each cluster and lay the lists out one after the other.
+    m_pPointCounts.assign(CLUSTER_COUNT, 0);
+    m_pSpotCounts.assign(CLUSTER_COUNT, 0);
+    for (const uvec2& vAssignment : m_pAssignments)
+        ++(vAssignment.y < iFirstSpotTexel ? m_pPointCounts : m_pSpotCounts)[vAssignment.x];
+
+    for (unsigned int iCluster = 0; iCluster < CLUSTER_COUNT; ++iCluster)
+    {
+        GLuint iCount = m_pPointCounts[iCluster] + m_pSpotCounts[iCluster];
+        pClusterData[iCluster * 2] = iOffset;
+        pClusterData[(iCluster * 2) + 1] = (m_pPointCounts[iCluster] << 16) | m_pSpotCounts[iCluster];
+        m_pPointCounts[iCluster] = iOffset;     // Now the next free entry of the cluster's list
+        iOffset += iCount;
+        m_iLastMaxLightsPerCluster = std::max(m_iLastMaxLightsPerCluster, iCount);
+    }
+
+    // The assignments are in light order, so each list keeps its point lights first.
+    m_pLightIndices.resize(iOffset);
+    for (const uvec2& vAssignment : m_pAssignments)
+        m_pLightIndices[m_pPointCounts[vAssignment.x]++] = vAssignment.y;
+    m_iLastAssignments += static_cast<unsigned int>(m_pAssignments.size());
+}
@@ -0,0 +1,114 @@
+#include "DataStructures/MappedFile.h"
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Default Constructor
+MappedFile::MappedFile()
+{
+    m_pData = nullptr;
+    m_iSize = 0;
+    m_bOpenEmpty = false;
+#ifdef _WIN32
+    m_pFileHandle = INVALID_HANDLE_VALUE;
+    m_pMappingHandle = nullptr;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+/*
+    Map a file into memory for reading.
+
+    @param sFileName    of the file to map
+    @return true if the file was mapped (or is empty)
+*/
+bool MappedFile::open(const string& sFileName)
+{
+    close();
+
+#ifdef _WIN32
+    LARGE_INTEGER iFileSize;
+    m_pFileHandle = CreateFileA(sFileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (INVALID_HANDLE_VALUE == m_pFileHandle)
+        return false;
+
+    if (!GetFileSizeEx(m_pFileHandle, &iFileSize))
+    {
+        close();
+        return false;
+    }
+
+    m_iSize = static_cast<size_t>(iFileSize.QuadPart);
+    if (0 != m_iSize)
+    {
+        m_pMappingHandle = CreateFileMappingA(m_pFileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (nullptr != m_pMappingHandle)
+            m_pData = static_cast<const char*>(MapViewOfFile(m_pMappingHandle, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    struct stat sFileStats;
+    int iFile = ::open(sFileName.c_str(), O_RDONLY);
+    if (-1 == iFile)
+        return false;
+
+    if (0 == fstat(iFile, &sFileStats))
+    {
+        m_iSize = static_cast<size_t>(sFileStats.st_size);
+        if (0 != m_iSize)
+        {
+            void* pMapping = mmap(nullptr, m_iSize, PROT_READ, MAP_PRIVATE, iFile, 0);
+            if (MAP_FAILED != pMapping)
+            {
+                madvise(pMapping, m_iSize, MADV_SEQUENTIAL);
+                m_pData = static_cast<const char*>(pMapping);
+            }
+        }
+    }
+    ::close(iFile);     // The mapping keeps its own reference to the file.
+#endif
+
+    m_bOpenEmpty = (0 == m_iSize);
+    if (!isOpen())
+    {
+        cout << "MappedFile: unable to map \"" << sFileName << "\"." << endl;
+        close();
+    }
+
+    return isOpen();
+}
+
+// Unmap the file.
+void MappedFile::close()
+{
+#ifdef _WIN32
+    if (nullptr != m_pData)
+        UnmapViewOfFile(m_pData);
+    if (nullptr != m_pMappingHandle)
+        CloseHandle(m_pMappingHandle);
+    if (INVALID_HANDLE_VALUE != m_pFileHandle)
+        CloseHandle(m_pFileHandle);
+    m_pMappingHandle = nullptr;
+    m_pFileHandle = INVALID_HANDLE_VALUE;
+#else
+    if (nullptr != m_pData)
+        munmap(const_cast<char*>(m_pData), m_iSize);
+#endif
+
+    m_pData = nullptr;
+    m_iSize = 0;
+    m_bOpenEmpty = false;
+}
@@ -0,0 +1,720 @@
+#include "DataStructures/ObjParser.h"
+#include "DataStructures/MappedFile.h"
+#include "Utils/MeshOptimizer.h"
+#include <chrono>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+/***********\
+ * Defines *
+\***********/
+#define EMPTY_SLOT                  0xFFFFFFFF
+#define MIN_VERTEX_TABLE_SIZE       1024
+// Parses per file in the benchmark; the fastest one is reported.
+#define BENCHMARK_ITERATIONS        5
+// Cache sizes reported by the optimization report.
+#define SMALL_VERTEX_CACHE          16
+#define LARGE_VERTEX_CACHE          32
+// Each detail level targets this fraction of the triangles of the previous one, within an
+//  error that grows with the level (relative to the size of the mesh). A level has to save
+//  at least LOD_MIN_REDUCTION of the triangles of the previous one to be kept.
+#define LOD_TRIANGLE_RATIO          0.5f
+#define LOD_BASE_ERROR              0.01f
+#define LOD_ERROR_GROWTH            3.0f
+#define LOD_MIN_REDUCTION           0.2f
+#define LOD_MIN_TRIANGLES           64
+
+/*********************\
+ * Parsing Functions *
+\*********************/
+static inline bool isSpace(char c)      { return ' ' == c || '\t' == c; }
+static inline bool isLineEnd(char c)    { return '\n' == c || '\r' == c; }
+static inline bool isDigit(char c)      { return c >= '0' && c <= '9'; }
+
+static inline void skipSpaces(const char** pCursor, const char* pEnd)
+{
+    while (*pCursor < pEnd && isSpace(**pCursor))
+        ++(*pCursor);
+}
+
+static inline void skipLine(const char** pCursor, const char* pEnd)
+{
+    while (*pCursor < pEnd && '\n' != **pCursor)
+        ++(*pCursor);
+    if (*pCursor < pEnd)
+        ++(*pCursor);
+}
+
+// Reads the keyword at the start of a line, returns its length.
+static inline unsigned int readKeyword(const char** pCursor, const char* pEnd, const char** pKeyword)
+{
+    skipSpaces(pCursor, pEnd);
+    *pKeyword = *pCursor;
+    while (*pCursor < pEnd && !isSpace(**pCursor) && !isLineEnd(**pCursor))
+        ++(*pCursor);
+    return static_cast<unsigned int>(*pCursor - *pKeyword);
+}
+
+static inline bool isKeyword(const char* pKeyword, unsigned int iLength, const char* sExpected)
+{
+    return strlen(sExpected) == iLength && 0 == memcmp(pKeyword, sExpected, iLength);
+}
+
+// Remainder of the line with surrounding whitespace trimmed (names and file paths).
+static string readRestOfLine(const char** pCursor, const char* pEnd)
+{
+    skipSpaces(pCursor, pEnd);
+    const char* pStart = *pCursor;
+    while (*pCursor < pEnd && !isLineEnd(**pCursor))
+        ++(*pCursor);
+
+    const char* pLast = *pCursor;
+    while (pLast > pStart && isSpace(*(pLast - 1)))
+        --pLast;
+    return string(pStart, pLast);
+}
+
+static bool parseInt(const char** pCursor, const char* pEnd, int* iReturnValue)
+{
+    const char* p = *pCursor;
+    bool bNegative = false;
+    int iValue = 0;
+
+    if (p < pEnd && ('-' == *p || '+' == *p))
+        bNegative = ('-' == *(p++));
+    if (p >= pEnd || !isDigit(*p))
+        return false;
+
+    while (p < pEnd && isDigit(*p))
+        iValue = (iValue * 10) + (*(p++) - '0');
+
+    *iReturnValue = bNegative ? -iValue : iValue;
+    *pCursor = p;
+    return true;
+}
+
+/*
+    Decimal to float conversion for the formats found in .obj files
+    ("-0.125", "1e-05", "3."). Up to 19 significant digits are accumulated in an
+    integer and scaled once by a power of ten, which is exact to within a float ulp.
+*/
+static bool parseFloat(const char** pCursor, const char* pEnd, float* fReturnValue)
+{
+    static const double POWERS_OF_TEN[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                                            1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+                                            1e21, 1e22 };
+    const char* p = *pCursor;
+    bool bNegative = false, bHasDigits = false;
+    unsigned long long iMantissa = 0;
+    int iSignificantDigits = 0, iExponent = 0, iExplicitExponent = 0;
+    double fValue;
+
+    skipSpaces(&p, pEnd);
+    if (p < pEnd && ('-' == *p || '+' == *p))
+        bNegative = ('-' == *(p++));
+
+    // Integer part; digits past what fits in the mantissa only scale it.
+    for (; p < pEnd && isDigit(*p); ++p, bHasDigits = true)
+    {
+        if (iSignificantDigits < 19)
+        {
+            iMantissa = (iMantissa * 10) + (*p - '0');
+            iSignificantDigits += (0 != iMantissa);
+        }
+        else
+            ++iExponent;
+    }
+
+    // Fractional part
+    if (p < pEnd && '.' == *p)
+    {
+        for (++p; p < pEnd && isDigit(*p); ++p, bHasDigits = true)
+        {
+            if (iSignificantDigits < 19)
+            {
+                iMantissa = (iMantissa * 10) + (*p - '0');
+                iSignificantDigits += (0 != iMantissa);
+                --iExponent;
+            }
+        }
+    }
+
+    if (!bHasDigits)
+        return false;
+
+    // Exponent
+    if (p < pEnd && ('e' == *p || 'E' == *p))
+    {
+        const char* pExponent = p + 1;
+        if (parseInt(&pExponent, pEnd, &iExplicitExponent))
+        {
+            iExponent += iExplicitExponent;
+            p = pExponent;
+        }
+    }
+
+    fValue = static_cast<double>(iMantissa);
+    if (0 == iMantissa)
+        fValue = 0.0;
+    else if (iExponent < 0)
+        fValue = (iExponent >= -22) ? fValue / POWERS_OF_TEN[-iExponent] : fValue * pow(10.0, iExponent);
+    else if (iExponent > 0)
+        fValue = (iExponent <= 22) ? fValue * POWERS_OF_TEN[iExponent] : fValue * pow(10.0, iExponent);
+
+    *fReturnValue = static_cast<float>(bNegative ? -fValue : fValue);
+    *pCursor = p;
+    return true;
+}
+
+static inline bool parseVec3(const char** pCursor, const char* pEnd, vec3* vReturnValue)
+{
+    return parseFloat(pCursor, pEnd, &vReturnValue->x) &&
+           parseFloat(pCursor, pEnd, &vReturnValue->y) &&
+           parseFloat(pCursor, pEnd, &vReturnValue->z);
+}
+
+// Directory of a file path including the trailing separator.
+static string getDirectory(const string& sFileName)
+{
+    return sFileName.substr(0, sFileName.find_last_of("/\\") + 1);
+}
+
+/*
+    Convert a 1-based (or negative, relative to the iCount elements read so far)
+    .obj index to a 0-based index. Absolute indices may point past the elements
+    read so far; they're checked once the whole file is read.
+
+    @return false if the index is 0 or points before the first element
+*/
+static inline bool resolveIndex(int iIndex, size_t iCount, int* iReturnIndex)
+{
+    *iReturnIndex = (iIndex < 0) ? static_cast<int>(iCount) + iIndex : iIndex - 1;
+    return *iReturnIndex >= 0;
+}
+
+// Default Constructor
+ObjParser::ObjParser()
+{
+    m_vMinimum = m_vMaximum = vec3(0.0f);
+}
+
+// Clear all parsed data while keeping the allocated memory.
+void ObjParser::clear()
+{
+    m_pPositions.clear();
+    m_pNormals.clear();
+    m_pUVs.clear();
+    m_pVertexKeys.clear();
+    m_pIndices.clear();
+    m_pLodIndices.clear();
+    m_pLodIndexCounts.clear();
+    m_pVertexData.clear();
+    m_pMaterials.clear();
+    m_sUsedMaterial.clear();
+    m_vMinimum = vec3(FLT_MAX);
+    m_vMaximum = vec3(-FLT_MAX);
+
+    if (m_pVertexTable.size() < MIN_VERTEX_TABLE_SIZE)
+        m_pVertexTable.resize(MIN_VERTEX_TABLE_SIZE);
+    fill(m_pVertexTable.begin(), m_pVertexTable.end(), EMPTY_SLOT);
+}
+
+/*
+    Parse an .obj file along with its material library.
+
+    @param sFileName    of the .obj file
+    @return true if the file was read and all faces are valid
+*/
+bool ObjParser::parse(const string& sFileName)
+{
+    MappedFile pFile;
+    bool bReturnValue = true;
+    const char *pKeyword, *pCursor, *pEnd;
+    unsigned int iLength;
+
+    clear();
+    if (!pFile.open(sFileName))
+    {
+        cerr << "Could not Load Mesh File: " << sFileName << ".\n";
+        return false;
+    }
+
+    pCursor = pFile.getData();
+    pEnd = pCursor + pFile.getSize();
+    while (pCursor < pEnd)
+    {
+        iLength = readKeyword(&pCursor, pEnd, &pKeyword);
+        if (0 == iLength)
+        {/* Empty Line */
+        }
+        else if (isKeyword(pKeyword, iLength, "v"))         // Vertex Data
+        {
+            vec3 vPosition;
+            if (parseVec3(&pCursor, pEnd, &vPosition))
+            {
+                m_pPositions.push_back(vPosition);
+                m_vMinimum = min(m_vMinimum, vPosition);
+                m_vMaximum = max(m_vMaximum, vPosition);
+            }
+        }
+        else if (isKeyword(pKeyword, iLength, "vt"))        // uv-coords
+        {
+            vec2 vUV(0.0f);
+            parseFloat(&pCursor, pEnd, &vUV.x);
+            parseFloat(&pCursor, pEnd, &vUV.y);
+            m_pUVs.push_back(vUV);
+        }
+        else if (isKeyword(pKeyword, iLength, "vn"))        // Normal
+        {
+            vec3 vNormal(0.0f);
+            parseVec3(&pCursor, pEnd, &vNormal);
+            m_pNormals.push_back(vNormal);
+        }
+        else if (isKeyword(pKeyword, iLength, "f"))         // Face
+        {
+            if (!parseFace(&pCursor, pEnd) && bReturnValue)
+            {
+                cerr << "Invalid Object in File: " << sFileName << ".\n";
+                bReturnValue = false;
+            }
+        }
+        else if (isKeyword(pKeyword, iLength, "mtllib"))    // Material Library
+        {
+            parseMaterialLibrary(getDirectory(sFileName) + readRestOfLine(&pCursor, pEnd));
+        }
+        else if (isKeyword(pKeyword, iLength, "usemtl"))    // Material of the following faces
+        {
+            string sMaterial = readRestOfLine(&pCursor, pEnd);
+            if (m_sUsedMaterial.empty())
+                m_sUsedMaterial = sMaterial;
+        }
+        /* Groups, Objects, Smoothing Groups and Comments are ignored */
+
+        skipLine(&pCursor, pEnd);
+    }
+
+    if (m_pPositions.empty())
+        m_vMinimum = m_vMaximum = vec3(0.0f);
+
+    // Faces may reference data listed after them, so the indices are checked once everything is read.
+    if (!hasValidVertices())
+    {
+        if (bReturnValue)
+            cerr << "Invalid Object in File: " << sFileName << ".\n";
+        m_pVertexKeys.clear();
+        m_pIndices.clear();
+        bReturnValue = false;
+    }
+
+    buildVertexData();
+    return bReturnValue;
+}
+
+/*
+    Parse the vertices of a face ("v", "v/vt", "v//vn" or "v/vt/vn") and store it
+    as a triangle fan, so quads are split into (0, 1, 2) and (0, 2, 3).
+
+    @return false if an index of the face is 0 or relative to before the first element
+*/
+bool ObjParser::parseFace(const char** pCursor, const char* pEnd)
+{
+    int iIndex;
+    m_pFaceVertices.clear();
+
+    while (true)
+    {
+        sVertexKey sKey = { -1, -1, -1 };
+        skipSpaces(pCursor, pEnd);
+        if (!parseInt(pCursor, pEnd, &iIndex))
+            break;
+        if (!resolveIndex(iIndex, m_pPositions.size(), &sKey.iPosition))
+            return false;
+
+        if (*pCursor < pEnd && '/' == **pCursor)
+        {
+            ++(*pCursor);
+            if (parseInt(pCursor, pEnd, &iIndex) && !resolveIndex(iIndex, m_pUVs.size(), &sKey.iUV))
+                return false;
+
+            if (*pCursor < pEnd && '/' == **pCursor)
+            {
+                ++(*pCursor);
+                if (parseInt(pCursor, pEnd, &iIndex) && !resolveIndex(iIndex, m_pNormals.size(), &sKey.iNormal))
+                    return false;
+            }
+        }
+
+        m_pFaceVertices.push_back(findOrAddVertex(sKey));
+    }
+
+    for (unsigned int i = 2; i < m_pFaceVertices.size(); ++i)
+    {
+        m_pIndices.push_back(m_pFaceVertices[0]);
+        m_pIndices.push_back(m_pFaceVertices[i - 1]);
+        m_pIndices.push_back(m_pFaceVertices[i]);
+    }
+
+    return true;
+}
+
+/*
+    Optimize the parsed mesh with MeshOptimizer: triangles are reordered for the
+    post-transform cache, then the vertices in the order the triangles use them.
+    Must be called after parse(); the triplet table isn't valid afterwards.
+*/
+void ObjParser::optimize()
+{
+    vector<unsigned int> pNewOrder;
+    vector<sVertexKey> pReorderedKeys;
+
+    MeshOptimizer::optimizeVertexCache(&m_pIndices, getVertexCount());
+    MeshOptimizer::optimizeVertexFetch(&m_pIndices, getVertexCount(), &pNewOrder);
+
+    pReorderedKeys.reserve(pNewOrder.size());
+    for (unsigned int iOldVertex : pNewOrder)
+        pReorderedKeys.push_back(m_pVertexKeys[iOldVertex]);
+    m_pVertexKeys.swap(pReorderedKeys);
+
+    buildVertexData();
+}
+
+/*
+    Every level is simplified from the full mesh rather than the previous level so
+    the errors don't accumulate, then optimized for the vertex cache on its own.
+    Call after optimize(): the levels index the vertices as they are then.
+*/
+void ObjParser::generateLods()
+{
+    vector<unsigned int> pVertexPositions, pLevel;
+    unsigned int iStride = 3 + (hasNormals() ? 3 : 0) + (hasUVs() ? 2 : 0);
+    unsigned int iPreviousCount = static_cast<unsigned int>(m_pIndices.size());
+    float fMaxError = LOD_BASE_ERROR;
+
+    m_pLodIndices.clear();
+    m_pLodIndexCounts.clear();
+    if (m_pIndices.size() < LOD_MIN_TRIANGLES * 3)
+        return;
+
+    pVertexPositions.reserve(m_pVertexKeys.size());
+    for (const sVertexKey& sKey : m_pVertexKeys)
+        pVertexPositions.push_back(static_cast<unsigned int>(sKey.iPosition));
+
+    for (unsigned int iLod = 1; iLod < MAX_MESH_LODS; ++iLod, fMaxError *= LOD_ERROR_GROWTH)
+    {
+        unsigned int iTarget = static_cast<unsigned int>(iPreviousCount * LOD_TRIANGLE_RATIO) / 3 * 3;
+        MeshOptimizer::simplify(m_pIndices, m_pPositions, pVertexPositions, m_pVertexData.data(), iStride,
+                                iTarget, fMaxError, &pLevel);
+        if (pLevel.empty() || pLevel.size() > iPreviousCount * (1.0f - LOD_MIN_REDUCTION))
+            break;
+
+        MeshOptimizer::optimizeVertexCache(&pLevel, getVertexCount());
+        m_pLodIndices.insert(m_pLodIndices.end(), pLevel.begin(), pLevel.end());
+        m_pLodIndexCounts.push_back(static_cast<unsigned int>(pLevel.size()));
+        iPreviousCount = static_cast<unsigned int>(pLevel.size());
+    }
+}
+
+/*
+    Look up the vertex of an index triplet, adding it if it hasn't been seen yet.
+    The table is linear probing over a power of two size kept at most half full.
+
+    @return index of the unique vertex
+*/
+unsigned int ObjParser::findOrAddVertex(const sVertexKey& sKey)
+{
+    unsigned int iMask = static_cast<unsigned int>(m_pVertexTable.size()) - 1;
+    unsigned int iHash = (static_cast<unsigned int>(sKey.iPosition) * 73856093u) ^
+                         (static_cast<unsigned int>(sKey.iUV) * 19349663u) ^
+                         (static_cast<unsigned int>(sKey.iNormal) * 83492791u);
+    iHash ^= iHash >> 16;
+    iHash *= 0x85EBCA6Bu;
+    iHash ^= iHash >> 13;
+
+    for (unsigned int iSlot = iHash & iMask; ; iSlot = (iSlot + 1) & iMask)
+    {
+        unsigned int iVertex = m_pVertexTable[iSlot];
+        if (EMPTY_SLOT == iVertex)
+        {
+            iVertex = static_cast<unsigned int>(m_pVertexKeys.size());
+            m_pVertexKeys.push_back(sKey);
+            m_pVertexTable[iSlot] = iVertex;
+            if ((m_pVertexKeys.size() * 2) > m_pVertexTable.size())
+                growVertexTable();
+            return iVertex;
+        }
+        else if (m_pVertexKeys[iVertex] == sKey)
+            return iVertex;
+    }
+}
+
+// Double the size of the vertex table and reinsert all vertices.
+void ObjParser::growVertexTable()
+{
+    m_pVertexTable.assign(m_pVertexTable.size() * 2, EMPTY_SLOT);
+    vector<sVertexKey> pKeys;
+    pKeys.swap(m_pVertexKeys);
+    m_pVertexKeys.reserve(pKeys.capacity());
+
+    for (const sVertexKey& sKey : pKeys)
+        findOrAddVertex(sKey);
+}
+
+// @return true if every index of every vertex is within the data read from the file.
+bool ObjParser::hasValidVertices() const
+{
+    for (const sVertexKey& sKey : m_pVertexKeys)
+    {
+        if (static_cast<size_t>(sKey.iPosition) >= m_pPositions.size() ||
+            (-1 != sKey.iUV && static_cast<size_t>(sKey.iUV) >= m_pUVs.size()) ||
+            (-1 != sKey.iNormal && static_cast<size_t>(sKey.iNormal) >= m_pNormals.size()))
+            return false;
+    }
+
+    return true;
+}
+
+/*
+    Interleave the unique vertices as position[, normal][, uv], matching the
+    layout expected by Mesh::initalizeVBOs. UVs are flipped vertically for OpenGL.
+    This is done after parsing so faces may reference data listed after them.
+*/
+void ObjParser::buildVertexData()
+{
+    float* pOutput;
+    unsigned int iStride = 3 + (hasNormals() ? 3 : 0) + (hasUVs() ? 2 : 0);
+    m_pVertexData.resize(m_pVertexKeys.size() * iStride);
+    pOutput = m_pVertexData.data();
+
+    for (const sVertexKey& sKey : m_pVertexKeys)
+    {
+        const vec3& vPosition = m_pPositions[sKey.iPosition];
+        *(pOutput++) = vPosition.x;
+        *(pOutput++) = vPosition.y;
+        *(pOutput++) = vPosition.z;
+
+        if (hasNormals())
+        {
+            vec3 vNormal = (-1 != sKey.iNormal) ? m_pNormals[sKey.iNormal] : vec3(0.0f);
+            *(pOutput++) = vNormal.x;
+            *(pOutput++) = vNormal.y;
+            *(pOutput++) = vNormal.z;
+        }
+
+        if (hasUVs())
+        {
+            vec2 vUV = (-1 != sKey.iUV) ? m_pUVs[sKey.iUV] : vec2(0.0f);
+            *(pOutput++) = vUV.x;
+            *(pOutput++) = 1.0f - vUV.y;
+        }
+    }
+}
+
+/*
+    Parse the materials of a .mtl library. Only the values the renderer uses are read.
+
+    @param sFileName    of the .mtl file
+    @return true if the library could be read
+*/
+bool ObjParser::parseMaterialLibrary(const string& sFileName)
+{
+    MappedFile pFile;
+    string sDirectory = getDirectory(sFileName);
+    const char *pKeyword, *pCursor, *pEnd;
+    unsigned int iLength;
+
+    if (!pFile.open(sFileName))
+        return false;
+
+    pCursor = pFile.getData();
+    pEnd = pCursor + pFile.getSize();
+    while (pCursor < pEnd)
+    {
+        iLength = readKeyword(&pCursor, pEnd, &pKeyword);
+        if (isKeyword(pKeyword, iLength, "newmtl"))
+        {
+            sMaterial sNewMaterial;
+            sNewMaterial.sName = readRestOfLine(&pCursor, pEnd);
+            sNewMaterial.vDiffuseColor = vec3(1.0f);
+            sNewMaterial.vSpecularColor = vec3(0.0f);
+            sNewMaterial.fShininess = 1.0f;
+            m_pMaterials.push_back(sNewMaterial);
+        }
+        else if (!m_pMaterials.empty())
+        {
+            sMaterial& sCurrent = m_pMaterials.back();
+            if (isKeyword(pKeyword, iLength, "Kd"))
+                parseVec3(&pCursor, pEnd, &sCurrent.vDiffuseColor);
+            else if (isKeyword(pKeyword, iLength, "Ks"))
+                parseVec3(&pCursor, pEnd, &sCurrent.vSpecularColor);
+            else if (isKeyword(pKeyword, iLength, "Ns"))
+                parseFloat(&pCursor, pEnd, &sCurrent.fShininess);
+            else if (isKeyword(pKeyword, iLength, "map_Kd") || isKeyword(pKeyword, iLength, "map_Ks"))
+            {
+                // Texture options may precede the file name, which is the last token.
+                string sMap = readRestOfLine(&pCursor, pEnd);
+                sMap = sDirectory + sMap.substr(sMap.find_last_of(" \t") + 1);
+                ('d' == pKeyword[5] ? sCurrent.sDiffuseMap : sCurrent.sSpecularMap) = sMap;
+            }
+        }
+
+        skipLine(&pCursor, pEnd);
+    }
+
+    return true;
+}
+
+const ObjParser::sMaterial* ObjParser::getMaterial() const
+{
+    for (const sMaterial& sCurrent : m_pMaterials)
+    {
+        if (sCurrent.sName == m_sUsedMaterial)
+            return &sCurrent;
+    }
+
+    return m_pMaterials.empty() ? nullptr : &m_pMaterials.front();
+}
+
+/*************\
+ * Benchmark *
+\*************/
+
+// Collect all .obj files below a directory.
+static void collectObjFiles(const string& sDirectory, vector<string>* pFiles)
+{
+    string sName;
+#ifdef _WIN32
+    WIN32_FIND_DATAA sFindData;
+    HANDLE pFind = FindFirstFileA((sDirectory + "/*").c_str(), &sFindData);
+    if (INVALID_HANDLE_VALUE == pFind)
+        return;
+
+    do
+    {
+        sName = sFindData.cFileName;
+        if ("." == sName || ".." == sName)
+            continue;
+        if (sFindData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            collectObjFiles(sDirectory + "/" + sName, pFiles);
+        else if (sName.size() > 4 && ".obj" == sName.substr(sName.size() - 4))
+            pFiles->push_back(sDirectory + "/" + sName);
+    } while (FindNextFileA(pFind, &sFindData));
+    FindClose(pFind);
+#else
+    DIR* pDirectory = opendir(sDirectory.c_str());
+    if (nullptr == pDirectory)
+        return;
+
+    while (dirent* pEntry = readdir(pDirectory))
+    {
+        sName = pEntry->d_name;
+        if ("." == sName || ".." == sName)
+            continue;
+        if (DT_DIR == pEntry->d_type)
+            collectObjFiles(sDirectory + "/" + sName, pFiles);
+        else if (sName.size() > 4 && ".obj" == sName.substr(sName.size() - 4))
+            pFiles->push_back(sDirectory + "/" + sName);
+    }
+    closedir(pDirectory);
+#endif
+}
+
+void ObjParser::findObjFiles(const string& sDirectory, vector<string>* pFiles)
+{
+    pFiles->clear();
+    collectObjFiles(sDirectory, pFiles);
+    sort(pFiles->begin(), pFiles->end());
+}
+
+/*
+    Parse every .obj file below a directory a few times and print the best
+    parse time of each along with the size of the resulting mesh.
+
+    @param sDirectory   to search for .obj files, e.g. "models"
+*/
+void ObjParser::runBenchmark(const string& sDirectory)
+{
+    typedef chrono::high_resolution_clock clock;
+    ObjParser pParser;
+    vector<string> pFiles;
+    double fTotalTime = 0.0;
+    size_t iTotalBytes = 0;
+
+    findObjFiles(sDirectory, &pFiles);
+    if (pFiles.empty())
+    {
+        cout << "ObjParser: no .obj files found in \"" << sDirectory << "\"." << endl;
+        return;
+    }
+
+    for (const string& sFile : pFiles)
+    {
+        double fBestTime = DBL_MAX;
+        MappedFile pSizeCheck;
+        pSizeCheck.open(sFile);
+        size_t iBytes = pSizeCheck.getSize();
+        pSizeCheck.close();
+
+        for (unsigned int i = 0; i < BENCHMARK_ITERATIONS; ++i)
+        {
+            clock::time_point pStart = clock::now();
+            pParser.parse(sFile);
+            fBestTime = std::min(fBestTime, chrono::duration<double, milli>(clock::now() - pStart).count());
+        }
+
+        fTotalTime += fBestTime;
+        iTotalBytes += iBytes;
+        cout << sFile << ": " << fBestTime << " ms"
+             << " | " << (iBytes / 1024) << " KB"
+             << " | positions: " << pParser.getPositions().size()
+             << " | vertices: " << pParser.getVertexCount()
+             << " | triangles: " << (pParser.getIndices().size() / 3) << endl;
+    }
+
+    cout << "Parsed " << pFiles.size() << " files (" << (iTotalBytes / 1024) << " KB) in " << fTotalTime << " ms"
+         << " | " << ((iTotalBytes / (1024.0 * 1024.0)) / (fTotalTime / 1000.0)) << " MB/s" << endl;
+}
+
+/*
+    Print the ACMR of every .obj file below a directory for 16 and 32 entry
+    FIFO caches, in file order and after optimize(), along with the vertex
+    buffer size as floats and quantized.
+
+    @param sDirectory   to search for .obj files, e.g. "models"
+*/
+void ObjParser::runOptimizationReport(const string& sDirectory)
+{
+    ObjParser pParser;
+    vector<string> pFiles;
+
+    findObjFiles(sDirectory, &pFiles);
+    for (const string& sFile : pFiles)
+    {
+        if (!pParser.parse(sFile))
+            continue;
+
+        unsigned int iVertexCount = pParser.getVertexCount();
+        float fSmallBefore = MeshOptimizer::computeACMR(pParser.getIndices(), iVertexCount, SMALL_VERTEX_CACHE);
+        float fLargeBefore = MeshOptimizer::computeACMR(pParser.getIndices(), iVertexCount, LARGE_VERTEX_CACHE);
+        size_t iFloatBytes = pParser.getVertexData().size() * sizeof(float);
+        size_t iQuantizedBytes = iVertexCount * MeshOptimizer::getQuantizedStride(pParser.hasNormals(), pParser.hasUVs());
+
+        pParser.optimize();
+        pParser.generateLods();
+        cout << sFile << ": " << (pParser.getIndices().size() / 3) << " triangles, " << iVertexCount << " vertices"
+             << " | ACMR(" << SMALL_VERTEX_CACHE << "): " << fSmallBefore << " -> "
+             << MeshOptimizer::computeACMR(pParser.getIndices(), iVertexCount, SMALL_VERTEX_CACHE)
+             << " | ACMR(" << LARGE_VERTEX_CACHE << "): " << fLargeBefore << " -> "
+             << MeshOptimizer::computeACMR(pParser.getIndices(), iVertexCount, LARGE_VERTEX_CACHE)
+             << " | vertex data: " << (iFloatBytes / 1024) << " KB -> " << (iQuantizedBytes / 1024) << " KB"
+             << " | LOD triangles:";
+        for (unsigned int iLod = 0; iLod < pParser.getLodCount(); ++iLod)
+            cout << " " << (pParser.getLodIndexCount(iLod) / 3);
+        cout << endl;
+    }
+}
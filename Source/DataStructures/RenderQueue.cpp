@@ -0,0 +1,157 @@
+#include "DataStructures/RenderQueue.h"
+#include "EntityComponentHeaders/RenderComponent.h"
+#include "Texture.h"
+
+/***********\
+ * Defines *
+\***********/
+#define SHADER_BITS     6
+#define TEXTURE_BITS    16
+#define MESH_BITS       16
+#define DEPTH_BITS      22
+#define PASS_SHIFT      60
+// Depths are stored in steps of 1/DEPTH_STEPS_PER_UNIT; anything further than the range shares the last step.
+#define DEPTH_STEPS_PER_UNIT    16.0f
+const uint64_t MAX_DEPTH = (1ull << DEPTH_BITS) - 1;
+
+// Material sampler uniforms, by eSampler
+const ShaderManager::eUniform SAMPLER_UNIFORMS[RenderQueue::SAMPLER_COUNT] = { ShaderManager::MATERIAL_DIFFUSE, ShaderManager::MATERIAL_SPECULAR };
+
+static uint64_t maskBits(uint64_t iValue, unsigned int iBits)
+{
+    return iValue & ((1ull << iBits) - 1);
+}
+
+// Default Constructor
+RenderQueue::RenderQueue()
+{
+    m_iStateChanges = m_iStateChangesAvoided = 0;
+    m_iLastFrameStateChanges = m_iLastFrameStateChangesAvoided = 0;
+    resetState();
+}
+
+/*
+    Queue a Render Component with the key for its state.
+
+    @param iTexture     name of the main texture of its Material
+    @param iMesh        name of the Vertex Array of its Mesh
+    @param fDepth       distance to the viewer, 0 if unknown
+*/
+void RenderQueue::push(RenderComponent* pComponent, ePass ePass, ShaderManager::eShaderType eShader,
+                       GLuint iTexture, GLuint iMesh, float fDepth)
+{
+    uint64_t iDepth = std::min(static_cast<uint64_t>(std::max(fDepth, 0.0f) * DEPTH_STEPS_PER_UNIT), MAX_DEPTH);
+    uint64_t iState = (maskBits(eShader, SHADER_BITS) << (TEXTURE_BITS + MESH_BITS)) |
+                      (maskBits(iTexture, TEXTURE_BITS) << MESH_BITS) |
+                      maskBits(iMesh, MESH_BITS);
+    sItem sNewItem;
+
+    if (BLENDED_PASS == ePass)
+        sNewItem.iKey = ((MAX_DEPTH - iDepth) << (SHADER_BITS + TEXTURE_BITS + MESH_BITS)) | iState;
+    else
+        sNewItem.iKey = (iState << DEPTH_BITS) | iDepth;
+    sNewItem.iKey |= static_cast<uint64_t>(ePass) << PASS_SHIFT;
+    sNewItem.pComponent = pComponent;
+    m_pItems.push_back(sNewItem);
+}
+
+void RenderQueue::draw()
+{
+    sort(m_pItems.begin(), m_pItems.end(), [](const sItem& sLHS, const sItem& sRHS) { return sLHS.iKey < sRHS.iKey; });
+
+    resetState();
+    for (const sItem& sDrawItem : m_pItems)
+        sDrawItem.pComponent->render(this);
+
+    // Leave no textures bound, as the components used to after each draw.
+    unbindTextures();
+    m_pItems.clear();
+}
+
+void RenderQueue::useProgram(GLuint iProgram)
+{
+    if (m_bProgramKnown && iProgram == m_iBoundProgram)
+        ++m_iStateChangesAvoided;
+    else
+    {
+        glUseProgram(iProgram);
+        m_iBoundProgram = iProgram;
+        m_bProgramKnown = true;
+        ++m_iStateChanges;
+    }
+}
+
+void RenderQueue::bindVertexArray(GLuint iVertexArray)
+{
+    if (m_bVertexArrayKnown && iVertexArray == m_iBoundVertexArray)
+        ++m_iStateChangesAvoided;
+    else
+    {
+        glBindVertexArray(iVertexArray);
+        m_iBoundVertexArray = iVertexArray;
+        m_bVertexArrayKnown = true;
+        ++m_iStateChanges;
+    }
+}
+
+/*
+    Bind a texture for a Material sampler of a shader, as Texture::bindTexture
+    does. The texture stays bound to its unit, so it's only bound again if
+    something else was bound there, and the sampler uniform is only set if it
+    points at another unit.
+*/
+void RenderQueue::bindSampler(ShaderManager::eShaderType eShader, eSampler eSampler, Texture* pTexture)
+{
+    GLuint iTexture = pTexture->getTextureID();
+
+    if (iTexture >= m_pBoundTextures.size())
+        m_pBoundTextures.resize(iTexture + 1, 0);
+
+    if (iTexture == m_pBoundTextures[iTexture])
+        ++m_iStateChangesAvoided;
+    else
+    {
+        glActiveTexture(GL_TEXTURE0 + iTexture);
+        glBindTexture(GL_TEXTURE_2D, iTexture);
+        m_pBoundTextures[iTexture] = iTexture;
+        ++m_iStateChanges;
+    }
+
+    if (iTexture == m_pSamplerTextures[eShader][eSampler])
+        ++m_iStateChangesAvoided;
+    else
+    {
+        SHADER_MANAGER->setUniformInt(eShader, SAMPLER_UNIFORMS[eSampler], iTexture);
+        m_pSamplerTextures[eShader][eSampler] = iTexture;
+        ++m_iStateChanges;
+    }
+}
+
+void RenderQueue::beginFrame()
+{
+    m_iLastFrameStateChanges = m_iStateChanges;
+    m_iLastFrameStateChangesAvoided = m_iStateChangesAvoided;
+    m_iStateChanges = m_iStateChangesAvoided = 0;
+}
+
+// Forget every binding: the next request for each one is issued.
+void RenderQueue::resetState()
+{
+    m_iBoundProgram = m_iBoundVertexArray = 0;
+    m_bProgramKnown = m_bVertexArrayKnown = false;
+    m_pBoundTextures.assign(m_pBoundTextures.size(), 0);
+    memset(m_pSamplerTextures, 0, sizeof(m_pSamplerTextures));
+}
+
+void RenderQueue::unbindTextures()
+{
+    for (GLuint iUnit = 0; iUnit < m_pBoundTextures.size(); ++iUnit)
+    {
+        if (0 != m_pBoundTextures[iUnit])
+        {
+            glActiveTexture(GL_TEXTURE0 + iUnit);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            m_pBoundTextures[iUnit] = 0;
+        }
+    }
+}
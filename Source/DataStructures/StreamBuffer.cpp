@@ -0,0 +1,163 @@
+#include "DataStructures/StreamBuffer.h"
+
+/***********\
+ * Defines *
+\***********/
+#define PERSISTENT_MAP_FLAGS    (GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT)
+// Nanoseconds to wait on a fence before checking it again.
+#define FENCE_TIMEOUT           1000000000
+
+// Static Variables
+bool StreamBuffer::m_bPersistentMappingEnabled = true;
+unsigned int StreamBuffer::m_iTotalStalls = 0;
+
+// Default Constructor
+StreamBuffer::StreamBuffer()
+{
+    m_iBuffer = 0;
+    m_iRegionSize = 0;
+    m_pMappedData = nullptr;
+    memset(m_pFences, 0, sizeof(m_pFences));
+    m_iReadRegion = m_iWriteRegion = 0;
+    m_iRegionCount = 1;
+    m_bPersistent = false;
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    release();
+}
+
+// Persistent mapping requires GL 4.4 or ARB_buffer_storage.
+bool StreamBuffer::usePersistentMapping()
+{
+    return m_bPersistentMappingEnabled && (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage);
+}
+
+/*
+    Allocate the buffer. With persistent mapping all regions are allocated as
+    immutable storage and mapped once for the lifetime of the buffer.
+
+    @param iRegionSize  number of bytes that can be written per write
+*/
+void StreamBuffer::initialize(GLsizeiptr iRegionSize)
+{
+    release();
+
+    m_iRegionSize = iRegionSize;
+    m_bPersistent = usePersistentMapping();
+    m_iRegionCount = m_bPersistent ? STREAM_BUFFER_REGIONS : 1;
+
+    glGenBuffers(1, &m_iBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_iBuffer);
+    if (m_bPersistent)
+    {
+        glBufferStorage(GL_ARRAY_BUFFER, m_iRegionSize * m_iRegionCount, nullptr, PERSISTENT_MAP_FLAGS);
+        m_pMappedData = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, m_iRegionSize * m_iRegionCount, PERSISTENT_MAP_FLAGS));
+
+        // Fall back to orphaning if the mapping failed.
+        if (nullptr == m_pMappedData)
+        {
+            cout << "StreamBuffer: unable to persistently map buffer, falling back to orphaning." << endl;
+            glDeleteBuffers(1, &m_iBuffer);
+            glGenBuffers(1, &m_iBuffer);
+            glBindBuffer(GL_ARRAY_BUFFER, m_iBuffer);
+            m_bPersistent = false;
+            m_iRegionCount = 1;
+        }
+    }
+
+    if (!m_bPersistent)
+        glBufferData(GL_ARRAY_BUFFER, m_iRegionSize, nullptr, GL_STREAM_DRAW);
+
+    m_iReadRegion = m_iWriteRegion = 0;
+}
+
+// Unmap and delete the buffer along with any pending fences.
+void StreamBuffer::release()
+{
+    for (unsigned int i = 0; i < STREAM_BUFFER_REGIONS; ++i)
+    {
+        if (nullptr != m_pFences[i])
+            glDeleteSync(m_pFences[i]);
+        m_pFences[i] = nullptr;
+    }
+
+    if (0 != m_iBuffer)
+    {
+        if (nullptr != m_pMappedData)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, m_iBuffer);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+        glDeleteBuffers(1, &m_iBuffer);
+    }
+
+    m_iBuffer = 0;
+    m_pMappedData = nullptr;
+}
+
+/*
+    Start writing to the next region.
+
+    @return pointer to the start of the region, getRegionSize() bytes long,
+            or nullptr if the buffer couldn't be mapped
+*/
+void* StreamBuffer::beginWrite()
+{
+    void* pReturnData = nullptr;
+    assert(isInitialized());
+
+    if (m_bPersistent)
+    {
+        // Every draw reading the current region has been issued by now.
+        if (nullptr != m_pFences[m_iReadRegion])
+            glDeleteSync(m_pFences[m_iReadRegion]);
+        m_pFences[m_iReadRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        m_iWriteRegion = getNextRegion();
+        waitForRegion(m_iWriteRegion);
+        pReturnData = m_pMappedData + (m_iWriteRegion * m_iRegionSize);
+    }
+    else
+    {
+        // Orphan the old storage so the driver doesn't synchronize with draws still using it.
+        glBindBuffer(GL_ARRAY_BUFFER, m_iBuffer);
+        glBufferData(GL_ARRAY_BUFFER, m_iRegionSize, nullptr, GL_STREAM_DRAW);
+        pReturnData = glMapBufferRange(GL_ARRAY_BUFFER, 0, m_iRegionSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    }
+
+    return pReturnData;
+}
+
+// Finish writing: draws issued from now on read the region that was just written.
+void StreamBuffer::endWrite()
+{
+    if (!m_bPersistent)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, m_iBuffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+
+    m_iReadRegion = m_iWriteRegion;
+}
+
+// Block until the GPU has finished every draw that read from a region.
+void StreamBuffer::waitForRegion(unsigned int iRegion)
+{
+    GLenum eResult;
+    if (nullptr == m_pFences[iRegion])
+        return;
+
+    eResult = glClientWaitSync(m_pFences[iRegion], 0, 0);
+    if (GL_TIMEOUT_EXPIRED == eResult)
+    {
+        ++m_iTotalStalls;
+        do
+            eResult = glClientWaitSync(m_pFences[iRegion], GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+        while (GL_TIMEOUT_EXPIRED == eResult);
+    }
+
+    glDeleteSync(m_pFences[iRegion]);
+    m_pFences[iRegion] = nullptr;
+}
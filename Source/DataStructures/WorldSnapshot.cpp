@@ -0,0 +1,112 @@
+#include "DataStructures/WorldSnapshot.h"
+#include <fstream>
+#include <iostream>
+
+/***********\
+ * Defines *
+\***********/
+#define SNAPSHOT_MAGIC      0x53535648  // "HVSS" in little endian
+// Increment whenever the layout of any serialized object changes.
+#define SNAPSHOT_VERSION    3
+// Enough for a full 8 hovercraft match; the buffer grows beyond this if needed.
+#define SNAPSHOT_RESERVE    (64 * 1024)
+
+// Default Constructor
+WorldSnapshot::WorldSnapshot()
+{
+    m_iReadOffset = 0;
+    m_bReadValid = false;
+}
+
+/*
+    Clear the snapshot and write a new header. The capacity of the buffer is
+    kept so repeated captures don't allocate.
+*/
+void WorldSnapshot::beginWrite()
+{
+    if (m_vData.capacity() < SNAPSHOT_RESERVE)
+        m_vData.reserve(SNAPSHOT_RESERVE);
+
+    m_vData.clear();
+    sHeader sNewHeader;
+    sNewHeader.iMagic = SNAPSHOT_MAGIC;
+    sNewHeader.iVersion = SNAPSHOT_VERSION;
+    sNewHeader.iPayloadSize = 0;
+    write(sNewHeader);
+}
+
+// Patch the payload size into the header once everything has been written.
+void WorldSnapshot::endWrite()
+{
+    unsigned int iPayloadSize = static_cast<unsigned int>(m_vData.size() - sizeof(sHeader));
+    memcpy(m_vData.data() + offsetof(sHeader, iPayloadSize), &iPayloadSize, sizeof(unsigned int));
+}
+
+/*
+    Validate the header and set up the snapshot for reading.
+
+    @return true if the snapshot is a complete snapshot of the current version.
+*/
+bool WorldSnapshot::beginRead()
+{
+    sHeader sReadHeader;
+    m_iReadOffset = 0;
+    m_bReadValid = true;
+
+    if (!read(&sReadHeader) ||
+        SNAPSHOT_MAGIC != sReadHeader.iMagic ||
+        SNAPSHOT_VERSION != sReadHeader.iVersion ||
+        (sReadHeader.iPayloadSize + sizeof(sHeader)) != m_vData.size())
+    {
+        cout << "WorldSnapshot: invalid or incompatible snapshot." << endl;
+        m_bReadValid = false;
+    }
+
+    return m_bReadValid;
+}
+
+/*
+    Write the snapshot to disk as is.
+
+    @param sFileName    to write the snapshot to
+    @return true if the file was written successfully
+*/
+bool WorldSnapshot::saveToFile(const string& sFileName) const
+{
+    ofstream pFile(sFileName, ios::out | ios::binary | ios::trunc);
+    if (!pFile.is_open())
+    {
+        cout << "WorldSnapshot: unable to open \"" << sFileName << "\" for writing." << endl;
+        return false;
+    }
+
+    pFile.write(reinterpret_cast<const char*>(m_vData.data()), m_vData.size());
+    return pFile.good();
+}
+
+/*
+    Load a snapshot previously written by saveToFile().
+
+    @param sFileName    to read the snapshot from
+    @return true if the file was read and has a valid header
+*/
+bool WorldSnapshot::loadFromFile(const string& sFileName)
+{
+    ifstream pFile(sFileName, ios::in | ios::binary | ios::ate);
+    if (!pFile.is_open())
+    {
+        cout << "WorldSnapshot: unable to open \"" << sFileName << "\" for reading." << endl;
+        return false;
+    }
+
+    streamsize iSize = pFile.tellg();
+    pFile.seekg(0, ios::beg);
+    m_vData.resize(static_cast<size_t>(iSize));
+    if (!pFile.read(reinterpret_cast<char*>(m_vData.data()), iSize))
+    {
+        m_vData.clear();
+        return false;
+    }
+
+    return beginRead();
+}
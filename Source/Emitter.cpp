@@ -4,14 +4,8 @@
 #include "TextureManager.h"
 #include "MeshManager.h"
 
-/*************\
- * Constants *
-\*************/
-const vec3 GRAVITY = vec3(0.0f, -9.81f, 0.0f);
-const vec4 COLOR = vec4(2.26f, 0.88f, 0.34f, 1.0f);
-
 // Default Constructor
-Emitter::Emitter(const vec3* vPosition)
+Emitter::Emitter(const vec3* vPosition, ParticlePool* pParticlePool)
 {
     m_iMaxNumParticles = 0;
     m_iCurrNumParticles = 0;
@@ -19,16 +13,16 @@ Emitter::Emitter(const vec3* vPosition)
     m_vEmitterNormal = vec3(0.f, 1.f, 0.f);
     m_vOrthogonalVec = vec3(1.f, 0.f, 0.f);
     m_fAngleFromNormal = m_fDefaultDuration = 0.f;
+    m_fTimeSinceLastSpawn = 0.f;
     m_bReadyToDelete = false;
-    glGenVertexArrays(1, &m_iVertexArray);
+    m_pParticlePool = pParticlePool;
+    m_iParticleBatch = 0;
 }
 
-// Destructor: Eliminate Particles and delete Render Component.
+// Destructor: the particles belong to the Particle Pool and die on their own.
 Emitter::~Emitter()
 {
-    m_pParticleList.clear();
-    glDeleteBuffers(1, &m_iVertexBuffer);
-    glDeleteVertexArrays(1, &m_iVertexArray);
+
 }
 
 /**************************************************************************************\
@@ -44,8 +38,6 @@ void Emitter::initializeEmitter(unsigned int iMaxParticles,
 {
     // Set internal variables
     m_iMaxNumParticles = iMaxParticles;
-    m_pParticleList.reserve(iMaxParticles);    // Reserve maximum size to avoid resizing computation
-    m_pPositions.reserve(iMaxParticles);    // Reserve maximum size to avoid resizing computation
     m_iCurrNumParticles     = 0;
     m_vEmitterNormal        = *vEmitterNormal;
     m_fAngleFromNormal      = fAngleFromNormal;
@@ -67,82 +59,33 @@ void Emitter::initializeEmitter(unsigned int iMaxParticles,
     m_vOrthogonalVec[m] = -m_vEmitterNormal[n];
     m_vOrthogonalVec = normalize(m_vOrthogonalVec);
 
+    // Emitters of the same color share a texture, and so a batch of the Particle Pool.
+    vec4 vTexColor(*vColor, 1.0);
+    m_iParticleBatch = m_pParticlePool->getBatch(TEXTURE_MANAGER->genTexture(&vTexColor));
+
     // Create first particle
     if (bExplosion)
     {
         for (unsigned int i = 0; i < m_iMaxNumParticles; ++i)
             spawnNewParticle();
     }
-    
-    // Set up Vertex Buffer.
-    m_iVertexBuffer = SHADER_MANAGER->genVertexBuffer(m_iVertexArray, m_pPositions.data(), m_pPositions.size() * sizeof(vec3), GL_DYNAMIC_DRAW);
-    SHADER_MANAGER->setAttrib(m_iVertexArray, 0, 3, 0, (void*)0);
-
-    vec4 vTexColor(*vColor, 1.0);
-    m_pDiffuseTexture = TEXTURE_MANAGER->genTexture(&vTexColor);
 }
 
-// Integrate Particle Positions, velocities and forces as well as updating the remaining duration for
-//    all particles.
+// Spawn the next particle of a fountain. The particles themselves are integrated by the Particle Pool.
+//    The Emitter is finished once it has spawned all its particles and the last one has died.
 bool Emitter::update(float fDelta)
 {
-    // Store GameTime as float
-    m_bReadyToDelete = true;
-    m_pPositions.resize(m_pParticleList.size(), vec3(0.f));
-
-    // Integrate Particles
-    for (unsigned int i = 0; i < m_pParticleList.size(); ++i)
-    {
-        if (m_pParticleList[i]->fDuration > 0.f)
-        {
-            m_bReadyToDelete = false;
-            m_pParticleList[i]->vVelocity += m_pParticleList[i]->vForce * fDelta;
-            m_pParticleList[i]->vForce += GRAVITY * fDelta;
-            m_pParticleList[i]->vPosition += m_pParticleList[i]->vVelocity * fDelta;
-            m_pParticleList[i]->fDuration -= fDelta;
-            m_pPositions[i] = m_pParticleList[i]->vPosition;
-        }
-    }
-
-    // Clean up any Emitters that are subject for deletion.
-    m_pParticleList.erase(
-        remove_if(
-            m_pParticleList.begin(),
-            m_pParticleList.end(),
-            [](unique_ptr<sParticleInformation> const & p) { return p->fDuration <= 0.f; }
-        ),
-        m_pParticleList.end());
+    m_fTimeSinceLastSpawn += fDelta;
 
     // Spawn a new one if available.
     if (m_iCurrNumParticles != m_iMaxNumParticles)
-    {
-        m_bReadyToDelete = false;
         spawnNewParticle();
-    }
 
     // Return boolean saying that the emitter is ready to delete
+    m_bReadyToDelete = m_iCurrNumParticles == m_iMaxNumParticles && m_fTimeSinceLastSpawn >= m_fDefaultDuration;
     return m_bReadyToDelete;
 }
 
-// Draw the Particles from the Emitter
-void Emitter::draw()
-{
-    // Update Vertex Buffer with new Positions
-    glBindVertexArray(m_iVertexArray);
-    glBindBuffer(GL_ARRAY_BUFFER, m_iVertexBuffer);
-    glBufferData(GL_ARRAY_BUFFER, m_pPositions.size() * sizeof(vec3), m_pPositions.data(), GL_DYNAMIC_DRAW);
-    glUseProgram(SHADER_MANAGER->getProgram(ShaderManager::eShaderType::PARTICLE_SHDR));
-
-    m_pDiffuseTexture->bindTexture(ShaderManager::eShaderType::PARTICLE_SHDR, "sMaterial.vDiffuse");
-
-    glPointSize(5.f);
-    glDrawArrays(GL_POINTS, 0, m_pPositions.size());
-    glPointSize(1.f);
-
-    m_pDiffuseTexture->unbindTexture();
-
-}
-
 /************************************************************************************\
  * Private Variables                                                                *
 \************************************************************************************/
@@ -162,16 +105,13 @@ void Emitter::spawnNewParticle()
     quat qRotateWRTNormal        = angleAxis(fRandTheta, m_vEmitterNormal);
 
     // Generate Particle information
-    unique_ptr<sParticleInformation> pNewParticle = make_unique<sParticleInformation>();
-    pNewParticle->vVelocity = vec3(qRotateWRTNormal * (qRotateWRTOrthogonal * vec4(m_vEmitterNormal, 1.0f)));
-    pNewParticle->vVelocity *= m_fRadius; // Initial force equal to radius
-    pNewParticle->vForce = pNewParticle->vVelocity;
-    pNewParticle->fDuration = m_fDefaultDuration;
-    pNewParticle->vPosition = m_vPosition;
+    vec3 vVelocity = vec3(qRotateWRTNormal * (qRotateWRTOrthogonal * vec4(m_vEmitterNormal, 1.0f)));
+    vVelocity *= m_fRadius; // Initial force equal to radius
 
     // Store Particle.
-    m_pParticleList.push_back(move(pNewParticle));
+    m_pParticlePool->spawnParticle(m_iParticleBatch, &m_vPosition, &vVelocity, m_fDefaultDuration);
 
     // Count new Particle
     ++m_iCurrNumParticles;
+    m_fTimeSinceLastSpawn = 0.f;
 }
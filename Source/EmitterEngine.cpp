@@ -1,5 +1,11 @@
 #include "EmitterEngine.h"
 
+/***********\
+ * Defines *
+\***********/
+#define EXPLOSION_LIGHT_POWER       4.0f
+#define EXPLOSION_LIGHT_DURATION    0.5f
+
 // Initialization of Static Singleton instance
 EmitterEngine* EmitterEngine::m_pInstance = nullptr;
 
@@ -28,6 +34,8 @@ EmitterEngine::~EmitterEngine()
 void EmitterEngine::clearAllEmitters()
 {
     m_pEmitters.clear();
+    m_sParticlePool.clear();
+    m_pExplosionLights.clear();
 }
 
 // Function to update all Emitters in the Engine.
@@ -36,6 +44,20 @@ void EmitterEngine::update(float fDelta)
     // Local Variables
     bool bCleanUp = false;
 
+    // Integrate every particle, then let the Emitters spawn new ones.
+    m_sParticlePool.update(fDelta);
+
+    // Fade the explosion lights
+    for (sExplosionLight& sLight : m_pExplosionLights)
+        sLight.fTimeLeft -= fDelta;
+    m_pExplosionLights.erase(
+        remove_if(
+            m_pExplosionLights.begin(),
+            m_pExplosionLights.end(),
+            [](const sExplosionLight& sLight) { return sLight.fTimeLeft <= 0.0f; }
+        ),
+        m_pExplosionLights.end());
+
     // Update all Emitter
     for (vector<unique_ptr<Emitter>>::iterator iter = m_pEmitters.begin();
         iter != m_pEmitters.end();
@@ -55,13 +77,23 @@ void EmitterEngine::update(float fDelta)
     }
 }
 
+// Writes the Particles of all Emitters to the GPU, once per frame before rendering.
+void EmitterEngine::uploadEmitters()
+{
+    m_sParticlePool.upload();
+}
+
+// Each explosion lights its surroundings, fading out linearly.
+void EmitterEngine::queueExplosionLights(LightClusters* pLightClusters) const
+{
+    for (const sExplosionLight& sLight : m_pExplosionLights)
+        pLightClusters->queuePointLight(&sLight.vPosition, &sLight.vColor, EXPLOSION_LIGHT_POWER * (sLight.fTimeLeft / EXPLOSION_LIGHT_DURATION));
+}
+
 // Draws all Emitters.
 void EmitterEngine::renderEmitters()
 {
-    for (vector<unique_ptr<Emitter>>::iterator iter = m_pEmitters.begin();
-        iter != m_pEmitters.end();
-        ++iter)
-        (*iter)->draw();
+    m_sParticlePool.draw();
 }
 
 // Generates a new Emitter with the given parameters
@@ -74,7 +106,11 @@ void EmitterEngine::generateEmitter(const vec3& vPos,               // Position
                                     bool bExplosion,                // Set as Explosion type or Fountain
                                     float fRadius)                  // Radius of Emission
 {
-    unique_ptr<Emitter> pNewEmitter = make_unique<Emitter>(&vPos);  // Generate new Emiter
+    unique_ptr<Emitter> pNewEmitter = make_unique<Emitter>(&vPos, &m_sParticlePool);   // Generate new Emiter
     pNewEmitter->initializeEmitter(iNumParticles, &vNormal, vColor, fAngleFromNormal, fParticleDuration, fRadius, bExplosion);   // Initialize it
     m_pEmitters.push_back(move(pNewEmitter));                       // Store Emitter
+
+    // Explosions light up their surroundings for a moment
+    if (bExplosion)
+        m_pExplosionLights.push_back({ vPos, *vColor, EXPLOSION_LIGHT_DURATION });
 }
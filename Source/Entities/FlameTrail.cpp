@@ -3,6 +3,7 @@
 #include "SoundManager.h"
 #include "EntityComponentHeaders/AnimationComponent.h"
 #include "EntityHeaders/HovercraftEntity.h"
+#include "DataStructures/WorldSnapshot.h"
 
 using namespace SpriteSheetDatabase;
 
@@ -132,3 +133,63 @@ void FlameTrail::spawnFlame(const vec3* vNormal, const vec3* vPosition)
     // Grab Pointer to HashKey to give to Physics Component as Name.
     //m_pPhysicsComponent->initializeFlame(sHashKey.c_str(), vPosition, m_fHeight * 0.5f, m_fWidth * 0.5f);
 }
+
+/****************************************************************\
+ * Snapshot Functions                                           *
+\****************************************************************/
+
+/*
+    Write every live flame (its remaining duration and position) as well as
+    the flame billboards to a snapshot.
+
+    @param pSnapshot    to write to
+*/
+void FlameTrail::writeSnapshot(WorldSnapshot* pSnapshot) const
+{
+    pSnapshot->write(static_cast<unsigned int>(m_pReferenceMap.size()));
+    for (vector<sReferenceBlock>::const_iterator pIter = m_pReferenceMap.begin();
+        pIter != m_pReferenceMap.end();
+        ++pIter)
+    {
+        PxVec3 pxPosition = pIter->pActorRef->getGlobalPose().p;
+        pSnapshot->write(pIter->fDuration);
+        pSnapshot->write(vec3(pxPosition.x, pxPosition.y, pxPosition.z));
+    }
+
+    m_pAnimationComponent->writeBillboardSnapshot(pSnapshot);
+}
+
+/*
+    Replace all live flames with the flames stored in a snapshot.
+
+    @param pSnapshot    to read from
+    @return true if the flames were read successfully
+*/
+bool FlameTrail::readSnapshot(WorldSnapshot* pSnapshot)
+{
+    unsigned int iFlameCount = 0;
+    if (!pSnapshot->read(&iFlameCount))
+        return false;
+
+    // Clear the current flames
+    for (vector<sReferenceBlock>::iterator pIter = m_pReferenceMap.begin();
+        pIter != m_pReferenceMap.end();
+        ++pIter)
+        m_pPhysXMngr->removeRigidActor(pIter->pActorRef);
+    m_pReferenceMap.clear();
+
+    // Regenerate the flames from the snapshot
+    for (unsigned int i = 0; i < iFlameCount; ++i)
+    {
+        sReferenceBlock pNewBlock;
+        vec3 vPosition;
+        if (!(pSnapshot->read(&pNewBlock.fDuration) && pSnapshot->read(&vPosition)))
+            return false;
+
+        m_pPhysXMngr->createCylinderObject(m_sName.c_str(), &vPosition, m_fHeight * 0.5f,
+                                           m_fWidth * 0.5f, &pNewBlock.pActorRef);
+        m_pReferenceMap.push_back(pNewBlock);
+    }
+
+    return m_pAnimationComponent->readBillboardSnapshot(pSnapshot);
+}
@@ -6,6 +6,7 @@
 #include "MeshManager.h"
 #include "EntityManager.h"
 #include "SoundManager.h"
+#include "DataStructures/WorldSnapshot.h"
 
 /***********\
  * Defines *
@@ -289,6 +290,7 @@ HovercraftEntity::HovercraftEntity(int iID, const vec3* vPosition, const vec3 &c
     m_pSpatialMap               = SPATIAL_DATA_MAP;
     m_pGameStats                = GAME_STATS;
     m_pSoundMngr                = SOUND_MANAGER;
+    m_iMeshInstance             = INVALID_INSTANCE_HANDLE;
 
     m_vColor = color;
 }
@@ -333,12 +335,8 @@ void HovercraftEntity::update(float fTimeInSeconds)
     // Get the Transformation from the Physics component
     m_pPhysicsComponent->getTransformMatrix(&m4NewTransform);
 
-    // Spike Animations
-    for (unsigned int i = 0; i < NUM_SPIKES; ++i)
-        m_pSpikeAnimations[i]->setWorldTransform(&m4NewTransform);
-
-    // If there's a new Transformation, apply it to the Mesh.
-    m_pMesh->updateInstance(&m4NewTransform, m_sName);
+    // The Mesh and Spikes are drawn from this in interpolate()
+    m_sTransform.step(&m4NewTransform);
 
     // Check to update Dynamic Position in Spatial Map
     vec3 vNewPosition = m4NewTransform[3];
@@ -357,6 +355,44 @@ void HovercraftEntity::update(float fTimeInSeconds)
     updateQueuedActions();
 }
 
+/*
+    Draw the hovercraft and position its cameras between the last two
+    simulation steps.
+
+    @param fAlpha   fraction of a simulation step since the last step
+*/
+void HovercraftEntity::interpolate(float fAlpha)
+{
+    mat4 m4Transform = m_sTransform.getTransform(fAlpha);
+
+    // Spike Animations
+    for (unsigned int i = 0; i < NUM_SPIKES; ++i)
+        m_pSpikeAnimations[i]->setWorldTransform(&m4Transform);
+
+    m_pMesh->updateInstance(&m4Transform, m_iMeshInstance);
+
+    // The camera rotation is integrated component-wise by the spring in
+    // updateCameraRotation(), so it's interpolated the same way.
+    vec3 vCameraPosition = mix(m_vPreviousCameraPosition, m_vCurrentCameraPosition, fAlpha);
+    quat qCameraRotation = (m_qPreviousCameraRotation * (1.0f - fAlpha)) + (m_qCurrentCameraRotation * fAlpha);
+
+    m_pCmrComponents[FRONT_CAMERA]->setRotationQuat(qCameraRotation);
+    m_pCmrComponents[BACK_CAMERA]->setRotationQuat(qCameraRotation);
+    m_pCmrComponents[FRONT_CAMERA]->setLookAt(vCameraPosition + qCameraRotation * FRONT_CAMERA_POSITION_OFFSET);
+    m_pCmrComponents[BACK_CAMERA]->setLookAt(vCameraPosition + qCameraRotation * BACK_CAMERA_POSITION_OFFSET);
+}
+
+// Snap the drawn hovercraft and cameras to the current state without interpolating.
+void HovercraftEntity::resetInterpolation()
+{
+    mat4 m4Transform = mat4(1.0f);
+    m_pPhysicsComponent->getTransformMatrix(&m4Transform);
+    m_sTransform.reset(&m4Transform);
+
+    m_vPreviousCameraPosition = m_vCurrentCameraPosition;
+    m_qPreviousCameraRotation = m_qCurrentCameraRotation;
+}
+
 void HovercraftEntity::updateSpatialMap(vec3 &vNewPosition)
 {
     if (m_vPosition != vNewPosition)
@@ -699,7 +735,7 @@ void HovercraftEntity::initialize(const string& sFileName,
     // Set up Mesh for Initial Transformation drawing.
     mat4 m4InitialTransform;
     m_pPhysicsComponent->getTransformMatrix(&m4InitialTransform);
-    m_pMesh->addInstance(&m4InitialTransform, m_sName);
+    m_iMeshInstance = m_pMesh->addInstance(&m4InitialTransform, m_sName);
 
     // The fire trail entity is always at the same location as the hovecraft
     m_pFireTrail = pEntityMngr->generateFlameTrailEntity(&m_vPosition, vColor, m_iID,
@@ -729,6 +765,7 @@ void HovercraftEntity::initialize(const string& sFileName,
     m_pCmrComponents[BACK_CAMERA]->setSphericalPos(BACK_CAMERA_START_VIEW);
 
     reinitialize();
+    resetInterpolation();
 }
 
 /*
@@ -848,6 +885,9 @@ void HovercraftEntity::initializePowerups()
 */
 void HovercraftEntity::updateCameraLookAts(float fTimeInSeconds)
 {
+    m_vPreviousCameraPosition = m_vCurrentCameraPosition;
+    m_qPreviousCameraRotation = m_qCurrentCameraRotation;
+
     updateCameraRotation(fTimeInSeconds);
     updateCameraPosition(fTimeInSeconds);
 }
@@ -864,9 +904,6 @@ void HovercraftEntity::updateCameraRotation(float fTimeInSeconds)
         float fSpring = SPRING_ROTATION_CONSTANT * (length(cameraRotationDirection) - CAMERA_REST_LENGTH);
 
         m_qCurrentCameraRotation += (normalize(cameraRotationDirection) * fSpring) * fTimeInSeconds;
-
-        m_pCmrComponents[FRONT_CAMERA]->setRotationQuat(m_qCurrentCameraRotation);
-        m_pCmrComponents[BACK_CAMERA]->setRotationQuat(m_qCurrentCameraRotation);
     }
 }
 
@@ -881,10 +918,6 @@ void HovercraftEntity::updateCameraPosition(float fTimeInSeconds)
     {
         float fSpring = SPRING_MOVEMENT_CONSTANT * (length(cameraLength) - CAMERA_REST_LENGTH);
         m_vCurrentCameraPosition += (normalize(cameraLength) * fSpring) * (fTimeInSeconds);
-
-        // Update all the camera look at and rotation values based on the averaging calculations.
-        m_pCmrComponents[FRONT_CAMERA]->setLookAt(m_vCurrentCameraPosition + m_qCurrentCameraRotation * FRONT_CAMERA_POSITION_OFFSET);
-        m_pCmrComponents[BACK_CAMERA]->setLookAt(m_vCurrentCameraPosition + m_qCurrentCameraRotation * BACK_CAMERA_POSITION_OFFSET);
     }
 }
 
@@ -1311,3 +1344,141 @@ void HovercraftEntity::animateSpikes()
     }
 }
 
+
+/****************************************************************\
+ * Snapshot Functions                                           *
+\****************************************************************/
+
+/*
+    Write the state of this hovercraft to a snapshot: its physics body,
+    cooldowns, ability and powerup timers, camera, and all of its live
+    rockets and flames.
+
+    @param pSnapshot    to write to
+*/
+void HovercraftEntity::writeSnapshot(WorldSnapshot* pSnapshot) const
+{
+    // Entity ID is used to validate the snapshot belongs to this hovercraft
+    pSnapshot->write(m_iID);
+    pSnapshot->write(m_vPosition);
+    m_pPhysicsComponent->writeSnapshot(pSnapshot);
+
+    // Cooldowns
+    pSnapshot->writeArray(m_fCooldowns, COOLDOWN_COUNT);
+    pSnapshot->writeArray(m_fMaxCooldowns, COOLDOWN_COUNT);
+    pSnapshot->write(m_iDashCharges);
+    pSnapshot->write(m_iDashMaxCharges);
+    pSnapshot->write(m_fDashMaxRecharge);
+    pSnapshot->write(m_fDashRecharge);
+
+    // Flame Trail
+    pSnapshot->write(m_bTrailActivated);
+    pSnapshot->write(m_fSecondsSinceTrailDeactivated);
+    pSnapshot->write(m_bTrailReadyToRecharge);
+    pSnapshot->write(m_fTrailGauge);
+    pSnapshot->write(m_fTrailRechargeMultipler);
+    pSnapshot->write(m_fSecondsSinceLastFlame);
+    pSnapshot->write(m_vPositionOfLastFlame);
+
+    // Control, Vulnerability and Spikes
+    pSnapshot->write(inControl);
+    pSnapshot->write(outOfControlTime);
+    pSnapshot->write(lowEnoughToMove);
+    pSnapshot->write(m_bInvincible);
+    pSnapshot->write(m_fSecondsLeftUntilVulnerable);
+    pSnapshot->write(m_bSpikesActivated);
+    pSnapshot->write(m_fSecondsSinceSpikesActivated);
+
+    // Powerups
+    pSnapshot->writeArray(m_vPowerupsTime, POWERUP_COUNT);
+    pSnapshot->writeArray(m_vPowerupsEnabled, POWERUP_COUNT);
+
+    // Queued Actions
+    pSnapshot->writeArray(queuedActions, QUEUED_COUNT);
+    pSnapshot->write(queuedX);
+    pSnapshot->write(queuedY);
+    pSnapshot->write(m_m4ReflectTransform);
+    pSnapshot->write(m_vReflectVelocity);
+    pSnapshot->write(lastAttacker);
+    pSnapshot->write(lastAbility);
+
+    // Camera
+    pSnapshot->write(activeCameraIndex);
+    pSnapshot->write(m_vCurrentCameraPosition);
+    pSnapshot->write(m_qCurrentCameraRotation);
+
+    // Abilities in the world
+    m_pRocket->writeSnapshot(pSnapshot);
+    m_pFireTrail->writeSnapshot(pSnapshot);
+}
+
+/*
+    Restore the state of this hovercraft from a snapshot written by
+    writeSnapshot().
+
+    @param pSnapshot    to read from
+    @return true if the state was read successfully and belongs to this hovercraft
+*/
+bool HovercraftEntity::readSnapshot(WorldSnapshot* pSnapshot)
+{
+    int iID;
+    bool bSpikesActivated = m_bSpikesActivated;
+
+    if (!pSnapshot->read(&iID) || iID != m_iID)
+    {
+        cout << "HovercraftEntity::readSnapshot(): snapshot doesn't match hovercraft " << m_iID << endl;
+        return false;
+    }
+
+    bool bSuccess = pSnapshot->read(&m_vPosition) &&
+                    m_pPhysicsComponent->readSnapshot(pSnapshot) &&
+                    // Cooldowns
+                    pSnapshot->readArray(m_fCooldowns, COOLDOWN_COUNT) &&
+                    pSnapshot->readArray(m_fMaxCooldowns, COOLDOWN_COUNT) &&
+                    pSnapshot->read(&m_iDashCharges) &&
+                    pSnapshot->read(&m_iDashMaxCharges) &&
+                    pSnapshot->read(&m_fDashMaxRecharge) &&
+                    pSnapshot->read(&m_fDashRecharge) &&
+                    // Flame Trail
+                    pSnapshot->read(&m_bTrailActivated) &&
+                    pSnapshot->read(&m_fSecondsSinceTrailDeactivated) &&
+                    pSnapshot->read(&m_bTrailReadyToRecharge) &&
+                    pSnapshot->read(&m_fTrailGauge) &&
+                    pSnapshot->read(&m_fTrailRechargeMultipler) &&
+                    pSnapshot->read(&m_fSecondsSinceLastFlame) &&
+                    pSnapshot->read(&m_vPositionOfLastFlame) &&
+                    // Control, Vulnerability and Spikes
+                    pSnapshot->read(&inControl) &&
+                    pSnapshot->read(&outOfControlTime) &&
+                    pSnapshot->read(&lowEnoughToMove) &&
+                    pSnapshot->read(&m_bInvincible) &&
+                    pSnapshot->read(&m_fSecondsLeftUntilVulnerable) &&
+                    pSnapshot->read(&m_bSpikesActivated) &&
+                    pSnapshot->read(&m_fSecondsSinceSpikesActivated) &&
+                    // Powerups
+                    pSnapshot->readArray(m_vPowerupsTime, POWERUP_COUNT) &&
+                    pSnapshot->readArray(m_vPowerupsEnabled, POWERUP_COUNT) &&
+                    // Queued Actions
+                    pSnapshot->readArray(queuedActions, QUEUED_COUNT) &&
+                    pSnapshot->read(&queuedX) &&
+                    pSnapshot->read(&queuedY) &&
+                    pSnapshot->read(&m_m4ReflectTransform) &&
+                    pSnapshot->read(&m_vReflectVelocity) &&
+                    pSnapshot->read(&lastAttacker) &&
+                    pSnapshot->read(&lastAbility) &&
+                    // Camera
+                    pSnapshot->read(&activeCameraIndex) &&
+                    pSnapshot->read(&m_vCurrentCameraPosition) &&
+                    pSnapshot->read(&m_qCurrentCameraRotation) &&
+                    // Abilities in the world
+                    m_pRocket->readSnapshot(pSnapshot) &&
+                    m_pFireTrail->readSnapshot(pSnapshot);
+
+    // Spike animations toggle, so only animate if the state changed.
+    if (bSpikesActivated != m_bSpikesActivated)
+        animateSpikes();
+
+    resetInterpolation();
+
+    return bSuccess;
+}
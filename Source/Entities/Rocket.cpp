@@ -3,6 +3,8 @@
 #include "EmitterEngine.h"
 #include "SoundManager.h"
 #include "EntityHeaders/HovercraftEntity.h"
+#include "DataStructures/WorldSnapshot.h"
+#include "ShaderManager.h"
 
 /***********\
  * DEFINES *
@@ -11,6 +13,7 @@
 #define PARTICLE_DURATION   2.0f
 #define NUM_PARTICLES       100
 #define EXPLOSION_RADIUS    3.0f
+#define ROCKET_LIGHT_POWER  1.5f
 
 int Rocket::LAUNCH_SPEED = 100;
 
@@ -50,14 +53,32 @@ void Rocket::update(float fTimeInSeconds)
     // Local Variables
     mat4 m4TransformationMatrix = mat4(1.0f);
 
-    // Go through each Rocket Reference, grab the Physics Transformation and
-    // update the Mesh.
+    // Go through each Rocket Reference and grab the Physics Transformation.
+    // The Mesh is updated in interpolate().
     for (vector<string>::const_iterator pIter = m_pReferenceList.begin();
         pIter != m_pReferenceList.end();
         ++pIter)
     {
         m_pPhysicsComponent->getTransformMatrix(*pIter, &m4TransformationMatrix);
-        m_pMesh->updateInstance(&m4TransformationMatrix, *pIter);
+        m_pRocketInstances[*pIter].sTransform.step(&m4TransformationMatrix);
+    }
+}
+
+// Draw each Rocket between the last two simulation steps. Each Rocket lights its surroundings for the frame.
+void Rocket::interpolate(float fAlpha)
+{
+    mat4 m4TransformationMatrix;
+    LightClusters* pLightClusters = SHADER_MANAGER->getLightClusters();
+
+    for (unordered_map<string, sRocketInstance>::const_iterator pIter = m_pRocketInstances.begin();
+        pIter != m_pRocketInstances.end();
+        ++pIter)
+    {
+        m4TransformationMatrix = pIter->second.sTransform.getTransform(fAlpha);
+        m_pMesh->updateInstance(&m4TransformationMatrix, pIter->second.iMeshInstance);
+
+        vec3 vPosition = vec3(m4TransformationMatrix[3]);
+        pLightClusters->queuePointLight(&vPosition, &m_vExplosionColor, ROCKET_LIGHT_POWER);
     }
 }
 
@@ -123,7 +144,12 @@ void Rocket::handleHovercraftCollision(HovercraftEntity *owner, HovercraftEntity
 void Rocket::removeFromScene(unsigned int iVictimMsg, bool shouldExplode)
 {
     string sHashKey = to_string(m_iID) + " " + to_string(iVictimMsg);
-    m_pMesh->removeInstance(sHashKey);
+    unordered_map<string, sRocketInstance>::iterator pInstance = m_pRocketInstances.find(sHashKey);
+    if (pInstance != m_pRocketInstances.end())
+    {
+        m_pMesh->removeInstance(pInstance->second.iMeshInstance);
+        m_pRocketInstances.erase(pInstance);
+    }
 
     if (shouldExplode)
     {
@@ -156,13 +182,28 @@ void Rocket::launchRocket(const mat4* m4InitialTransform,
         SOUND_MANAGER->play(SoundManager::SOUND_ROCKET_ACTIVATE);
     }
 
+    addRocket(getNewRocketID(), m4InitialTransform, vVelocity, fBBLength);
+}
+
+/*
+    Add a rocket to the scene for rendering and physics.
+
+    @param iRocketIndex         used to differentiate rocket A from rocket B
+    @param m4InitialTransform   of the rocket
+    @param vVelocity            of the rocket
+    @param fBBLength            length of the rocket hit box
+*/
+void Rocket::addRocket(unsigned int iRocketIndex, const mat4* m4InitialTransform, const vec3* vVelocity, float fBBLength)
+{
     // Generate Hash Key (<Rocket Entity ID> <Transformation Index>)
     // Transformation index used to differentiate rocket A from rocket B for
     // rendering and physics.
-    string sHashKey = to_string(m_iID) + " " + to_string(getNewRocketID());
+    string sHashKey = to_string(m_iID) + " " + to_string(iRocketIndex);
 
     // Add Instance to the Mesh for rendering new Rocket
-    m_pMesh->addInstance(m4InitialTransform, sHashKey);
+    sRocketInstance& sNewInstance = m_pRocketInstances[sHashKey];
+    sNewInstance.iMeshInstance = m_pMesh->addInstance(m4InitialTransform);
+    sNewInstance.sTransform.reset(m4InitialTransform);
 
     // Save Rocket in Reference Map.
     m_pReferenceList.push_back(sHashKey);
@@ -207,3 +248,69 @@ void Rocket::explode(unsigned int iVictimMsg)
 {
     removeFromScene(iVictimMsg, true);
 }
+
+/*************************************************************************************************\
+ * Snapshot Functions                                                                            *
+\*************************************************************************************************/
+
+/*
+    Write the state of every live rocket to a snapshot.
+
+    @param pSnapshot    to write to
+*/
+void Rocket::writeSnapshot(WorldSnapshot* pSnapshot) const
+{
+    mat4 m4Transform = mat4(1.0f);
+
+    pSnapshot->write(m_iRocketID);
+    pSnapshot->write(static_cast<unsigned int>(m_pReferenceList.size()));
+    for (vector<string>::const_iterator pIter = m_pReferenceList.begin();
+        pIter != m_pReferenceList.end();
+        ++pIter)
+    {
+        // Rocket index is the second half of the hash key
+        unsigned int iRocketIndex = static_cast<unsigned int>(strtoul(pIter->c_str() + pIter->find(' ') + 1, nullptr, 10));
+        m_pPhysicsComponent->getTransformMatrix(*pIter, &m4Transform);
+
+        pSnapshot->write(iRocketIndex);
+        pSnapshot->write(m4Transform);
+        pSnapshot->write(m_pPhysicsComponent->getLinearVelocity(*pIter));
+    }
+}
+
+/*
+    Replace all live rockets with the rockets stored in a snapshot.
+    Rockets keep their index so in-flight collisions refer to the same rocket.
+
+    @param pSnapshot    to read from
+    @return true if the rockets were read successfully
+*/
+bool Rocket::readSnapshot(WorldSnapshot* pSnapshot)
+{
+    unsigned int iRocketCount = 0;
+    if (!(pSnapshot->read(&m_iRocketID) && pSnapshot->read(&iRocketCount)))
+        return false;
+
+    // Clear the current rockets, including any pending removal.
+    for (unordered_map<string, sRocketInstance>::const_iterator pIter = m_pRocketInstances.begin();
+        pIter != m_pRocketInstances.end();
+        ++pIter)
+        m_pMesh->removeInstance(pIter->second.iMeshInstance);
+    m_pPhysicsComponent->removeAllInstances();
+    m_pReferenceList.clear();
+    m_pRocketInstances.clear();
+
+    // Regenerate the rockets from the snapshot
+    for (unsigned int i = 0; i < iRocketCount; ++i)
+    {
+        unsigned int iRocketIndex;
+        mat4 m4Transform;
+        vec3 vVelocity;
+        if (!(pSnapshot->read(&iRocketIndex) && pSnapshot->read(&m4Transform) && pSnapshot->read(&vVelocity)))
+            return false;
+
+        addRocket(iRocketIndex, &m4Transform, &vVelocity, BOUNDING_BOX);
+    }
+
+    return true;
+}
@@ -97,36 +97,38 @@ float getDistance(vec2 a, vec2 b) {
 /*
     Get the path for seek mode.
 
-    @return the seek path
+    @param pPath    to store the seek path in
 
     @modifies seekLocation
     @modifies lastIndex
 
 */
-vector<uvec2> AIComponent::getSeekPath()
+void AIComponent::getSeekPath(vector<uvec2>* pPath)
 {
     if (glm::distance(vec2(minXBot, minYBot), seekLocation) < 2) {
         vec3 currSeekLock = get2ndNearestSeekPoint(vec2(minXBot, minYBot));
         seekLocation = vec2(currSeekLock.x, currSeekLock.y);
         lastIndex = static_cast<int>(currSeekLock.z);
     }
-    return m_pSpatialDataMap->getShortestPath(seekLocation,
-                                              seekLocation,
-                                              vec2(minXBot, minYBot),
-                                              vec2(maxXBot, maxYBot));
+    m_pSpatialDataMap->getShortestPath(seekLocation,
+                                       seekLocation,
+                                       vec2(minXBot, minYBot),
+                                       vec2(maxXBot, maxYBot),
+                                       pPath);
 }
 
 /*
     Get the path for chase mode.
 
-    @param target   to chase
+    @param pPath    to store the chase path in
 */
-vector<uvec2> AIComponent::getChasePath() const
+void AIComponent::getChasePath(vector<uvec2>* pPath) const
 {
-    return m_pSpatialDataMap->getShortestPath(vec2(minXTarget, minYTarget),
-                                                vec2(maxXTarget, maxYTarget),
-                                                vec2(minXBot + 1, minYBot + 1),
-                                                vec2(maxXBot + 1, maxYBot + 1));
+    m_pSpatialDataMap->getShortestPath(vec2(minXTarget, minYTarget),
+                                       vec2(maxXTarget, maxYTarget),
+                                       vec2(minXBot + 1, minYBot + 1),
+                                       vec2(maxXBot + 1, maxYBot + 1),
+                                       pPath);
 }
 /*
     Update the target and bot locations on the spatial data map.
@@ -152,10 +154,10 @@ void AIComponent::determinePath()
 {
     switch (m_eCurrentMode) {
     case MODE_CHASE:
-        path = getChasePath();
+        getChasePath(&path);
         break;
     default:
-        path = getSeekPath();
+        getSeekPath(&path);
         break;
     }
 }
@@ -1,9 +1,9 @@
 #include "EntityComponentHeaders/AnimationComponent.h"
 #include "EntityManager.h"
 #include "EntityHeaders/Entity.h"
+#include "DataStructures/WorldSnapshot.h"
 
 // DEFINES
-#define ANIMATION_SPEED     (1.0f/60.0f)
 #define CURR_FRAME          m_vKeyFrames[m_iCurrFrame]
 #define NEXT_FRAME          m_vKeyFrames[m_iNextFrame]
 
@@ -16,7 +16,7 @@ AnimationComponent::AnimationComponent(int iEntityID, int iComponentID )
     m_fAnimTime             = 0.0f;
     m_fInterpolationK       = 0.0f;
     m_iCurrFrame            = m_iNextFrame = 0;
-    m_sMeshInstanceHandle   = to_string(iEntityID) + " " + to_string(iComponentID);
+    m_iMeshInstanceHandle   = INVALID_INSTANCE_HANDLE;
     m_bAnimating            = false;
     m_m4WorldTransform      = mat4(1.0f);
 }
@@ -53,7 +53,7 @@ void AnimationComponent::updateAnimation(float fTimeInSeconds)
         m_fInterpolationK       = m_fAnimTime / NEXT_FRAME.fTimeToKeyFrame; // Get Interpolation K
         m4MeshTransform = CURR_FRAME.interpolateWithKeyFrame(&NEXT_FRAME, m_fInterpolationK).toTransformationMatrix();
         m4MeshTransform = m_m4WorldTransform * m4MeshTransform;
-        m_pMesh->updateInstance(&m4MeshTransform, m_sMeshInstanceHandle);
+        m_pMesh->updateInstance(&m4MeshTransform, m_iMeshInstanceHandle);
 
         // Update Animation if it's finished.
         if (0.0f >= m_fAnimTime)
@@ -65,81 +65,15 @@ void AnimationComponent::updateAnimation(float fTimeInSeconds)
     else if (1 <= m_vKeyFrames.size())
     {
         m4MeshTransform = m_m4WorldTransform * CURR_FRAME.toTransformationMatrix();
-        m_pMesh->updateInstance(&m4MeshTransform, m_sMeshInstanceHandle);
+        m_pMesh->updateInstance(&m4MeshTransform, m_iMeshInstanceHandle);
     }
 }
 
-// Overloaded Update Function
+// Advance the Billboard clock. The billboard shader animates the sprites from it.
 void AnimationComponent::updateBillboard(float fTimeInSeconds)
 {
-    // Add Timestep to Animation GameTime.
     m_fAnimTime += fTimeInSeconds;
-    bool bUpdateAnimation = m_fAnimTime >= ANIMATION_SPEED;
-    bool bDeletionFlag = false;
-
-    if (bUpdateAnimation)
-        m_fAnimTime -= ANIMATION_SPEED;
-
-    if (!m_pBillboardListPtr->empty())
-    {
-        // Update Billboards
-        for( vector<Mesh::sBillboardInfo>::iterator iter = m_pMesh->m_pBillboardList.begin();
-             iter != m_pMesh->m_pBillboardList.end();
-             ++iter)
-        {
-            // Only compute Animation if it has duration remaining.
-            if (iter->fDuration > 0.0f)
-            {
-                // Decrement Duration
-                iter->fDuration -= fTimeInSeconds;
-                bDeletionFlag |= iter->fDuration <= 0;
-
-                // Animate the Sprite on the Animation Speed.
-                if (bUpdateAnimation)
-                {
-                    // Move Sprite UVs right.
-                    iter->vUVStart.x += m_vSpriteHxW.x;
-
-                    // If overstepped past, reset back to beginning and evaluate v constraints
-                    if (iter->vUVStart.x >= 1.0f)
-                    {
-                        // Reset u back to beginning.
-                        iter->vUVStart.x = m_vSpriteHxWBorder.x;
-                        iter->vUVEnd.x = m_vSpriteHxW.x - m_vSpriteHxWBorder.x;
-
-                        // Evaluate v
-                        iter->vUVStart.y += m_vSpriteHxW.y;
-
-                        // If gone past bottom of sprite sheet, return back to beginning.
-                        if (iter->vUVStart.y >= 1.0f)
-                        {
-                            iter->vUVStart.y = m_vSpriteHxWBorder.y;
-                            iter->vUVEnd.y = m_vSpriteHxW.y - m_vSpriteHxWBorder.y;
-                        }
-                        else // No reset? update the end of the UV
-                            iter->vUVEnd.y += m_vSpriteHxW.y;
-                    }
-                    else    // No reset? update the end of the UV
-                        iter->vUVEnd.x += m_vSpriteHxW.x;
-                }
-            }
-        }
-
-        if (bDeletionFlag)
-        {
-            // Clean up any Billboards that are subject for deletion.
-            m_pBillboardListPtr->erase(
-                remove_if(
-                    m_pBillboardListPtr->begin(),
-                    m_pBillboardListPtr->end(),
-                    [](Mesh::sBillboardInfo const & p) { return p.fDuration <= 0.f; }
-                ),
-                m_pBillboardListPtr->end());
-        }
-
-        // Update VBOs with Animated Sprite
-        m_pMesh->updateBillboardVBO();
-    }
+    m_pMesh->setBillboardTime(m_fAnimTime);
 }
 
 // Set up New Current Frame and Next Frame
@@ -175,7 +109,7 @@ void AnimationComponent::addKeyFrame(const vec3* vPosition,
         mat4 m4Transformation = m_m4WorldTransform * m_vKeyFrames.front().toTransformationMatrix();
 
         // Add Instance to the Mesh.
-        m_pMesh->addInstance(&m4Transformation, m_sMeshInstanceHandle);
+        m_iMeshInstanceHandle = m_pMesh->addInstance(&m4Transformation);
     }
     else if (m_iCurrFrame + 1 <= m_vKeyFrames.size())   // Set Next Frame
         m_iNextFrame = m_iCurrFrame + 1;
@@ -202,16 +136,10 @@ void AnimationComponent::animateToNextFrame()
 
 unsigned int AnimationComponent::addBillboard(const vec3* vPosition, const vec3* vNormal, const vec3* vColor)
 {
-    // Local Variables
-    vec2 vUVRandStart = vec2(0.0f);
-    vec2 vUVRandEnd = vec2(0.0f);
-
-    // Get a Random starting Sprite for the billboard.
-    pickRandomSprite(&vUVRandStart);
-    vUVRandEnd = vUVRandStart + (m_vSpriteHxW - m_vSpriteHxWBorder);    // Calculate the End UV Coordinates of the random sprite
-    vUVRandStart += m_vSpriteHxWBorder;                                 // Calculate the Beginning UV coordinates of the random sprite
-
-    return m_pMesh->addBillboard(vPosition, vNormal, vColor, &vUVRandStart, &vUVRandEnd, m_fBillboardHeight, m_fBillboardWidth, m_fDuration);
+    // Start the billboard on a random sprite, the shader animates it from there.
+    vec2 vSpriteCounts = vec2(m_iNumSpritesX, m_iNumSpritesY);
+    return m_pMesh->addBillboard(vPosition, vNormal, vColor, &vSpriteCounts, &m_vSpriteHxWBorder, pickRandomSprite(),
+                                 m_fBillboardHeight, m_fBillboardWidth, m_fDuration);
 }
 
 void AnimationComponent::initializeComponentAsBillboard( Mesh* pMesh, const sSpriteSheetInfo* pSpriteInfo, float fBillboardHeight, float fBillboardWidth)
@@ -234,6 +162,33 @@ void AnimationComponent::initializeComponentAsBillboard( Mesh* pMesh, const sSpr
     m_fBillboardWidth   = fBillboardWidth;
 }
 
+/*
+    Write the animation timer and all live billboards to a snapshot.
+
+    @param pSnapshot    to write to
+*/
+void AnimationComponent::writeBillboardSnapshot(WorldSnapshot* pSnapshot) const
+{
+    pSnapshot->write(m_fAnimTime);
+    pSnapshot->writeVector(*m_pBillboardListPtr);
+}
+
+/*
+    Replace all live billboards with the ones stored in a snapshot.
+
+    @param pSnapshot    to read from
+    @return true if the billboards were read successfully
+*/
+bool AnimationComponent::readBillboardSnapshot(WorldSnapshot* pSnapshot)
+{
+    if (!(pSnapshot->read(&m_fAnimTime) && pSnapshot->readVector(m_pBillboardListPtr)))
+        return false;
+
+    m_pMesh->setBillboardTime(m_fAnimTime);
+    m_pMesh->updateBillboardVBO();
+    return true;
+}
+
 /*****************************************************************\
  * Private Variables                                             *
 \*****************************************************************/
@@ -248,16 +203,14 @@ mat4 AnimationComponent::generateTransformationMatrix(const sKeyFrame* pKeyFrame
     return translate(pKeyFrame->vPosition) * m4ReturnTransformation;
 }
 
-// Picks a random sprite position (top left corner) based on the Texture HxW, the Sprite HxW and the Sprite buffer.
-void AnimationComponent::pickRandomSprite(vec2* vReturnUV)
+// Picks a random sprite of the sprite sheet, counted across then down the sheet.
+unsigned int AnimationComponent::pickRandomSprite()
 {
     // Local Variables
     int iRandX = FuncUtils::random(m_iNumSpritesX);   // Compute a Random index for the sprite sheet.
     int iRandY = FuncUtils::random(m_iNumSpritesY);   // Compute a Random index for the sprite sheet.
 
-    // Convert those indices to their respective uv coordinates within the sprite sheet.
-    vReturnUV->x = iRandX * m_vSpriteHxW.x;
-    vReturnUV->y = iRandY * m_vSpriteHxW.y;
+    return (iRandY * m_iNumSpritesX) + iRandX;
 }
 
 /*****************************************************************\
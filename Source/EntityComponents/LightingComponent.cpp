@@ -19,12 +19,15 @@ LightingComponent::LightingComponent(int iEntityID, int iComponentID)
     : EntityComponent( iEntityID, iComponentID )
 {
     glGenFramebuffers(1, &m_iFrameBuffer);
+    glGenFramebuffers(1, &m_iStaticFrameBuffer);
+    m_pShadowMap = m_pStaticShadowMap = nullptr;
 }
 
 // Destructor
 LightingComponent::~LightingComponent()
 {
     glDeleteFramebuffers(1, &m_iFrameBuffer);
+    glDeleteFramebuffers(1, &m_iStaticFrameBuffer);
 }
 
 // Overloaded Update Function
@@ -33,13 +36,32 @@ void LightingComponent::update(float fTimeInSeconds)
     /* Not Implemented */
 }
 
-// Sets up the GPU for drawing the Shadow Map
-void LightingComponent::setupShadowFBO() const
+// Sets up the GPU for drawing the Shadow Map, either cleared or starting from the Static Shadow Map.
+void LightingComponent::setupShadowFBO(bool bFromStaticShadows) const
 {
     if (DIRECTIONAL_LIGHT == m_eType)
     {
         glViewport(0, 0, m_iShadowWidth, m_iShadowHeight);
         glBindFramebuffer(GL_FRAMEBUFFER, m_iFrameBuffer);
+        if (bFromStaticShadows)
+        {
+            // Both maps have the same size and format, so the depth is copied as is.
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, m_iStaticFrameBuffer);
+            glBlitFramebuffer(0, 0, m_iShadowWidth, m_iShadowHeight, 0, 0, m_iShadowWidth, m_iShadowHeight, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+            glBindFramebuffer(GL_FRAMEBUFFER, m_iFrameBuffer);
+        }
+        else
+            glClear(GL_DEPTH_BUFFER_BIT);
+    }
+}
+
+// Sets up the GPU for drawing the Static Shadow Map
+void LightingComponent::setupStaticShadowFBO() const
+{
+    if (DIRECTIONAL_LIGHT == m_eType)
+    {
+        glViewport(0, 0, m_iShadowWidth, m_iShadowHeight);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_iStaticFrameBuffer);
         glClear(GL_DEPTH_BUFFER_BIT);
     }
 }
@@ -112,6 +134,8 @@ void LightingComponent::initializeAsDirectionalLight(const vec3* vDirection, con
     // Generate Shadow Map
     m_pShadowMap = TEXTURE_MANAGER->genDepthBuffer(m_iShadowWidth, m_iShadowHeight);
     m_pShadowMap->bindToFrameBuffer(m_iFrameBuffer, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, 0); // Bind Shadow Map to Light's Framebuffer
+    m_pStaticShadowMap = TEXTURE_MANAGER->genDepthBuffer(m_iShadowWidth, m_iShadowHeight, "StaticDepthBuffer");
+    m_pStaticShadowMap->bindToFrameBuffer(m_iStaticFrameBuffer, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, 0);
 
     // Store Light Data for passing to Shaders :> Assumes the Light is static and won't be moving.
     m_pLightData = { vec4(m_vDirection, 0.0), vec4(m_vAmbientColor, 0.0), vec4(m_vDiffuseColor, 0.0), vec4(m_vSpecularColor, 0.0) };
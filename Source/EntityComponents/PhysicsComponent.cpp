@@ -1,4 +1,5 @@
 #include "EntityComponentHeaders/PhysicsComponent.h"
+#include "DataStructures/WorldSnapshot.h"
 #include "stdafx.h"
 
 #define JUMP_FORCE 200000
@@ -290,6 +291,21 @@ void PhysicsComponent::removeInstance(string sHashKey)
     }
 }
 
+// Remove all DynamicBodies from the Physics scene, including any flagged for removal.
+void PhysicsComponent::removeAllInstances()
+{
+    if (!m_bVehicle)
+    {
+        for (unordered_map<string, PxRigidDynamic*>::iterator pIter = m_pDynamicObjects.begin();
+            pIter != m_pDynamicObjects.end();
+            ++pIter)
+            m_pPhysicsManager->removeRigidActor(pIter->second);
+
+        m_pDynamicObjects.clear();
+        m_pObjectsFlaggedForRemoval.clear();
+    }
+}
+
 // Flag an object for removal
 //  Since the collision call back is on a separate thread, it's not possible to remove the object during the collision
 //  call back. Flag it for removal and remove it outside of the callback thread.
@@ -346,12 +362,25 @@ void PhysicsComponent::getTransformMatrix(mat4* pReturnTransformMatrix)
 }
 
 // Get the Transformation Matrix for a specified Dynamic Object at a given hash key
-void PhysicsComponent::getTransformMatrix(string sHashKey, mat4* pReturnTransformMatrix)
+void PhysicsComponent::getTransformMatrix(const string& sHashKey, mat4* pReturnTransformMatrix)
 {
-    if (!m_bVehicle && m_pDynamicObjects.find(sHashKey) != m_pDynamicObjects.end())
+    unordered_map<string, PxRigidDynamic*>::const_iterator pIter = m_pDynamicObjects.find(sHashKey);
+    if (!m_bVehicle && pIter != m_pDynamicObjects.end())
+    {
+        *pReturnTransformMatrix = m_pPhysicsManager->getMat4(pIter->second->getGlobalPose());
+    }
+}
+
+// Get the Linear Velocity of a specified Dynamic Object at a given hash key
+glm::vec3 PhysicsComponent::getLinearVelocity(const string& sHashKey)
+{
+    unordered_map<string, PxRigidDynamic*>::const_iterator pIter = m_pDynamicObjects.find(sHashKey);
+    if (!m_bVehicle && pIter != m_pDynamicObjects.end())
     {
-        *pReturnTransformMatrix = m_pPhysicsManager->getMat4(m_pDynamicObjects[sHashKey]->getGlobalPose());
+        PxVec3 velocity = pIter->second->getLinearVelocity();
+        return glm::vec3(velocity.x, velocity.y, velocity.z);
     }
+    return glm::vec3();
 }
 glm::vec3 PhysicsComponent::getPosition() {
     physx::PxVec3 position = body->getGlobalPose().p;
@@ -401,3 +430,60 @@ void PhysicsComponent::setMaxSpeedToDash()
 {
     body->setMaxLinearVelocity(m_fMaxDashSpeed);
 }
+
+/*
+    Write the state of the vehicle body to a snapshot.
+    PhysX types aren't trivially copyable, so they're stored as glm types.
+
+    @param pSnapshot    to write to
+*/
+void PhysicsComponent::writeSnapshot(WorldSnapshot* pSnapshot) const
+{
+    PxTransform pxPose = body->getGlobalPose();
+    PxVec3 pxLinearVelocity = body->getLinearVelocity();
+    PxVec3 pxAngularVelocity = body->getAngularVelocity();
+
+    pSnapshot->write(vec3(pxPose.p.x, pxPose.p.y, pxPose.p.z));
+    pSnapshot->write(quat(pxPose.q.w, pxPose.q.x, pxPose.q.y, pxPose.q.z));
+    pSnapshot->write(vec3(pxLinearVelocity.x, pxLinearVelocity.y, pxLinearVelocity.z));
+    pSnapshot->write(vec3(pxAngularVelocity.x, pxAngularVelocity.y, pxAngularVelocity.z));
+    pSnapshot->write(m_fSecondsSinceLastDash);
+    pSnapshot->write(m_bIsDashing);
+    pSnapshot->write(isInAir);
+}
+
+/*
+    Restore the state of the vehicle body from a snapshot.
+
+    @param pSnapshot    to read from
+    @return true if the state was read successfully
+*/
+bool PhysicsComponent::readSnapshot(WorldSnapshot* pSnapshot)
+{
+    vec3 vPosition, vLinearVelocity, vAngularVelocity;
+    quat qRotation;
+    bool bIsDashing;
+
+    if (!(pSnapshot->read(&vPosition) &&
+          pSnapshot->read(&qRotation) &&
+          pSnapshot->read(&vLinearVelocity) &&
+          pSnapshot->read(&vAngularVelocity) &&
+          pSnapshot->read(&m_fSecondsSinceLastDash) &&
+          pSnapshot->read(&bIsDashing) &&
+          pSnapshot->read(&isInAir)))
+        return false;
+
+    body->setGlobalPose(PxTransform(PxVec3(vPosition.x, vPosition.y, vPosition.z),
+                                    PxQuat(qRotation.x, qRotation.y, qRotation.z, qRotation.w)));
+    body->setLinearVelocity(PxVec3(vLinearVelocity.x, vLinearVelocity.y, vLinearVelocity.z));
+    body->setAngularVelocity(PxVec3(vAngularVelocity.x, vAngularVelocity.y, vAngularVelocity.z));
+
+    // Restore the matching maximum speed.
+    m_bIsDashing = bIsDashing;
+    if (m_bIsDashing)
+        setMaxSpeedToDash();
+    else
+        setMaxSpeedToNormal();
+
+    return true;
+}
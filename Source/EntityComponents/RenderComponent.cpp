@@ -1,10 +1,18 @@
 #include "EntityComponentHeaders/RenderComponent.h"
 #include "EntityManager.h"
+#include "DataStructures/RenderQueue.h"
 
 /*************\
  * Constants *
 \*************/
 const vec4 BOUNDING_BOX_COLOR = vec4(0.2235294117647059, 1.0, 0.0784313725490196, 1.0); // Neon Green
+// Level of Detail: below each of these sizes on screen (in pixels), the next lower level is drawn.
+//  A size has to cross a threshold by LOD_HYSTERESIS before the level changes so meshes
+//  near a threshold don't keep switching levels.
+const float LOD_SCREEN_SIZES[MAX_MESH_LODS - 1] = { 240.0f, 120.0f, 60.0f };
+const float LOD_HYSTERESIS = 0.15f;
+// Terrain Chunks closer than this many chunk widths are drawn at full detail, every doubling of the distance drops a level.
+const float TERRAIN_LOD_DISTANCE = 1.5f;
 
 // Default Constructor:
 //        Requires an EntityID for the Entity that the component is a part of
@@ -20,6 +28,7 @@ RenderComponent::RenderComponent(int iEntityID, int iComponentID, bool bRenderSh
     m_eMode = eMode;
     m_pShdrMngr = SHADER_MANAGER;
     m_pEntityManager = ENTITY_MANAGER;
+    memset(m_iLodLevels, 0, sizeof(m_iLodLevels));
 }
 
 // Destructor
@@ -28,38 +37,91 @@ RenderComponent::~RenderComponent()
 
 }
 
+/*
+    Queue the component with the state it draws with. Billboards are blended,
+    so they're drawn after everything else. The shadow pass uses one program
+    and no textures, so only the Mesh matters there.
+*/
+void RenderComponent::enqueue(RenderQueue* pRenderQueue)
+{
+    if (m_pEntityManager->doShadowDraw())
+        pRenderQueue->push(this, RenderQueue::OPAQUE_PASS, ShaderManager::eShaderType::SHADOW_SHDR, 0, m_pMesh->getVertexArray(), 0.0f);
+    else
+    {
+        // Ordered by the nearest of the cameras drawn
+        float fDistance = FLT_MAX;
+        for (unsigned int iCamera = 0; iCamera < m_pEntityManager->getViewCount(); ++iCamera)
+            fDistance = std::min(fDistance, m_pMesh->getNearestInstanceDistance(&m_pEntityManager->getViewPosition(iCamera)));
+
+        pRenderQueue->push(this, m_pMesh->usingBillboards() ? RenderQueue::BLENDED_PASS : RenderQueue::OPAQUE_PASS, m_eShaderType,
+                           m_pMesh->getDiffuseTextureID(), m_pMesh->getVertexArray(), fDistance);
+    }
+}
+
+// Opaque Render Components whose shader can draw every screen at once, see EntityManager::renderViewsTogether.
+bool RenderComponent::canDrawViewsTogether() const
+{
+    return !m_pMesh->usingBillboards() && ShaderManager::isMultiViewShader(m_eShaderType);
+}
+
 // Loads the GPU and calls openGL to render.
-void RenderComponent::render()
+void RenderComponent::render(RenderQueue* pRenderQueue)
 {
     if (m_pMesh->getCount() > 0)
     {
         // Set up OpenGL state
-        glBindVertexArray(m_pMesh->getVertexArray());
+        pRenderQueue->bindVertexArray(m_pMesh->getVertexArray());
         CheckGLErrors();
 
         if (m_pEntityManager->doShadowDraw()) // Process Shadow Drawing if Specified.
-            glUseProgram(m_pShdrMngr->getProgram(ShaderManager::eShaderType::SHADOW_SHDR));
+            pRenderQueue->useProgram(m_pShdrMngr->getProgram(ShaderManager::eShaderType::SHADOW_SHDR));
         else                                // Otherwise, perform regular Render
-            glUseProgram(m_pShdrMngr->getProgram(m_eShaderType));
-        CheckGLErrors();
+        {
+            pRenderQueue->useProgram(m_pShdrMngr->getProgram(m_eShaderType));
 
-        // Bind Texture(s) HERE
-        m_pMesh->bindTextures(m_eShaderType);
-        CheckGLErrors();
+            // Billboards are animated by the shader from the time of their Mesh.
+            if (m_pMesh->usingBillboards())
+                m_pShdrMngr->setUniformFloat(m_eShaderType, ShaderManager::BILLBOARD_TIME, m_pMesh->getBillboardTime());
 
-        // Call related glDraw function.
-        if (m_bUsingInstanced && m_bUsingIndices)
-            glDrawElementsInstanced(m_eMode, m_pMesh->getCount(), GL_UNSIGNED_INT, 0, m_pMesh->getNumInstances());
-        else if (m_bUsingInstanced)
-            glDrawArraysInstanced(m_eMode, 0, m_pMesh->getCount(), m_pMesh->getNumInstances());
-        else if (m_bUsingIndices)
-            glDrawElements(m_eMode, m_pMesh->getCount(), GL_UNSIGNED_INT, nullptr);
-        else
-            glDrawArrays(m_eMode, 0, m_pMesh->getCount());
+            // Bind Texture(s) HERE, the shadow shader doesn't sample any.
+            m_pMesh->bindTextures(m_eShaderType, pRenderQueue);
+        }
         CheckGLErrors();
 
-        // Unbind Texture(s) HERE
-        m_pMesh->unbindTextures();
+        // Call related glDraw function. In the shadow pass, the only view is the light's, so Instances are culled against its frustum.
+        GLsizei iInstances = m_bUsingInstanced ? m_pMesh->getNumInstances() : 1;
+        GLsizei iViews = static_cast<GLsizei>(m_pEntityManager->getViewCount());
+        if (m_pMesh->usingCulling())
+        {
+            // Only the Instances in the frustum of the views drawn and not hidden behind the arena are drawn.
+            GLsizei iVisible = m_pMesh->cullInstances(m_pEntityManager->getViewFrusta(), m_pEntityManager->getViewCells(),
+                                                      iViews, m_pEntityManager->getCurrentView());
+            m_pEntityManager->addCulledInstances(iInstances - iVisible);
+            iInstances = iVisible;
+        }
+
+        // Several views are drawn as iViews instances of each Instance.
+        m_pMesh->setInstanceDivisor(iViews);
+        if (m_pMesh->isChunked())
+            renderChunks(iInstances, iViews);
+        else if (iInstances > 0)
+        {
+            // The Shadow Map is seen from every player's view, so it's drawn from the full Mesh.
+            unsigned int iLod = m_pEntityManager->doShadowDraw() ? 0 : selectLod();
+            GLsizei iCount = m_bUsingIndices ? m_pMesh->getLodIndexCount(iLod) : m_pMesh->getCount();
+            if ((m_bUsingInstanced || iViews > 1) && m_bUsingIndices)
+                glDrawElementsInstanced(m_eMode, iCount, GL_UNSIGNED_INT, m_pMesh->getLodIndexOffset(iLod), iInstances * iViews);
+            else if (m_bUsingInstanced || iViews > 1)
+                glDrawArraysInstanced(m_eMode, m_pMesh->getFirstVertex(), iCount, iInstances * iViews);
+            else if (m_bUsingIndices)
+                glDrawElements(m_eMode, iCount, GL_UNSIGNED_INT, m_pMesh->getLodIndexOffset(iLod));
+            else
+                glDrawArrays(m_eMode, m_pMesh->getFirstVertex(), iCount);
+            m_pEntityManager->addDrawCall();
+
+            if (GL_TRIANGLES == m_eMode)
+                m_pEntityManager->addDrawnTriangles((iCount / 3) * iInstances * iViews);
+        }
         CheckGLErrors();
 
         if (!m_pEntityManager->doShadowDraw())
@@ -68,9 +130,9 @@ void RenderComponent::render()
             if (m_pEntityManager->doBoundingBoxDrawing() && m_pMesh->usingBoundingBox())
             {
                 // Bind the Bounding Box Vertex Array and use the Bounding Box Shader
-                glBindVertexArray(m_pMesh->getBBVertexArray());
-                glUseProgram(m_pShdrMngr->getProgram(ShaderManager::eShaderType::DEBUG_SHDR));
-                m_pShdrMngr->setUniformVec4(ShaderManager::eShaderType::DEBUG_SHDR, "vColor", &BOUNDING_BOX_COLOR);
+                pRenderQueue->bindVertexArray(m_pMesh->getBBVertexArray());
+                pRenderQueue->useProgram(m_pShdrMngr->getProgram(ShaderManager::eShaderType::DEBUG_SHDR));
+                m_pShdrMngr->setUniformVec4(ShaderManager::eShaderType::DEBUG_SHDR, ShaderManager::DEBUG_COLOR, &BOUNDING_BOX_COLOR);
 
                 // Draw Bounding Box
                 glDrawElementsInstanced(GL_LINES, m_pMesh->getBBCount(), GL_UNSIGNED_INT, nullptr, m_pMesh->getNumInstances());
@@ -79,6 +141,82 @@ void RenderComponent::render()
     }
 }
 
+/*
+    Pick the Level of Detail for the current view from how large the nearest
+    Instance of the Mesh appears in it. One level is drawn for all Instances so
+    they stay a single instanced draw; views drawn together share the level of
+    the camera it appears largest to.
+    The level only moves once the size is past a threshold by the hysteresis
+    margin; the level of each view is kept for the next frame.
+*/
+unsigned int RenderComponent::selectLod()
+{
+    unsigned int iView = m_pEntityManager->getCurrentView();
+    unsigned int iLodCount = m_pMesh->getLodCount();
+    unsigned int iLod = std::min(m_iLodLevels[iView], iLodCount - 1);
+    if (iLodCount < 2)
+        return 0;
+
+    float fSize = 0.0f;
+    for (unsigned int iCamera = 0; iCamera < m_pEntityManager->getViewCount(); ++iCamera)
+        fSize = std::max(fSize, m_pMesh->getLargestProjectedSize(&m_pEntityManager->getViewPosition(iCamera), m_pEntityManager->getViewPixelScale(iCamera)));
+    while ((iLod + 1) < iLodCount && fSize < (LOD_SCREEN_SIZES[iLod] * (1.0f - LOD_HYSTERESIS)))
+        ++iLod;
+    while (iLod > 0 && fSize > (LOD_SCREEN_SIZES[iLod - 1] * (1.0f + LOD_HYSTERESIS)))
+        --iLod;
+
+    m_iLodLevels[iView] = iLod;
+    return iLod;
+}
+
+/*
+    Draw each Terrain Chunk that's in the frustum of the current view at a level
+    of detail picked from its distance to the viewer. Chunks are small enough
+    that a draw per chunk costs less than drawing the terrain out of view.
+    Views drawn together draw the chunks any of them sees, at the level of the
+    nearest camera. The shadow pass draws every chunk at full detail.
+*/
+void RenderComponent::renderChunks(GLsizei iInstances, GLsizei iViews)
+{
+    bool bShadowDraw = m_pEntityManager->doShadowDraw();
+    float fFullDetailDistance = m_pMesh->getChunkSize() * TERRAIN_LOD_DISTANCE;
+    float fDistance = 0.0f, fCameraDistance = 0.0f;
+
+    for (unsigned int iChunk = 0; iChunk < m_pMesh->getChunkCount(); ++iChunk)
+    {
+        unsigned int iLod = 0;
+        if (!bShadowDraw)
+        {
+            bool bVisible = false;
+            fDistance = FLT_MAX;
+            for (GLsizei iCamera = 0; iCamera < iViews; ++iCamera)
+            {
+                if (m_pMesh->getChunkVisibility(iChunk, &m_pEntityManager->getViewFrusta()[iCamera],
+                                                &m_pEntityManager->getViewPosition(iCamera), &fCameraDistance))
+                {
+                    bVisible = true;
+                    fDistance = std::min(fDistance, fCameraDistance);
+                }
+            }
+            if (!bVisible)
+                continue;
+
+            for (float fThreshold = fFullDetailDistance; (iLod + 1) < TERRAIN_LOD_LEVELS && fDistance > fThreshold; fThreshold *= 2.0f)
+                ++iLod;
+        }
+
+        GLsizei iCount = m_pMesh->getChunkIndexCount(iChunk, iLod);
+        if (m_bUsingInstanced || iViews > 1)
+            glDrawElementsInstanced(m_eMode, iCount, GL_UNSIGNED_INT, m_pMesh->getChunkIndexOffset(iChunk, iLod), iInstances * iViews);
+        else
+            glDrawElements(m_eMode, iCount, GL_UNSIGNED_INT, m_pMesh->getChunkIndexOffset(iChunk, iLod));
+        m_pEntityManager->addDrawCall();
+
+        if (GL_TRIANGLES == m_eMode)
+            m_pEntityManager->addDrawnTriangles((iCount / 3) * iInstances * iViews);
+    }
+}
+
 // Overloaded Update Function
 void RenderComponent::update(float fTimeInSeconds)
 {
@@ -15,12 +15,16 @@
 #include "EntityHeaders/DirectionalLight.h"
 #include "EntityHeaders/SpotLight.h"
 #include "SoundManager.h"
+#include "GameStats.h"
+#include "DataStructures/WorldSnapshot.h"
 
 /***********\
  * Defines *
 \***********/
 #define DEFAULT_HXW 1024
-#define FRAMERATE sixtieth_of_a_sec{ 1 }
+#define DEFAULT_SIMULATION_RATE         60  // Steps per second
+// Steps to catch up on before the simulation gives up on real time (slow down rather than spiral)
+#define MAX_SIMULATION_STEPS_PER_FRAME  5
 
 /*************\
  * Constants *
@@ -78,6 +82,9 @@ const GLfloat DEPTH_ZERO = 1.0f;
 
 // Initialize Static Instance Variable
 EntityManager* EntityManager::m_pInstance = nullptr;
+bool EntityManager::m_bStaticShadowCacheEnabled = true;
+bool EntityManager::m_bMultiViewEnabled = true;
+bool EntityManager::m_bOcclusionCullingEnabled = true;
 
 // Default Constructor
 EntityManager::EntityManager()
@@ -85,6 +92,25 @@ EntityManager::EntityManager()
     // Initialize ID Pools
     m_iComponentIDPool = m_iEntityIDPool = 0;
     m_fGameTime = seconds(0);
+    setSimulationRate(DEFAULT_SIMULATION_RATE);
+    m_iLastFrameSimulationSteps = 0;
+    m_iCurrentView = 0;
+    m_iViewCount = 1;
+    mat4 m4Identity = mat4(1.0f);
+    for (unsigned int i = 0; i < MAX_PLAYER_COUNT; ++i)
+    {
+        m_pViewPositions[i] = vec3(0.0f);
+        m_pViewPixelScales[i] = 1.0f;
+        m_pViewFrusta[i].setViewProjection(&m4Identity);
+        m_pViewCells[i] = -1;
+    }
+    m_iScreenCount = 0;
+    m_bViewsDrawnTogether = false;
+    m_iFrameTriangles = m_iLastFrameTriangles = 0;
+    memset(m_iViewDrawCalls, 0, sizeof(m_iViewDrawCalls));
+    memset(m_iLastViewDrawCalls, 0, sizeof(m_iLastViewDrawCalls));
+    memset(m_iViewCulledInstances, 0, sizeof(m_iViewCulledInstances));
+    memset(m_iLastViewCulledInstances, 0, sizeof(m_iLastViewCulledInstances));
 
     // Initialize Local Variables
     m_iHeight = m_iWidth = DEFAULT_HXW;
@@ -92,6 +118,9 @@ EntityManager::EntityManager()
     m_bDrawBoundingBoxes = false;
     m_bDrawSpatialMap    = false;
     m_bShadowDraw        = false;
+    m_eShadowCasters     = ALL_SHADOW_CASTERS;
+    m_bStaticShadowsValid = false;
+    m_iStaticShadowRevision = m_iStaticShadowRedraws = 0;
     m_bUseDebugCamera    = false;
     m_pCubeMapTexture    = nullptr;
     m_pMshMngr           = MESH_MANAGER;
@@ -161,6 +190,7 @@ void EntityManager::initializeEnvironment(string sFileName)
     SceneLoader* pObjFctry = SceneLoader::getInstance();
 
     purgeEnvironment();
+    m_fGameTime = seconds(0);
     pObjFctry->loadFromFile(sFileName);
     // Generate Debug Camera
     m_pCamera = generateCameraEntity();
@@ -213,6 +243,7 @@ void EntityManager::purgeEnvironment()
     m_pMshMngr->unloadAllMeshes();
     m_pPhysxMngr->cleanupPhysics(); // Clean up current Physics Scene
     m_pDirectionalLight = nullptr;
+    m_bStaticShadowsValid = false;
     m_pActiveCameraComponent = nullptr;
 }
 
@@ -232,22 +263,34 @@ void EntityManager::setupRender()
     // Local Variables
     LightingComponent* pDirectionalLightComponent = nullptr;
 
+    // A new frame begins
+    m_iLastFrameTriangles = m_iFrameTriangles;
+    m_iFrameTriangles = 0;
+    memcpy(m_iLastViewDrawCalls, m_iViewDrawCalls, sizeof(m_iViewDrawCalls));
+    memset(m_iViewDrawCalls, 0, sizeof(m_iViewDrawCalls));
+    memcpy(m_iLastViewCulledInstances, m_iViewCulledInstances, sizeof(m_iViewCulledInstances));
+    memset(m_iViewCulledInstances, 0, sizeof(m_iViewCulledInstances));
+    m_sRenderQueue.beginFrame();
+    m_bViewsDrawnTogether = false;
+
+    // Upload all Mesh Instances, Billboards and Particles changed this frame before the first draw.
+    m_pMshMngr->uploadStreams();
+    m_pEmtrEngn->uploadEmitters();
+
     // Get Directional Light
     if (nullptr != m_pDirectionalLight)
     {
         pDirectionalLightComponent = m_pDirectionalLight->getLightingComponent();
-        pDirectionalLightComponent->setupShadowFBO();       // Set up Frame Buffer for Shadow
-        pDirectionalLightComponent->setupPMVMatrices();     // Set the Lighting ModelView and Projection Matrices for generating a Depth Buffer from Light Position
-        m_bShadowDraw = true;                               // Render For Shadow Map
-        glCullFace(GL_FRONT);
-        doRender();                                         // Do the Render
-        glCullFace(GL_BACK);
+        renderShadows(pDirectionalLightComponent);
         pDirectionalLightComponent->setupShadowUniforms();  // Set the Shadow Map in the Shaders.
         resetFBO();                                         // Reset the Frame Buffer for typical rendering.
     }
 
     // Calculate information for each Light in the scene
     m_pShdrMngr->setLightsInUniformBuffer(pDirectionalLightComponent, &m_pLights);
+
+    // The cameras of all screens, along with the Light Clusters they see
+    setupScreenCameras();
 }
 
 // Name: renderEnvironment
@@ -257,14 +300,101 @@ void EntityManager::setupRender()
 // TODO: Have Lighting load based on Spatial Data Structure
 void EntityManager::renderEnvironment(unsigned int iPlayer)
 {    
-    // Perform Final Render
-    glClearBufferfv(GL_COLOR, 0, color);
-    glClearBufferfv(GL_DEPTH, 0, &DEPTH_ZERO);
+    // Perform Final Render, on top of the screen drawn by renderViewsTogether if it was.
+    if (!m_bViewsDrawnTogether)
+    {
+        glClearBufferfv(GL_COLOR, 0, color);
+        glClearBufferfv(GL_DEPTH, 0, &DEPTH_ZERO);
+    }
     setCameraPMVMatrices(iPlayer);
     doRender();
     renderSkyBox();
 }
 
+// The screens can be drawn together if there's more than one and the shaders can pick the layer they draw to.
+//  The Bounding Boxes are drawn with the Render Components, but only for a single view.
+bool EntityManager::canRenderViewsTogether() const
+{
+    return m_bMultiViewEnabled && m_iScreenCount > 1 && !m_bDrawBoundingBoxes && ShaderManager::supportsLayeredViews();
+}
+
+/*
+    Cull and draw the opaque Render Components once for all screens, into the
+    layered Frame Buffer bound by the caller. Their shaders draw each Instance
+    once per screen, into the layer of the screen (see the Views block of the
+    shaders), so the screens share the traversal, culling, sorting and state
+    changes. Blended Render Components, Emitters and the Skybox are still
+    drawn per screen by renderEnvironment.
+*/
+void EntityManager::renderViewsTogether()
+{
+    assert(canRenderViewsTogether());
+
+    // Clears every layer
+    glClearBufferfv(GL_COLOR, 0, color);
+    glClearBufferfv(GL_DEPTH, 0, &DEPTH_ZERO);
+
+    m_iCurrentView = MULTI_VIEW;
+    m_iViewCount = m_iScreenCount;
+    for (unsigned int i = 0; i < m_iScreenCount; ++i)
+        setViewCamera(i, &m_pScreenProjections[i], &m_pScreenModelViews[i]);
+    m_pShdrMngr->setViewMatrices(m_pScreenProjections, m_pScreenModelViews, m_iScreenCount, 0);
+
+    for (unordered_map<Mesh const*, RenderComponent*>::iterator pIter = m_pRenderingComponents.begin();
+        pIter != m_pRenderingComponents.end();
+        ++pIter)
+    {
+        if ((*pIter).second->canDrawViewsTogether())
+            (*pIter).second->enqueue(&m_sRenderQueue);
+    }
+    m_sRenderQueue.draw();
+
+    m_bViewsDrawnTogether = true;
+}
+
+/*
+    Render the Shadow Map of the Directional Light. With the static shadow cache,
+    the Static Meshes are drawn into the Static Shadow Map when they or the light
+    changed, and the Shadow Map of the frame starts from a copy of it so only the
+    moving casters (hovercrafts, rockets, pickups) are drawn.
+*/
+void EntityManager::renderShadows(LightingComponent* pDirectionalLightComponent)
+{
+    pDirectionalLightComponent->setupPMVMatrices();     // Set the Lighting ModelView and Projection Matrices for generating a Depth Buffer from Light Position
+    const mat4& m4LightSpace = pDirectionalLightComponent->getLightSpaceMatrix();
+    m_iCurrentView = SHADOW_VIEW;                       // Cull against what the light sees
+    m_iViewCount = 1;
+    m_pViewFrusta[0].setViewProjection(&m4LightSpace);
+    m_pViewCells[0] = -1;                               // The light sees over the arena
+    m_bShadowDraw = true;                               // Render For Shadow Map
+    glCullFace(GL_FRONT);
+
+    if (m_bStaticShadowCacheEnabled)
+    {
+        if (!m_bStaticShadowsValid || Mesh::getStaticInstanceRevision() != m_iStaticShadowRevision || m4LightSpace != m_m4StaticShadowLightSpace)
+        {
+            pDirectionalLightComponent->setupStaticShadowFBO();
+            m_eShadowCasters = STATIC_SHADOW_CASTERS;
+            doRender();
+            m_bStaticShadowsValid = true;
+            m_iStaticShadowRevision = Mesh::getStaticInstanceRevision();
+            m_m4StaticShadowLightSpace = m4LightSpace;
+            ++m_iStaticShadowRedraws;
+        }
+        pDirectionalLightComponent->setupShadowFBO(true);
+        m_eShadowCasters = DYNAMIC_SHADOW_CASTERS;
+    }
+    else
+    {
+        pDirectionalLightComponent->setupShadowFBO();
+        m_eShadowCasters = ALL_SHADOW_CASTERS;
+    }
+    doRender();
+
+    glCullFace(GL_BACK);
+    m_eShadowCasters = ALL_SHADOW_CASTERS;
+}
+
 // Renders the Skybox
 void EntityManager::renderSkyBox()
 {
@@ -292,14 +422,23 @@ void EntityManager::renderSkyBox()
 // Performs Rendering of scene
 void EntityManager::doRender()
 {
-    // Render all render components
+    // Render all render components, sorted by the state they draw with
     for (unordered_map<Mesh const*, RenderComponent*>::iterator pIter = m_pRenderingComponents.begin();
         pIter != m_pRenderingComponents.end();
         ++pIter)
     {
-        if (!m_bShadowDraw || (*pIter).second->castsShadows())     // Render depending on Shadow Settings of the current render and the render component
-            (*pIter).second->render();
+        // Skip what renderViewsTogether drew already
+        if (m_bViewsDrawnTogether && !m_bShadowDraw && (*pIter).second->canDrawViewsTogether())
+            continue;
+
+        // Render depending on Shadow Settings of the current render and the render component
+        bool bStaticCaster = (*pIter).first->isStaticMesh();
+        if (!m_bShadowDraw ||
+            ((*pIter).second->castsShadows() &&
+             (ALL_SHADOW_CASTERS == m_eShadowCasters || (STATIC_SHADOW_CASTERS == m_eShadowCasters) == bStaticCaster)))
+            (*pIter).second->enqueue(&m_sRenderQueue);
     }
+    m_sRenderQueue.draw();
 
     // Don't render these if only doing a shadow pass
     if (!m_bShadowDraw)
@@ -340,34 +479,63 @@ void EntityManager::renderAxis()
     glPointSize(1.f);
 }
 
-// Sets the Camera Projection, Model and View Matrices from the active camera.
+// Sets the Camera Projection, Model and View Matrices of a screen.
 void EntityManager::setCameraPMVMatrices(unsigned int iPlayer)
 {
     // Ensure a valid player has been specified.
-    assert(iPlayer < m_pPlayerEntityList.size());
+    assert(iPlayer < m_iScreenCount);
+    const mat4* pProjectionMatrix = &m_pScreenProjections[iPlayer];
+    const mat4* pModelViewMatrix = &m_pScreenModelViews[iPlayer];
+
+    // Store the view for Level of Detail selection
+    m_iCurrentView = iPlayer;
+    m_iViewCount = 1;
+    setViewCamera(0, pProjectionMatrix, pModelViewMatrix);
+
+    // Set camera information in Shaders before rendering
+    m_pShdrMngr->setProjectionModelViewMatrix(pProjectionMatrix, pModelViewMatrix);
+    m_pShdrMngr->setViewMatrices(pProjectionMatrix, pModelViewMatrix, 1, iPlayer);
+}
 
-    // Get proper camera to show
+// Gets the camera of every screen from the active cameras and builds the Light Clusters of all of them at once.
+void EntityManager::setupScreenCameras()
+{
+    m_iScreenCount = std::min(static_cast<unsigned int>(m_pPlayerEntityList.size()), static_cast<unsigned int>(MAX_PLAYER_COUNT));
+    for (unsigned int iPlayer = 0; iPlayer < m_iScreenCount; ++iPlayer)
+    {
+        // Get proper camera to show
 #ifdef _DEBUG
-    // Set Debug Camera to follow player. Copy the Rotation Quaternion to the Camera which will rotate the camera using the same quaternion before
-    //  translating the camera to world coordinates. TODO: Re-evaluate this methodology.
-    m_pCamera->setLookAt(m_pPlayerEntityList[iPlayer]->getCameraPosition());
-    quat pQuat = m_pPlayerEntityList[iPlayer]->getCameraRotation();
-    m_pCamera->setRotationQuat(pQuat);
-
-    // Determine if using Debug Camera or Player Camera
-    const CameraComponent* pCamera = m_bUseDebugCamera ?
-        m_pCamera->getCameraComponent() : m_pPlayerEntityList[iPlayer]->getActiveCameraComponent();
+        // Set Debug Camera to follow player. Copy the Rotation Quaternion to the Camera which will rotate the camera using the same quaternion before
+        //  translating the camera to world coordinates. TODO: Re-evaluate this methodology.
+        m_pCamera->setLookAt(m_pPlayerEntityList[iPlayer]->getCameraPosition());
+        quat pQuat = m_pPlayerEntityList[iPlayer]->getCameraRotation();
+        m_pCamera->setRotationQuat(pQuat);
+
+        // Determine if using Debug Camera or Player Camera
+        const CameraComponent* pCamera = m_bUseDebugCamera ?
+            m_pCamera->getCameraComponent() : m_pPlayerEntityList[iPlayer]->getActiveCameraComponent();
 #else
-    // Get Player Camera Component
-    const CameraComponent* pCamera = m_pPlayerEntityList[iPlayer]->getActiveCameraComponent();
+        // Get Player Camera Component
+        const CameraComponent* pCamera = m_pPlayerEntityList[iPlayer]->getActiveCameraComponent();
 #endif
 
-    // Get Model View and Projection Matrices
-    mat4 pModelViewMatrix = pCamera->getToCameraMat();
-    mat4 pProjectionMatrix = pCamera->getPerspectiveMat();
+        // Get Model View and Projection Matrices
+        m_pScreenModelViews[iPlayer] = pCamera->getToCameraMat();
+        m_pScreenProjections[iPlayer] = pCamera->getPerspectiveMat();
+    }
 
-    // Set camera information in Shaders before rendering
-    m_pShdrMngr->setProjectionModelViewMatrix(&pProjectionMatrix, &pModelViewMatrix);
+    if (m_iScreenCount > 0)
+        m_pShdrMngr->setLightClusters(m_pScreenProjections, m_pScreenModelViews, m_iScreenCount, m_iWidth, m_iHeight);
+}
+
+// Stores a camera of the views drawn for culling and Level of Detail selection.
+void EntityManager::setViewCamera(unsigned int iCamera, const mat4* pProjectionMatrix, const mat4* pModelViewMatrix)
+{
+    m_pViewPositions[iCamera] = vec3(inverse(*pModelViewMatrix)[3]);
+    m_pViewPixelScales[iCamera] = (*pProjectionMatrix)[1][1] * m_iHeight * 0.5f;
+    mat4 m4ViewProjection = *pProjectionMatrix * *pModelViewMatrix;
+    m_pViewFrusta[iCamera].setViewProjection(&m4ViewProjection);
+    m_pViewCells[iCamera] = m_bOcclusionCullingEnabled ? m_pSpatialMap->getVisibilityCell(&m_pViewPositions[iCamera]) : -1;
 }
 
 /*********************************************************************************\
@@ -645,48 +813,199 @@ void EntityManager::updateWidthAndHeight(int iWidth, int iHeight)
 // Main Update Function
 // This function checks the timer and updates necessary components
 //    in the game world. No rendering is done here.
+// The environment is stepped at a fixed rate: the frame time is accumulated
+//    and as many whole steps as fit are simulated. The remainder carries over
+//    to the next frame and is used to draw everything between the last two steps.
 void EntityManager::updateEnvironment(std::chrono::duration<double> fSecondsSinceLastFrame)
 {
+    float fStep = m_fSimulationStep.count();
     m_fGameTime += fSecondsSinceLastFrame;
-    constexpr auto pMaxDeltaTime = FRAMERATE;
-    float fDeltaTime = 0.0f;
+    m_iLastFrameSimulationSteps = 0;
+
+    while (m_fGameTime >= m_fSimulationStep)
+    {
+        // Too far behind to catch up (e.g. a long load or a breakpoint):
+        //    drop the whole steps that are left rather than stalling every frame after.
+        if (MAX_SIMULATION_STEPS_PER_FRAME == m_iLastFrameSimulationSteps)
+        {
+            m_fGameTime = duration<float>(fmod(m_fGameTime.count(), fStep));
+            break;
+        }
+
+        stepEnvironment(fStep);
+        m_fGameTime -= m_fSimulationStep;
+        ++m_iLastFrameSimulationSteps;
+    }
+
+    interpolateEnvironment(m_fGameTime.count() / fStep);
+}
 
-   // These updates occur faster than the frame rate.
-   // If there are updates that don't need to be updated more than once per
-   // frame, update them externally in GameMenu::renderGraphics()
-    while (m_fGameTime > seconds{ 0 })
+/*
+    Set how many times per second the environment is simulated. This is
+    independent of the frame rate.
+
+    @param iStepsPerSecond  simulation rate
+*/
+void EntityManager::setSimulationRate(unsigned int iStepsPerSecond)
+{
+    m_fSimulationStep = duration<float>(1.0f / static_cast<float>(std::max(iStepsPerSecond, 1u)));
+}
+
+/*
+    Simulate a single fixed step of the environment.
+
+    @param fTimeInSeconds   duration of the step
+*/
+void EntityManager::stepEnvironment(float fTimeInSeconds)
+{
+    m_pPhysxMngr->update(fTimeInSeconds);
+    m_pEmtrEngn->update(fTimeInSeconds);
+
+    for (vector<PhysicsComponent*>::iterator iter = m_pPhysicsComponents.begin();
+        iter != m_pPhysicsComponents.end();
+        ++iter)
+        (*iter)->update(fTimeInSeconds);
+
+    // Iterate through all Entities and call their update with the current time.
+    for (unordered_map<int, unique_ptr<Entity>>::iterator iter = m_pMasterEntityList.begin();
+        iter != m_pMasterEntityList.end();
+        ++iter)
+        iter->second->update(fTimeInSeconds);
+
+    // Iteratre through all Animation Components to update their animations
+    for (vector<AnimationComponent*>::iterator iter = m_pAnimationComponents.begin();
+        iter != m_pAnimationComponents.end();
+        ++iter)
+        (*iter)->update(fTimeInSeconds);
+}
+
+/*
+    Draw every entity between the last two simulation steps.
+
+    @param fAlpha   fraction of a step that has passed since the last step
+*/
+void EntityManager::interpolateEnvironment(float fAlpha)
+{
+    // Short-lived lights follow what's drawn, so they're queued again.
+    LightClusters* pLightClusters = m_pShdrMngr->getLightClusters();
+    pLightClusters->clearQueuedLights();
+    m_pEmtrEngn->queueExplosionLights(pLightClusters);
+
+    for (unordered_map<int, unique_ptr<Entity>>::iterator iter = m_pMasterEntityList.begin();
+        iter != m_pMasterEntityList.end();
+        ++iter)
+        iter->second->interpolate(fAlpha);
+}
+
+/*********************************************************************************\
+* World Snapshots                                                                *
+\*********************************************************************************/
+
+/*
+    Capture the state of the current match into a snapshot: the random number
+    generator, update timers, every hovercraft (including their rockets and
+    flames) and the GameStats tables.
+    The snapshot keeps its buffer between captures so this can be called every
+    frame.
+
+    @param pSnapshot    to capture into
+*/
+void EntityManager::captureSnapshot(WorldSnapshot* pSnapshot) const
+{
+    pSnapshot->beginWrite();
+
+    // Timing and Random State
+    pSnapshot->write(FuncUtils::getRandomGenerator());
+    pSnapshot->write(m_fGameTime.count());
+
+    // Hovercrafts
+    pSnapshot->write(static_cast<unsigned int>(m_pPlayerEntityList.size()));
+    pSnapshot->write(static_cast<unsigned int>(m_pBotEntityList.size()));
+    for (vector<HovercraftEntity*>::const_iterator pIter = m_pPlayerEntityList.begin();
+        pIter != m_pPlayerEntityList.end();
+        ++pIter)
+        (*pIter)->writeSnapshot(pSnapshot);
+    for (vector<HovercraftEntity*>::const_iterator pIter = m_pBotEntityList.begin();
+        pIter != m_pBotEntityList.end();
+        ++pIter)
+        (*pIter)->writeSnapshot(pSnapshot);
+
+    // Stats
+    GAME_STATS->writeSnapshot(pSnapshot);
+
+    pSnapshot->endWrite();
+}
+
+/*
+    Restore the state of the current match from a snapshot captured by
+    captureSnapshot(). The snapshot must have been captured in the same match.
+
+    @param pSnapshot    to restore from
+    @return true if the snapshot was restored successfully
+*/
+bool EntityManager::restoreSnapshot(WorldSnapshot* pSnapshot)
+{
+    mt19937 pRandomGenerator;
+    float fGameTime;
+    unsigned int iPlayerCount, iBotCount;
+
+    if (!(pSnapshot->beginRead() &&
+          pSnapshot->read(&pRandomGenerator) &&
+          pSnapshot->read(&fGameTime) &&
+          pSnapshot->read(&iPlayerCount) &&
+          pSnapshot->read(&iBotCount)))
+        return false;
+
+    if (iPlayerCount != m_pPlayerEntityList.size() || iBotCount != m_pBotEntityList.size())
     {
-        // Get the Delta of this time step <= 1/60th of a second (60 fps)
-        // Interpolate on steps < 1/60th of a second
-        duration<float> pDeltaTime =
-            std::min<common_type<decltype(m_fGameTime), decltype(pMaxDeltaTime)>::type>(m_fGameTime, pMaxDeltaTime);
-
-        m_fGameTime -= pDeltaTime;
-        fDeltaTime = static_cast<float>(pDeltaTime.count());
-        
-        // UPDATES GO HERE
-        m_pPhysxMngr->update(fDeltaTime); // PHYSICSTODO: This is where the Physics Update is called.
-        m_pEmtrEngn->update(fDeltaTime);
-
-        for (vector<PhysicsComponent*>::iterator iter = m_pPhysicsComponents.begin();
-            iter != m_pPhysicsComponents.end();
-            ++iter)
-            (*iter)->update(fDeltaTime);
-
-        // Iterate through all Entities and call their update with the current time.
-        for (unordered_map<int, unique_ptr<Entity>>::iterator iter = m_pMasterEntityList.begin();
-            iter != m_pMasterEntityList.end();
-            ++iter)
-            iter->second->update(fDeltaTime);
-
-        // Iteratre through all Animation Components to update their animations
-        for (vector<AnimationComponent*>::iterator iter = m_pAnimationComponents.begin();
-            iter != m_pAnimationComponents.end();
-            ++iter)
-            (*iter)->update(fDeltaTime);
+        cout << "EntityManager::restoreSnapshot(): snapshot is from a different match." << endl;
+        return false;
     }
+
+    FuncUtils::setRandomGenerator(pRandomGenerator);
+    m_fGameTime = duration<float>(fGameTime);
+
+    bool bSuccess = true;
+    for (vector<HovercraftEntity*>::iterator pIter = m_pPlayerEntityList.begin();
+        bSuccess && pIter != m_pPlayerEntityList.end();
+        ++pIter)
+        bSuccess = (*pIter)->readSnapshot(pSnapshot);
+    for (vector<HovercraftEntity*>::iterator pIter = m_pBotEntityList.begin();
+        bSuccess && pIter != m_pBotEntityList.end();
+        ++pIter)
+        bSuccess = (*pIter)->readSnapshot(pSnapshot);
+
+    bSuccess = bSuccess && GAME_STATS->readSnapshot(pSnapshot);
+
+    if (!bSuccess)
+        cout << "EntityManager::restoreSnapshot(): snapshot is incomplete, match may be partially restored." << endl;
+
+    return bSuccess;
 }
 
+#ifndef NDEBUG
+// Quick save the current match and report how long the capture took.
+void EntityManager::debugCaptureSnapshot()
+{
+    if (nullptr == m_pDebugSnapshot)
+        m_pDebugSnapshot = make_unique<WorldSnapshot>();
+
+    time_point<high_resolution_clock> pStart = high_resolution_clock::now();
+    captureSnapshot(m_pDebugSnapshot.get());
+    duration<double, micro> fCaptureTime = high_resolution_clock::now() - pStart;
+
+    cout << "Snapshot captured: " << m_pDebugSnapshot->getSize() << " bytes in "
+         << fCaptureTime.count() << " us" << endl;
+}
+
+// Quick load the last quick saved match.
+void EntityManager::debugRestoreSnapshot()
+{
+    if (nullptr != m_pDebugSnapshot && restoreSnapshot(m_pDebugSnapshot.get()))
+        cout << "Snapshot restored." << endl;
+}
+#endif
+
 /*********************************************************************************\
 * Entity Component Management                                                    *
 \*********************************************************************************/
@@ -0,0 +1,175 @@
+#include "FramePacer.h"
+#include <thread>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+/*************\
+ * Constants *
+\*************/
+const unsigned int TARGET_RATES[FramePacer::TARGET_RATE_COUNT] = { 30, 60, 120, 0 };
+const char* TARGET_RATE_NAMES[FramePacer::TARGET_RATE_COUNT] = { "30", "60", "120", "uncapped" };
+const float HISTOGRAM_BOUNDS[FramePacer::HISTOGRAM_BUCKETS - 1] = { 5.0f, 9.0f, 15.0f, 18.0f, 25.0f, 35.0f, 50.0f };
+
+// The spin margin stays within these bounds (microseconds)
+#define MIN_SPIN_MARGIN         250
+#define MAX_SPIN_MARGIN         2000
+#define INITIAL_SPIN_MARGIN     1000
+// The margin shrinks by 1/SPIN_MARGIN_DECAY of its distance to the last oversleep each frame
+#define SPIN_MARGIN_DECAY       16
+
+// Static Initialization
+FramePacer::eTargetRate FramePacer::m_eTargetRate = FramePacer::RATE_60;
+bool FramePacer::m_bVSyncEnabled = false;
+
+// Default Constructor
+FramePacer::FramePacer()
+{
+    m_bPacing = false;
+    m_bTimerPeriodSet = false;
+    m_pFramePeriod = steady_clock::duration::zero();
+    m_pSpinMargin = microseconds(INITIAL_SPIN_MARGIN);
+    m_pNextFrame = m_pLastFrameStart = steady_clock::now();
+    resetTotals();
+}
+
+// Destructor
+FramePacer::~FramePacer()
+{
+#ifdef _WIN32
+    if (m_bTimerPeriodSet)
+        timeEndPeriod(1);
+#endif
+}
+
+/*
+    Without vsync, the swap interval is 0 so the swap never waits and the
+    pacer sleeps to the target rate. With vsync, the swap waits for as many
+    refreshes as fit in a frame of the target rate (at least one) and the
+    pacer only records the frame times.
+*/
+void FramePacer::initialize()
+{
+    unsigned int iTargetRate = TARGET_RATES[m_eTargetRate];
+
+    if (m_bVSyncEnabled)
+    {
+        GLFWmonitor* pMonitor = glfwGetPrimaryMonitor();
+        const GLFWvidmode* pMode = nullptr != pMonitor ? glfwGetVideoMode(pMonitor) : nullptr;
+        int iSwapInterval = 1;
+        if (0 != iTargetRate && nullptr != pMode && pMode->refreshRate > 0)
+            iSwapInterval = std::max(1, static_cast<int>(std::round(static_cast<float>(pMode->refreshRate) / iTargetRate)));
+        glfwSwapInterval(iSwapInterval);
+    }
+    else
+        glfwSwapInterval(0);
+
+    m_bPacing = !m_bVSyncEnabled && 0 != iTargetRate;
+    if (m_bPacing)
+        m_pFramePeriod = duration_cast<steady_clock::duration>(duration<double>(1.0 / iTargetRate));
+
+#ifdef _WIN32
+    // The default timer resolution of Windows (15.6 ms) is longer than a frame.
+    if (m_bPacing && !m_bTimerPeriodSet)
+        m_bTimerPeriodSet = (TIMERR_NOERROR == timeBeginPeriod(1));
+#endif
+
+    m_pNextFrame = m_pLastFrameStart = steady_clock::now();
+    resetTotals();
+}
+
+/*
+    The deadlines follow each other by exactly one frame period so the rate
+    doesn't drift with the time spent waking up. A frame that ran over its
+    deadline starts the next one right away, and the schedule restarts from
+    there instead of rushing frames out to catch up.
+*/
+void FramePacer::waitForNextFrame()
+{
+    if (m_bPacing)
+    {
+        m_pNextFrame += m_pFramePeriod;
+        steady_clock::time_point pNow = steady_clock::now();
+
+        if (m_pNextFrame <= pNow)
+            m_pNextFrame = pNow;
+        else
+        {
+            // Sleep until the spin margin, then follow how late the sleep woke up.
+            steady_clock::time_point pWakeUp = m_pNextFrame - m_pSpinMargin;
+            if (pWakeUp > pNow)
+            {
+                this_thread::sleep_until(pWakeUp);
+                steady_clock::time_point pAwake = steady_clock::now();
+                steady_clock::duration pOversleep = pAwake - pWakeUp;
+
+                if (pOversleep > m_pSpinMargin)
+                    m_pSpinMargin = pOversleep;
+                else
+                    m_pSpinMargin -= (m_pSpinMargin - pOversleep) / SPIN_MARGIN_DECAY;
+                m_pSpinMargin = std::min(std::max(m_pSpinMargin, steady_clock::duration(microseconds(MIN_SPIN_MARGIN))),
+                                         steady_clock::duration(microseconds(MAX_SPIN_MARGIN)));
+
+                m_fSleepMilliseconds += duration<double, milli>(pAwake - pNow).count();
+                pNow = pAwake;
+            }
+
+            // Spin for the rest
+            steady_clock::time_point pSpinStart = pNow;
+            while (pNow < m_pNextFrame)
+                pNow = steady_clock::now();
+            m_fSpinMilliseconds += duration<double, milli>(pNow - pSpinStart).count();
+        }
+    }
+
+    recordFrame(steady_clock::now());
+}
+
+// Sort the time since the last frame started into the histogram.
+void FramePacer::recordFrame(steady_clock::time_point pFrameStart)
+{
+    float fMilliseconds = duration<float, milli>(pFrameStart - m_pLastFrameStart).count();
+    unsigned int iBucket = 0;
+
+    while (iBucket < (HISTOGRAM_BUCKETS - 1) && fMilliseconds >= HISTOGRAM_BOUNDS[iBucket])
+        ++iBucket;
+
+    ++m_pHistogram[iBucket];
+    ++m_iFrames;
+    m_pLastFrameStart = pFrameStart;
+}
+
+void FramePacer::resetTotals()
+{
+    memset(m_pHistogram, 0, sizeof(m_pHistogram));
+    m_iFrames = 0;
+    m_fSleepMilliseconds = m_fSpinMilliseconds = 0.0;
+}
+
+// @return the upper bound of a histogram bucket in milliseconds, 0 for the last bucket
+float FramePacer::getHistogramBound(unsigned int iBucket)
+{
+    return iBucket < (HISTOGRAM_BUCKETS - 1) ? HISTOGRAM_BOUNDS[iBucket] : 0.0f;
+}
+
+const char* FramePacer::getTargetRateName(eTargetRate eRate)
+{
+    return TARGET_RATE_NAMES[eRate];
+}
+
+bool FramePacer::setTargetRate(const string& sRate)
+{
+    for (unsigned int i = 0; i < TARGET_RATE_COUNT; ++i)
+    {
+        if (sRate == TARGET_RATE_NAMES[i])
+        {
+            m_eTargetRate = static_cast<eTargetRate>(i);
+            return true;
+        }
+    }
+
+    cout << "Unknown frame rate \"" << sRate << "\", expected 30, 60, 120 or uncapped." << endl;
+    return false;
+}
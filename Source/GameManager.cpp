@@ -13,6 +13,8 @@
 #include "Menus/LoadingMenu.h"
 #include "TextureManager.h"
 #include "UserInterface/UserInterfaceManager.h"
+#include "InputHandler.h"
+#include "InputRecorder.h"
 
 // Unit: seconds
 #define GAME_OVER_TIME 0.0f
@@ -29,6 +31,17 @@
 // Blur
 #define BLUR_AMOUNT 10
 
+// Bloom Mip Chain: the first frame buffer texture number of its levels, and how much of
+//  an upsampled level is blended over the level above it in resolution.
+#define BLOOM_BUFFER_NUM        4
+#define BLOOM_UPSAMPLE_WEIGHT   0.6f
+#define BLOOM_BENCHMARK_FRAMES  100
+
+// Render Benchmark: the game it draws, with the cameras where the hovercrafts spawn
+#define RENDER_BENCHMARK_BOTS       4
+#define RENDER_BENCHMARK_GAME_TIME  180.0f
+#define RENDER_BENCHMARK_WARMUP     10
+
 /*************\
  * Constants *
 \*************/
@@ -46,6 +59,12 @@ const vec3 COLORS[MAX_HOVERCRAFT_COUNT]{
     vec3(1.0f)                                              // White
 };
 
+// Command line names of the bloom quality tiers, by eBloomQuality
+const char* BLOOM_QUALITY_NAMES[GameManager::BLOOM_QUALITY_COUNT] = { "gaussian", "low", "medium", "high" };
+
+// Names of the stages of drawScene in the render benchmark, by eRenderStage
+const char* RENDER_STAGE_NAMES[GameManager::RENDER_STAGE_COUNT] = { "setup", "views together", "screens", "bloom", "composite" };
+
 const vec4 BLUR_QUAD[4]{
     vec4(-1.0f, -1.0f, 0.0f, 0.0f), /*Bottom Left*/
     vec4(1.0f,  -1.0f, 1.0f, 0.0f), /*Bottom Right*/
@@ -55,6 +74,9 @@ const vec4 BLUR_QUAD[4]{
 
 // Singleton Variable initialization
 GameManager* GameManager::m_pInstance = nullptr;
+GameManager::eBloomQuality GameManager::m_eBloomQuality = GameManager::BLOOM_MEDIUM;
+bool GameManager::m_bHeadless = false;
+string GameManager::m_sFrameDumpFile = "";
 
 // Constructor - Private, only accessable within the Graphics Manager
 GameManager::GameManager(GLFWwindow* rWindow)
@@ -71,10 +93,6 @@ GameManager::GameManager(GLFWwindow* rWindow)
     m_pEntityManager->updateWidthAndHeight(m_iWidth, m_iHeight);
     m_pGameStats = nullptr;
 
-    // Initialize Timer Variables
-    m_fFrameTime = duration<float>(0.0f);
-    m_fMaxDeltaTime = sixtieth_of_a_sec{ 1 };
-
     m_eKeyboardHovercraft = HOVERCRAFT_PLAYER_1;
 
     m_pUserInterfaceManager = UI_MANAGER;
@@ -85,6 +103,8 @@ GameManager::GameManager(GLFWwindow* rWindow)
 
     m_pSoundManager = SOUND_MANAGER;
 
+    m_pInputRecorder = INPUT_RECORDER;
+
     // Generate VAO and VBO for rendering SplitScreen Quads
     glGenVertexArrays(1, &m_iVertexArray);
     m_iVertexBuffer = m_pShaderManager->genVertexBuffer(m_iVertexArray, nullptr, (sizeof(vec4) << 4), GL_STATIC_DRAW);
@@ -97,6 +117,25 @@ GameManager::GameManager(GLFWwindow* rWindow)
 
     // Generate VAO for rendering Map items
     glGenVertexArrays(1, &m_iMapVAO);
+
+    // The Multi-View Buffer is generated once the screens are drawn together
+    m_sMultiViewBuffer = { 0, 0, { 0, 0, 0 }, 0 };
+
+    // Without a visible window, the frames are drawn to a Frame Buffer of the window's size instead
+    m_iScreenFrameBuffer = 0;
+    m_pScreenRenderBuffers[0] = m_pScreenRenderBuffers[1] = 0;
+    if (m_bHeadless)
+        generateScreenFrameBuffer();
+
+    m_bTimeRenderStages = false;
+
+#ifndef NDEBUG
+    m_bReportFrameStats = false;
+    m_fFrameStatsTime = 0.0f;
+    m_iFrameStatsFrames = m_iFrameStatsHeapAllocations = m_iFrameStatsMaxHeapAllocations = 0;
+    m_fFrameStatsSubmitTime = 0.0;
+    m_iFrameStatsDrawnFrames = 0;
+#endif
 }
 
 /*
@@ -135,8 +174,15 @@ GameManager::~GameManager()
         glDeleteFramebuffers(1, &pRenderBlock.iFrameBuffer);
         for (sRenderBlock::sPingPongBuffer pBuffer : pRenderBlock.pPingPongBuffers)
             glDeleteFramebuffers(1, &pBuffer.iFBO);
+        glDeleteFramebuffers(1, &pRenderBlock.sBloomBuffer.iFBO);
     }
     m_pFrameBufferTextures.clear();
+    for (sRenderBlock::sPingPongBuffer pBuffer : m_pBloomMips)
+        glDeleteFramebuffers(1, &pBuffer.iFBO);
+    m_pBloomMips.clear();
+    deleteMultiViewBuffer();
+    glDeleteFramebuffers(1, &m_iScreenFrameBuffer);
+    glDeleteRenderbuffers(2, m_pScreenRenderBuffers);
 
     // Split Screen Clean Up
     glDeleteBuffers(1, &m_iVertexBuffer);
@@ -182,6 +228,7 @@ GameManager::~GameManager()
 void GameManager::startRendering()
 {
     m_pSoundManager->start();
+    m_pFramePacer.initialize();
     resetTime();
 
     while (renderGraphics());
@@ -196,7 +243,15 @@ void GameManager::startRendering()
 */
 bool GameManager::renderGraphics()
 {
+    // Hold the loop to the target frame rate, then reclaim all transient memory from the last frame.
+    m_pFramePacer.waitForNextFrame();
+    FRAME_ARENA->reset();
     updateTime();
+    updateInput();
+#ifndef NDEBUG
+    if (m_bReportFrameStats)
+        reportFrameStats();
+#endif
     // Execute all commands for this frame
     // These should be done before the EntityManager updates so that the
     // environment can respond to the commands issued this frame.
@@ -348,10 +403,117 @@ void GameManager::updateTime()
 {
     m_pTimer.updateTimeSinceLastFrame();
     m_fFrameDeltaTimePrecise = m_pTimer.getFrameTimeSinceLastFrame();
-    m_fFrameTime += m_fFrameDeltaTimePrecise;
     m_fFrameDeltaTime = static_cast<float>(m_fFrameDeltaTimePrecise.count());
 }
 
+/*
+    Poll the joysticks for this frame. If input is being recorded, the input
+    and frame time are logged. If a recording is being replayed, the input and
+    frame time of this frame are replaced with the recorded ones so the
+    session plays out exactly as it was recorded.
+*/
+void GameManager::updateInput()
+{
+    double fRecordedDeltaTime = 0.0;
+
+    if (m_pInputRecorder->isReplaying())
+    {
+        if (m_pInputRecorder->replayFrame(m_fFrameDeltaTimePrecise.count(), &fRecordedDeltaTime))
+        {
+            m_fFrameDeltaTimePrecise = duration<double>(fRecordedDeltaTime);
+            m_fFrameDeltaTime = static_cast<float>(fRecordedDeltaTime);
+        }
+        else    // Replay finished
+            flagWindowToClose();
+    }
+    else
+    {
+        INPUT_HANDLER->updateJoysticks();
+        if (m_pInputRecorder->isRecording())
+            m_pInputRecorder->recordFrame(m_fFrameDeltaTimePrecise.count());
+    }
+}
+
+#ifndef NDEBUG
+/*
+    Accumulate the statistics of the last frame and print them to the console
+    once a second.
+*/
+void GameManager::reportFrameStats()
+{
+    FrameArena* pFrameArena = FRAME_ARENA;
+    unsigned int iHeapAllocations = pFrameArena->getLastFrameHeapAllocations();
+
+    ++m_iFrameStatsFrames;
+    m_iFrameStatsHeapAllocations += iHeapAllocations;
+    m_iFrameStatsMaxHeapAllocations = std::max(m_iFrameStatsMaxHeapAllocations, iHeapAllocations);
+    m_fFrameStatsTime += m_fFrameDeltaTime;
+    m_sBloomTimer.collect();
+
+    if (m_fFrameStatsTime >= 1.0f)
+    {
+        cout << "[Frame Stats] fps: " << m_iFrameStatsFrames
+             << " | heap allocs/frame: " << (m_iFrameStatsHeapAllocations / m_iFrameStatsFrames)
+             << " (max " << m_iFrameStatsMaxHeapAllocations << ")"
+             << " | frame arena: " << pFrameArena->getLastFrameBytesUsed() << "/" << pFrameArena->getCapacity()
+             << " bytes (peak " << pFrameArena->getPeakBytesUsed() << ", overflows " << pFrameArena->getLastFrameOverflows() << ")"
+             << " | sim steps last frame: " << m_pEntityManager->getLastFrameSimulationSteps()
+             << " | triangles last frame: " << m_pEntityManager->getLastFrameTriangles()
+             << " | state changes: " << m_pEntityManager->getRenderQueue().getLastFrameStateChanges()
+             << " (" << m_pEntityManager->getRenderQueue().getLastFrameStateChangesAvoided() << " avoided)"
+             << " | stream stalls: " << StreamBuffer::getTotalStalls()
+             << (StreamBuffer::usePersistentMapping() ? " (persistent)" : " (orphaning)")
+             << " | GL submission: " << (m_fFrameStatsSubmitTime / std::max(m_iFrameStatsDrawnFrames, 1u)) << " ms/frame"
+             << (ShaderManager::useUniformCache() ? " (cached uniforms)" : " (uniform lookups)")
+             << endl;
+
+        // Draw calls and culled Instances of each viewport, then of the shadow pass
+        cout << "[Frame Stats] draw calls/culled instances:";
+        for (unsigned int iView = 0; iView < m_pFrameBufferTextures.size(); ++iView)
+            cout << " view " << iView << ": " << m_pEntityManager->getLastFrameDrawCalls(iView)
+                 << "/" << m_pEntityManager->getLastFrameCulledInstances(iView) << " |";
+        cout << (EntityManager::useOcclusionCulling() ? " (occlusion culled) |" : " (no occlusion culling) |");
+        cout << " together: " << m_pEntityManager->getLastFrameDrawCalls(MULTI_VIEW)
+             << "/" << m_pEntityManager->getLastFrameCulledInstances(MULTI_VIEW)
+             << (EntityManager::useMultiView() ? " |" : " (disabled) |");
+        cout << " shadow: " << m_pEntityManager->getLastFrameDrawCalls(SHADOW_VIEW)
+             << "/" << m_pEntityManager->getLastFrameCulledInstances(SHADOW_VIEW)
+             << (EntityManager::useStaticShadowCache() ? " (static shadows cached, " : " (no static shadow cache, ")
+             << m_pEntityManager->getStaticShadowRedraws() << " redraws)" << endl;
+
+        // Lights of the frame and how they were spread over the clusters of the last view
+        const LightClusters* pLightClusters = SHADER_MANAGER->getLightClusters();
+        cout << "[Frame Stats] lights: " << pLightClusters->getNumPointLights() << " point, "
+             << pLightClusters->getNumSpotLights() << " spot | cluster light lists: "
+             << (static_cast<float>(pLightClusters->getLastAssignments()) / LightClusters::CLUSTER_COUNT) << " lights/cluster (max "
+             << pLightClusters->getLastMaxLightsPerCluster() << ")" << endl;
+
+        // GPU time of the bloom, a few frames behind as the timer doesn't wait on the GPU
+        cout << "[Frame Stats] bloom (" << BLOOM_QUALITY_NAMES[m_eBloomQuality] << "): "
+             << (m_sBloomTimer.getMilliseconds() / std::max(m_sBloomTimer.getIntervals(), 1u)) << " ms/frame on the GPU" << endl;
+        m_sBloomTimer.resetTotals();
+
+        // Frame times and how long the Frame Pacer slept and spun to hold the target rate
+        const unsigned int* pHistogram = m_pFramePacer.getHistogram();
+        unsigned int iPacedFrames = std::max(m_pFramePacer.getFrames(), 1u);
+        cout << "[Frame Stats] frame times (" << FramePacer::getTargetRateName(FramePacer::getTargetRate()) << " fps"
+             << (FramePacer::useVSync() ? ", vsync):" : "):");
+        for (unsigned int i = 0; i < FramePacer::HISTOGRAM_BUCKETS - 1; ++i)
+            cout << " <" << FramePacer::getHistogramBound(i) << "ms: " << pHistogram[i] << " |";
+        cout << " >=" << FramePacer::getHistogramBound(FramePacer::HISTOGRAM_BUCKETS - 2) << "ms: " << pHistogram[FramePacer::HISTOGRAM_BUCKETS - 1]
+             << " | sleep: " << (m_pFramePacer.getSleepMilliseconds() / iPacedFrames) << " ms/frame"
+             << " | spin: " << (m_pFramePacer.getSpinMilliseconds() / iPacedFrames) << " ms/frame"
+             << " (margin " << m_pFramePacer.getSpinMarginMilliseconds() << " ms)" << endl;
+        m_pFramePacer.resetTotals();
+
+        m_fFrameStatsTime = 0.0f;
+        m_iFrameStatsFrames = m_iFrameStatsHeapAllocations = m_iFrameStatsMaxHeapAllocations = 0;
+        m_fFrameStatsSubmitTime = 0.0;
+        m_iFrameStatsDrawnFrames = 0;
+    }
+}
+#endif
+
 /*
     If the game has initiated game, either by time out, or the user ending the
     game manually from the pause menu, then the game will "start" game over.
@@ -567,14 +729,19 @@ void GameManager::cleanupFrameBuffers()
         for( unsigned int i = 0; i < 2; ++i )
             pTxtMngr->unloadTexture(&(pRenderBlock.pColorBuffer[i]));
 
-        // Clean up Ping Pong Buffers
-        for (sRenderBlock::sPingPongBuffer pBuffer : pRenderBlock.pPingPongBuffers)
-        {
-            TEXTURE_MANAGER->unloadTexture(&pBuffer.pBuffer);
-            glDeleteFramebuffers(1, &pBuffer.iFBO);
-        }
+        // Clean up Ping Pong and Bloom Buffers
+        for (unsigned int i = 0; i < 2; ++i)
+            deleteColorTarget(&pRenderBlock.pPingPongBuffers[i]);
+        deleteColorTarget(&pRenderBlock.sBloomBuffer);
     }
     m_pFrameBufferTextures.clear();
+
+    // Clean up the shared levels of the Bloom Mip Chain
+    for (sRenderBlock::sPingPongBuffer& pBuffer : m_pBloomMips)
+        deleteColorTarget(&pBuffer);
+    m_pBloomMips.clear();
+
+    deleteMultiViewBuffer();
 }
 
 void GameManager::generateFrameBuffer(unsigned int iPlayer)
@@ -606,20 +773,26 @@ void GameManager::generateFrameBuffer(unsigned int iPlayer)
     unsigned int iAttachments[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
     glDrawBuffers(2, iAttachments);
 
-    // Generate Pingpong Buffers
-    for (unsigned int i = 0; i < 2; ++i)
+    // Generate the Buffers the Bloom is blurred in: only those of the bloom quality are needed.
+    sNewBlock.pPingPongBuffers[0] = sNewBlock.pPingPongBuffers[1] = sNewBlock.sBloomBuffer = { 0, nullptr };
+    if (BLOOM_GAUSSIAN == m_eBloomQuality)
+    {
+        // Generate Pingpong Buffers
+        for (unsigned int i = 0; i < 2; ++i)
+            generateColorTarget(&sNewBlock.pPingPongBuffers[i], m_iSplitWidth, m_iSplitHeight, iPlayer, i + 2);
+    }
+    else
     {
-        glGenFramebuffers(1, &sNewBlock.pPingPongBuffers[i].iFBO);
-        glBindFramebuffer(GL_FRAMEBUFFER, sNewBlock.pPingPongBuffers[i].iFBO);
-        sNewBlock.pPingPongBuffers[i].pBuffer =
-            TEXTURE_MANAGER->genFrameBufferTexture(m_iSplitWidth, m_iSplitHeight,
-                                                   iPlayer, i + 2);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
-            sNewBlock.pPingPongBuffers[i].pBuffer->getTextureID(), 0);
-
-        // Verify that Framebuffer is set up correctly
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-            cout << "ERROR: Framebuffer is not complete.\n";
+        generateColorTarget(&sNewBlock.sBloomBuffer, std::max(m_iSplitWidth >> 1, 1), std::max(m_iSplitHeight >> 1, 1),
+                            iPlayer, BLOOM_BUFFER_NUM);
+
+        // The smaller levels are shared by every screen, generate them along with the first one.
+        for (unsigned int iLevel = 2; m_pBloomMips.size() < static_cast<unsigned int>(m_eBloomQuality); ++iLevel)
+        {
+            m_pBloomMips.emplace_back();
+            generateColorTarget(&m_pBloomMips.back(), std::max(m_iSplitWidth >> iLevel, 1), std::max(m_iSplitHeight >> iLevel, 1),
+                                0, BLOOM_BUFFER_NUM + iLevel);
+        }
     }
 
     // Save Render Block and unbind frame buffer.
@@ -627,6 +800,124 @@ void GameManager::generateFrameBuffer(unsigned int iPlayer)
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
+// Generate a Frame Buffer that renders to a single color texture.
+void GameManager::generateColorTarget(sRenderBlock::sPingPongBuffer* pTarget, int iWidth, int iHeight,
+                                      unsigned int iPlayer, unsigned int iBufferNum)
+{
+    glGenFramebuffers(1, &pTarget->iFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, pTarget->iFBO);
+    pTarget->pBuffer = TEXTURE_MANAGER->genFrameBufferTexture(iWidth, iHeight, iPlayer, iBufferNum);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, pTarget->pBuffer->getTextureID(), 0);
+
+    // Verify that Framebuffer is set up correctly
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        cout << "ERROR: Framebuffer is not complete.\n";
+}
+
+/*
+    Generate the layered Frame Buffer the screens are drawn to together: the
+    same attachments as the Frame Buffer of a screen, as texture arrays with a
+    layer per screen. Depth and stencil are a texture as well so they can be
+    copied to the screens like the colors.
+*/
+void GameManager::generateMultiViewBuffer(unsigned int iLayers)
+{
+    const GLenum pAttachments[3] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_DEPTH_STENCIL_ATTACHMENT };
+
+    m_sMultiViewBuffer.iLayers = iLayers;
+    glGenFramebuffers(1, &m_sMultiViewBuffer.iFrameBuffer);
+    glGenFramebuffers(1, &m_sMultiViewBuffer.iReadFrameBuffer);
+    glGenTextures(3, m_sMultiViewBuffer.pTextures);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_sMultiViewBuffer.iFrameBuffer);
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        glBindTexture(GL_TEXTURE_2D_ARRAY, m_sMultiViewBuffer.pTextures[i]);
+        if (i < 2)  // 16bit Floating Point for HDR rendering
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGB16F, m_iSplitWidth, m_iSplitHeight, iLayers, 0, GL_RGB, GL_FLOAT, nullptr);
+        else
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH24_STENCIL8, m_iSplitWidth, m_iSplitHeight, iLayers, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, nullptr);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glFramebufferTexture(GL_FRAMEBUFFER, pAttachments[i], m_sMultiViewBuffer.pTextures[i], 0);
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    // Verify that Framebuffer is set up correctly
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        cout << "ERROR: Multi-View Framebuffer is not complete.\n";
+
+    // Renders to two color buffers, like the Frame Buffers of the screens
+    glDrawBuffers(2, pAttachments);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+// Delete the Multi-View Buffer, if it was generated.
+void GameManager::deleteMultiViewBuffer()
+{
+    if (0 != m_sMultiViewBuffer.iFrameBuffer)
+    {
+        glDeleteFramebuffers(1, &m_sMultiViewBuffer.iFrameBuffer);
+        glDeleteFramebuffers(1, &m_sMultiViewBuffer.iReadFrameBuffer);
+        glDeleteTextures(3, m_sMultiViewBuffer.pTextures);
+    }
+    m_sMultiViewBuffer = { 0, 0, { 0, 0, 0 }, 0 };
+}
+
+/*
+    Draw what the screens share in a single pass into the Multi-View Buffer,
+    then copy each layer to the Frame Buffer of its screen. The copies are done
+    on the GPU, so the CPU cost of the pass doesn't grow with the screens.
+*/
+void GameManager::renderViewsTogether()
+{
+    const GLenum pAttachments[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+    unsigned int iScreens = static_cast<unsigned int>(m_pFrameBufferTextures.size());
+
+    if (m_sMultiViewBuffer.iLayers != iScreens)
+    {
+        deleteMultiViewBuffer();
+        generateMultiViewBuffer(iScreens);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_sMultiViewBuffer.iFrameBuffer);
+    glViewport(0, 0, m_iSplitWidth, m_iSplitHeight);
+    m_pEntityManager->renderViewsTogether();
+
+    // Both colors, then depth and stencil with the first one
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_sMultiViewBuffer.iReadFrameBuffer);
+    for (unsigned int iScreen = 0; iScreen < iScreens; ++iScreen)
+    {
+        glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_sMultiViewBuffer.pTextures[0], 0, iScreen);
+        glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, m_sMultiViewBuffer.pTextures[1], 0, iScreen);
+        glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, m_sMultiViewBuffer.pTextures[2], 0, iScreen);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_pFrameBufferTextures[iScreen].iFrameBuffer);
+
+        for (unsigned int i = 0; i < 2; ++i)
+        {
+            glReadBuffer(pAttachments[i]);
+            glDrawBuffer(pAttachments[i]);
+            glBlitFramebuffer(0, 0, m_iSplitWidth, m_iSplitHeight, 0, 0, m_iSplitWidth, m_iSplitHeight,
+                              0 == i ? (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT) : GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        }
+        glDrawBuffers(2, pAttachments);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+// Delete a Frame Buffer from generateColorTarget and unload its texture, if it was generated.
+void GameManager::deleteColorTarget(sRenderBlock::sPingPongBuffer* pTarget)
+{
+    if (nullptr != pTarget->pBuffer)
+        TEXTURE_MANAGER->unloadTexture(&pTarget->pBuffer);
+
+    if (0 != pTarget->iFBO)
+    {
+        glDeleteFramebuffers(1, &pTarget->iFBO);
+        pTarget->iFBO = 0;
+    }
+}
+
 /*
     End the current game.
 
@@ -659,65 +950,94 @@ void GameManager::endGame()
 }
 
 /*
-    Draw the scene with a 60 fps lock.
-    In other words, if drawScene() is called over 60 times per second, the
-    scene will not be drawn more than it needs to.
+    Draw the scene of a frame. The Frame Pacer has already held the loop to
+    the target frame rate, so every frame is drawn.
 */
 void GameManager::drawScene()
 {
-    if (m_fFrameTime >= sixtieth_of_a_sec{ 1 }) // This locks the framerate to 60 fps
+#ifndef NDEBUG
+    // Time spent on the CPU issuing the frame, up to the buffer swap (which waits on the GPU).
+    high_resolution_clock::time_point pSubmitStart = high_resolution_clock::now();
+#endif
+    if (m_bTimeRenderStages)
+        m_pRenderStageStart = high_resolution_clock::now();
+
+    // Render the Scene
+    glBindFramebuffer(GL_FRAMEBUFFER, m_iScreenFrameBuffer);
+    glEnable(GL_DEPTH_TEST);
+    if (m_bInGame)
     {
-        m_fFrameTime = seconds{ 0 };
-
-        // Render the Scene
-        glEnable(GL_DEPTH_TEST);
-        if (m_bInGame)
+        // Set up Render for this frame
+        m_pEntityManager->setupRender();
+
+        // Set Map Position Data.
+        m_pEntityManager->getPlayerPositions(&m_vPositions);
+        glBindBuffer(GL_ARRAY_BUFFER, m_iMapVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, m_vPositions.size() * sizeof(vec3), m_vPositions.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        endRenderStage(STAGE_SETUP);
+
+        // Draw what the screens share all at once, if they can be, then the rest of each screen
+        if (m_pEntityManager->canRenderViewsTogether())
+            renderViewsTogether();
+        endRenderStage(STAGE_VIEWS_TOGETHER);
+
+        // Render each screen
+        for( unsigned int screen = 0; screen < m_pFrameBufferTextures.size(); ++screen)
         {
-            // Set up Render for this frame
-            m_pEntityManager->setupRender();
-
-            // Set Map Position Data.
-            m_pEntityManager->getPlayerPositions(&m_vPositions);
-            glBindBuffer(GL_ARRAY_BUFFER, m_iMapVBO);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_vPositions.size() * sizeof(vec3), m_vPositions.data());
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-            // Render each screen
-            for( unsigned int screen = 0; screen < m_pFrameBufferTextures.size(); ++screen)
-            {
-                // Bind Frame Buffer
-                glBindFramebuffer(GL_FRAMEBUFFER, m_pFrameBufferTextures[screen].iFrameBuffer);
-                glViewport(0, 0, m_iSplitWidth, m_iSplitHeight);
-
-                // Render Frame
-                m_pEntityManager->renderEnvironment(screen);                
-                renderMap();
-                // Render the UI
-                // Since the GameInterface is rendering directly, we do not need to
-                // switch to the GameInterface
-                m_pGameInterface->setFocus(static_cast<eHovercraft>(screen));
-                m_pGameInterface->render();
-                // Blur the Bloom Buffer
-                blurBloomBuffer(screen);
-            }
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
-            glClear(GL_COLOR_BUFFER_BIT);
-            glDisable(GL_DEPTH_TEST);
-
-            // Render the Split Screen Quads
-            renderSplitScreen();
+            // Bind Frame Buffer
+            glBindFramebuffer(GL_FRAMEBUFFER, m_pFrameBufferTextures[screen].iFrameBuffer);
+            glViewport(0, 0, m_iSplitWidth, m_iSplitHeight);
+
+            // Render Frame
+            m_pEntityManager->renderEnvironment(screen);                
+            renderMap();
+            // Render the UI
+            // Since the GameInterface is rendering directly, we do not need to
+            // switch to the GameInterface
+            m_pGameInterface->setFocus(static_cast<eHovercraft>(screen));
+            m_pGameInterface->render();
         }
+        endRenderStage(STAGE_SCREENS);
 
+        // Blur the Bloom Buffers
+        renderBloom();
+        endRenderStage(STAGE_BLOOM);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_iScreenFrameBuffer);
+        glClear(GL_COLOR_BUFFER_BIT);
         glDisable(GL_DEPTH_TEST);
-        if (!m_bInGame)
-        {
-            // In game check is to avoid double rendering the user interface.
-            m_pUserInterfaceManager->render();
-        }
-        
 
-        // scene is rendered to the back buffer, so swap to front for display
+        // Render the Split Screen Quads
+        renderSplitScreen();
+    }
+
+    glDisable(GL_DEPTH_TEST);
+    if (!m_bInGame)
+    {
+        // In game check is to avoid double rendering the user interface.
+        m_pUserInterfaceManager->render();
+    }
+    endRenderStage(STAGE_COMPOSITE);
+#ifndef NDEBUG
+    m_fFrameStatsSubmitTime += duration<double, milli>(high_resolution_clock::now() - pSubmitStart).count();
+    ++m_iFrameStatsDrawnFrames;
+#endif
+
+    // scene is rendered to the back buffer, so swap to front for display
+    if (m_bHeadless)
+        glFlush();
+    else
         glfwSwapBuffers(m_pWindow);
+}
+
+// Adds the time since the last stage ended to a stage of drawScene, while the render benchmark runs.
+void GameManager::endRenderStage(eRenderStage eStage)
+{
+    if (m_bTimeRenderStages)
+    {
+        high_resolution_clock::time_point pNow = high_resolution_clock::now();
+        m_pRenderStageTimes[eStage] += duration<double, milli>(pNow - m_pRenderStageStart).count();
+        m_pRenderStageStart = pNow;
     }
 }
 
@@ -761,15 +1081,45 @@ void GameManager::updateGameTime(float frameDeltaTime)
 }
 
 
+// Name: renderBloom
+// Description: Blurs the bloom buffer of every screen with the method its buffers were
+//      generated for. The screens are blurred one after the other once they've all been
+//      drawn, which lets them share the Vertex Array and the levels of the mip chain.
+void GameManager::renderBloom()
+{
+#ifndef NDEBUG
+    if (m_bReportFrameStats)
+        m_sBloomTimer.begin();
+#endif
+    glBindVertexArray(m_iBlurVAO);
+
+    for (unsigned int iScreen = 0; iScreen < m_pFrameBufferTextures.size(); ++iScreen)
+    {
+        if (nullptr != m_pFrameBufferTextures[iScreen].sBloomBuffer.pBuffer)
+            renderBloomMipChain(iScreen);
+        else
+            blurBloomBuffer(iScreen);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindVertexArray(0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, m_iSplitWidth, m_iSplitHeight);
+#ifndef NDEBUG
+    if (m_bReportFrameStats)
+        m_sBloomTimer.end();
+#endif
+}
+
 // Name: blurBloomBuffer
 // Description: Applies a gaussian blur shader to the bloom buffer
 //      for the specified frame buffer.
 //  Algorithm modified from: https://learnopengl.com/Advanced-Lighting/Bloom
 void GameManager::blurBloomBuffer(unsigned int iScreen)
 {
-    // Bind Vertex Array and Use Blur Program
-    glBindVertexArray(m_iBlurVAO);
+    // Use Blur Program at full resolution
     glUseProgram(m_pShaderManager->getProgram(ShaderManager::eShaderType::BLUR_SHDR));
+    glViewport(0, 0, m_iSplitWidth, m_iSplitHeight);
     
     // Local variables
     unsigned int iAmount = BLUR_AMOUNT;
@@ -782,27 +1132,248 @@ void GameManager::blurBloomBuffer(unsigned int iScreen)
         glBindFramebuffer(GL_FRAMEBUFFER, m_pFrameBufferTextures[iScreen].pPingPongBuffers[bHorizontal].iFBO);
 
         // Set Horizontal/Vertical setting
-        m_pShaderManager->setUniformBool(ShaderManager::eShaderType::BLUR_SHDR, "horizontal", bHorizontal);
+        m_pShaderManager->setUniformBool(ShaderManager::eShaderType::BLUR_SHDR, ShaderManager::BLUR_HORIZONTAL, bHorizontal);
 
         // This is first iteration? bind the Buffer to blur
         if (bFirstIteration)
         {
-            m_pFrameBufferTextures[iScreen].pColorBuffer[1]->bindTexture(ShaderManager::eShaderType::BLUR_SHDR, "mTexture");
+            m_pFrameBufferTextures[iScreen].pColorBuffer[1]->bindTexture(ShaderManager::eShaderType::BLUR_SHDR, ShaderManager::BLUR_TEXTURE);
             bFirstIteration = false;
         }
         else    // Otherwise, apply opposite blur to previous output.
-            m_pFrameBufferTextures[iScreen].pPingPongBuffers[!bHorizontal].pBuffer->bindTexture(ShaderManager::eShaderType::BLUR_SHDR, "mTexture");
+            m_pFrameBufferTextures[iScreen].pPingPongBuffers[!bHorizontal].pBuffer->bindTexture(ShaderManager::eShaderType::BLUR_SHDR, ShaderManager::BLUR_TEXTURE);
 
         // Draw Screen Quad.
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
         bHorizontal = !bHorizontal;
     }
+}
 
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glBindVertexArray(0);
+// Name: renderBloomMipChain
+// Description: Downsamples the bloom buffer of a screen to half resolution and on down the
+//      shared levels of the mip chain, then upsamples back up the chain, blending each level
+//      over the one above it. The blur widens with every level at a fraction of the cost of
+//      a full resolution blur, and ends in the half resolution bloom buffer of the screen.
+void GameManager::renderBloomMipChain(unsigned int iScreen)
+{
+    // Local Variables
+    sRenderBlock& sBlock = m_pFrameBufferTextures[iScreen];
+    Texture* pSource = sBlock.pColorBuffer[1];
+    unsigned int iLevels = static_cast<unsigned int>(m_pBloomMips.size()) + 1;
+
+    // Downsample: level 0 is the full resolution bloom buffer, level 1 the bloom buffer of the screen.
+    glUseProgram(m_pShaderManager->getProgram(ShaderManager::eShaderType::BLOOM_DOWNSAMPLE_SHDR));
+    for (unsigned int iLevel = 1; iLevel <= iLevels; ++iLevel)
+    {
+        sRenderBlock::sPingPongBuffer* pTarget = (1 == iLevel) ? &sBlock.sBloomBuffer : &m_pBloomMips[iLevel - 2];
+
+        glBindFramebuffer(GL_FRAMEBUFFER, pTarget->iFBO);
+        glViewport(0, 0, std::max(m_iSplitWidth >> iLevel, 1), std::max(m_iSplitHeight >> iLevel, 1));
+        pSource->bindTexture(ShaderManager::eShaderType::BLOOM_DOWNSAMPLE_SHDR, ShaderManager::BLUR_TEXTURE);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        pSource = pTarget->pBuffer;
+    }
+
+    // Upsample: blend each level over the level above it, from the smallest up to level 1.
+    glUseProgram(m_pShaderManager->getProgram(ShaderManager::eShaderType::BLOOM_UPSAMPLE_SHDR));
+    glBlendColor(0.0f, 0.0f, 0.0f, BLOOM_UPSAMPLE_WEIGHT);
+    glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA);
+    for (unsigned int iLevel = iLevels - 1; iLevel > 0; --iLevel)
+    {
+        sRenderBlock::sPingPongBuffer* pTarget = (1 == iLevel) ? &sBlock.sBloomBuffer : &m_pBloomMips[iLevel - 2];
+
+        glBindFramebuffer(GL_FRAMEBUFFER, pTarget->iFBO);
+        glViewport(0, 0, std::max(m_iSplitWidth >> iLevel, 1), std::max(m_iSplitHeight >> iLevel, 1));
+        m_pBloomMips[iLevel - 1].pBuffer->bindTexture(ShaderManager::eShaderType::BLOOM_UPSAMPLE_SHDR, ShaderManager::BLUR_TEXTURE);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    }
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+// The blurred bloom buffer of a screen, wherever the method its buffers were generated for leaves it.
+Texture* GameManager::getBloomTexture(unsigned int iScreen) const
+{
+    const sRenderBlock& sBlock = m_pFrameBufferTextures[iScreen];
+    return (nullptr != sBlock.sBloomBuffer.pBuffer) ? sBlock.sBloomBuffer.pBuffer
+                                                    : sBlock.pPingPongBuffers[BLUR_AMOUNT & 1].pBuffer;
+}
+
+/*
+    Set the bloom quality of the frame buffers generated from now on.
+
+    @param sQuality     gaussian, low, medium or high
+    @return false if the quality isn't known
+*/
+bool GameManager::setBloomQuality(const string& sQuality)
+{
+    for (unsigned int i = 0; i < BLOOM_QUALITY_COUNT; ++i)
+    {
+        if (sQuality == BLOOM_QUALITY_NAMES[i])
+        {
+            m_eBloomQuality = static_cast<eBloomQuality>(i);
+            return true;
+        }
+    }
+
+    cout << "Unknown bloom quality \"" << sQuality << "\", expected gaussian, low, medium or high." << endl;
+    return false;
+}
+
+/*
+    Print the GPU time of the bloom of a frame with each quality tier, for
+    every split screen layout at the window resolution. The bloom buffers
+    are only cleared: the cost of the blur doesn't depend on their content.
+*/
+void GameManager::runBloomBenchmark()
+{
+    // Local Variables
+    eBloomQuality eStartQuality = m_eBloomQuality;
+    GpuTimer sTimer;
+
+    for (unsigned int iScreens = 1; iScreens <= MAX_PLAYER_COUNT; ++iScreens)
+    {
+        calculateScreenDimensions(iScreens);
+        for (unsigned int iQuality = 0; iQuality < BLOOM_QUALITY_COUNT; ++iQuality)
+        {
+            m_eBloomQuality = static_cast<eBloomQuality>(iQuality);
+            for (unsigned int i = 0; i < iScreens; ++i)
+            {
+                generateFrameBuffer(i);
+                glBindFramebuffer(GL_FRAMEBUFFER, m_pFrameBufferTextures[i].iFrameBuffer);
+                glViewport(0, 0, m_iSplitWidth, m_iSplitHeight);
+                glClear(GL_COLOR_BUFFER_BIT);
+            }
+
+            // The first frame isn't timed, the driver may still be allocating the buffers.
+            renderBloom();
+            for (unsigned int iFrame = 0; iFrame < BLOOM_BENCHMARK_FRAMES; ++iFrame)
+            {
+                sTimer.begin();
+                renderBloom();
+                sTimer.end();
+            }
+            sTimer.collect(true);
+
+            cout << iScreens << (1 == iScreens ? " screen " : " screens ") << m_iSplitWidth << "x" << m_iSplitHeight
+                 << ", " << BLOOM_QUALITY_NAMES[iQuality] << " bloom: "
+                 << (sTimer.getMilliseconds() / std::max(sTimer.getIntervals(), 1u)) << " ms per frame" << endl;
+
+            sTimer.resetTotals();
+            cleanupFrameBuffers();
+        }
+    }
+
+    m_eBloomQuality = eStartQuality;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, m_iWidth, m_iHeight);
+}
+
+/*
+    Start a game with a number of screens and draw it for a number of frames,
+    then print the CPU time spent issuing each stage of drawScene and the time
+    the GPU took to finish each frame. The game isn't simulated, so the
+    cameras stay where the hovercrafts spawned and every frame draws the same
+    scene. The last frame is dumped if a file was given.
+*/
+void GameManager::runRenderBenchmark(unsigned int iPlayers, unsigned int iFrames)
+{
+    // Local Variables
+    double fFinishTime = 0.0;
+    double fSubmitTime = 0.0;
+
+    iPlayers = std::min(std::max(iPlayers, 1u), static_cast<unsigned int>(MAX_PLAYER_COUNT));
+    iFrames = std::max(iFrames, 1u);
+    initializeNewGame(iPlayers, RENDER_BENCHMARK_BOTS, DIFFICULTY_MEDIUM, RENDER_BENCHMARK_GAME_TIME,
+                      GAMEMODE_FREE_FOR_ALL, MAP_1_NUMBER, false);
+
+    // The swap mustn't wait for the display, and the first frames aren't timed as the driver may still be allocating.
+    glfwSwapInterval(0);
+    for (unsigned int iFrame = 0; iFrame < RENDER_BENCHMARK_WARMUP; ++iFrame)
+        drawScene();
+    glFinish();
+
+    memset(m_pRenderStageTimes, 0, sizeof(m_pRenderStageTimes));
+    m_bTimeRenderStages = true;
+    for (unsigned int iFrame = 0; iFrame < iFrames; ++iFrame)
+    {
+        drawScene();
+        high_resolution_clock::time_point pFinishStart = high_resolution_clock::now();
+        glFinish();
+        fFinishTime += duration<double, milli>(high_resolution_clock::now() - pFinishStart).count();
+    }
+    m_bTimeRenderStages = false;
+
+    cout << iPlayers << (1 == iPlayers ? " screen " : " screens ") << m_iSplitWidth << "x" << m_iSplitHeight
+         << ", " << iFrames << " frames" << (m_bHeadless ? " (headless)" : "") << ":" << endl;
+    for (unsigned int i = 0; i < RENDER_STAGE_COUNT; ++i)
+    {
+        cout << "    " << RENDER_STAGE_NAMES[i] << ": " << (m_pRenderStageTimes[i] / iFrames) << " ms per frame" << endl;
+        fSubmitTime += m_pRenderStageTimes[i];
+    }
+    cout << "    CPU submission: " << (fSubmitTime / iFrames) << " ms per frame"
+         << " | GPU finish: " << (fFinishTime / iFrames) << " ms per frame" << endl;
+
+    if (!m_sFrameDumpFile.empty())
+        dumpFrame(m_sFrameDumpFile);
+}
+
+// Frame Buffer standing in for the window in headless mode, with the attachments of a default frame buffer.
+void GameManager::generateScreenFrameBuffer()
+{
+    glGenRenderbuffers(2, m_pScreenRenderBuffers);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_pScreenRenderBuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_iWidth, m_iHeight);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_pScreenRenderBuffers[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_iWidth, m_iHeight);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &m_iScreenFrameBuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_iScreenFrameBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_pScreenRenderBuffers[0]);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_pScreenRenderBuffers[1]);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        cout << "ERROR: Headless Framebuffer is not complete.\n";
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
+/*
+    Write the last frame drawn to a binary PPM image. Only the Frame Buffer of
+    headless mode can be read back: the back buffer of a window is undefined
+    once it's been swapped.
+
+    @return true if the frame was written
+*/
+bool GameManager::dumpFrame(const string& sFileName) const
+{
+    if (!m_bHeadless)
+    {
+        cout << "Frames can only be dumped in headless mode." << endl;
+        return false;
+    }
+
+    vector<unsigned char> pPixels(m_iWidth * m_iHeight * 3);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_iScreenFrameBuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, m_iWidth, m_iHeight, GL_RGB, GL_UNSIGNED_BYTE, pPixels.data());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    ofstream pFile(sFileName, ios::out | ios::binary | ios::trunc);
+    if (!pFile.is_open())
+    {
+        cout << "Couldn't write the frame to \"" << sFileName << "\"." << endl;
+        return false;
+    }
+
+    // GL reads the rows bottom up, PPM stores them top down
+    pFile << "P6\n" << m_iWidth << " " << m_iHeight << "\n255\n";
+    for (int iRow = m_iHeight - 1; iRow >= 0; --iRow)
+        pFile.write(reinterpret_cast<const char*>(&pPixels[iRow * m_iWidth * 3]), m_iWidth * 3);
+
+    cout << "Frame written to \"" << sFileName << "\"." << endl;
+    return true;
+}
+
 // Name: renderSplitScreen
 // Written by: James Coté
 // Description: Draws each Frame Buffer into set up quads in screen space.
@@ -821,8 +1392,8 @@ void GameManager::renderSplitScreen()
 
     for (unsigned int i = 0; i < m_pFrameBufferTextures.size(); ++i)
     {
-        m_pFrameBufferTextures[i].pColorBuffer[0]->bindTexture(ShaderManager::eShaderType::SPLIT_SCREEN_SHDR, "hdrBuffer");
-        m_pFrameBufferTextures[i].pPingPongBuffers[BLUR_AMOUNT & 1].pBuffer->bindTexture(ShaderManager::eShaderType::SPLIT_SCREEN_SHDR, "bloomBuffer");
+        m_pFrameBufferTextures[i].pColorBuffer[0]->bindTexture(ShaderManager::eShaderType::SPLIT_SCREEN_SHDR, ShaderManager::HDR_BUFFER);
+        getBloomTexture(i)->bindTexture(ShaderManager::eShaderType::SPLIT_SCREEN_SHDR, ShaderManager::BLOOM_BUFFER);
         glDrawArrays(GL_TRIANGLE_STRIP, (i << 2), 4);
     }
     
@@ -2,6 +2,7 @@
 #include "UserInterface/GameInterface.h"
 #include "EntityManager.h"
 #include "EntityHeaders/HovercraftEntity.h"
+#include "DataStructures/WorldSnapshot.h"
 
 /*
     Number of killstreaks against another player to count as domination
@@ -1141,3 +1142,33 @@ void GameStats::awardAwards()
     // Special awards
     awardZeroStat(DEATHS_TOTAL,                            "Untouchable",       "Zero deaths",              500);
 }
+
+/*
+    Write the in-game stat tables to a snapshot. End game stats are computed
+    from these at the end of the game, so they're not included.
+
+    @param pSnapshot    to write to
+*/
+void GameStats::writeSnapshot(WorldSnapshot* pSnapshot) const
+{
+    pSnapshot->writeArray(&stats[0][0], STAT_TABLE_SIZE);
+    pSnapshot->writeArray(globalStats, GLOBALSTAT_COUNT);
+    pSnapshot->write(firstBloodHappened);
+    pSnapshot->write(queueFirstBlood);
+    pSnapshot->writeVector(m_eScoreLeaders);
+}
+
+/*
+    Restore the in-game stat tables from a snapshot.
+
+    @param pSnapshot    to read from
+    @return true if the stats were read successfully
+*/
+bool GameStats::readSnapshot(WorldSnapshot* pSnapshot)
+{
+    return pSnapshot->readArray(&stats[0][0], STAT_TABLE_SIZE) &&
+           pSnapshot->readArray(globalStats, GLOBALSTAT_COUNT) &&
+           pSnapshot->read(&firstBloodHappened) &&
+           pSnapshot->read(&queueFirstBlood) &&
+           pSnapshot->readVector(&m_eScoreLeaders);
+}
@@ -16,6 +16,7 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #include "ImageReader.h"
+#include "DataStructures/AssetPreloader.h"
 
 using namespace std;
 
@@ -27,7 +28,19 @@ bool InitializeTexture(Texture *mytex, const string &imageFileName, bool bGammaC
     // Local Variables
     int iWidth, iHeight, nrComponents;
     bool bReturnValue = false;
-    unsigned char* data = stbi_load(imageFileName.data(), &iWidth, &iHeight, &nrComponents, 0);
+    unsigned char* data;
+    AssetPreloader::sImage sPreloadedImage;
+
+    // Use the image if it was decoded with the scene, otherwise decode it now.
+    if (ASSET_PRELOADER->takeImage(imageFileName, &sPreloadedImage))
+    {
+        data = sPreloadedImage.pPixels;
+        iWidth = sPreloadedImage.iWidth;
+        iHeight = sPreloadedImage.iHeight;
+        nrComponents = sPreloadedImage.iComponents;
+    }
+    else
+        data = stbi_load(imageFileName.data(), &iWidth, &iHeight, &nrComponents, 0);
 
     // Ensure that data was properly loaded.
     if (nullptr != data)
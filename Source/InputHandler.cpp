@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "InputHandler.h"
+#include "InputRecorder.h"
 #include "GameManager.h"
 #include "EntityHeaders/HovercraftEntity.h"
 #include "EntityManager.h"
@@ -73,6 +74,10 @@ void InputHandler::keyCallback(GLFWwindow* window, int key, int scancode, int ac
     if (GLFW_KEY_UNKNOWN == key)
         return;
 
+    // While replaying, the keyboard state comes from the recording.
+    if (INPUT_RECORDER->isReplaying())
+        return;
+
     /*
         Possible actions:
 
@@ -184,6 +189,10 @@ void InputHandler::debugKeyCommands(int key, int action)
 */
 void InputHandler::mouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
 {
+    // Mouse input isn't recorded, so it's ignored while replaying.
+    if (INPUT_RECORDER->isReplaying())
+        return;
+
     // Left Click
     if (GLFW_MOUSE_BUTTON_1 == button)
     {
@@ -238,6 +247,9 @@ void InputHandler::mouseMoveCallback(GLFWwindow* window, double x, double y)
 */
 void InputHandler::mouseScrollCallback(GLFWwindow* window, double xoffset, double yoffset)
 {
+    if (INPUT_RECORDER->isReplaying())
+        return;
+
     m_pInstance->m_pGameManager->zoomCamera((float) yoffset * ZOOM_SCALE);
 }
 
@@ -473,6 +485,11 @@ void InputHandler::disconnectJoystick(int joystickID)
 void InputHandler::joystickCallback(int joystickID, int event)
 {
     string name;
+
+    // While replaying, the joysticks are the ones from the recording.
+    if (INPUT_RECORDER->isReplaying())
+        return;
+
     switch (event)
     {
     case GLFW_CONNECTED:
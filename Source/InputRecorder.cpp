@@ -0,0 +1,264 @@
+#include "InputRecorder.h"
+#include "InputHandler.h"
+
+/***********\
+ * Defines *
+\***********/
+#define RECORDING_MAGIC     0x43525648  // "HVRC" in little endian
+// Increment whenever the layout of a recorded frame changes.
+#define RECORDING_VERSION   1
+
+// Singleton instance
+InputRecorder* InputRecorder::m_pInstance = nullptr;
+
+/*
+    Raw binary reads and writes of the log. Only trivially copyable values are
+    written; the log is only valid for the build that recorded it.
+*/
+template <class T>
+static void writeValue(fstream* pFile, const T& value)
+{
+    static_assert(is_trivially_copyable<T>::value, "InputRecorder only logs trivially copyable values.");
+    pFile->write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+static bool readValue(fstream* pFile, T* pValue)
+{
+    static_assert(is_trivially_copyable<T>::value, "InputRecorder only logs trivially copyable values.");
+    return static_cast<bool>(pFile->read(reinterpret_cast<char*>(pValue), sizeof(T)));
+}
+
+InputRecorder* InputRecorder::getInstance()
+{
+    if (nullptr == m_pInstance)
+        m_pInstance = new InputRecorder();
+    return m_pInstance;
+}
+
+// Default Constructor
+InputRecorder::InputRecorder()
+{
+    m_eMode = RECORDER_IDLE;
+    m_iRandomSeed = 0;
+    m_iFrameCount = 0;
+    m_fTotalWallTime = m_fMaxWallTime = 0.0;
+    memset(m_fReplayAxes, 0, sizeof(m_fReplayAxes));
+}
+
+InputRecorder::~InputRecorder()
+{
+    stop();
+    m_pInstance = nullptr;
+}
+
+/*
+    Start logging input to a file. Should be called before the game starts so
+    that the menus leading up to the match are recorded as well.
+
+    @param sFileName    of the log to write
+    @return true if the log was successfully opened
+*/
+bool InputRecorder::startRecording(const string& sFileName)
+{
+    stop();
+
+    m_pLogFile.open(sFileName, ios::out | ios::binary | ios::trunc);
+    if (!m_pLogFile.is_open())
+    {
+        cout << "InputRecorder: unable to open \"" << sFileName << "\" for recording." << endl;
+        return false;
+    }
+
+    // Write Header
+    m_iRandomSeed = random_device()();
+    writeValue(&m_pLogFile, static_cast<unsigned int>(RECORDING_MAGIC));
+    writeValue(&m_pLogFile, static_cast<unsigned int>(RECORDING_VERSION));
+    writeValue(&m_pLogFile, m_iRandomSeed);
+
+    seedRandomGenerators();
+    m_iFrameCount = 0;
+    m_eMode = RECORDER_RECORDING;
+    cout << "Recording input to \"" << sFileName << "\"." << endl;
+    return true;
+}
+
+/*
+    Start replaying a log written by startRecording(). Must be started at the
+    same point the recording was started.
+
+    @param sFileName    of the log to replay
+    @return true if the log was successfully opened and is compatible
+*/
+bool InputRecorder::startReplay(const string& sFileName)
+{
+    unsigned int iMagic = 0, iVersion = 0;
+    stop();
+
+    m_pLogFile.open(sFileName, ios::in | ios::binary);
+    if (!m_pLogFile.is_open())
+    {
+        cout << "InputRecorder: unable to open \"" << sFileName << "\" for replay." << endl;
+        return false;
+    }
+
+    if (!readValue(&m_pLogFile, &iMagic) || !readValue(&m_pLogFile, &iVersion) ||
+        !readValue(&m_pLogFile, &m_iRandomSeed) ||
+        RECORDING_MAGIC != iMagic || RECORDING_VERSION != iVersion)
+    {
+        cout << "InputRecorder: \"" << sFileName << "\" is not a compatible recording." << endl;
+        m_pLogFile.close();
+        return false;
+    }
+
+    seedRandomGenerators();
+    m_iFrameCount = 0;
+    m_fTotalWallTime = m_fMaxWallTime = 0.0;
+    m_eMode = RECORDER_REPLAYING;
+    cout << "Replaying input from \"" << sFileName << "\"." << endl;
+    return true;
+}
+
+// Stop recording or replaying and close the log.
+void InputRecorder::stop()
+{
+    if (isRecording())
+        cout << "Recorded " << m_iFrameCount << " frames." << endl;
+
+    if (m_pLogFile.is_open())
+        m_pLogFile.close();
+    m_eMode = RECORDER_IDLE;
+}
+
+/*
+    Seed the generator used by FuncUtils::random() and rand(), which is also
+    used by glm's random functions.
+*/
+void InputRecorder::seedRandomGenerators()
+{
+    FuncUtils::setRandomGenerator(mt19937(m_iRandomSeed));
+    srand(m_iRandomSeed);
+}
+
+/*
+    Log the frame time and the current state of the keyboard and joysticks.
+
+    Frame Layout:
+        double              frame delta time
+        unsigned int        number of keys
+            int, int        key, input state
+        per joystick:
+            bool            present
+            if present:
+                int         mask
+                int         button count
+                int[]       MAX_BUTTON_COUNT input states
+                float[]     MAX_AXES_COUNT axes values
+*/
+void InputRecorder::recordFrame(double fFrameDeltaTime)
+{
+    InputHandler* pInputHandler = INPUT_HANDLER;
+
+    writeValue(&m_pLogFile, fFrameDeltaTime);
+
+    // Keyboard
+    writeValue(&m_pLogFile, static_cast<unsigned int>(pInputHandler->m_keys.size()));
+    for (map<int, InputHandler::eInputState>::const_iterator pIter = pInputHandler->m_keys.begin();
+        pIter != pInputHandler->m_keys.end();
+        ++pIter)
+    {
+        writeValue(&m_pLogFile, pIter->first);
+        writeValue(&m_pLogFile, static_cast<int>(pIter->second));
+    }
+
+    // Joysticks
+    for (unsigned int iJoystick = 0; iJoystick < MAX_PLAYER_COUNT; ++iJoystick)
+    {
+        const InputHandler::sJoystickInfo& sJoystick = pInputHandler->m_pJoystickData[iJoystick];
+        writeValue(&m_pLogFile, sJoystick.bPresent);
+        if (sJoystick.bPresent)
+        {
+            float fAxes[MAX_AXES_COUNT] = { 0.0f };
+            if (nullptr != sJoystick.pAxes)
+                memcpy(fAxes, sJoystick.pAxes, sizeof(float) * std::min(sJoystick.iAxesCount, MAX_AXES_COUNT));
+
+            writeValue(&m_pLogFile, sJoystick.iMask);
+            writeValue(&m_pLogFile, sJoystick.iButtonCount);
+            for (unsigned int iButton = 0; iButton < MAX_BUTTON_COUNT; ++iButton)
+                writeValue(&m_pLogFile, static_cast<int>(sJoystick.eButtonState[iButton]));
+            writeValue(&m_pLogFile, fAxes);
+        }
+    }
+
+    ++m_iFrameCount;
+}
+
+/*
+    Read the next frame from the log and overwrite the input state of the
+    InputHandler with it. Stops the replay and reports the replay statistics
+    once the end of the log is reached.
+*/
+bool InputRecorder::replayFrame(double fWallDeltaTime, double* fReturnDeltaTime)
+{
+    InputHandler* pInputHandler = INPUT_HANDLER;
+    unsigned int iKeyCount = 0;
+    int iKey = 0, iState = 0;
+    bool bValid = readValue(&m_pLogFile, fReturnDeltaTime) && readValue(&m_pLogFile, &iKeyCount);
+
+    // Keyboard
+    pInputHandler->m_keys.clear();
+    for (unsigned int i = 0; bValid && i < iKeyCount; ++i)
+    {
+        bValid = readValue(&m_pLogFile, &iKey) && readValue(&m_pLogFile, &iState);
+        pInputHandler->m_keys[iKey] = static_cast<InputHandler::eInputState>(iState);
+    }
+
+    // Joysticks
+    for (unsigned int iJoystick = 0; bValid && iJoystick < MAX_PLAYER_COUNT; ++iJoystick)
+    {
+        InputHandler::sJoystickInfo& sJoystick = pInputHandler->m_pJoystickData[iJoystick];
+        bValid = readValue(&m_pLogFile, &sJoystick.bPresent);
+        if (bValid && sJoystick.bPresent)
+        {
+            bValid = readValue(&m_pLogFile, &sJoystick.iMask) && readValue(&m_pLogFile, &sJoystick.iButtonCount);
+            for (unsigned int iButton = 0; bValid && iButton < MAX_BUTTON_COUNT; ++iButton)
+            {
+                bValid = readValue(&m_pLogFile, &iState);
+                sJoystick.eButtonState[iButton] = static_cast<InputHandler::eInputState>(iState);
+            }
+            bValid = bValid && readValue(&m_pLogFile, &m_fReplayAxes[iJoystick]);
+            sJoystick.iAxesCount = MAX_AXES_COUNT;
+            sJoystick.pAxes = m_fReplayAxes[iJoystick];
+            sJoystick.pRawButtons = nullptr;
+        }
+    }
+
+    if (!bValid)
+    {
+        // End of the log: release all input so nothing stays held down.
+        pInputHandler->m_keys.clear();
+        for (unsigned int iJoystick = 0; iJoystick < MAX_PLAYER_COUNT; ++iJoystick)
+            pInputHandler->m_pJoystickData[iJoystick].initialize();
+
+        reportReplay();
+        stop();
+        return false;
+    }
+
+    // Statistics
+    ++m_iFrameCount;
+    m_fTotalWallTime += fWallDeltaTime;
+    m_fMaxWallTime = std::max(m_fMaxWallTime, fWallDeltaTime);
+    return true;
+}
+
+// Print the real frame times measured over the replay.
+void InputRecorder::reportReplay() const
+{
+    if (0 == m_iFrameCount)
+        return;
+
+    cout << "Replay finished: " << m_iFrameCount << " frames in " << m_fTotalWallTime << " s"
+         << " | avg frame: " << ((m_fTotalWallTime / m_iFrameCount) * 1000.0) << " ms"
+         << " | worst frame: " << (m_fMaxWallTime * 1000.0) << " ms" << endl;
+}
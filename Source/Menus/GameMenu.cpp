@@ -51,6 +51,9 @@ GameMenu::GameMenu() : Menu(
         {GLFW_KEY_4,            COMMAND_DEBUG_SWITCH_KEYBOARD_TO_PLAYER4},
         {GLFW_KEY_B,            COMMAND_DEBUG_TOGGLE_DRAW_BOUNDING_BOXES},
         {GLFW_KEY_M,            COMMAND_DEBUG_TOGGLE_DRAW_SPATIAL_MAP},
+        {GLFW_KEY_G,            COMMAND_DEBUG_TOGGLE_FRAME_STATS},
+        {GLFW_KEY_F5,           COMMAND_DEBUG_CAPTURE_SNAPSHOT},
+        {GLFW_KEY_F9,           COMMAND_DEBUG_RESTORE_SNAPSHOT},
         {GLFW_KEY_KP_0,         COMMAND_DEBUG_SET_UI_DISPLAY_COUNT_0},
         {GLFW_KEY_KP_1,         COMMAND_DEBUG_SET_UI_DISPLAY_COUNT_1},
         {GLFW_KEY_KP_2,         COMMAND_DEBUG_SET_UI_DISPLAY_COUNT_2},
@@ -257,6 +260,15 @@ void GameMenu::executeValidHovercraft(HovercraftEntity *hovercraft,
     case COMMAND_DEBUG_TOGGLE_DRAW_SPATIAL_MAP:
         m_pEntityMngr->toggleSpatialMapDrawing();
         break;
+    case COMMAND_DEBUG_TOGGLE_FRAME_STATS:
+        m_pGameManager->toggleFrameStats();
+        break;
+    case COMMAND_DEBUG_CAPTURE_SNAPSHOT:
+        m_pEntityMngr->debugCaptureSnapshot();
+        break;
+    case COMMAND_DEBUG_RESTORE_SNAPSHOT:
+        m_pEntityMngr->debugRestoreSnapshot();
+        break;
 //    case COMMAND_DEBUG_SET_UI_DISPLAY_COUNT_0:
 //        m_pGameManager->m_pCurrentInterface->setDisplayCount(0);
 //        break;
@@ -105,7 +105,7 @@ void Menu::updateKeyboardCommands()
 void Menu::updateJoystickCommands()
 {
     int iButtonCount = 0, iMask = 0, iMaskedButton = 0;
-    m_pInputHandler->updateJoysticks();
+    // Joysticks are polled by the GameManager before the menus update.
 
     eFixedCommand command;
 
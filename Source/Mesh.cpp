@@ -1,6 +1,8 @@
 #include "Mesh.h"
-#include <sstream>
 #include "TextureManager.h"
+#include "DataStructures/AssetPreloader.h"
+#include "DataStructures/RenderQueue.h"
+#include "SpatialDataMap.h"
 
 /****************************\
  * Constants: For Materials *
@@ -17,30 +19,61 @@ const vec4 DEFAULT_SPEC_COLOR = vec4(vec3(0.f), 1.0f);
 #define MAX_THETA_CUTS (int)(MAX_THETA_DEGS / SLICE_SIZE)
 #define MAX_PHI_CUTS (int)(MAX_PHI_DEGS / SLICE_SIZE)
 
+/*************************************\
+ * Defines: For Terrain Construction *
+\*************************************/
+#define TERRAIN_CHUNK_QUADS     16      // Tiles along each side of a Terrain Chunk
+#define TERRAIN_SKIRT_MARGIN    0.1f    // Depth of the skirts below the lowest point of the terrain, in tiles
+
 /**********************************************\
  * Defines: For Billboard Buffer Manipulation *
 \**********************************************/
-#define BILLBOARD_STRIDE    (sizeof(vec3)/*Vertex*/ + sizeof(vec3)/*Normal*/ + sizeof(vec3)/*Color*/ + sizeof(vec2)/*UVStart*/ + sizeof(vec2)/*UVEnd*/ + sizeof(vec2) /*Height/Width*/ + sizeof(float) /*Duration*/ )
+#define BILLBOARD_STRIDE    (sizeof(vec3)/*Vertex*/ + sizeof(vec3)/*Normal*/ + sizeof(vec3)/*Color*/ + sizeof(vec2) /*Height/Width*/ + sizeof(vec2)/*Sprite Counts*/ + sizeof(vec2)/*UV Border*/ + sizeof(float)/*Start Frame*/ + sizeof(float)/*Spawn Time*/ + sizeof(float) /*Duration*/ )
 #define VERTEX_OFFSET       0
 #define NORMAL_OFFSET       sizeof(vec3)
 #define COLOR_OFFSET        (NORMAL_OFFSET + sizeof(vec3))
-#define UV_START_OFFSET     (COLOR_OFFSET + sizeof(vec3))
-#define UV_END_OFFSET       (UV_START_OFFSET + sizeof(vec2))
-#define DIMENSION_OFFSET    (UV_END_OFFSET + sizeof(vec2))
-#define DURATION_OFFSET     (DIMENSION_OFFSET + sizeof(vec2))
+#define DIMENSION_OFFSET    (COLOR_OFFSET + sizeof(vec3))
+#define SPRITE_COUNT_OFFSET (DIMENSION_OFFSET + sizeof(vec2))
+#define UV_BORDER_OFFSET    (SPRITE_COUNT_OFFSET + sizeof(vec2))
+#define START_FRAME_OFFSET  (UV_BORDER_OFFSET + sizeof(vec2))
+#define SPAWN_TIME_OFFSET   (START_FRAME_OFFSET + sizeof(float))
+#define DURATION_OFFSET     (SPAWN_TIME_OFFSET + sizeof(float))
+
+/***************************************\
+ * Defines: For Stream Buffer Capacity *
+\***************************************/
+#define DEFAULT_INSTANCE_CAPACITY   16
+#define DEFAULT_BILLBOARD_CAPACITY  64
+
+unsigned int Mesh::m_iStaticInstanceRevision = 0;
 
 // Basic Constructor
-Mesh::Mesh(const string &sManagerKey, bool bStaticMesh, float fScale, const ObjectInfo* pObjectProperties, string sHashKey, manager_cookie)
+Mesh::Mesh(const string &sManagerKey, bool bStaticMesh, float fScale, const ObjectInfo* pObjectProperties, manager_cookie)
 {
     m_sManagerKey = sManagerKey;
     m_bStaticMesh = bStaticMesh;
     m_pShdrMngr = SHADER_MANAGER;
     m_vNegativeOffset = m_vPositiveOffset = vec3(0.0f);
+    m_vBoundingCenter = vec3(0.0f);
+    m_fBoundingRadius = 0.0f;
+    memset(m_iVisibleCapacity, 0, sizeof(m_iVisibleCapacity));
+    m_bDrawingVisibleStream = false;
+    m_iInstanceDivisor = 1;
+    m_fTerrainChunkSize = 0.0f;
     glGenVertexArrays(1, &m_iVertexArray);
     m_m4ScaleMatrix = scale(vec3(fScale));
-    m_m4InstanceMap.clear();
-
-    loadObjectInfo(pObjectProperties, sHashKey);
+    m_iVertexBuffer = m_iIndicesBuffer = 0;
+    memset(m_iDirtyBegin, 0, sizeof(m_iDirtyBegin));
+    memset(m_iDirtyEnd, 0, sizeof(m_iDirtyEnd));
+    m_bInstancesChanged = false;
+    m_iInstanceCapacity = 0;
+    m_bBillboardsChanged = false;
+    m_iBillboardCapacity = 0;
+    m_iFirstVertex = 0;
+    m_fBillboardTime = 0.0f;
+    m_bDefaultMaterial = false;
+
+    loadObjectInfo(pObjectProperties);
 }
 
 // Delete any buffers that we initialized
@@ -48,7 +81,10 @@ Mesh::~Mesh()
 {
     glDeleteBuffers(1, &m_iVertexBuffer);
     glDeleteBuffers(1, &m_iIndicesBuffer);
-    glDeleteBuffers(1, &m_iInstancedBuffer);
+    m_sInstanceStream.release();
+    m_sBillboardStream.release();
+    for (StreamBuffer& sVisibleStream : m_sVisibleStreams)
+        sVisibleStream.release();
     glDeleteVertexArrays(1, &m_iVertexArray);
 
     // Delete the Buffers of the Bounding Box
@@ -79,15 +115,10 @@ bool Mesh::genMesh(const string& sFileName, vec3 vPosition, string sHashKey, flo
         // Add Transformation for Static Objects
         if (m_bStaticMesh)
         {
-            mat4 m4Transformation = m_m4ScaleMatrix * mat4(1.0f);
-
-            // Translation
-            if (vec3(0.f) != vPosition)
-                m4Transformation = translate(vPosition) * m4Transformation;
+            mat4 m4Transformation = translate(vPosition);
 
-            // Store initial transformation
-            m_m4InstanceMap.insert(make_pair(sHashKey, m4Transformation));
-            loadInstanceBuffer();
+            // Store initial transformation; the Scale Matrix is applied by addInstance.
+            addInstance(&m4Transformation, sHashKey);
         }
     }
 
@@ -95,98 +126,167 @@ bool Mesh::genMesh(const string& sFileName, vec3 vPosition, string sHashKey, flo
     return bReturnValue;
 }
 
-// Generate a generic plane at the origin with a given Height and Width
-//    Normals are along the y-axis.
-// 
-void Mesh::genPlane(int tilesX, int tilesY,float gridSize, float *values, vec3 vPosition, vec3 vNormal, string sHashKey)
+// Generate a plane at the origin from a heightmap of tilesX by tilesY vertices.
+//    Normals are along the y-axis. The plane is split into Terrain Chunks (see buildTerrainChunks).
+void Mesh::genPlane(int tilesX, int tilesY, float gridSize, float *values, vec3 vPosition, vec3 vNormal, string sHashKey)
 {
-    // Generate 4 vertices around the origin
     /***********************************
         Width = (x-axis)
         Height = (z-axis)
+        Vertex (x, y) is stored at x * tilesY + y, as is its height in values.
     */
+    float fMinHeight = FLT_MAX, fMaxHeight = -FLT_MAX;
 
     vNormal = normalize(vNormal); // Normalize Normal Vector
     for (int x = 0; x < tilesX; x++) {
         for (int y = 0; y < tilesY; y++) {
-            m_pVertices.push_back(vec3(x*gridSize - (((tilesX) * gridSize)/ 2), values[x*tilesX + y],y*gridSize - (((tilesY ) * gridSize) / 2)));
-            m_pUVs.push_back(vec2(x % 2, y % 2));
+            float fHeight = values[(x * tilesY) + y];
+            fMinHeight = std::min(fMinHeight, fHeight);
+            fMaxHeight = std::max(fMaxHeight, fHeight);
+
+            m_pVertices.push_back(vec3(x*gridSize - (((tilesX) * gridSize)/ 2), fHeight, y*gridSize - (((tilesY ) * gridSize) / 2)));
+            m_pUVs.push_back(vec2(x, y));   // One texture repeat per tile, also across the tiles skipped by lower levels of detail
             m_pNormals.push_back(vNormal);
         }
     }
-    /*
-    vertA___vertB
-    |     X      |
-    vertC___vertD
-    super helpful comment that will definitly make senese when I come back later.
-    */
-    for (int x = 0; x < tilesX -1 ; x++) {
-        for (int y = 0; y < tilesY -1 ; y++) {
-            int vertA = ( y * tilesX)       + x;
-            int vertB = ( y * tilesX)       + x + 1;
-            int vertC = ((y + 1) * tilesX)  + x;
-            int vertD = ((y + 1) * tilesX)  + x + 1;
-
-            m_pIndices.push_back(vertD);
-            m_pIndices.push_back(vertC);
-            m_pIndices.push_back(vertA);
-
-            m_pIndices.push_back(vertB);
-            m_pIndices.push_back(vertD);
-            m_pIndices.push_back(vertA);
-        }
-    }
-    //float fHeight = static_cast<float>(iHeight);
-    //float fWidth = static_cast<float>(iWidth);
-    //float fHalfHeight = fHeight * 0.5f;
-    //float fHalfWidth = fWidth * 0.5f;
-    /*m_pVertices.push_back(vec3(-fHalfWidth, 0.f, -fHalfHeight));
-    m_pVertices.push_back(vec3(-fHalfWidth, 0.f, fHalfHeight));
-    m_pVertices.push_back(vec3(fHalfWidth, 0.f, -fHalfHeight));
-    m_pVertices.push_back(vec3(fHalfWidth, 0.f, fHalfHeight));*/
-
-    // Generate Normals for each Vertex.
-    //m_pNormals.insert(m_pNormals.begin(), 4, vNormal);
-
-    //fHalfHeight *= 0.1f;
-    //fHalfWidth *= 0.1f;
-
-    //// Generate UVs for Plane
-    //m_pUVs.push_back(vec2(0.0, 0.0));
-    //m_pUVs.push_back(vec2(0.0, fHalfHeight));
-    //m_pUVs.push_back(vec2(fHalfWidth, 0.0));
-    //m_pUVs.push_back(vec2(fHalfWidth, fHalfHeight));
-
-    // Generate Indices
-    //m_pIndices = { 0, 1, 2, 1, 2, 3 };
-
-    // Set Spatial Cube/Plane
-    //m_vNegativeOffset = m_pVertices.front();
-    //m_vPositiveOffset = m_pVertices.back();
-
-    //if (SPATIAL_CALC == m_sBoundingBox.eType)
-    //    m_sBoundingBox.generateCubicBox(0.0f, static_cast<float>(iWidth), static_cast<float>(iHeight));
-
-    // Store Initial Transformation Matrix for Static Meshes
-    //if (m_bStaticMesh)
-    //{
-    //    // Translation Matrix
-    //    mat4 m4TranslationMatrix = getRotationMat4ToNormal(&vNormal);
-
-    //    // If translation is necessary, translate plane.
-    //    if (vec3(0.f) != vPosition)
-    //        m4TranslationMatrix = translate(vPosition) * m4TranslationMatrix;
-
-    //    // Store Transformation to List
-    //    //m_m4ListOfInstances.push_back(m4TranslationMatrix);
-    //    m_m4InstanceMap.insert(make_pair(sHashKey, m4TranslationMatrix));
-    //}
-    m_m4InstanceMap.insert(make_pair(sHashKey, mat4(1.0f)));
+
+    // Skirts have to reach below any neighbouring chunk, however its level of detail cuts the terrain.
+    buildTerrainChunks(tilesX, tilesY, gridSize, (fMaxHeight - fMinHeight) + (gridSize * TERRAIN_SKIRT_MARGIN));
+
+    mat4 m4InitialTransformation = mat4(1.0f);
+    addInstance(&m4InitialTransformation, sHashKey);
 
     // Load Mesh into GPU
     this->initalizeVBOs();
 }
 
+// Vertices of a chunk edge used by a level of detail: every iStep vertex from iStart, and always iEnd.
+static void getTerrainSamples(int iStart, int iEnd, int iStep, vector<int>* pSamples)
+{
+    pSamples->clear();
+    for (int i = iStart; i < iEnd; i += iStep)
+        pSamples->push_back(i);
+    pSamples->push_back(iEnd);
+}
+
+// Two triangles from the edge a-b down to its skirt vertices, facing vOutward.
+static void addTerrainSkirt(const vector<vec3>& pVertices, unsigned int iVertA, unsigned int iVertB,
+                            unsigned int iSkirtA, unsigned int iSkirtB, const vec3& vOutward, vector<unsigned int>* pIndices)
+{
+    vec3 vFaceNormal = cross(pVertices[iSkirtA] - pVertices[iVertA], pVertices[iVertB] - pVertices[iVertA]);
+    if (dot(vFaceNormal, vOutward) < 0.0f)
+    {
+        swap(iVertA, iVertB);
+        swap(iSkirtA, iSkirtB);
+    }
+
+    pIndices->insert(pIndices->end(), { iVertA, iSkirtA, iVertB, iVertB, iSkirtA, iSkirtB });
+}
+
+/*
+    Split the heightmap into chunks of TERRAIN_CHUNK_QUADS by TERRAIN_CHUNK_QUADS
+    tiles (smaller along the far edges) and build the indices of every level of
+    detail of each chunk, chunk by chunk. The vertices on chunk edges get a copy
+    fSkirtDepth below them for the skirts.
+*/
+void Mesh::buildTerrainChunks(int iTilesX, int iTilesY, float fGridSize, float fSkirtDepth)
+{
+    int iQuadsX = iTilesX - 1, iQuadsY = iTilesY - 1;
+    vector<int> pSkirtVertices(m_pVertices.size(), -1);     // Index of the vertex below each edge vertex
+    vector<int> pSamplesX, pSamplesY;
+
+    m_fTerrainChunkSize = TERRAIN_CHUNK_QUADS * fGridSize;
+    for (int x = 0; x < iTilesX; ++x)
+    {
+        for (int y = 0; y < iTilesY; ++y)
+        {
+            if (0 == (x % TERRAIN_CHUNK_QUADS) || 0 == (y % TERRAIN_CHUNK_QUADS) || iQuadsX == x || iQuadsY == y)
+            {
+                int iVertex = (x * iTilesY) + y;
+                pSkirtVertices[iVertex] = static_cast<int>(m_pVertices.size());
+                m_pVertices.push_back(m_pVertices[iVertex] - vec3(0.0f, fSkirtDepth, 0.0f));
+                m_pUVs.push_back(m_pUVs[iVertex]);
+                m_pNormals.push_back(m_pNormals[iVertex]);
+            }
+        }
+    }
+
+    for (int iChunkX = 0; iChunkX < iQuadsX; iChunkX += TERRAIN_CHUNK_QUADS)
+    {
+        for (int iChunkY = 0; iChunkY < iQuadsY; iChunkY += TERRAIN_CHUNK_QUADS)
+        {
+            int iEndX = std::min(iChunkX + TERRAIN_CHUNK_QUADS, iQuadsX);
+            int iEndY = std::min(iChunkY + TERRAIN_CHUNK_QUADS, iQuadsY);
+            sTerrainChunk sChunk;
+
+            // Bounds
+            sChunk.vMinimum = vec3(FLT_MAX);
+            sChunk.vMaximum = vec3(-FLT_MAX);
+            for (int x = iChunkX; x <= iEndX; ++x)
+            {
+                for (int y = iChunkY; y <= iEndY; ++y)
+                {
+                    sChunk.vMinimum = glm::min(sChunk.vMinimum, m_pVertices[(x * iTilesY) + y]);
+                    sChunk.vMaximum = glm::max(sChunk.vMaximum, m_pVertices[(x * iTilesY) + y]);
+                }
+            }
+            sChunk.vMinimum.y -= fSkirtDepth;
+            vec3 vCenter = (sChunk.vMinimum + sChunk.vMaximum) * 0.5f;
+
+            for (int iLod = 0; iLod < TERRAIN_LOD_LEVELS; ++iLod)
+            {
+                size_t iFirstIndex = m_pIndices.size();
+                getTerrainSamples(iChunkX, iEndX, 1 << iLod, &pSamplesX);
+                getTerrainSamples(iChunkY, iEndY, 1 << iLod, &pSamplesY);
+
+                /*
+                vertA___vertB
+                |     X      |
+                vertC___vertD
+                A is (x, y), B (x, y + 1), C (x + 1, y) and D (x + 1, y + 1) in samples.
+                */
+                for (unsigned int i = 0; (i + 1) < pSamplesX.size(); ++i)
+                {
+                    for (unsigned int j = 0; (j + 1) < pSamplesY.size(); ++j)
+                    {
+                        unsigned int vertA = (pSamplesX[i] * iTilesY) + pSamplesY[j];
+                        unsigned int vertB = (pSamplesX[i] * iTilesY) + pSamplesY[j + 1];
+                        unsigned int vertC = (pSamplesX[i + 1] * iTilesY) + pSamplesY[j];
+                        unsigned int vertD = (pSamplesX[i + 1] * iTilesY) + pSamplesY[j + 1];
+
+                        m_pIndices.insert(m_pIndices.end(), { vertD, vertC, vertA, vertB, vertD, vertA });
+                    }
+                }
+
+                // Skirts along the four edges
+                for (unsigned int i = 0; (i + 1) < pSamplesX.size(); ++i)
+                {
+                    for (int y : { iChunkY, iEndY })
+                    {
+                        unsigned int iVertA = (pSamplesX[i] * iTilesY) + y, iVertB = (pSamplesX[i + 1] * iTilesY) + y;
+                        addTerrainSkirt(m_pVertices, iVertA, iVertB, pSkirtVertices[iVertA], pSkirtVertices[iVertB],
+                                        m_pVertices[iVertA] - vCenter, &m_pIndices);
+                    }
+                }
+                for (unsigned int j = 0; (j + 1) < pSamplesY.size(); ++j)
+                {
+                    for (int x : { iChunkX, iEndX })
+                    {
+                        unsigned int iVertA = (x * iTilesY) + pSamplesY[j], iVertB = (x * iTilesY) + pSamplesY[j + 1];
+                        addTerrainSkirt(m_pVertices, iVertA, iVertB, pSkirtVertices[iVertA], pSkirtVertices[iVertB],
+                                        m_pVertices[iVertA] - vCenter, &m_pIndices);
+                    }
+                }
+
+                sChunk.pLevels[iLod].iIndexCount = static_cast<GLsizei>(m_pIndices.size() - iFirstIndex);
+                sChunk.pLevels[iLod].iIndexOffset = static_cast<GLintptr>(iFirstIndex * sizeof(unsigned int));
+            }
+
+            m_pTerrainChunks.push_back(sChunk);
+        }
+    }
+}
+
 // Generates a Sphere Mesh
 void Mesh::genSphere(float fRadius, vec3 vPosition, string sHashKey)
 {
@@ -257,7 +357,7 @@ void Mesh::genSphere(float fRadius, vec3 vPosition, string sHashKey)
 
         // Store Initial Transformation Matrix
         //m_m4ListOfInstances.push_back(m4InitialTransformation);
-        m_m4InstanceMap.insert(make_pair(sHashKey, m4InitialTransformation));
+        addInstance(&m4InitialTransformation, sHashKey);
     }
 
     // Store Mesh in GPU
@@ -414,7 +514,7 @@ void Mesh::genCube(float fHeight, float fWidth, float fDepth, vec3 vPosition, st
 
         // Store Initial Transformation Matrix in Transformation vector
         // m_m4ListOfInstances.push_back(m4InitialTransformationMatrix);
-        m_m4InstanceMap.insert(make_pair(sHashKey, m4InitialTransformationMatrix));
+        addInstance(&m4InitialTransformationMatrix, sHashKey);
     }
 
     initalizeVBOs();
@@ -424,43 +524,66 @@ void Mesh::genCube(float fHeight, float fWidth, float fDepth, vec3 vPosition, st
 //    the height and width will be set up and stored in the VBO as well.
 //    The billboard functionality of a Mesh will set up the VBOs in a very different manner:
 //        - For each data entry:
-//            * Vertex   (vec3)
-//            * Normal   (vec3)
-//            * UVStart  (vec2)
-//            * UVEnd    (vec2)
-//            * Height   (float)
-//            * Width    (float)
-//            * Duration (float)
+//            * Vertex          (vec3)
+//            * Normal          (vec3)
+//            * Color           (vec3)
+//            * Height          (float)
+//            * Width           (float)
+//            * Sprite Counts   (vec2)
+//            * UV Border       (vec2)
+//            * Start Frame     (float)
+//            * Spawn Time      (float)
+//            * Duration        (float)
 void Mesh::genBillboard()
 {
+    m_iBillboardCapacity = DEFAULT_BILLBOARD_CAPACITY;
+    initializeBillboardStream();
+}
+
+// Allocates the Billboard Stream for the current Billboard Capacity and points the Billboard Attributes at it.
+void Mesh::initializeBillboardStream()
+{
+    static_assert(sizeof(sBillboardInfo) == BILLBOARD_STRIDE, "Billboards are uploaded as is.");
+
     // Generate VBO
-    m_iVertexBuffer = m_pShdrMngr->genVertexBuffer(m_iVertexArray, nullptr, 0, GL_STATIC_DRAW);
+    m_sBillboardStream.initialize(m_iBillboardCapacity * BILLBOARD_STRIDE);
+    m_iFirstVertex = 0;
+    glBindVertexArray(m_iVertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, m_sBillboardStream.getBuffer());
 
     // Set up VBO Attributes
     m_pShdrMngr->setAttrib(m_iVertexArray, 0, 3, BILLBOARD_STRIDE, (void*)VERTEX_OFFSET);    /*Vertex*/
     m_pShdrMngr->setAttrib(m_iVertexArray, 1, 3, BILLBOARD_STRIDE, (void*)NORMAL_OFFSET);    /*Normal*/
     m_pShdrMngr->setAttrib(m_iVertexArray, 2, 3, BILLBOARD_STRIDE, (void*)COLOR_OFFSET);     /*Color*/
-    m_pShdrMngr->setAttrib(m_iVertexArray, 3, 2, BILLBOARD_STRIDE, (void*)UV_START_OFFSET);  /*UVStart*/
-    m_pShdrMngr->setAttrib(m_iVertexArray, 4, 2, BILLBOARD_STRIDE, (void*)UV_END_OFFSET);    /*UVEnd*/
-    m_pShdrMngr->setAttrib(m_iVertexArray, 5, 2, BILLBOARD_STRIDE, (void*)DIMENSION_OFFSET); /*Height/Width*/
-    m_pShdrMngr->setAttrib(m_iVertexArray, 6, 1, BILLBOARD_STRIDE, (void*)DURATION_OFFSET);  /*Duration*/
+    m_pShdrMngr->setAttrib(m_iVertexArray, 3, 2, BILLBOARD_STRIDE, (void*)DIMENSION_OFFSET);     /*Height/Width*/
+    m_pShdrMngr->setAttrib(m_iVertexArray, 4, 2, BILLBOARD_STRIDE, (void*)SPRITE_COUNT_OFFSET);  /*Sprite Counts*/
+    m_pShdrMngr->setAttrib(m_iVertexArray, 5, 2, BILLBOARD_STRIDE, (void*)UV_BORDER_OFFSET);     /*UV Border*/
+    m_pShdrMngr->setAttrib(m_iVertexArray, 6, 1, BILLBOARD_STRIDE, (void*)START_FRAME_OFFSET);   /*Start Frame*/
+    m_pShdrMngr->setAttrib(m_iVertexArray, 7, 1, BILLBOARD_STRIDE, (void*)SPAWN_TIME_OFFSET);    /*Spawn Time*/
+    m_pShdrMngr->setAttrib(m_iVertexArray, 8, 1, BILLBOARD_STRIDE, (void*)DURATION_OFFSET);      /*Duration*/
 }
 
 /****************************************************************************************\
  * Billboard Usage                                                                        *
 \****************************************************************************************/
 
-// Adds a Billboard object to the Mesh.
-unsigned int Mesh::addBillboard(const vec3* vPosition, const vec3* vNormal, const vec3* vColor, const vec2* vUVStart, const vec2* vUVEnd, float fHeight, float fWidth, float fDuration)
+// Adds a Billboard object to the Mesh at the current Billboard Time.
+unsigned int Mesh::addBillboard(const vec3* vPosition, const vec3* vNormal, const vec3* vColor, const vec2* vSpriteCounts, const vec2* vUVBorder,
+                                unsigned int iStartFrame, float fHeight, float fWidth, float fDuration)
 {
+    // The list is about to be uploaded anyway, so drop the Billboards that have expired.
+    removeExpiredBillboards();
+
     // Create new Billboard
     sBillboardInfo sNewBillboard;
     sNewBillboard.vPosition     = *vPosition;
     sNewBillboard.vNormal       = *vNormal;
     sNewBillboard.vColor        = *vColor;
-    sNewBillboard.vUVStart      = *vUVStart;
-    sNewBillboard.vUVEnd        = *vUVEnd;
     sNewBillboard.vDimensions   = vec2(fHeight, fWidth);
+    sNewBillboard.vSpriteCounts = *vSpriteCounts;
+    sNewBillboard.vUVBorder     = *vUVBorder;
+    sNewBillboard.fStartFrame   = static_cast<float>(iStartFrame);
+    sNewBillboard.fSpawnTime    = m_fBillboardTime;
     sNewBillboard.fDuration     = fDuration;
 
     // add to main list
@@ -473,20 +596,69 @@ unsigned int Mesh::addBillboard(const vec3* vPosition, const vec3* vNormal, cons
     return m_pBillboardList.size() - 1;
 }
 
+// Flag the Billboards to be written to the Billboard Stream on the next upload.
 void Mesh::updateBillboardVBO()
 {
-    // Update in VBO
-    glBindBuffer(GL_ARRAY_BUFFER, m_iVertexBuffer);
-    glBufferData(GL_ARRAY_BUFFER, m_pBillboardList.size() * sizeof(sBillboardInfo), m_pBillboardList.data(), GL_DYNAMIC_DRAW);
+    m_bBillboardsChanged = true;
 }
 
 // Clear VBO data and Clear the Billboard data internally.
 void Mesh::flushBillboards()
 {
-    glBindBuffer(GL_ARRAY_BUFFER, m_iVertexBuffer);
-    glBufferData(GL_ARRAY_BUFFER, 0, (void*)0, GL_DYNAMIC_DRAW);
-
     m_pBillboardList.clear();
+    m_bBillboardsChanged = true;
+}
+
+// Removes the Billboards whose duration has passed.
+void Mesh::removeExpiredBillboards()
+{
+    vector<sBillboardInfo>::iterator pNewEnd = remove_if(m_pBillboardList.begin(), m_pBillboardList.end(),
+        [this](sBillboardInfo const & p) { return (p.fSpawnTime + p.fDuration) <= m_fBillboardTime; });
+
+    if (m_pBillboardList.end() != pNewEnd)
+    {
+        m_pBillboardList.erase(pNewEnd, m_pBillboardList.end());
+        m_bBillboardsChanged = true;
+    }
+}
+
+/*
+    Advance the time the Billboards are animated at. Only the time changes, the
+    Billboards themselves are left alone unless they have all expired, in which
+    case the list is emptied so nothing is drawn.
+
+    @param fTime    seconds since the Billboards' clock started
+*/
+void Mesh::setBillboardTime(float fTime)
+{
+    m_fBillboardTime = fTime;
+
+    // All Billboards of a Mesh last as long, so the last one added expires last.
+    if (!m_pBillboardList.empty() && (m_pBillboardList.back().fSpawnTime + m_pBillboardList.back().fDuration) <= m_fBillboardTime)
+        removeExpiredBillboards();
+}
+
+// Writes all Billboards to the next region of the Billboard Stream if they changed since the last upload.
+void Mesh::uploadBillboards()
+{
+    if (!m_bBillboardsChanged || !m_sBillboardStream.isInitialized())
+        return;
+
+    // Grow the Stream if necessary
+    if (m_pBillboardList.size() > m_iBillboardCapacity)
+    {
+        m_iBillboardCapacity = std::max(static_cast<unsigned int>(m_pBillboardList.size()), m_iBillboardCapacity * 2);
+        initializeBillboardStream();
+    }
+
+    void* pData = m_sBillboardStream.beginWrite();
+    if (nullptr != pData)
+        memcpy(pData, m_pBillboardList.data(), m_pBillboardList.size() * sizeof(sBillboardInfo));
+    m_sBillboardStream.endWrite();
+
+    // The Billboard Attributes always point at the start of the Stream, so select the region with the first vertex.
+    m_iFirstVertex = static_cast<GLint>(m_sBillboardStream.getReadOffset() / BILLBOARD_STRIDE);
+    m_bBillboardsChanged = false;
 }
 
 void Mesh::gatherVNData(vector<float>* vVNData, bool* bUsingNormals, bool* bUsingUVs)
@@ -531,15 +703,22 @@ void Mesh::gatherVNData(vector<float>* vVNData, bool* bUsingNormals, bool* bUsin
 }
 
 // Initialize the GPU with Mesh Data and tell it how to read it.
-void Mesh::initalizeVBOs(const vector<float>* vVNData, bool bUsingNormals, bool bUsingUVs)
+//  pVNData is interleaved position[, normal][, uv] data, iVNDataSize bytes long.
+//  Quantized data has 10:10:10:2 normals and half float uvs, see MeshOptimizer::quantizeVertices.
+void Mesh::initalizeVBOs(const void* pVNData, size_t iVNDataSize, bool bUsingNormals, bool bUsingUVs, bool bQuantized)
 {
+    // The vertices are final now, so the Instances can be bounded.
+    computeBoundingSphere();
+
     // Calculate Stride for setting up Attributes
+    GLsizei iNormalSize = bQuantized ? sizeof(unsigned int) : sizeof(vec3);
+    GLsizei iUVSize = bQuantized ? sizeof(unsigned int) : sizeof(vec2);
     GLsizei iStride = sizeof(vec3) +
-        (bUsingNormals ? sizeof(vec3) : 0) +
-        (bUsingUVs ? sizeof(vec2) : 0);
+        (bUsingNormals ? iNormalSize : 0) +
+        (bUsingUVs ? iUVSize : 0);
     
     // Generate VBO
-    m_iVertexBuffer = m_pShdrMngr->genVertexBuffer(m_iVertexArray, vVNData->data(), vVNData->size() * sizeof(float), GL_STATIC_DRAW);
+    m_iVertexBuffer = m_pShdrMngr->genVertexBuffer(m_iVertexArray, pVNData, iVNDataSize, GL_STATIC_DRAW);
 
     // Set-up Attributes
     // Vertices
@@ -547,18 +726,23 @@ void Mesh::initalizeVBOs(const vector<float>* vVNData, bool bUsingNormals, bool
     // Normals
     if (bUsingNormals)
     {
-        m_pShdrMngr->setAttrib(m_iVertexArray, 1, 3, iStride, (void*)sizeof(vec3));
+        if (bQuantized)
+            m_pShdrMngr->setAttrib(m_iVertexArray, 1, 4, iStride, (void*)sizeof(vec3), GL_INT_2_10_10_10_REV, GL_TRUE);
+        else
+            m_pShdrMngr->setAttrib(m_iVertexArray, 1, 3, iStride, (void*)sizeof(vec3));
     }
     // UVs
-    if (bUsingUVs) // Specified index could be 1 or 2 and Start location is Stride - sizeof(vec2) depending on if Normals exist.
+    if (bUsingUVs) // Specified index could be 1 or 2 and Start location is Stride - sizeof(UV) depending on if Normals exist.
     {
-        m_pShdrMngr->setAttrib(m_iVertexArray, 2, 2, iStride, (void*)(iStride - sizeof(vec2)));
+        m_pShdrMngr->setAttrib(m_iVertexArray, 2, 2, iStride, (void*)(iStride - iUVSize), bQuantized ? GL_HALF_FLOAT : GL_FLOAT);
     }
 
-    // Initialize Instance Buffer
-    m_iInstancedBuffer = SHADER_MANAGER->genInstanceBuffer(m_iVertexArray, 3, NULL,
-                                                        m_m4InstanceMap.size() * sizeof(mat4), GL_DYNAMIC_DRAW);
-    loadInstanceBuffer();
+    // Initialize Instance Stream, the Instances are written on the next upload.
+    m_iInstanceCapacity = std::max(static_cast<unsigned int>(m_pInstanceTransforms.size()), static_cast<unsigned int>(DEFAULT_INSTANCE_CAPACITY));
+    m_sInstanceStream.initialize(m_iInstanceCapacity * sizeof(mat4));
+    SHADER_MANAGER->setInstanceAttribs(m_iVertexArray, 3, m_sInstanceStream.getBuffer(), 0);
+    m_iInstanceDivisor = 1;
+    markAllInstancesDirty();
 
     // Set up Indices if applicable
     if (!m_pIndices.empty())
@@ -580,171 +764,245 @@ void Mesh::initalizeVBOs()
     bool bUsingNormals, bUsingUVs;
 
     gatherVNData(&vVNData, &bUsingNormals, &bUsingUVs);
-    initalizeVBOs(&vVNData, bUsingNormals, bUsingUVs);
+    initalizeVBOs(vVNData.data(), vVNData.size() * sizeof(float), bUsingNormals, bUsingUVs);
 }
 
-// Code for Loading a .obj file. Not comprehensive, will generate its own normals and will fail to load any
-//        faces that are not quads or tris. Algorithm modified from original written by Andrew Robert Owens.
+// Load a .obj file and its material. The cooked binary of the file is used if it's
+//  up to date, otherwise the file is parsed and cooked for the next load.
+//  If the file was preloaded with the scene, only the upload is left to do.
 bool Mesh::loadObj(const string& sFileName)
 {
     // Locals
-    ifstream in(sFileName.c_str());
-    bool bReturnValue = in.is_open();
-    vec2 vXRange, vYRange, vZRange;     // Compute Basic cubic convex hull for Spatial information.
-    vector <float> vVNData;
-    unordered_map<string, unsigned int> pIndexMap;
-    unsigned int iIndexTick = 0;
-    vZRange = vYRange = vXRange = vec2(numeric_limits<float>::max(), numeric_limits<float>::min());
-
-    // Failed to load file.
-    if (!bReturnValue)
-        cerr << "Could not Load Mesh File: " << sFileName << ".\n";
+    unique_ptr<CookedMesh> pCookedMesh;
+    ObjParser::sMaterial sMaterial;
+    bool bReturnValue;
+
+    if (ASSET_PRELOADER->takeMesh(sFileName, &pCookedMesh))
+        bReturnValue = nullptr != pCookedMesh;
     else
     {
-        // Local for Extraction
-        string sInput;
-        vec3 vTempVec;
-
-        // Read through file.
-        while (getline(in, sInput))
+        pCookedMesh = make_unique<CookedMesh>();
+        bReturnValue = pCookedMesh->open(sFileName);
+        if (!bReturnValue)
         {
-            stringstream ssLine(sInput);
-            string sToken;
+            ObjParser pParser;
+            bReturnValue = pParser.parse(sFileName);
+            if (bReturnValue)
+                pCookedMesh->cook(&pParser, sFileName);
+        }
+    }
 
-            // Read first token from line
-            ssLine >> sToken;
+    if (bReturnValue && 0 != pCookedMesh->getPositionCount())
+    {
+        // Store computed Spatial Range
+        m_vNegativeOffset = m_m4ScaleMatrix * vec4(pCookedMesh->getMinimum(), 1.0f);  // Min
+        m_vPositiveOffset = m_m4ScaleMatrix * vec4(pCookedMesh->getMaximum(), 1.0f);  // Max
+
+        // Keep the positions for physics and the indices for drawing.
+        m_pVertices.assign(pCookedMesh->getPositions(), pCookedMesh->getPositions() + pCookedMesh->getPositionCount());
+        m_pIndices.assign(pCookedMesh->getIndices(), pCookedMesh->getIndices() + pCookedMesh->getIndexCount());
+
+        // Upload straight from the cooked data
+        initalizeVBOs(pCookedMesh->getVertexData(), pCookedMesh->getVertexDataSize(),
+                      pCookedMesh->hasNormals(), pCookedMesh->hasUVs(), pCookedMesh->isQuantized());
+        loadLods(pCookedMesh.get());
+        if (pCookedMesh->getMaterial(&sMaterial))
+            loadObjMaterial(&sMaterial);
+    }
 
-            if ("v" == sToken)    // Vertex Data
-            {
-                ssLine >> vTempVec.x >> vTempVec.y >> vTempVec.z;
-                m_pVertices.push_back(vTempVec);
+    return bReturnValue;
+}
 
-                // Evaluate cubic convex hull
-                vXRange.x = vTempVec.x < vXRange.x ? vTempVec.x : vXRange.x;    // X Range Min
-                vXRange.y = vTempVec.x > vXRange.y ? vTempVec.x : vXRange.y;    // X Range Max
+// Replace the Index Buffer with the indices of every detail level of a cooked mesh.
+//  m_pIndices keeps the full mesh, which is what physics and getCount() use.
+void Mesh::loadLods(const CookedMesh* pCookedMesh)
+{
+    GLintptr iOffset = 0;
+    m_pLodLevels.clear();
+    if (pCookedMesh->getLodCount() < 2)
+        return;
 
-                vYRange.x = vTempVec.y < vYRange.x ? vTempVec.y : vYRange.x;    // Y Range Min
-                vYRange.y = vTempVec.y > vYRange.y ? vTempVec.y : vYRange.y;    // Y Range Max
+    for (unsigned int i = 0; i < pCookedMesh->getLodCount(); ++i)
+    {
+        sLodLevel sLevel = { static_cast<GLsizei>(pCookedMesh->getLodIndexCount(i)), iOffset };
+        m_pLodLevels.push_back(sLevel);
+        iOffset += sLevel.iIndexCount * sizeof(unsigned int);
+    }
 
-                vZRange.x = vTempVec.z < vZRange.x ? vTempVec.z : vZRange.x;    // Z Range Min
-                vZRange.y = vTempVec.z > vZRange.y ? vTempVec.z : vZRange.y;    // Z Range Max
-            }
-            else if ("vt" == sToken) // uv-coords
-            {
-                ssLine >> vTempVec.x >> vTempVec.y >> vTempVec.z;
-                m_pUVs.push_back(vec2(vTempVec));
-            }
-            else if ("vn" == sToken) // Normal
+    glBindVertexArray(m_iVertexArray);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_iIndicesBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, iOffset, pCookedMesh->getIndices(), GL_STATIC_DRAW);
+    glBindVertexArray(0);
+}
+
+/*
+    Estimate how large the Mesh appears on screen from the bounding sphere of its
+    nearest Instance.
+
+    @param vViewPosition    world position of the camera
+    @param fPixelsPerUnit   height in pixels of one unit at a distance of one unit
+    @return projected diameter in pixels
+*/
+float Mesh::getLargestProjectedSize(const vec3* vViewPosition, float fPixelsPerUnit) const
+{
+    float fLargestSize = 0.0f;
+    for (const vec4& vBounds : m_pInstanceBounds)
+    {
+        float fRadius = vBounds.w;
+        float fDistance = length(vec3(vBounds) - *vViewPosition);
+
+        // Inside the sphere: as large as it gets.
+        if (fDistance <= fRadius)
+            return FLT_MAX;
+        fLargestSize = std::max(fLargestSize, (2.0f * fRadius * fPixelsPerUnit) / fDistance);
+    }
+
+    return fLargestSize;
+}
+
+// Distance from the viewer to the surface of the nearest Instance bounds, 0 if it has none.
+float Mesh::getNearestInstanceDistance(const vec3* vViewPosition) const
+{
+    float fNearest = m_pInstanceBounds.empty() ? 0.0f : FLT_MAX;
+    for (const vec4& vBounds : m_pInstanceBounds)
+        fNearest = std::min(fNearest, std::max(length(vec3(vBounds) - *vViewPosition) - vBounds.w, 0.0f));
+    return fNearest;
+}
+
+// Bounding Sphere of the vertices, then of every Instance already added.
+void Mesh::computeBoundingSphere()
+{
+    vec3 vMinimum = vec3(FLT_MAX), vMaximum = vec3(-FLT_MAX);
+
+    m_vBoundingCenter = vec3(0.0f);
+    m_fBoundingRadius = 0.0f;
+    if (!m_pVertices.empty())
+    {
+        for (const vec3& vVertex : m_pVertices)
+        {
+            vMinimum = glm::min(vMinimum, vVertex);
+            vMaximum = glm::max(vMaximum, vVertex);
+        }
+        m_vBoundingCenter = (vMinimum + vMaximum) * 0.5f;
+        m_fBoundingRadius = length(vMaximum - vMinimum) * 0.5f;
+    }
+
+    for (unsigned int i = 0; i < m_pInstanceTransforms.size(); ++i)
+        m_pInstanceBounds[i] = getInstanceBounds(&m_pInstanceTransforms[i]);
+}
+
+// World Bounding Sphere of an Instance from its scaled transform.
+vec4 Mesh::getInstanceBounds(const mat4* m4ScaledTransform) const
+{
+    const mat4& m4Transform = *m4ScaledTransform;
+    float fScale = std::max(length(vec3(m4Transform[0])), std::max(length(vec3(m4Transform[1])), length(vec3(m4Transform[2]))));
+    return vec4(vec3(m4Transform * vec4(m_vBoundingCenter, 1.0f)), m_fBoundingRadius * fScale);
+}
+
+/*
+    Collect the Instances whose Bounding Sphere intersects the frustum of a view
+    and isn't hidden from its camera by the arena (see the Potentially Visible
+    Set of the Spatial Data Map), and point the Instance Attributes at them:
+    the Instance Stream itself if all of them are visible, otherwise the
+    visible transforms written to the Visible Stream of the view. When several
+    views are drawn together, an Instance is visible if any of them sees it.
+
+    @param pFrusta          frustums of the views being drawn
+    @param pViewCells       cell of the Potentially Visible Set of each view, -1 if it isn't used
+    @param iFrustumCount    number of frustums
+    @param iView            index of the view, SHADOW_VIEW for the shadow pass or MULTI_VIEW
+    @return number of Instances to draw, 0 if none are visible
+*/
+GLsizei Mesh::cullInstances(const sFrustum* pFrusta, const int* pViewCells, unsigned int iFrustumCount, unsigned int iView) const
+{
+    const SpatialDataMap* pSpatialMap = SPATIAL_DATA_MAP;
+
+    m_pVisibleTransforms.clear();
+    for (unsigned int i = 0; i < m_pInstanceBounds.size(); ++i)
+    {
+        vec3 vCenter = vec3(m_pInstanceBounds[i]);
+        for (unsigned int iFrustum = 0; iFrustum < iFrustumCount; ++iFrustum)
+        {
+            if (pFrusta[iFrustum].intersectsSphere(&vCenter, m_pInstanceBounds[i].w) &&
+                pSpatialMap->isPotentiallyVisible(pViewCells[iFrustum], &m_pInstanceBounds[i]))
             {
-                ssLine >> vTempVec.x >> vTempVec.y >> vTempVec.z;
-                m_pNormals.push_back(vTempVec);
-            }
-            else if ("g" == sToken) // Group
-            {/* Ignored */
-            }
-            else if ("o" == sToken) // Object Name
-            {/* Ignored */
+                m_pVisibleTransforms.push_back(m_pInstanceTransforms[i]);
+                break;
             }
-            else if ("f" == sToken) // Face
-            {
-                // Local Variables for reading face.
-                int iIndices[3] = { -1, -1, -1 };
-                vector< unsigned int > vFaceVerts;
-                string pTupleKey;
-
-                // Read through rest of line
-                while (ssLine >> sInput)
-                {
-                    // Set up parser and reset previous indices
-                    stringstream ssItem(sInput);
-                    iIndices[0] = iIndices[1] = iIndices[2] = -1;
+        }
+    }
 
-                    // Read in face line
-                    for (int j = 0; getline(ssItem, sInput, '/') && j < 3; ++j)
-                    {
-                        stringstream ssIndex(sInput);
-                        ssIndex >> iIndices[j];
-                    }
+    if (m_pVisibleTransforms.size() == m_pInstanceTransforms.size())
+    {
+        if (m_bDrawingVisibleStream)
+        {
+            m_pShdrMngr->setInstanceAttribs(m_iVertexArray, 3, m_sInstanceStream.getBuffer(), m_sInstanceStream.getReadOffset());
+            m_bDrawingVisibleStream = false;
+            m_iInstanceDivisor = 1;
+        }
+    }
+    else if (!m_pVisibleTransforms.empty())
+    {
+        StreamBuffer& sVisibleStream = m_sVisibleStreams[iView];
+        if (m_pVisibleTransforms.size() > m_iVisibleCapacity[iView])
+        {
+            m_iVisibleCapacity[iView] = std::max(m_iInstanceCapacity, static_cast<unsigned int>(m_pVisibleTransforms.size()));
+            sVisibleStream.initialize(m_iVisibleCapacity[iView] * sizeof(mat4));
+        }
 
-                    // Convert to 0-based indices
-                    iIndices[0] = (-1 == iIndices[0] ? iIndices[0] : iIndices[0] - 1); // Vertex
-                    iIndices[1] = (-1 == iIndices[1] ? iIndices[1] : iIndices[1] - 1); // UV-Coord
-                    iIndices[2] = (-1 == iIndices[2] ? iIndices[2] : iIndices[2] - 1); // Normal
-                    pTupleKey = to_string(iIndices[0]) + to_string(iIndices[1]) + to_string(iIndices[2]);
+        void* pData = sVisibleStream.beginWrite();
+        if (nullptr != pData)
+            memcpy(pData, m_pVisibleTransforms.data(), m_pVisibleTransforms.size() * sizeof(mat4));
+        sVisibleStream.endWrite();
 
-                    // If the Index for this tuple doesn't exist yet, add it to the map.
-                    if (pIndexMap.find(pTupleKey) == pIndexMap.end())
-                    {
-                        // Add Vertex Data
-                        vVNData.push_back(m_pVertices[iIndices[0]].x);
-                        vVNData.push_back(m_pVertices[iIndices[0]].y);
-                        vVNData.push_back(m_pVertices[iIndices[0]].z);
-
-                        // Add Normal Data
-                        if (!m_pNormals.empty())
-                        {
-                            vVNData.push_back(m_pNormals[iIndices[2]].x);
-                            vVNData.push_back(m_pNormals[iIndices[2]].y);
-                            vVNData.push_back(m_pNormals[iIndices[2]].z);
-                        }
-
-                        // Add UV Data
-                        if (!m_pUVs.empty())
-                        {
-                            vVNData.push_back(m_pUVs[iIndices[1]].x);
-                            vVNData.push_back(1.0f - m_pUVs[iIndices[1]].y);
-                        }
-
-                        // Store Index in Index Map
-                        pIndexMap.insert(make_pair(pTupleKey, iIndexTick++));
-                    }
+        m_pShdrMngr->setInstanceAttribs(m_iVertexArray, 3, sVisibleStream.getBuffer(), sVisibleStream.getReadOffset());
+        m_bDrawingVisibleStream = true;
+        m_iInstanceDivisor = 1;
+    }
 
-                    // Collect the Face Indices for the Data
-                    vFaceVerts.push_back(pIndexMap[pTupleKey]);
-                }
+    return static_cast<GLsizei>(m_pVisibleTransforms.size());
+}
 
-                // Store Indices; Only handles 3-4 vert faces.
-                if (3 <= vFaceVerts.size())
-                {
-                    // Triangle
-                    for (int i = 0; i < 3; ++i)
-                        m_pIndices.push_back(vFaceVerts[i]);
-                
-                    // Quad
-                    if (4 == vFaceVerts.size())
-                    {
-                        // Store other Triangle
-                        int j = 2;
-                        for (int i = 0; i < 3; ++i)
-                        {
-                            m_pIndices.push_back(vFaceVerts[j]);
-                            j = (j + 1) & 3;
-                        }
-                    }
-                    else if (3 != vFaceVerts.size()) // Error
-                    {
-                        cerr << "Invalid Object in File: " << sFileName << ".\n";
-                        bReturnValue = false;
-                    }
-                } // END Indices Store
-            }// END Face
-        } // END While
+/*
+    When the views are drawn together, every Instance is drawn once per view in
+    a row: the Instance Attributes advance every iViews instances and the shader
+    picks the view from the instance index. Only changed when needed, as the
+    Instance Attributes are set back to a divisor of 1 whenever they're pointed
+    at another Stream.
+*/
+void Mesh::setInstanceDivisor(GLuint iViews) const
+{
+    if (iViews == m_iInstanceDivisor || !usingInstanced())
+        return;
 
-        // Close file when finished.
-        in.close();
+    glBindVertexArray(m_iVertexArray);
+    for (GLuint i = 0; i < 4; ++i)
+        glVertexAttribDivisor(3 + i, iViews);
+    m_iInstanceDivisor = iViews;
+}
 
-        // Store computed Spatial Range
-        m_vNegativeOffset = m_m4ScaleMatrix * vec4(vXRange.x, vYRange.x, vZRange.x, 1.0f);  // Min
-        m_vPositiveOffset = m_m4ScaleMatrix * vec4(vXRange.y, vYRange.y, vZRange.y, 1.0f);  // Max
+// Test a Terrain Chunk of every Instance against the frustum and find the nearest one in view.
+bool Mesh::getChunkVisibility(unsigned int iChunk, const sFrustum* pFrustum, const vec3* vViewPosition, float* fDistance) const
+{
+    const sTerrainChunk& sChunk = m_pTerrainChunks[iChunk];
+    vec3 vMinimum, vMaximum;
+    bool bVisible = false;
 
-        // Set up special VBOs for Mesh
-        initalizeVBOs(&vVNData, !m_pNormals.empty(), !m_pUVs.empty());
+    *fDistance = FLT_MAX;
+    for (const mat4& m4Transform : m_pInstanceTransforms)
+    {
+        sFrustum::transformBox(&m4Transform, &sChunk.vMinimum, &sChunk.vMaximum, &vMinimum, &vMaximum);
+        if (pFrustum->intersectsBox(&vMinimum, &vMaximum))
+        {
+            bVisible = true;
+            *fDistance = std::min(*fDistance, distance(*vViewPosition, clamp(*vViewPosition, vMinimum, vMaximum)));
+        }
     }
 
-    return bReturnValue;
+    return bVisible;
 }
 
-void Mesh::addInstance(const vec3* vPosition, const vec3* vNormal, float fScale, string sHashKey)
+unsigned int Mesh::addInstance(const vec3* vPosition, const vec3* vNormal, float fScale, string sHashKey)
 {
     // Order as Scale -> Rotation -> Translation
     mat4 m4NewTransform = scale(vec3(fScale));
@@ -752,76 +1010,231 @@ void Mesh::addInstance(const vec3* vPosition, const vec3* vNormal, float fScale,
     m4NewTransform = translate(*vPosition) * m4NewTransform;
 
     // Utilize Overloaded Function for functionality.
-    addInstance(&m4NewTransform, sHashKey);
+    return addInstance(&m4NewTransform, sHashKey);
 }
 
-// Take in a new Transformation Matrix, update the internal transform list as well as the VBO
-void Mesh::addInstance(const mat4* m4Transform, string sHashKey)
+// Add an Instance that can later be updated or removed by its HashKey.
+//  If an Instance already exists for the HashKey, that Instance is kept and its handle returned.
+unsigned int Mesh::addInstance(const mat4* m4Transform, string sHashKey)
 {
-    // Local Variables
-    mat4 m4ScaledTransform = *m4Transform * m_m4ScaleMatrix;
+    unordered_map<string, unsigned int>::const_iterator pIter = m_pInstanceKeys.find(sHashKey);
+    if (pIter != m_pInstanceKeys.end())
+        return pIter->second;
 
-    // Add new Transformation
-    m_m4InstanceMap.insert(make_pair(sHashKey, m4ScaledTransform));   // Add the New instance to the Instance Buffer
+    unsigned int iHandle = addInstance(m4Transform);
+    m_pInstanceKeys.insert(make_pair(sHashKey, iHandle));
+    return iHandle;
+}
 
-    // Load VBO with new Data.
-    loadInstanceBuffer();
+// Take in a new Transformation Matrix and store it as a new Instance.
+//  Returns the handle to update or remove the Instance with.
+unsigned int Mesh::addInstance(const mat4* m4Transform)
+{
+    // Local Variables
+    mat4 m4ScaledTransform = *m4Transform * m_m4ScaleMatrix;
 
-    // Add the Same instance for the Bounding Box
-    addBBInstance(m4Transform, sHashKey);
+    // The Bounding Box uses the unscaled Transformation
+    return storeInstance(&m4ScaledTransform, m4Transform);
 }
 
 // Update the Instance with the specified HashKey.
 void Mesh::updateInstance(const mat4* m4Transform, string sHashKey)
 {
     // Ensure the specified index is a valid index.
-    if (m_m4InstanceMap.find(sHashKey) != m_m4InstanceMap.end())
-    {
-        mat4 m4ScaledTransform = *m4Transform * m_m4ScaleMatrix;    // Scale transformation with Scale MAtrix for the model.
+    unordered_map<string, unsigned int>::const_iterator pIter = m_pInstanceKeys.find(sHashKey);
+    if (pIter != m_pInstanceKeys.end())
+        updateInstance(m4Transform, pIter->second);
+}
 
-        // Update the local List of Instances with the updated Transformation.
-        m_m4InstanceMap[sHashKey] = m4ScaledTransform;
-        loadInstanceBuffer();
+// Update the Instance with the specified Handle.
+void Mesh::updateInstance(const mat4* m4Transform, unsigned int iHandle)
+{
+    assert(iHandle < m_pInstanceHandleSlots.size() && INVALID_INSTANCE_HANDLE != m_pInstanceHandleSlots[iHandle]);
+    unsigned int iSlot = m_pInstanceHandleSlots[iHandle];
 
-        // Update the Bounding Box Transformation if the Bounding Box is loaded.
-        if (m_sBoundingBox.isLoaded())
-            m_sBoundingBox.updateInstance(m4Transform, sHashKey);
-    }
+    m_pInstanceTransforms[iSlot] = *m4Transform * m_m4ScaleMatrix;    // Scale transformation with Scale MAtrix for the model.
+    m_pBBInstanceTransforms[iSlot] = *m4Transform;
+    m_pInstanceBounds[iSlot] = getInstanceBounds(&m_pInstanceTransforms[iSlot]);
+    markInstanceDirty(iSlot);
+    if (m_bStaticMesh)
+        ++m_iStaticInstanceRevision;
 }
 
 // Removes an Instance from the Transformation list at the specified index.
 void Mesh::removeInstance(string sHashKey)
 {
-    if (m_m4InstanceMap.find(sHashKey) != m_m4InstanceMap.end())
+    unordered_map<string, unsigned int>::iterator pIter = m_pInstanceKeys.find(sHashKey);
+    if (pIter != m_pInstanceKeys.end())
     {
-        // Remove Insatnce
-        m_m4InstanceMap.erase(sHashKey);
-
-        // Update the VBO with the new transformation
-        loadInstanceBuffer();
-        
-        // Apply same to Bounding Box
-        if (m_sBoundingBox.isLoaded())
-            m_sBoundingBox.removeInstance(sHashKey);
+        removeInstance(pIter->second);
+        m_pInstanceKeys.erase(pIter);
     }
 }
 
-// Pulls Instances from the instance map and stores the data in the Instance Buffer of the GPU.
-void Mesh::loadInstanceBuffer()
+// Removes the Instance with the specified Handle.
+//  The last Instance is moved into the freed slot so the Instances stay densely packed.
+void Mesh::removeInstance(unsigned int iHandle)
 {
-    // Local Variables
-    vector<mat4> pInstanceList;
-    pInstanceList.reserve(m_m4InstanceMap.size());  // Reserve size to avoid unnecessary resizing.
-
-    // Populate Vector
-    for (unordered_map<string, mat4>::iterator pIter = m_m4InstanceMap.begin();
-        pIter != m_m4InstanceMap.end();
-        ++pIter)
-        pInstanceList.push_back(pIter->second);
-
-    // Store data in GPU
-    glBindBuffer(GL_ARRAY_BUFFER, m_iInstancedBuffer);
-    glBufferData(GL_ARRAY_BUFFER, pInstanceList.size() * sizeof(mat4), pInstanceList.data(), GL_DYNAMIC_DRAW);
+    if (iHandle >= m_pInstanceHandleSlots.size() || INVALID_INSTANCE_HANDLE == m_pInstanceHandleSlots[iHandle])
+        return;
+
+    unsigned int iSlot = m_pInstanceHandleSlots[iHandle];
+    unsigned int iLastSlot = m_pInstanceTransforms.size() - 1;
+
+    // Move the last Instance into the removed slot
+    if (iSlot != iLastSlot)
+    {
+        unsigned int iMovedHandle = m_pInstanceSlotHandles[iLastSlot];
+        m_pInstanceTransforms[iSlot] = m_pInstanceTransforms[iLastSlot];
+        m_pBBInstanceTransforms[iSlot] = m_pBBInstanceTransforms[iLastSlot];
+        m_pInstanceBounds[iSlot] = m_pInstanceBounds[iLastSlot];
+        m_pInstanceSlotHandles[iSlot] = iMovedHandle;
+        m_pInstanceHandleSlots[iMovedHandle] = iSlot;
+        markInstanceDirty(iSlot);
+    }
+
+    m_pInstanceTransforms.pop_back();
+    m_pBBInstanceTransforms.pop_back();
+    m_pInstanceBounds.pop_back();
+    m_pInstanceSlotHandles.pop_back();
+
+    // Release the Handle
+    m_pInstanceHandleSlots[iHandle] = INVALID_INSTANCE_HANDLE;
+    m_pFreeInstanceHandles.push_back(iHandle);
+
+    // The dirty ranges never need to extend past the end of the Instances.
+    for (unsigned int i = 0; i < STREAM_BUFFER_REGIONS; ++i)
+    {
+        m_iDirtyEnd[i] = std::min(m_iDirtyEnd[i], static_cast<unsigned int>(m_pInstanceTransforms.size()));
+        m_iDirtyBegin[i] = std::min(m_iDirtyBegin[i], m_iDirtyEnd[i]);
+    }
+    m_bInstancesChanged = true;
+    if (m_bStaticMesh)
+        ++m_iStaticInstanceRevision;
+}
+
+// Appends a new Instance to the end of the Instance list and assigns it a Handle.
+unsigned int Mesh::storeInstance(const mat4* m4ScaledTransform, const mat4* m4BBTransform)
+{
+    unsigned int iSlot = m_pInstanceTransforms.size();
+    unsigned int iHandle;
+
+    // Reuse a released Handle if possible
+    if (!m_pFreeInstanceHandles.empty())
+    {
+        iHandle = m_pFreeInstanceHandles.back();
+        m_pFreeInstanceHandles.pop_back();
+        m_pInstanceHandleSlots[iHandle] = iSlot;
+    }
+    else
+    {
+        iHandle = m_pInstanceHandleSlots.size();
+        m_pInstanceHandleSlots.push_back(iSlot);
+    }
+
+    m_pInstanceTransforms.push_back(*m4ScaledTransform);
+    m_pBBInstanceTransforms.push_back(*m4BBTransform);
+    m_pInstanceBounds.push_back(getInstanceBounds(m4ScaledTransform));
+    m_pInstanceSlotHandles.push_back(iHandle);
+    markInstanceDirty(iSlot);
+    if (m_bStaticMesh)
+        ++m_iStaticInstanceRevision;
+
+    return iHandle;
+}
+
+// Grows the dirty range of every region to include the given slot.
+void Mesh::markInstanceDirty(unsigned int iSlot)
+{
+    for (unsigned int i = 0; i < STREAM_BUFFER_REGIONS; ++i)
+    {
+        if (m_iDirtyBegin[i] == m_iDirtyEnd[i])   // Nothing dirty yet
+        {
+            m_iDirtyBegin[i] = iSlot;
+            m_iDirtyEnd[i] = iSlot + 1;
+        }
+        else
+        {
+            m_iDirtyBegin[i] = std::min(m_iDirtyBegin[i], iSlot);
+            m_iDirtyEnd[i] = std::max(m_iDirtyEnd[i], iSlot + 1);
+        }
+    }
+    m_bInstancesChanged = true;
+}
+
+// Flags every Instance to be written to every region, used when the Instance Streams are reallocated.
+void Mesh::markAllInstancesDirty()
+{
+    for (unsigned int i = 0; i < STREAM_BUFFER_REGIONS; ++i)
+    {
+        m_iDirtyBegin[i] = 0;
+        m_iDirtyEnd[i] = m_pInstanceTransforms.size();
+    }
+    m_bInstancesChanged = true;
+}
+
+// Called once per frame by the MeshManager before anything is rendered.
+void Mesh::uploadStreams()
+{
+    uploadInstances();
+    uploadBillboards();
+}
+
+/*
+    If any Instance changed since the last upload, write the dirty range of the
+    next region of the Instance Streams of the Mesh and its Bounding Box. Both
+    Streams are always written together so they cycle through their regions in
+    step. The Streams are only reallocated when the Instances outgrow them.
+*/
+void Mesh::uploadInstances()
+{
+    bool bUsingBoundingBox = m_sBoundingBox.isLoaded();
+    if (!m_sInstanceStream.isInitialized())
+        return;
+
+    // Reallocate the Streams if the Instances outgrew them or a Bounding Box was loaded since.
+    if (m_pInstanceTransforms.size() > m_iInstanceCapacity ||
+        (bUsingBoundingBox && !m_sBoundingBox.sInstanceStream.isInitialized()))
+    {
+        m_iInstanceCapacity = std::max(static_cast<unsigned int>(m_pInstanceTransforms.size()), m_iInstanceCapacity * 2);
+        m_sInstanceStream.initialize(m_iInstanceCapacity * sizeof(mat4));
+        if (bUsingBoundingBox)
+            m_sBoundingBox.sInstanceStream.initialize(m_iInstanceCapacity * sizeof(mat4));
+        markAllInstancesDirty();
+    }
+
+    if (!m_bInstancesChanged)
+        return;
+
+    unsigned int iRegion = m_sInstanceStream.getNextRegion();
+    writeInstanceStream(&m_sInstanceStream, m_iVertexArray, 3, &m_pInstanceTransforms, iRegion);
+    m_bDrawingVisibleStream = false;
+    m_iInstanceDivisor = 1;
+    if (bUsingBoundingBox)
+        writeInstanceStream(&m_sBoundingBox.sInstanceStream, m_sBoundingBox.iVertexArray, 1, &m_pBBInstanceTransforms, iRegion);
+
+    m_iDirtyBegin[iRegion] = m_iDirtyEnd[iRegion] = 0;
+    m_bInstancesChanged = false;
+}
+
+// Writes the dirty range of a region to an Instance Stream and points the Instance Attributes of the Vertex Array at it.
+void Mesh::writeInstanceStream(StreamBuffer* pStream, GLuint iVertexArray, GLuint iStartIndex, const vector<mat4>* pTransforms, unsigned int iRegion)
+{
+    unsigned int iBegin = m_iDirtyBegin[iRegion], iEnd = m_iDirtyEnd[iRegion];
+    unsigned char* pData = static_cast<unsigned char*>(pStream->beginWrite());
+
+    // The region has to be written completely if it didn't keep its previous contents.
+    if (!pStream->keepsContents())
+    {
+        iBegin = 0;
+        iEnd = pTransforms->size();
+    }
+
+    if (nullptr != pData && iBegin < iEnd)
+        memcpy(pData + (iBegin * sizeof(mat4)), pTransforms->data() + iBegin, (iEnd - iBegin) * sizeof(mat4));
+    pStream->endWrite();
+
+    m_pShdrMngr->setInstanceAttribs(iVertexArray, iStartIndex, pStream->getBuffer(), pStream->getReadOffset());
 }
 
 // Returns a Rotation Matrix to rotate an object from a World Coordinate System to a Local
@@ -853,19 +1266,22 @@ mat4 Mesh::getRotationMat4ToNormal(const vec3* vNormal)
 \************************************************************************************/
 
 // Function to Load Mesh Properties from a given ObjectInfo structure
-void Mesh::loadObjectInfo(const ObjectInfo* pObjectProperties, string sHashkey)
+void Mesh::loadObjectInfo(const ObjectInfo* pObjectProperties)
 {
     // Ensure the Object Properties pointer is valid
     if (nullptr != pObjectProperties)
     {
         loadMaterial(&pObjectProperties->sObjMaterial);                                         // Load Mesh Material
-        loadBoundingBox(&pObjectProperties->sObjBoundingBox, &pObjectProperties->vPosition, sHashkey);    // Load Bounding Box
+        loadBoundingBox(&pObjectProperties->sObjBoundingBox);                                  // Load Bounding Box
     }
 }
 
 // Load the Material for the Mesh
 void Mesh::loadMaterial(const ObjectInfo::Material* pMaterial)
 {
+    m_bDefaultMaterial = (nullptr == pMaterial) ||
+                         ("" == pMaterial->sDiffuseMap && vec4(0.0f) == pMaterial->vOptionalDiffuseColor);
+
     if (nullptr != pMaterial)
     {
         // Load Diffuse Texture if applicable
@@ -891,13 +1307,41 @@ void Mesh::loadMaterial(const ObjectInfo::Material* pMaterial)
         m_sRenderMaterial.m_pSpecularMap = TEXTURE_MANAGER->genTexture(&DEFAULT_SPEC_COLOR);
 }
 
+// Use the material from the .mtl library of an .obj file. Only applied if the
+//  Object Info didn't specify a diffuse map or color for the Mesh.
+void Mesh::loadObjMaterial(const ObjParser::sMaterial* pMaterial)
+{
+    Texture* pTexture;
+    if (nullptr == pMaterial || !m_bDefaultMaterial)
+        return;
+
+    // Diffuse: texture if it loads, otherwise the diffuse color
+    pTexture = ("" != pMaterial->sDiffuseMap) ? TEXTURE_MANAGER->loadTexture(pMaterial->sDiffuseMap) : nullptr;
+    if (nullptr == pTexture)
+    {
+        vec4 vDiffuseColor = vec4(pMaterial->vDiffuseColor, 1.0f);
+        pTexture = TEXTURE_MANAGER->genTexture(&vDiffuseColor);
+    }
+    m_sRenderMaterial.m_pDiffuseMap = pTexture;
+
+    // Specular: same as above
+    pTexture = ("" != pMaterial->sSpecularMap) ? TEXTURE_MANAGER->loadTexture(pMaterial->sSpecularMap) : nullptr;
+    if (nullptr == pTexture)
+    {
+        vec4 vSpecularColor = vec4(pMaterial->vSpecularColor, 1.0f);
+        pTexture = TEXTURE_MANAGER->genTexture(&vSpecularColor);
+    }
+    m_sRenderMaterial.m_pSpecularMap = pTexture;
+
+    m_sRenderMaterial.fShininess = pMaterial->fShininess;
+}
+
 // Load the Bounding Box for the Mesh
-void Mesh::loadBoundingBox(const ObjectInfo::BoundingBox* pBoundingBox, const vec3* vStartingPosition, string sHashKey)
+//  The Bounding Box is drawn for every Instance of the Mesh, see addInstance.
+void Mesh::loadBoundingBox(const ObjectInfo::BoundingBox* pBoundingBox)
 {
-    if (nullptr != pBoundingBox && nullptr != vStartingPosition)
+    if (nullptr != pBoundingBox)
     {
-        // Generate Translation Matrix for starting position
-        mat4 m4Translation = translate(*vStartingPosition);
         m_sBoundingBox.eType = pBoundingBox->eType;
 
         // Nothing Set in the Bounding Box type? Don't evaluate further
@@ -907,13 +1351,8 @@ void Mesh::loadBoundingBox(const ObjectInfo::BoundingBox* pBoundingBox, const ve
             generateCubicBoundingBox(pBoundingBox->vDimensions.x, pBoundingBox->vDimensions.y, pBoundingBox->vDimensions.z);
             break;
         default:    // No Bounding Box specified
-            return;
             break;
         }
-
-        // Add initial translation for the Bounding Box.
-        if (DEFAULT_TYPE != pBoundingBox->eType)
-            addBBInstance(&m4Translation, sHashKey);
     }
 }
 
@@ -943,21 +1382,14 @@ void Mesh::getSpatialDimensions(vec3* pNegativeOffset, vec3* pPositiveOffset)
 
 // Function to Bind the Mesh Material to the Shader for Rendering
 //    To be called before the render function
-void Mesh::bindTextures(ShaderManager::eShaderType eShaderType) const
+void Mesh::bindTextures(ShaderManager::eShaderType eShaderType, RenderQueue* pRenderQueue) const
 {
     // Bind the Diffuse and Specular Maps
-    m_sRenderMaterial.m_pDiffuseMap->bindTexture(eShaderType, "sMaterial.vDiffuse");
-    m_sRenderMaterial.m_pSpecularMap->bindTexture(eShaderType, "sMaterial.vSpecular");
+    pRenderQueue->bindSampler(eShaderType, RenderQueue::DIFFUSE_SAMPLER, m_sRenderMaterial.m_pDiffuseMap);
+    pRenderQueue->bindSampler(eShaderType, RenderQueue::SPECULAR_SAMPLER, m_sRenderMaterial.m_pSpecularMap);
 
     // Set the Material's Shininess in the Material Uniform in the shader.
-    m_pShdrMngr->setUniformFloat(eShaderType, "sMaterial.fShininess", m_sRenderMaterial.fShininess);
-}
-
-// Funtion to unbind textures. To be called after a render call on this mesh.
-void Mesh::unbindTextures() const
-{
-    m_sRenderMaterial.m_pDiffuseMap->unbindTexture();
-    m_sRenderMaterial.m_pSpecularMap->unbindTexture();
+    m_pShdrMngr->setUniformFloat(eShaderType, ShaderManager::MATERIAL_SHININESS, m_sRenderMaterial.fShininess);
 }
 
 /************************************************************************************\
@@ -969,45 +1401,10 @@ void Mesh::sBoundingBox::deleteBuffers()
 {
     glDeleteBuffers(1, &iIndicesBuffer);
     glDeleteBuffers(1, &iVertexBuffer);
-    glDeleteBuffers(1, &iInstancedBuffer);
+    sInstanceStream.release();
     glDeleteVertexArrays(1, &iVertexArray);
 }
 
-// Loads a new Transformation Instance into the Instance Map and stores it in the GPU
-void Mesh::sBoundingBox::loadInstance(const mat4* pTransform, string sHashKey)
-{
-    // Ensure a valid transformation is passed in and that the InstancedBuffer is generated
-    assert(nullptr != pTransform && 0 != iInstancedBuffer);
-
-    // Add the Transformation to the Instance Vector and load the Instance Vector into the Instance VBO
-    pInstanceMap.insert(make_pair(sHashKey, *pTransform));
-    loadInstanceBuffer();
-}
-
-// Loads a new transformation Instance into the Instance buffer
-void Mesh::sBoundingBox::updateInstance(const mat4* pTransform, string sHashKey)
-{
-    // Ensure a valid transformation is passed in and that the InstancedBuffer is generated
-    assert(nullptr != pTransform && 0 != iInstancedBuffer && pInstanceMap.find(sHashKey) != pInstanceMap.end());
-
-    // Add the Transformation to the Instance Vector and load the Instance Vector into the Instance VBO
-    pInstanceMap[sHashKey] = *pTransform;
-    loadInstanceBuffer();
-}
-
-// Remove Bounding Box instance 
-void Mesh::sBoundingBox::removeInstance(string sHashKey)
-{
-    if (pInstanceMap.find(sHashKey) != pInstanceMap.end())
-    {
-        // Remove from Instance List
-        pInstanceMap.erase(sHashKey);
-
-        // Update GPU data.
-        loadInstanceBuffer();
-    }
-}
-
 // Initializes VBOs for the Bounding Box.
 void Mesh::sBoundingBox::initVBOs()
 {
@@ -1028,8 +1425,8 @@ void Mesh::sBoundingBox::initVBOs()
     // Generate Indices Buffer
     iIndicesBuffer = SHADER_MANAGER->genIndicesBuffer(iVertexArray, pIndices.data(), pIndices.size() * sizeof(unsigned int), GL_STATIC_DRAW);
 
-    // Generate Instance Buffer
-    iInstancedBuffer = SHADER_MANAGER->genInstanceBuffer(iVertexArray, 1, (void*)0, 0, GL_DYNAMIC_DRAW);
+    // The Instance Stream is allocated by Mesh::uploadInstances.
+    sInstanceStream.release();
 }
 
 // Generates a Cubic Bounding Box.
@@ -1097,33 +1494,3 @@ void Mesh::sBoundingBox::generateCubicBox(const vec3* vNegativeOffset, const vec
     // Initialize Bounding Box VBOs
     initVBOs();
 }
-
-// Set the Bounding Box Instance Matrix
-//  If the Mesh is static, add multiple instances
-//  dynamic? replace the current instance
-void Mesh::addBBInstance(const mat4* m4Transformation, string sHashKey)
-{
-    if (m_sBoundingBox.isLoaded())
-    {
-        // Load the new instance
-        m_sBoundingBox.loadInstance(m4Transformation, sHashKey);
-    }
-}
-
-// Loads the Instance Array for the Bounding Box from the Bounding Box Instance Map.
-void Mesh::sBoundingBox::loadInstanceBuffer()
-{
-    // Local Variables
-    vector<mat4> pInstanceList;
-    pInstanceList.reserve(pInstanceMap.size());  // Reserve size to avoid unnecessary resizing.
-
-    // Populate Vector
-    for (unordered_map<string, mat4>::iterator pIter = pInstanceMap.begin();
-        pIter != pInstanceMap.end();
-        ++pIter)
-        pInstanceList.push_back(pIter->second);
-
-    // Store data in GPU
-    glBindBuffer(GL_ARRAY_BUFFER, iInstancedBuffer);
-    glBufferData(GL_ARRAY_BUFFER, pInstanceList.size() * sizeof(mat4), pInstanceList.data(), GL_DYNAMIC_DRAW);
-}
@@ -33,6 +33,16 @@ void MeshManager::unloadAllMeshes()
     m_pMeshCache.clear();
 }
 
+// Uploads the Instances and Billboards changed since the last frame for every Mesh.
+//      Called once per frame before anything is rendered.
+void MeshManager::uploadStreams()
+{
+    for (unordered_map<string, unique_ptr<Mesh>>::iterator pIter = m_pMeshCache.begin();
+        pIter != m_pMeshCache.end();
+        ++pIter)
+        pIter->second->uploadStreams();
+}
+
 // loadMeshFromFile:    Takes in a FileName. Load in a mesh from that filename if possible.
 // Return:                Returns a pointer to the desired mesh from the specified file.
 // Parameters:            sFileName - The location of the file to load.
@@ -59,7 +69,7 @@ Mesh* MeshManager::loadMeshFromFile(const string& sFileName, const ObjectInfo* p
     else // Create the New Texture in the Texture Cache, attach the User to the Texture and return the newly created texture.
     {
         // Generate Mesh smart pointer
-        unique_ptr<Mesh> pNewMesh = make_unique<Mesh>( sHashKey, bStaticMesh, fScale, pObjectProperties, sInstanceHashKey, Mesh::manager_cookie() );
+        unique_ptr<Mesh> pNewMesh = make_unique<Mesh>( sHashKey, bStaticMesh, fScale, pObjectProperties, Mesh::manager_cookie() );
 
         if ( !pNewMesh->genMesh(sFileName, pObjectProperties->vPosition, sInstanceHashKey, fScale) )
         {
@@ -104,7 +114,7 @@ Mesh* MeshManager::generatePlaneMesh(bool bStaticMesh, int iHeight, int iWidth,
     }
     else // Generate a new Plane Mesh of height iHeight and width iWidth
     {
-        unique_ptr<Mesh> pNewPlane = make_unique<Mesh>(sHashHandle, bStaticMesh, 1.0f, pObjectProperties, sHashKey, Mesh::manager_cookie());
+        unique_ptr<Mesh> pNewPlane = make_unique<Mesh>(sHashHandle, bStaticMesh, 1.0f, pObjectProperties, Mesh::manager_cookie());
         pNewPlane->genPlane(static_cast<int>(iHeight / gridSize),
                             static_cast<int>(iWidth / gridSize),
                             gridSize,values,
@@ -134,7 +144,7 @@ Mesh* MeshManager::generateSphereMesh(bool bStaticMesh, float fRadius, const Obj
     }
     else // Generate a new Sphere Mesh of given Radius
     {
-        unique_ptr<Mesh> pNewSphere = make_unique<Mesh>(sHashHandle, bStaticMesh, 1.0f, pObjectProperties, sHashKey, Mesh::manager_cookie());
+        unique_ptr<Mesh> pNewSphere = make_unique<Mesh>(sHashHandle, bStaticMesh, 1.0f, pObjectProperties, Mesh::manager_cookie());
         pNewSphere->genSphere(fRadius, pObjectProperties->vPosition, sHashKey);    // Generate Sphere
         pReturnMesh = pNewSphere.get();                                  // Return raw pointer to managed Mesh
         m_pMeshCache.insert(make_pair(sHashHandle, move(pNewSphere)));   // Move Mesh to Cache
@@ -161,7 +171,7 @@ Mesh* MeshManager::generateCubeMesh(bool bStaticMesh, float fHeight, float fWidt
     }
     else // Generate a new Cube Mesh with given dimensions
     {
-        unique_ptr<Mesh> pNewCube = make_unique<Mesh>(sHashHandle, bStaticMesh, 1.0f, pObjectProperties, sHashKey, Mesh::manager_cookie());
+        unique_ptr<Mesh> pNewCube = make_unique<Mesh>(sHashHandle, bStaticMesh, 1.0f, pObjectProperties, Mesh::manager_cookie());
         pNewCube->genCube(fHeight, fWidth, fDepth, pObjectProperties->vPosition, sHashKey);
         pReturnMesh = pNewCube.get();
         m_pMeshCache.insert(make_pair(sHashHandle, move(pNewCube)));
@@ -185,7 +195,7 @@ Mesh* MeshManager::generateBillboardMesh(const ObjectInfo* pObjectProperties, co
     }
     else // generate a new Billboard Mesh
     {
-        unique_ptr<Mesh> pNewMesh = make_unique<Mesh>(sHashHandle, false, 1.0f, pObjectProperties, "Billboard", Mesh::manager_cookie());
+        unique_ptr<Mesh> pNewMesh = make_unique<Mesh>(sHashHandle, false, 1.0f, pObjectProperties, Mesh::manager_cookie());
         pNewMesh->genBillboard();
         pReturnMesh = pNewMesh.get();
         m_pMeshCache.insert(make_pair(sHashHandle, move(pNewMesh)));
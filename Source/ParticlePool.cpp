@@ -0,0 +1,251 @@
+#include "ParticlePool.h"
+#include "ShaderManager.h"
+#include "Texture.h"
+#include <chrono>
+
+/*************\
+ * Constants *
+\*************/
+const vec3 GRAVITY = vec3(0.0f, -9.81f, 0.0f);
+#define DEFAULT_STREAM_CAPACITY     1024
+#define PARTICLE_POINT_SIZE         5.f
+
+/*******************************\
+ * Defines: For the Benchmark  *
+\*******************************/
+#define BENCHMARK_PARTICLES_PER_EXPLOSION   100
+#define BENCHMARK_PARTICLE_DURATION         1.0f
+#define BENCHMARK_STEP                      (1.0f / 60.0f)
+
+// Default Constructor
+ParticlePool::ParticlePool()
+{
+    m_iVertexArray = 0;
+    m_iStreamCapacity = 0;
+}
+
+// Destructor
+ParticlePool::~ParticlePool()
+{
+    m_sPositionStream.release();
+    if (0 != m_iVertexArray)
+        glDeleteVertexArrays(1, &m_iVertexArray);
+}
+
+/*
+    Find the batch of a texture, adding it if it doesn't exist yet. Batches
+    are never removed, so the index stays valid for the Emitters using it.
+*/
+unsigned int ParticlePool::getBatch(Texture* pTexture)
+{
+    for (unsigned int i = 0; i < m_pBatches.size(); ++i)
+    {
+        if (m_pBatches[i].pTexture == pTexture)
+            return i;
+    }
+
+    m_pBatches.emplace_back();
+    m_pBatches.back().pTexture = pTexture;
+    m_pBatches.back().iCount = 0;
+    m_pBatches.back().iFirstVertex = 0;
+    m_pBatches.back().iDrawCount = 0;
+    return static_cast<unsigned int>(m_pBatches.size() - 1);
+}
+
+void ParticlePool::spawnParticle(unsigned int iBatch, const vec3* vPosition, const vec3* vVelocity, float fDuration)
+{
+    sBatch& sSpawnBatch = m_pBatches[iBatch];
+    const float pValues[COMPONENT_COUNT] = { vPosition->x, vPosition->y, vPosition->z,
+                                             vVelocity->x, vVelocity->y, vVelocity->z,
+                                             vVelocity->x, vVelocity->y, vVelocity->z,
+                                             fDuration };
+
+    for (unsigned int i = 0; i < COMPONENT_COUNT; ++i)
+        sSpawnBatch.pComponents[i].push_back(pValues[i]);
+    ++sSpawnBatch.iCount;
+}
+
+void ParticlePool::update(float fDelta)
+{
+    for (sBatch& sUpdateBatch : m_pBatches)
+        updateBatch(&sUpdateBatch, fDelta);
+}
+
+// Integrate one axis of every particle of a batch. Kept free of branches so it vectorizes.
+static void integrateAxis(float* pPositions, float* pVelocities, float* pForces, float fGravity, float fDelta, unsigned int iCount)
+{
+    for (unsigned int i = 0; i < iCount; ++i)
+    {
+        pVelocities[i] += pForces[i] * fDelta;
+        pForces[i] += fGravity * fDelta;
+        pPositions[i] += pVelocities[i] * fDelta;
+    }
+}
+
+/*
+    Integrate the positions, velocities and forces of a batch, count down the
+    durations, then swap the dead particles out with the last live ones.
+*/
+void ParticlePool::updateBatch(sBatch* pBatch, float fDelta)
+{
+    vector<float>* pComponents = pBatch->pComponents;
+    float* pDurations = pComponents[DURATION].data();
+    unsigned int iCount = pBatch->iCount;
+
+    for (unsigned int iAxis = 0; iAxis < 3; ++iAxis)
+        integrateAxis(pComponents[POSITION_X + iAxis].data(), pComponents[VELOCITY_X + iAxis].data(),
+                      pComponents[FORCE_X + iAxis].data(), GRAVITY[iAxis], fDelta, iCount);
+    for (unsigned int i = 0; i < iCount; ++i)
+        pDurations[i] -= fDelta;
+
+    // Swap-remove: the last particle takes the place of a dead one and is checked in turn.
+    for (unsigned int i = 0; i < iCount;)
+    {
+        if (pDurations[i] <= 0.0f)
+        {
+            --iCount;
+            for (unsigned int iComponent = 0; iComponent < COMPONENT_COUNT; ++iComponent)
+                pComponents[iComponent][i] = pComponents[iComponent][iCount];
+        }
+        else
+            ++i;
+    }
+
+    if (iCount != pBatch->iCount)
+    {
+        for (unsigned int iComponent = 0; iComponent < COMPONENT_COUNT; ++iComponent)
+            pComponents[iComponent].resize(iCount);
+        pBatch->iCount = iCount;
+    }
+}
+
+// Allocates the Position Stream for the current capacity and points the Vertex Array at it.
+void ParticlePool::initializePositionStream()
+{
+    if (0 == m_iVertexArray)
+        glGenVertexArrays(1, &m_iVertexArray);
+
+    m_sPositionStream.initialize(m_iStreamCapacity * sizeof(vec3));
+    glBindVertexArray(m_iVertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, m_sPositionStream.getBuffer());
+    SHADER_MANAGER->setAttrib(m_iVertexArray, 0, 3, 0, (void*)0);
+}
+
+// Write the positions of all batches, one after the other, to the next region of the Position Stream.
+void ParticlePool::upload()
+{
+    unsigned int iTotalCount = getParticleCount();
+
+    // Grow the Stream if necessary
+    if (!m_sPositionStream.isInitialized() || iTotalCount > m_iStreamCapacity)
+    {
+        m_iStreamCapacity = std::max(std::max(iTotalCount, m_iStreamCapacity * 2), static_cast<unsigned int>(DEFAULT_STREAM_CAPACITY));
+        initializePositionStream();
+    }
+
+    vec3* pPositions = static_cast<vec3*>(m_sPositionStream.beginWrite());
+    GLint iFirstVertex = 0;
+    for (sBatch& sUploadBatch : m_pBatches)
+    {
+        sUploadBatch.iFirstVertex = iFirstVertex;
+        sUploadBatch.iDrawCount = 0;
+        if (nullptr != pPositions)
+        {
+            const float* pX = sUploadBatch.pComponents[POSITION_X].data();
+            const float* pY = sUploadBatch.pComponents[POSITION_Y].data();
+            const float* pZ = sUploadBatch.pComponents[POSITION_Z].data();
+            for (unsigned int i = 0; i < sUploadBatch.iCount; ++i)
+                pPositions[i] = vec3(pX[i], pY[i], pZ[i]);
+
+            pPositions += sUploadBatch.iCount;
+            iFirstVertex += sUploadBatch.iCount;
+            sUploadBatch.iDrawCount = sUploadBatch.iCount;
+        }
+    }
+    m_sPositionStream.endWrite();
+
+    // The Vertex Array always points at the start of the Stream, so offset the batches into the region written.
+    GLint iRegionStart = static_cast<GLint>(m_sPositionStream.getReadOffset() / sizeof(vec3));
+    for (sBatch& sUploadBatch : m_pBatches)
+        sUploadBatch.iFirstVertex += iRegionStart;
+}
+
+// Draw every batch with its texture in a single draw call each.
+void ParticlePool::draw()
+{
+    if (0 == m_iVertexArray)
+        return;
+
+    glBindVertexArray(m_iVertexArray);
+    glUseProgram(SHADER_MANAGER->getProgram(ShaderManager::eShaderType::PARTICLE_SHDR));
+    glPointSize(PARTICLE_POINT_SIZE);
+
+    for (const sBatch& sDrawBatch : m_pBatches)
+    {
+        if (0 == sDrawBatch.iDrawCount)
+            continue;
+
+        sDrawBatch.pTexture->bindTexture(ShaderManager::eShaderType::PARTICLE_SHDR, ShaderManager::MATERIAL_DIFFUSE);
+        glDrawArrays(GL_POINTS, sDrawBatch.iFirstVertex, sDrawBatch.iDrawCount);
+        sDrawBatch.pTexture->unbindTexture();
+    }
+
+    glPointSize(1.f);
+}
+
+// Removes every particle; the batches are kept.
+void ParticlePool::clear()
+{
+    for (sBatch& sClearBatch : m_pBatches)
+    {
+        for (unsigned int iComponent = 0; iComponent < COMPONENT_COUNT; ++iComponent)
+            sClearBatch.pComponents[iComponent].clear();
+        sClearBatch.iCount = 0;
+        sClearBatch.iDrawCount = 0;
+    }
+}
+
+unsigned int ParticlePool::getParticleCount() const
+{
+    unsigned int iCount = 0;
+    for (const sBatch& sCountBatch : m_pBatches)
+        iCount += sCountBatch.iCount;
+    return iCount;
+}
+
+/*
+    Print the cost of a simulation step per particle for increasing numbers of
+    explosions that are alive at the same time. Only the CPU side is timed,
+    nothing is drawn.
+*/
+void ParticlePool::runBenchmark()
+{
+    typedef chrono::high_resolution_clock clock;
+    const unsigned int pExplosionCounts[] = { 1, 10, 50, 200 };
+    unsigned int iSteps = static_cast<unsigned int>(BENCHMARK_PARTICLE_DURATION / BENCHMARK_STEP);
+
+    for (unsigned int iExplosions : pExplosionCounts)
+    {
+        ParticlePool sPool;
+        unsigned int iBatch = sPool.getBatch(nullptr);
+        unsigned long long iParticleSteps = 0;
+
+        for (unsigned int i = 0; i < iExplosions * BENCHMARK_PARTICLES_PER_EXPLOSION; ++i)
+        {
+            vec3 vPosition = vec3(static_cast<float>(i % BENCHMARK_PARTICLES_PER_EXPLOSION));
+            vec3 vVelocity = vec3(1.0f, 2.0f + (i % 7), 0.5f);
+            sPool.spawnParticle(iBatch, &vPosition, &vVelocity, BENCHMARK_PARTICLE_DURATION * (0.5f + ((i % 11) / 20.0f)));
+        }
+
+        clock::time_point pStart = clock::now();
+        for (unsigned int iStep = 0; iStep < iSteps; ++iStep)
+        {
+            iParticleSteps += sPool.getParticleCount();
+            sPool.update(BENCHMARK_STEP);
+        }
+        double fNanoseconds = chrono::duration<double, nano>(clock::now() - pStart).count();
+
+        cout << iExplosions << " explosions (" << (iExplosions * BENCHMARK_PARTICLES_PER_EXPLOSION) << " particles): "
+             << (fNanoseconds / std::max(iParticleSteps, 1ull)) << " ns per particle per step" << endl;
+    }
+}
@@ -8,13 +8,21 @@
 #include "SoundManager.h"
 #include "GameStats.h"
 #include "EntityManager.h"
-#include <sstream>
+#include <cstdlib>
 
 #define TYPE        0
 #define SUBTYPE     1
 #define OWNER       1
 #define GROUND_ID   -1
 
+// Initial capacity of the collision event buffer; grows if a step reports more.
+#define COLLISION_EVENT_RESERVE 64
+
+PhysicsCallBack::PhysicsCallBack()
+{
+    m_vCollisionEvents.reserve(COLLISION_EVENT_RESERVE);
+}
+
 void PhysicsCallBack::initObjects(physx::PxRigidDynamic *body1, physx::PxRigidDynamic *body2) {
     this->m_pBody1 = body1;
     this->m_pBody2 = body2;
@@ -23,73 +31,85 @@ void PhysicsCallBack::initObjects(physx::PxRigidDynamic *body1, physx::PxRigidDy
 /*
 Detects when two actors have collided.
 
+Called by PhysX from within fetchResults(). The contact is only recorded here;
+it's handled later by dispatchCollisions().
+
 https://docs.nvidia.com/gameworks/content/gameworkslibrary/physx/guide/Manual/AdvancedCollisionDetection.html
 */
 void PhysicsCallBack::onContact(const PxContactPairHeader &pairHeader, const PxContactPair *pairs, PxU32 nbPairs) {
 
-    // Generate Pointer to Entity Manager
-    EntityManager* m_pEntMngr = ENTITY_MANAGER;
-    int iColliderID, iCollidedID;
+    // The contact pair header is shared by all pairs; parse the actor names once.
+    // Removed actors (flagged by eREMOVED_ACTOR_0/1) may not be dereferenced.
+    if (pairHeader.flags & (PxContactPairHeaderFlag::eREMOVED_ACTOR_0 | PxContactPairHeaderFlag::eREMOVED_ACTOR_1))
+        return;
+
+    sCollisionEvent sEvent;
+    if (!parseActorName(pairHeader.actors[0]->getName(), &sEvent.iColliderID, &sEvent.iColliderMsg) ||
+        !parseActorName(pairHeader.actors[1]->getName(), &sEvent.iCollidedID, &sEvent.iCollidedMsg))
+        return; // Skip this collision if it's unreadable.
 
-    // std::cout << "Collision detected" << std::endl;
     for (PxU32 i = 0; i < nbPairs; i++)
     {
-        const PxContactPair& cp = pairs[i];
-
-        // @NOTE what is this if-statement checking for?
-        if (cp.events & PxPairFlag::eNOTIFY_TOUCH_FOUND)
+        // Only record the start of a contact between the two actors.
+        if (pairs[i].events & PxPairFlag::eNOTIFY_TOUCH_FOUND)
         {
-            // Determine the results by actor names
-            string sCollider = pairHeader.actors[0]->getName(); // ""
-            string sCollided = pairHeader.actors[1]->getName(); // "14"
-
-            // temporary fix
-            if (!sCollider.empty() && !sCollided.empty())
-            {
-
-                // Parse Names
-                istringstream HitterSS(sCollider);
-                vector<string> HitterResults(istream_iterator<string>{HitterSS},
-                    istream_iterator<string>());
-                // istringstream VictimSS(sCollided);
-                istringstream VictimSS(sCollided);
-                vector<string> VictimResults(istream_iterator<string>{VictimSS},
-                    istream_iterator<string>());
-
-                // Get Entity IDs
-                // The ground has its own special ID since its not treated the same
-                // as the other entities
-                // @NOTE this crashes when sCollider == ""
-                try {
-                    if (!HitterResults.empty() && !VictimResults.empty())
-                    {
-                        iColliderID = stoi(HitterResults.front());
-                        iCollidedID = stoi(VictimResults.front());
-                    }
-                    else
-                        continue; // Skip this collision if it's unreadable.
-                }
-                catch (invalid_argument e)
-                {
-                    continue; // Skip this collision if it's unreadable
-                }
-                unsigned int iColliderMsg = 0, iCollidedMsg = 0;
-
-#ifndef NDEBUG
-                // Player 1: 11
-                // Bot 1: 14
-                // std::cout << "\tactor 0: " << HitterResults.front() << std::endl;
-                // std::cout << "\tactor 1: " << VictimResults.front() << std::endl;
-#endif
-                // Catch Messages if available.
-                if (HitterResults.size() > 1)
-                    iColliderMsg = stoi(HitterResults[1]);
-                if (VictimResults.size() > 1)
-                    iCollidedMsg = stoi(VictimResults[1]);
-
-                // Pass information to Entity Manager to handle collision
-                m_pEntMngr->dispatchCollision(iColliderID, iCollidedID, iColliderMsg, iCollidedMsg);
-            }
+            m_vCollisionEvents.push_back(sEvent);
+            break;  // Every pair shares the same actors, one event is enough.
         }
     }
 }
+
+/*
+    Dispatch all recorded collisions to the EntityManager in the order they
+    were reported. Duplicate events (the same actors with the same messages
+    reported more than once in a step) are only dispatched once.
+
+    Must be called outside of simulate()/fetchResults() as collision handling
+    may add or remove actors from the scene.
+*/
+void PhysicsCallBack::dispatchCollisions()
+{
+    if (m_vCollisionEvents.empty())
+        return;
+
+    // Remove duplicates while preserving the reported order.
+    vector<sCollisionEvent>::iterator pUniqueEnd = m_vCollisionEvents.begin();
+    for (vector<sCollisionEvent>::iterator pIter = m_vCollisionEvents.begin();
+        pIter != m_vCollisionEvents.end();
+        ++pIter)
+    {
+        if (find(m_vCollisionEvents.begin(), pUniqueEnd, *pIter) == pUniqueEnd)
+            *(pUniqueEnd++) = *pIter;
+    }
+    m_vCollisionEvents.erase(pUniqueEnd, m_vCollisionEvents.end());
+
+    // Pass information to Entity Manager to handle collisions
+    EntityManager* pEntMngr = ENTITY_MANAGER;
+    for (const sCollisionEvent& sEvent : m_vCollisionEvents)
+        pEntMngr->dispatchCollision(sEvent.iColliderID, sEvent.iCollidedID, sEvent.iColliderMsg, sEvent.iCollidedMsg);
+
+    m_vCollisionEvents.clear();
+}
+
+/*
+    Parse an actor name of the form "<Entity ID> [<Message>]" without any allocations.
+
+    @param cName        name of the actor, may be null
+    @param iReturnID    parsed Entity ID
+    @param iReturnMsg   parsed message, 0 if the name has no message
+    @return true if the name contained a valid Entity ID
+*/
+bool PhysicsCallBack::parseActorName(const char* cName, int* iReturnID, unsigned int* iReturnMsg)
+{
+    if (nullptr == cName)
+        return false;
+
+    char* cEnd = nullptr;
+    long lID = strtol(cName, &cEnd, 10);
+    if (cEnd == cName)
+        return false;   // Empty or non-numeric name
+
+    *iReturnID = static_cast<int>(lID);
+    *iReturnMsg = static_cast<unsigned int>(strtoul(cEnd, nullptr, 10));
+    return true;
+}
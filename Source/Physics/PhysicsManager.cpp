@@ -6,6 +6,7 @@
 #include "PxFoundation.h"
 #include "Physics/PhysicsCallBack.h"
 #include "Physics/PhysicsManager.h"
+#include "InputRecorder.h"
 #include "vehicle/PxVehicleUtil.h"
 #include "snippetvehiclecommon/SnippetVehicleSceneQuery.h"
 #include "snippetvehiclecommon/SnippetVehicleFilterShader.h"
@@ -20,7 +21,6 @@
  * DEFINES *
 \***********/
 #define PVD_HOST "127.0.0.1"
-#define UPDATE_TIME_IN_SECONDS (1.0f / 60.0f) // Physics should update every 1/60th of a second regardless of the game's framerate.
 
 /*
 Hovercraft material properties
@@ -202,24 +202,11 @@ snippetvehicle::VehicleDesc PhysicsManager::initVehicleDesc(PxVec3 chassisDims)
 \****************************************************************************/
 
 // Name: Update
-// Description: Provides Frame by Frame update functionality for Physics.
-//        Updates on a different interval than standard framerate.
+// Description: Steps the Physics scene once. Called by the EntityManager once per
+//        fixed simulation step, so the time delta is always the simulation step size.
 void PhysicsManager::update(float fTimeDelta)
 {
-    // Add the next delta to the loop
-    m_fTimeSinceLastUpdate += fTimeDelta;
-    // Increment Time since last update and check to see if an update is ready.
-    //    if an update is ready, decrement the internal timer to reset it accurately
-    //    then perform the update.
-    while (m_fTimeSinceLastUpdate >= UPDATE_TIME_IN_SECONDS)
-    {
-        // Don't reset to 0.0f as it's probably not at the Update Time Exactly.
-        //    this preserves an accuracy w.r.t. the game timer.
-        m_fTimeSinceLastUpdate = 0.0f;
-
-        // Step Physics at 1/60th of a second.
-        stepPhysics(UPDATE_TIME_IN_SECONDS); 
-    }
+    stepPhysics(fTimeDelta);
 }
 PxRigidStatic* PhysicsManager::createFloorHeightMap(PxReal hfScale, PxU32 hfSize, PxReal heightScale, float *values)
 {
@@ -343,6 +330,9 @@ void PhysicsManager::initPhysics(bool interactive)
     sceneDesc.simulationEventCallback = cb;
     sceneDesc.flags |= PxSceneFlag::eENABLE_KINEMATIC_PAIRS;
     sceneDesc.flags |= PxSceneFlag::eENABLE_KINEMATIC_STATIC_PAIRS;
+    // Replays must simulate identically to their recording.
+    if (INPUT_RECORDER->isActive())
+        sceneDesc.flags |= PxSceneFlag::eENABLE_ENHANCED_DETERMINISM;
     gScene = gPhysics->createScene(sceneDesc);
 #ifdef _DEBUG
     PxPvdSceneClient* pvdClient = gScene->getScenePvdClient();
@@ -714,6 +704,9 @@ void PhysicsManager::stepPhysics(float fTimeDelta)
     //incrementDrivingMode(timestep);
     gScene->simulate(timestep);
     gScene->fetchResults(true);
+
+    // Handle all collisions reported during this step now that the scene is no longer simulating.
+    cb->dispatchCollisions();
     //Suspension sweeps (instead of raycasts).
 }
 
@@ -1,5 +1,8 @@
 #include "SceneLoader.h"
 #include "EntityManager.h"
+#include "InputRecorder.h"
+#include "DataStructures/AssetPreloader.h"
+#include <chrono>
 #include <sstream>
 #include <iterator>
 
@@ -54,6 +57,7 @@ SceneLoader* SceneLoader::m_pInstance = nullptr;
 // Private Constructor
 SceneLoader::SceneLoader()
 {
+    m_pAssetPreloader = ASSET_PRELOADER;
     resetAllProperties();
 }
 
@@ -69,6 +73,7 @@ SceneLoader* SceneLoader::getInstance()
 
 SceneLoader::~SceneLoader()
 {
+    delete m_pAssetPreloader;
 }
 
 // Creation Functions
@@ -297,6 +302,7 @@ void SceneLoader::loadFromFile( string sFileName )
     vector< string > sData;
     vector< string > sAdditionalData;
     string sIndicator, sParser;
+    chrono::high_resolution_clock::time_point pLoadStart = chrono::high_resolution_clock::now();
 
     // Store Reference to Entity Manager
     if (nullptr == m_pEntityManager)
@@ -305,6 +311,9 @@ void SceneLoader::loadFromFile( string sFileName )
     // Open File
     inFile.open( sFileName );
 
+    // Load the meshes and images of the scene on worker threads while it's being read.
+    m_pAssetPreloader->preloadScene(sFileName);
+
     // Parse File if opened properly
     if ( inFile.good() )
     {
@@ -343,6 +352,11 @@ void SceneLoader::loadFromFile( string sFileName )
     inFile.close();
 
     postInitialize();
+    m_pAssetPreloader->finishScene();
+
+    cout << "Loaded \"" << sFileName << "\" in "
+         << chrono::duration<double, milli>(chrono::high_resolution_clock::now() - pLoadStart).count() << " ms ("
+         << (AssetPreloader::useParallelLoading() ? "parallel" : "serial") << " asset loading)" << endl;
 }
 
 // outputError - Outputs information about an error creating an object.  Usually if 
@@ -586,7 +600,8 @@ void SceneLoader::resetAllProperties()
 void SceneLoader::postInitialize()
 {
     // Shuffle the order of spawn points so they are different every game.
-    srand(static_cast<unsigned int>(time(0)));
+    // Recorded games need the same order every time they are replayed.
+    srand(INPUT_RECORDER->isActive() ? INPUT_RECORDER->getRandomSeed() : static_cast<unsigned int>(time(0)));
     random_shuffle(std::begin(m_vSpawnPoints), std::end(m_vSpawnPoints));
 }
 
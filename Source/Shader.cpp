@@ -70,6 +70,8 @@ bool Shader::initializeShader( )
 
         // Link Shaders
         m_uiProgram = LinkProgram( &bError );
+        if (!bError)
+            cacheUniformLocations();
 
         // Set that it's been initialized
         m_bInitialized = !CheckGLErrors() && !bError;
@@ -100,6 +102,10 @@ string Shader::LoadSource( int iShaderType, bool* bError)
             // Set GLFW Version in shader
             source = "#version 430 core\n";
 
+            // Vertex Shaders can pick the layer they draw to if the driver allows it, see ShaderManager::supportsLayeredViews
+            if (VERTEX == iShaderType)
+                source += "#extension GL_ARB_shader_viewport_layer_array : enable\n#extension GL_AMD_vertex_shader_layer : enable\n";
+
             // Attach Uniform Lighting header for Both Vertex and Fragment Shaders
             if (VERTEX == iShaderType || FRAGMENT == iShaderType)
             {
@@ -203,3 +209,40 @@ GLuint Shader::LinkProgram( bool* bError )
 
     return programObject;
 }
+
+/*
+    Look up the location of every active uniform of the linked program once,
+    so setting a uniform doesn't have to ask the driver for it again.
+*/
+void Shader::cacheUniformLocations()
+{
+    GLint iUniformCount = 0, iMaxNameLength = 0;
+    glGetProgramiv(m_uiProgram, GL_ACTIVE_UNIFORMS, &iUniformCount);
+    glGetProgramiv(m_uiProgram, GL_ACTIVE_UNIFORM_MAX_LENGTH, &iMaxNameLength);
+
+    vector<GLchar> pName(std::max(iMaxNameLength, 1));
+    m_pUniformLocations.clear();
+    for (GLint i = 0; i < iUniformCount; ++i)
+    {
+        GLsizei iLength = 0;
+        GLint iSize = 0;
+        GLenum eType;
+        glGetActiveUniform(m_uiProgram, i, static_cast<GLsizei>(pName.size()), &iLength, &iSize, &eType, pName.data());
+
+        // Uniforms in a block have no location; they're set through their Uniform Buffer.
+        string sName(pName.data(), iLength);
+        GLint iLocation = glGetUniformLocation(m_uiProgram, sName.c_str());
+        if (ERR_CODE == iLocation)
+            continue;
+
+        m_pUniformLocations[sName] = iLocation;
+        if (sName.size() > 3 && 0 == sName.compare(sName.size() - 3, 3, "[0]"))
+            m_pUniformLocations[sName.substr(0, sName.size() - 3)] = iLocation;
+    }
+}
+
+GLint Shader::getUniformLocation(const string& sVarName) const
+{
+    unordered_map<string, GLint>::const_iterator pIter = m_pUniformLocations.find(sVarName);
+    return m_pUniformLocations.end() == pIter ? ERR_CODE : pIter->second;
+}
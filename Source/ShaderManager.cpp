@@ -15,16 +15,17 @@
 #define DIRECTIONAL_LIGHT_OFFSET        16
 #define NUM_DIRECTIONAL_LIGHT_PARAMS    4
 #define DIRECTIONAL_LIGHT_SIZE          (sizeof(vec4) * NUM_DIRECTIONAL_LIGHT_PARAMS)
-#define POINT_LIGHT_OFFSET              (DIRECTIONAL_LIGHT_OFFSET + DIRECTIONAL_LIGHT_SIZE)
-// POINT_LIGHT_SIZE: float bytesize of 4 -> 16 bytes due to spacing requirements of uniform buffers
-#define NUM_POINT_LIGHT_PARAMS          3
-#define POINT_LIGHT_SIZE                (sizeof(vec4) * NUM_POINT_LIGHT_PARAMS)
-#define MAX_NUM_POINT_LIGHTS            16
-#define MAX_NUM_SPOT_LIGHTS             16
-#define NUM_SPOT_LIGHT_PARAMS           4
-#define SPOT_LIGHT_SIZE                 (sizeof(vec4) * NUM_SPOT_LIGHT_PARAMS)
-#define SPOT_LIGHT_OFFSET               (POINT_LIGHT_OFFSET + (POINT_LIGHT_SIZE * MAX_NUM_POINT_LIGHTS))
-#define LIGHT_BUFFER_SIZE               (DIRECTIONAL_LIGHT_OFFSET + DIRECTIONAL_LIGHT_SIZE + (POINT_LIGHT_SIZE * MAX_NUM_POINT_LIGHTS) + (SPOT_LIGHT_SIZE * MAX_NUM_SPOT_LIGHTS))
+// Written per frame: light counts and the cluster grid
+#define LIGHT_CLUSTERS_OFFSET           (DIRECTIONAL_LIGHT_OFFSET + DIRECTIONAL_LIGHT_SIZE)
+#define LIGHT_CLUSTERS_SIZE             (sizeof(vec4) * 3)
+#define LIGHT_BUFFER_SIZE               (LIGHT_CLUSTERS_OFFSET + LIGHT_CLUSTERS_SIZE)
+#define MAX_NUM_SPOT_LIGHT_MATRICES     4
+
+/* Views Defines */
+#define VIEW_PROJECTIONS_OFFSET         0
+#define VIEW_MODELVIEWS_OFFSET          (sizeof(mat4) * MAX_PLAYER_COUNT)
+#define VIEW_INDICES_OFFSET             (sizeof(mat4) * MAX_PLAYER_COUNT * 2)
+#define VIEWS_BUFFER_SIZE               (VIEW_INDICES_OFFSET + sizeof(ivec4))
 
 
 ///////////////
@@ -32,8 +33,27 @@
 ///////////////
 const GLsizei INSTANCE_STRIDE = sizeof(mat4);
 
+// Names of the uniforms with a handle, by eUniform
+const char* UNIFORM_NAMES[ShaderManager::MAX_UNIFORMS] =
+{
+    "sMaterial.vDiffuse",
+    "sMaterial.vSpecular",
+    "sMaterial.fShininess",
+    "fTime",
+    "vColor",
+    "horizontal",
+    "mTexture",
+    "hdrBuffer",
+    "bloomBuffer",
+    "text",
+    "textColor",
+    "isImage",
+    "backgroundImage"
+};
+
 // Singleton Variable initialization
 ShaderManager* ShaderManager::m_pInstance = nullptr;
+bool ShaderManager::m_bUniformCacheEnabled = true;
 
 typedef ShaderManager::eShaderType shader_Type;
 
@@ -53,19 +73,26 @@ const unordered_map<string, ShaderManager::eShaderType> ShaderManager::pShaderTy
 ShaderManager::ShaderManager()
 {
     m_bInitialized = false;
+    for (GLint* pLocations : m_pUniformLocations)
+        fill(pLocations, pLocations + MAX_UNIFORMS, ERR_CODE);
 
     // Set up Uniform Buffer Object
     glGenBuffers(1, &m_iMatricesBuffer);
     glGenBuffers(1, &m_iLightsBuffer);
+    glGenBuffers(1, &m_iViewsBuffer);
     glBindBuffer(GL_UNIFORM_BUFFER, m_iMatricesBuffer);
     glBufferData(GL_UNIFORM_BUFFER, UNIFORM_MATRICES_SIZE, NULL, GL_STATIC_DRAW);
     glBindBuffer(GL_UNIFORM_BUFFER, m_iLightsBuffer);
     glBufferData(GL_UNIFORM_BUFFER, LIGHT_BUFFER_SIZE, NULL, GL_STATIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_iViewsBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, VIEWS_BUFFER_SIZE, NULL, GL_STATIC_DRAW);
     glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
     // Bind the Uniform Buffer to a base of size 2 * sizeof(mat4) => (Projection and Model View Matrix)
     glBindBufferRange(GL_UNIFORM_BUFFER, 0, m_iMatricesBuffer, 0, UNIFORM_MATRICES_SIZE);    // Bind this buffer base to 0; this is for general Matrices.
     glBindBufferRange(GL_UNIFORM_BUFFER, 2, m_iLightsBuffer, 0, LIGHT_BUFFER_SIZE);
+    glBindBufferRange(GL_UNIFORM_BUFFER, 3, m_iViewsBuffer, 0, VIEWS_BUFFER_SIZE);
+    m_sLightClusters.initialize();
 
     glEnable(GL_BLEND);
     glEnable(GL_CULL_FACE);
@@ -120,9 +147,15 @@ ShaderManager::ShaderManager()
     m_pShader[eShaderType::BLUR_SHDR].storeShadrLoc(Shader::eShader::VERTEX, "Shaders/blur.vert");
     m_pShader[eShaderType::BLUR_SHDR].storeShadrLoc(Shader::eShader::FRAGMENT, "Shaders/blur.frag");
 
-    // Gaussian Blur Shader
+    // Tron Shader
     m_pShader[eShaderType::TRON_SHDR].storeShadrLoc(Shader::eShader::VERTEX, "Shaders/tron.vert");
     m_pShader[eShaderType::TRON_SHDR].storeShadrLoc(Shader::eShader::FRAGMENT, "Shaders/tron.frag");
+
+    // Bloom Mip Chain Shaders
+    m_pShader[eShaderType::BLOOM_DOWNSAMPLE_SHDR].storeShadrLoc(Shader::eShader::VERTEX, "Shaders/blur.vert");
+    m_pShader[eShaderType::BLOOM_DOWNSAMPLE_SHDR].storeShadrLoc(Shader::eShader::FRAGMENT, "Shaders/bloomDownsample.frag");
+    m_pShader[eShaderType::BLOOM_UPSAMPLE_SHDR].storeShadrLoc(Shader::eShader::VERTEX, "Shaders/blur.vert");
+    m_pShader[eShaderType::BLOOM_UPSAMPLE_SHDR].storeShadrLoc(Shader::eShader::FRAGMENT, "Shaders/bloomUpsample.frag");
 }
 
 // Get the Singleton ShaderManager Object.  Initialize it if nullptr.
@@ -146,6 +179,7 @@ ShaderManager::~ShaderManager()
 
     glDeleteBuffers(1, &m_iMatricesBuffer);
     glDeleteBuffers(1, &m_iLightsBuffer);
+    glDeleteBuffers(1, &m_iViewsBuffer);
 }
 
 // Given a potential string as a hashmap key, return the corresponding ShaderType
@@ -175,6 +209,18 @@ bool ShaderManager::initializeShaders()
     for (int eIndex = LIGHT_SHDR; eIndex < MAX_SHDRS; eIndex++)
         m_bInitialized &= m_pShader[eIndex].initializeShader();
 
+    // Resolve the uniforms with a handle for every shader.
+    for (int eIndex = LIGHT_SHDR; eIndex < MAX_SHDRS; eIndex++)
+    {
+        for (int eVar = 0; eVar < MAX_UNIFORMS; ++eVar)
+            m_pUniformLocations[eIndex][eVar] = m_pShader[eIndex].getUniformLocation(UNIFORM_NAMES[eVar]);
+    }
+
+    // The Light Cluster textures never leave their units.
+    setUniformIntAll("LightData", m_sLightClusters.getTexture(LightClusters::LIGHT_DATA));
+    setUniformIntAll("LightClusters", m_sLightClusters.getTexture(LightClusters::CLUSTER_DATA));
+    setUniformIntAll("LightIndices", m_sLightClusters.getTexture(LightClusters::LIGHT_INDICES));
+
     // return False if not all Shaders Initialized Properly
     return m_bInitialized;
 }
@@ -184,14 +230,13 @@ bool ShaderManager::initializeShaders()
 * Shader manipulation                                                          *
 \*******************************************************************************/
 
-// Set Projection Matrix for all Shaders
+// Set Projection Matrix for all Shaders: the Projection, Model View and Inverse Model View
+//  (for getting the Camera Position) Matrices are consecutive in the block, so they're written at once.
 void ShaderManager::setProjectionModelViewMatrix(const mat4* pProjMat, const mat4* pModelViewMat)
 {
-    mat4 pInvModelViewMat = inverse(*pModelViewMat);
+    mat4 pCameraMatrices[3] = { *pProjMat, *pModelViewMat, inverse(*pModelViewMat) };
     glBindBuffer(GL_UNIFORM_BUFFER, m_iMatricesBuffer);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(mat4), pProjMat);                                  // Set the Projection Matrix Data to the uniform Buffer.
-    glBufferSubData(GL_UNIFORM_BUFFER, sizeof(mat4), sizeof(mat4), pModelViewMat);                  // Set the Model View Matrix Data to the uniform Buffer.
-    glBufferSubData(GL_UNIFORM_BUFFER, (sizeof(mat4) * 2), sizeof(mat4), &pInvModelViewMat);        // Set the Inverse Model View Matrix Data for getting Camera Position.
+    glBufferSubData(GL_UNIFORM_BUFFER, PROJ_MAT_OFFSET, sizeof(pCameraMatrices), pCameraMatrices);
     glBindBuffer(GL_UNIFORM_BUFFER, 0);
 }
 
@@ -206,7 +251,7 @@ void ShaderManager::setDirectionalModelMatrix(const mat4* pDirModelMat)
 // Sets the Model View Matrix for a Spot Light at the specified index.
 void ShaderManager::setSpotLightModelMatrices(const mat4* pSpotLightMat, unsigned int iIndex)
 {
-    assert(iIndex < MAX_NUM_SPOT_LIGHTS);   // Ensure that the specified index is valid with respect to the maximum number of Spot Lights
+    assert(iIndex < MAX_NUM_SPOT_LIGHT_MATRICES);   // Ensure that the specified index is valid with respect to the maximum number of Spot Light matrices
 
     // Apply the SpotLight Model View Matrix to the Matrices Buffer
     glBindBuffer(GL_UNIFORM_BUFFER, m_iMatricesBuffer);     // Set the SpotLight MV Matrix to the proper indexed offset.
@@ -214,13 +259,16 @@ void ShaderManager::setSpotLightModelMatrices(const mat4* pSpotLightMat, unsigne
     glBindBuffer(GL_UNIFORM_BUFFER, 0);
 }
 
+/*
+    Sets the Directional Light in the Lights Buffer and collects the Point and
+    Spot Lights for the Light Clusters, which are built for the views of the
+    frame by setLightClusters. There's no limit on the number of Point and Spot Lights.
+*/
 void ShaderManager::setLightsInUniformBuffer(const LightingComponent* pDirectionalLight, const vector< LightingComponent* >* pPointLights)
 {
     // Get initial values for Light Block
     int bUsingDirectionalLight = nullptr != pDirectionalLight;
-    unsigned int iNumPointLights = 0, iNumSpotLights = 0;
-    vector< vec4 > vPointLightData, vSpotLightData;
-    const vector< vec4 > *pDirectionalLightData = nullptr, *pPointLightData = nullptr, *pSpotLightData = nullptr;
+    const vector< vec4 > *pDirectionalLightData = nullptr;
 
     if (bUsingDirectionalLight)
     {
@@ -229,57 +277,87 @@ void ShaderManager::setLightsInUniformBuffer(const LightingComponent* pDirection
     }
 
     // Pull the data from the Lighting Components
-    for (vector< LightingComponent* >::const_iterator iter = pPointLights->begin();
-        iter != pPointLights->end();
-        ++iter)
-    {
-        // POINT_LIGHT - Limited by a maximum number of Point Lights to store in the buffer.
-        if (MAX_NUM_POINT_LIGHTS > iNumPointLights &&
-            LightingComponent::eLightType::POINT_LIGHT == (*iter)->getType())
-        {
-            // Get Information
-            pPointLightData = (*iter)->getLightInformation();
-
-            // Returned amount of information should be expected.
-            assert(pPointLightData->size() == NUM_POINT_LIGHT_PARAMS);
-            vPointLightData.insert(vPointLightData.end(), pPointLightData->begin(), pPointLightData->end());
-            ++iNumPointLights;        // count this as an added Point Light
-        }
-        else if (MAX_NUM_SPOT_LIGHTS > iNumSpotLights &&
-            LightingComponent::eLightType::SPOTLIGHT == (*iter)->getType())
-        {
-            // Get Information
-            pSpotLightData = (*iter)->getLightInformation();
-
-            // Assert Expectations
-            assert(pSpotLightData->size() == NUM_SPOT_LIGHT_PARAMS);
-            vSpotLightData.insert(vSpotLightData.end(), pSpotLightData->begin(), pSpotLightData->end());
-            ++iNumSpotLights;
-
-        }
-    }
+    m_sLightClusters.gatherLights(pPointLights);
 
     //  GLSL Uniform Buffer Block:
     //      Base Alignment = the space a variable takes (including padding) within a uniform block. Per std140 layout rules.
     //      Aligned Offset = the byte offset of a variable from the start of the block. Must be equal to a multiple of its base alignment.
     //      For Light Buffer:
-    //          int iNumLights                  Base: 4     Aligned: 0
-    //          bool bUsingDirectionalLight     Base: 4     Aligned: 4  // Booleans are stored in 4 bytes in GLSL
+    //          bool bUsingDirectionalLight     Base: 4     Aligned: 0  // Booleans are stored in 4 bytes in GLSL
     //          vec3 pDirectionalLight[4]       Base: 64    Aligned: 16 // vec3 stored with 4 bytes of padding; must be aligned to base alignment
-    //          vec3 pPointLight[2]             Base: 32    Aligned: 80
-    glBindBuffer(GL_UNIFORM_BUFFER, m_iLightsBuffer);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, 4, &iNumPointLights);
-    glBufferSubData(GL_UNIFORM_BUFFER, 4, 4, &iNumSpotLights);
-    glBufferSubData(GL_UNIFORM_BUFFER, 8, 4, &bUsingDirectionalLight);
+    //          Light Clusters                  Base: 48    Aligned: 80 // Written per frame by setLightClusters
+    //  The per frame part is laid out on the CPU and written with a single upload, only if it changed since the last frame.
+    unsigned char pLightBlock[LIGHT_CLUSTERS_OFFSET] = {};
+    memcpy(pLightBlock, &bUsingDirectionalLight, 4);
     if (bUsingDirectionalLight)
     {
-        glBufferSubData(GL_UNIFORM_BUFFER, DIRECTIONAL_LIGHT_OFFSET, NUM_DIRECTIONAL_LIGHT_PARAMS * sizeof(vec4), pDirectionalLightData->data());
+        memcpy(pLightBlock + DIRECTIONAL_LIGHT_OFFSET, pDirectionalLightData->data(), NUM_DIRECTIONAL_LIGHT_PARAMS * sizeof(vec4));
     }
-    glBufferSubData(GL_UNIFORM_BUFFER, POINT_LIGHT_OFFSET, (NUM_POINT_LIGHT_PARAMS * sizeof(vec4))*iNumPointLights, vPointLightData.data());
-    glBufferSubData(GL_UNIFORM_BUFFER, SPOT_LIGHT_OFFSET, (NUM_SPOT_LIGHT_PARAMS * sizeof(vec4))*iNumSpotLights, vSpotLightData.data());
+
+    if (m_pLightBlock.size() != LIGHT_CLUSTERS_OFFSET || 0 != memcmp(m_pLightBlock.data(), pLightBlock, LIGHT_CLUSTERS_OFFSET))
+    {
+        m_pLightBlock.assign(pLightBlock, pLightBlock + LIGHT_CLUSTERS_OFFSET);
+        glBindBuffer(GL_UNIFORM_BUFFER, m_iLightsBuffer);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, LIGHT_CLUSTERS_OFFSET, pLightBlock);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+}
+
+/*
+    Builds the Light Clusters of every view of the frame and writes their
+    parameters to the Lights Buffer:
+        int numPointLights          Aligned: 80
+        int numSpotLights           Aligned: 84
+        uvec3 vClusterCounts        Aligned: 96
+        vec4 vClusterScale          Aligned: 112
+*/
+void ShaderManager::setLightClusters(const mat4* pProjMats, const mat4* pModelViewMats, unsigned int iViewCount, int iWidth, int iHeight)
+{
+    m_sLightClusters.buildClusters(pProjMats, pModelViewMats, iViewCount, iWidth, iHeight);
+
+    GLint pCounts[4] = { static_cast<GLint>(m_sLightClusters.getNumPointLights()), static_cast<GLint>(m_sLightClusters.getNumSpotLights()), 0, 0 };
+    unsigned char pClusterBlock[LIGHT_CLUSTERS_SIZE];
+    memcpy(pClusterBlock, pCounts, sizeof(pCounts));
+    memcpy(pClusterBlock + sizeof(vec4), &m_sLightClusters.getClusterCounts(), sizeof(uvec4));
+    memcpy(pClusterBlock + (sizeof(vec4) << 1), &m_sLightClusters.getClusterScale(), sizeof(vec4));
+
+    glBindBuffer(GL_UNIFORM_BUFFER, m_iLightsBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, LIGHT_CLUSTERS_OFFSET, LIGHT_CLUSTERS_SIZE, pClusterBlock);
     glBindBuffer(GL_UNIFORM_BUFFER, 0);
 }
 
+/*
+    Sets the cameras of the next draws in the Views Buffer:
+        mat4 pViewProjections[4]    Aligned: 0
+        mat4 pViewModelviews[4]     Aligned: 256
+        int iViewCount              Aligned: 512
+        int iClusterView            Aligned: 516
+    Only the views set are written.
+*/
+void ShaderManager::setViewMatrices(const mat4* pProjMats, const mat4* pModelViewMats, unsigned int iViewCount, int iClusterView)
+{
+    assert(iViewCount > 0 && iViewCount <= MAX_PLAYER_COUNT);
+    GLint pIndices[4] = { static_cast<GLint>(iViewCount), iClusterView, 0, 0 };
+
+    glBindBuffer(GL_UNIFORM_BUFFER, m_iViewsBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, VIEW_PROJECTIONS_OFFSET, iViewCount * sizeof(mat4), pProjMats);
+    glBufferSubData(GL_UNIFORM_BUFFER, VIEW_MODELVIEWS_OFFSET, iViewCount * sizeof(mat4), pModelViewMats);
+    glBufferSubData(GL_UNIFORM_BUFFER, VIEW_INDICES_OFFSET, sizeof(pIndices), pIndices);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+// The Vertex Shader can only pick its layer with one of these extensions.
+bool ShaderManager::supportsLayeredViews()
+{
+    return GLEW_ARB_shader_viewport_layer_array || GLEW_AMD_vertex_shader_layer;
+}
+
+// Shaders that draw each Instance once per view of the Views Buffer, into the layer of the view.
+bool ShaderManager::isMultiViewShader(eShaderType eType)
+{
+    return LIGHT_SHDR == eType || TOON_SHDR == eType || BLINN_PHONG_SHDR == eType || TRON_SHDR == eType;
+}
+
 // Binds and creates a buffer on the GPU.  Sets the data into the buffer and returns the location of the buffer.
 GLuint ShaderManager::genVertexBuffer(GLuint iVertArray, const void* pData, GLsizeiptr pSize, GLenum usage)
 {
@@ -294,10 +372,11 @@ GLuint ShaderManager::genVertexBuffer(GLuint iVertArray, const void* pData, GLsi
 }
 
 // Enables an Attribute Pointer for a specified Vertex Array
-void ShaderManager::setAttrib(GLuint iVertArray, GLuint iSpecifiedIndex, GLint iChunkSize, GLsizei iStride, const void *pOffset)
+//  Packed types (e.g. GL_INT_2_10_10_10_REV) are converted to floats for the shader, normalized if bNormalized is set.
+void ShaderManager::setAttrib(GLuint iVertArray, GLuint iSpecifiedIndex, GLint iChunkSize, GLsizei iStride, const void *pOffset, GLenum eType, GLboolean bNormalized)
 {
     glBindVertexArray(iVertArray);
-    glVertexAttribPointer(iSpecifiedIndex, iChunkSize, GL_FLOAT, GL_FALSE, iStride, pOffset);
+    glVertexAttribPointer(iSpecifiedIndex, iChunkSize, eType, bNormalized, iStride, pOffset);
     glEnableVertexAttribArray(iSpecifiedIndex);
 
     //glBindVertexArray(0);
@@ -326,226 +405,177 @@ GLuint ShaderManager::genInstanceBuffer(GLuint iVertArray, GLuint iStartIndex, c
     // Set up Instanced Buffer for Instance Rendering
     GLuint iReturnIBO = genVertexBuffer(iVertArray, pData, pSize, usage);
 
+    setInstanceAttribs(iVertArray, iStartIndex, iReturnIBO, 0);
+
+    return iReturnIBO;
+}
+
+// Points the Instance Attributes of a Vertex Array at a Mat4 array starting iOffset bytes into an Instance Buffer.
+//  Called again whenever the Instances are read from a different part of the buffer.
+void ShaderManager::setInstanceAttribs(GLuint iVertArray, GLuint iStartIndex, GLuint iInstanceBuffer, GLintptr iOffset)
+{
     // Instance Rendering Attributes
     //    Set up openGL for referencing the InstancedBuffer as a Mat4
     // column 0
-    glBindBuffer(GL_ARRAY_BUFFER, iReturnIBO);
+    glBindVertexArray(iVertArray);
+    glBindBuffer(GL_ARRAY_BUFFER, iInstanceBuffer);
     setAttrib(
-        iVertArray, iStartIndex, 4, INSTANCE_STRIDE, (void*)0);
+        iVertArray, iStartIndex, 4, INSTANCE_STRIDE, (void*)iOffset);
     // column 1
     setAttrib(
-        iVertArray, iStartIndex + 1, 4, INSTANCE_STRIDE, (void*)sizeof(vec4));
+        iVertArray, iStartIndex + 1, 4, INSTANCE_STRIDE, (void*)(iOffset + sizeof(vec4)));
     // column 2
-    SHADER_MANAGER->setAttrib(
-        iVertArray, iStartIndex + 2, 4, INSTANCE_STRIDE, (void*)(sizeof(vec4) << 1));
+    setAttrib(
+        iVertArray, iStartIndex + 2, 4, INSTANCE_STRIDE, (void*)(iOffset + (sizeof(vec4) << 1)));
     // column 3
-    SHADER_MANAGER->setAttrib(
-        iVertArray, iStartIndex + 3, 4, INSTANCE_STRIDE, (void*)(3 * sizeof(vec4)));
+    setAttrib(
+        iVertArray, iStartIndex + 3, 4, INSTANCE_STRIDE, (void*)(iOffset + 3 * sizeof(vec4)));
 
-    glBindVertexArray(iVertArray);
     glVertexAttribDivisor(iStartIndex, 1);
     glVertexAttribDivisor(iStartIndex + 1, 1);
     glVertexAttribDivisor(iStartIndex + 2, 1);
     glVertexAttribDivisor(iStartIndex + 3, 1);
+}
 
-    return iReturnIBO;
+/*
+    Location of a uniform by name. With the cache this is a lookup in the table
+    built at link time; without it the driver is asked every time.
+*/
+GLint ShaderManager::getUniformLocation(eShaderType eType, const string& sVarName)
+{
+    if (m_bUniformCacheEnabled)
+        return m_pShader[eType].getUniformLocation(sVarName);
+    return glGetUniformLocation(getProgram(eType), sVarName.c_str());
 }
 
-// given a glm 4x4 Matrix, a specifed shader and a variablename, attempt to set the given matrix into that uniform variable.
-void ShaderManager::setUnifromMatrix4x4(eShaderType eType, string sVarName, const mat4* pResultingMatrix)
+GLint ShaderManager::getUniformLocation(eShaderType eType, eUniform eVar)
 {
-    GLint iVariableLocation;
-    GLint iProgram, iCurrProgram;
+    if (m_bUniformCacheEnabled)
+        return m_pUniformLocations[eType][eVar];
+    return glGetUniformLocation(getProgram(eType), UNIFORM_NAMES[eVar]);
+}
 
-    if (eType < eShaderType::MAX_SHDRS && eType >= 0)
-    {
-        iProgram = getProgram(eType);
+/*
+    Set a uniform in the program of a shader. glProgramUniform writes to the
+    program directly; without the cache, the program is bound for the write and
+    the previous one restored afterwards, as every uniform used to be set.
+*/
+template <class WriteFunction>
+void ShaderManager::writeUniform(eShaderType eType, GLint iLocation, WriteFunction fnWrite)
+{
+    if (ERR_CODE == iLocation)
+        return;
 
+    GLuint iProgram = getProgram(eType);
+    if (m_bUniformCacheEnabled)
+        fnWrite(iProgram, iLocation);
+    else
+    {
+        GLint iCurrProgram;
         glGetIntegerv(GL_CURRENT_PROGRAM, &iCurrProgram);
         glUseProgram(iProgram);
-        iVariableLocation = glGetUniformLocation(iProgram, sVarName.c_str());
-        if (ERR_CODE != iVariableLocation)
-        {
-            glUniformMatrix4fv(iVariableLocation, 1, GL_FALSE, value_ptr(*pResultingMatrix));
-        }
+        fnWrite(iProgram, iLocation);
         glUseProgram(iCurrProgram);
+    }
 
 #ifdef _DEBUG
-        CheckGLErrors();
+    CheckGLErrors();
 #endif // _DEBUG
-    }
 }
 
-// given a glm vec3 set it as the unifrom light position in the mesh shader
-void ShaderManager::setUniformVec3(eShaderType eType, string sVarName, const glm::vec3* pValue )
+// given a glm 4x4 Matrix, a specifed shader and a variablename, attempt to set the given matrix into that uniform variable.
+void ShaderManager::setUnifromMatrix4x4(eShaderType eType, const string& sVarName, const mat4* pResultingMatrix)
 {
-    GLint iVariableLocation;
-    GLint iProgram, iCurrProgram;
-
     if (eType < eShaderType::MAX_SHDRS && eType >= 0)
-    {
-        iProgram = getProgram(eType);
+        writeUniform(eType, getUniformLocation(eType, sVarName), [pResultingMatrix](GLuint iProgram, GLint iLocation)
+                     { glProgramUniformMatrix4fv(iProgram, iLocation, 1, GL_FALSE, value_ptr(*pResultingMatrix)); });
+}
 
-        glGetIntegerv(GL_CURRENT_PROGRAM, &iCurrProgram);
-        glUseProgram(iProgram);
-        iVariableLocation = glGetUniformLocation(iProgram, sVarName.c_str());
-        if (ERR_CODE != iVariableLocation)
-        {
-            glUniform3fv(iVariableLocation, 1, glm::value_ptr(*pValue));
-        }
-        glUseProgram(iCurrProgram);
+// given a glm vec3 set it as the unifrom light position in the mesh shader
+void ShaderManager::setUniformVec3(eShaderType eType, const string& sVarName, const glm::vec3* pValue )
+{
+    if (eType < eShaderType::MAX_SHDRS && eType >= 0)
+        writeUniform(eType, getUniformLocation(eType, sVarName), [pValue](GLuint iProgram, GLint iLocation)
+                     { glProgramUniform3fv(iProgram, iLocation, 1, value_ptr(*pValue)); });
+}
 
-#ifdef _DEBUG
-        CheckGLErrors();
-#endif // _DEBUG
-    }
+void ShaderManager::setUniformVec3(eShaderType eType, eUniform eVar, const vec3* pValue)
+{
+    writeUniform(eType, getUniformLocation(eType, eVar), [pValue](GLuint iProgram, GLint iLocation)
+                 { glProgramUniform3fv(iProgram, iLocation, 1, value_ptr(*pValue)); });
 }
 
 // sets a uniform vec4 value in the specified shader to the given value.
-void ShaderManager::setUniformVec4(eShaderType eType, string sVarName, const vec4* pValue)
+void ShaderManager::setUniformVec4(eShaderType eType, const string& sVarName, const vec4* pValue)
 {
-    GLint iVariableLocation;
-    GLint iProgram, iCurrProgram;
-
     if (eType < eShaderType::MAX_SHDRS && eType >= 0)
-    {
-        iProgram = getProgram(eType);
-
-        glGetIntegerv(GL_CURRENT_PROGRAM, &iCurrProgram);
-        glUseProgram(iProgram);
-        iVariableLocation = glGetUniformLocation(iProgram, sVarName.c_str());
-        if (ERR_CODE != iVariableLocation)
-        {
-            glUniform4fv(iVariableLocation, 1, glm::value_ptr(*pValue));
-        }
-        glUseProgram(iCurrProgram);
+        writeUniform(eType, getUniformLocation(eType, sVarName), [pValue](GLuint iProgram, GLint iLocation)
+                     { glProgramUniform4fv(iProgram, iLocation, 1, value_ptr(*pValue)); });
+}
 
-#ifdef _DEBUG
-        CheckGLErrors();
-#endif // _DEBUG
-    }
+void ShaderManager::setUniformVec4(eShaderType eType, eUniform eVar, const vec4* pValue)
+{
+    writeUniform(eType, getUniformLocation(eType, eVar), [pValue](GLuint iProgram, GLint iLocation)
+                 { glProgramUniform4fv(iProgram, iLocation, 1, value_ptr(*pValue)); });
 }
 
 // Sets a single uniform floating value in the specified shader to the given value.
-void ShaderManager::setUniformFloat(eShaderType eType, string sVarName, float fVal)
+void ShaderManager::setUniformFloat(eShaderType eType, const string& sVarName, float fVal)
 {
-    GLint iVariableLocation;
-    GLint iProgram, iCurrProgram;
-
     if (eType < eShaderType::MAX_SHDRS && eType >= 0)
-    {
-        iProgram = getProgram(eType);
-
-        glGetIntegerv(GL_CURRENT_PROGRAM, &iCurrProgram);
-        glUseProgram(iProgram);
-        iVariableLocation = glGetUniformLocation(iProgram, sVarName.c_str());
-        if (ERR_CODE != iVariableLocation)
-        {
-            glUniform1f(iVariableLocation, fVal);
-        }
-        glUseProgram(iCurrProgram);
+        writeUniform(eType, getUniformLocation(eType, sVarName), [fVal](GLuint iProgram, GLint iLocation)
+                     { glProgramUniform1f(iProgram, iLocation, fVal); });
+}
 
-#ifdef _DEBUG
-        CheckGLErrors();
-#endif // _DEBUG
-    }
+void ShaderManager::setUniformFloat(eShaderType eType, eUniform eVar, float fVal)
+{
+    writeUniform(eType, getUniformLocation(eType, eVar), [fVal](GLuint iProgram, GLint iLocation)
+                 { glProgramUniform1f(iProgram, iLocation, fVal); });
 }
 
 // Sets a uniform integer value in the specified shader program to the given value.
-void ShaderManager::setUniformInt(eShaderType eType, string sVarName, int iVal, unsigned int iIndex)
+void ShaderManager::setUniformInt(eShaderType eType, const string& sVarName, int iVal, unsigned int iIndex)
 {
-    GLint iVariableLocation;
-    GLint iProgram, iCurrProgram;
-
     if (eType < eShaderType::MAX_SHDRS && eType >= 0)
-    {
-        iProgram = getProgram(eType);
-
-        glGetIntegerv(GL_CURRENT_PROGRAM, &iCurrProgram);
-        glUseProgram(iProgram);
-        iVariableLocation = glGetUniformLocation(iProgram, sVarName.c_str());
-        if (ERR_CODE != iVariableLocation)
-        {
-            glUniform1i(iVariableLocation + iIndex, iVal);
-        }
-        glUseProgram(iCurrProgram);
+        writeUniform(eType, getUniformLocation(eType, sVarName), [iVal, iIndex](GLuint iProgram, GLint iLocation)
+                     { glProgramUniform1i(iProgram, iLocation + iIndex, iVal); });
+}
 
-#ifdef _DEBUG
-        CheckGLErrors();
-#endif // _DEBUG
-    }
+void ShaderManager::setUniformInt(eShaderType eType, eUniform eVar, int iVal, unsigned int iIndex)
+{
+    writeUniform(eType, getUniformLocation(eType, eVar), [iVal, iIndex](GLuint iProgram, GLint iLocation)
+                 { glProgramUniform1i(iProgram, iLocation + iIndex, iVal); });
 }
 
 // Sets a uniform integer value to all loaded shaders if applicable.
-void ShaderManager::setUniformIntAll(string sVarName, int iVal, unsigned int iIndex)
+void ShaderManager::setUniformIntAll(const string& sVarName, int iVal, unsigned int iIndex)
 {
-    GLint iVariableLocation;
-    GLint iProgram, iCurrProgram;
-
-    // Get the current Program to rebase program after setting uniforms
-    glGetIntegerv(GL_CURRENT_PROGRAM, &iCurrProgram);
     for( unsigned int eIndex = 0; eIndex < MAX_SHDRS; ++eIndex )
-    {
-        iProgram = getProgram(static_cast<eShaderType>(eIndex));
-        glUseProgram(iProgram);
-
-        // Get the Uniform Location
-        iVariableLocation = glGetUniformLocation(iProgram, sVarName.c_str());
-        if (ERR_CODE != iVariableLocation)  // If the Uniform exists, set the value
-            glUniform1i(iVariableLocation + iIndex, iVal);
-
-#ifdef _DEBUG
-        CheckGLErrors();
-#endif // _DEBUG
-    }
-
-    // Set the program back to the original program
-    glUseProgram(iCurrProgram);
+        setUniformInt(static_cast<eShaderType>(eIndex), sVarName, iVal, iIndex);
 }
 
 // Set a Uniform Boolean Value within a given Shader.
-void ShaderManager::setUniformBool(eShaderType eType, string sVarName, bool bVal)
+void ShaderManager::setUniformBool(eShaderType eType, const string& sVarName, bool bVal)
 {
-    GLint iVariableLocation;
-    GLint iProgram, iCurrProgram;
-
     if (eType < eShaderType::MAX_SHDRS && eType >= 0)
-    {
-        iProgram = getProgram(eType);
-        iVariableLocation = glGetUniformLocation(iProgram, sVarName.c_str());
-
-        if (ERR_CODE != iVariableLocation)
-        {
-            glGetIntegerv(GL_CURRENT_PROGRAM, &iCurrProgram);
-            glUseProgram(iProgram);
-            glUniform1i(iVariableLocation, bVal);
-            glUseProgram(iCurrProgram);
-        }
-    }
+        writeUniform(eType, getUniformLocation(eType, sVarName), [bVal](GLuint iProgram, GLint iLocation)
+                     { glProgramUniform1i(iProgram, iLocation, bVal); });
 }
 
-// Toggles a Boolean Value in the given shader.
-void ShaderManager::toggleUniformBool(eShaderType eType, string sVarName)
+void ShaderManager::setUniformBool(eShaderType eType, eUniform eVar, bool bVal)
 {
-    GLint iVariableLocation;
-    GLint iProgram, iCurrProgram;
-    GLint bCurrSetting;
+    writeUniform(eType, getUniformLocation(eType, eVar), [bVal](GLuint iProgram, GLint iLocation)
+                 { glProgramUniform1i(iProgram, iLocation, bVal); });
+}
 
+// Toggles a Boolean Value in the given shader.
+void ShaderManager::toggleUniformBool(eShaderType eType, const string& sVarName)
+{
     if (eType < eShaderType::MAX_SHDRS && eType >= 0)
-    {
-        iProgram = getProgram(eType);
-        iVariableLocation = glGetUniformLocation(iProgram, sVarName.c_str());
-
-        if (ERR_CODE != iVariableLocation)
-        {
-            glGetUniformiv(iProgram, iVariableLocation, &bCurrSetting);
-
-            bCurrSetting = !bCurrSetting;
-
-            glGetIntegerv(GL_CURRENT_PROGRAM, &iCurrProgram);
-            glUseProgram(iProgram);
-            glUniform1i(iVariableLocation, bCurrSetting);
-            glUseProgram(iCurrProgram);
-        }
-    }
+        writeUniform(eType, getUniformLocation(eType, sVarName), [](GLuint iProgram, GLint iLocation)
+                     {
+                         GLint bCurrSetting;
+                         glGetUniformiv(iProgram, iLocation, &bCurrSetting);
+                         glProgramUniform1i(iProgram, iLocation, !bCurrSetting);
+                     });
 }
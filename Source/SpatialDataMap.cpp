@@ -14,12 +14,20 @@ const vec4 POINT_COLOR      = vec4(0.9411764705882353f, 1.0f, 0.9411764705882353
 const vec4 DYNAMIC_COLOR    = vec4(0.0f, 0.65882352941176470588235294117647f, 0.41960784313725490196078431372549f, ALPHA);    // Jade
 float OVERLAY_HEIGHT = 0.1f;
 
+// Points of a cell the visibility rays are cast between, as fractions of the tile size.
+const vec2 PVS_SAMPLES[] = { vec2(0.5f), vec2(0.1f, 0.1f), vec2(0.9f, 0.1f), vec2(0.1f, 0.9f), vec2(0.9f, 0.9f) };
+
 /***********\
  * Defines *
 \***********/
 #define MIN_INDEX 0
 #define MAX_INDEX 1
 
+// Heights the Potentially Visible Set holds between: an occluder has to fill them, and only the
+//  cameras and bounding spheres within them are culled with it.
+#define PVS_BOTTOM  -50.0f
+#define PVS_TOP     50.0f
+
 /****************************\
  * Singleton Implementation *
 \****************************/
@@ -36,6 +44,7 @@ SpatialDataMap* SpatialDataMap::getInstance()
 SpatialDataMap::SpatialDataMap()
 {
     m_bIsInitialized = false;
+    m_bVisibilityBaked = false;
 }
 
 // Destructor for Data Map
@@ -59,6 +68,8 @@ void SpatialDataMap::clearMap()
 
     // clear the base vector of its elements
     m_pSpatialMap.clear();
+    m_pVisibleCells.clear();
+    m_bVisibilityBaked = false;
 
 #ifdef _DEBUG
     // Delete VBOs and VAOs
@@ -143,6 +154,9 @@ void SpatialDataMap::populateStaticMap(const unordered_map<int, unique_ptr<Entit
         }
     }
 
+    // Bake which cells can see each other now that the occluders are in place.
+    computeVisibility();
+
 #ifdef _DEBUG // Only deal with GPU in Debug release
     // Add Populated Indices list to the GPU
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_iPopulatedIndicesBuffer);
@@ -347,11 +361,12 @@ void SpatialDataMap::initializeForAStar(vector<vector<bool>> &closedList)
     @param playerMax    maxiumum grid location of start
     @param destMin      minmum grid location of target
     @param destMax      maxiumum grid location of target
-
-    @return the shortest path
+    @param pReturnPath  cleared and filled with the shortest path. Passed in by
+                        the caller so its capacity is reused between frames.
 */
-vector<uvec2> SpatialDataMap::getShortestPath(uvec2 playerMin, uvec2 playerMax,
-                                              uvec2 destMin, uvec2 destMax) {
+void SpatialDataMap::getShortestPath(uvec2 playerMin, uvec2 playerMax,
+                                     uvec2 destMin, uvec2 destMax,
+                                     vector<uvec2>* pReturnPath) {
     uvec2 dest = destMin;
     if (!isValid((int)dest.x, (int)dest.y)) {
         int yMul = (destMax.y - destMin.y) == 0 ? 0 : (destMax.y - destMin.y) / abs(destMax.y - destMin.y);
@@ -418,7 +433,7 @@ vector<uvec2> SpatialDataMap::getShortestPath(uvec2 playerMin, uvec2 playerMax,
     }
 
     initializeForDijkstras();
-    queue<vec2> valuesToTry;
+    frame_queue<vec2> valuesToTry;  // Transient: allocated from the Frame Arena
     valuesToTry.push(player);
     vec2 currPos;
     bool exitLoop = false;
@@ -465,9 +480,9 @@ vector<uvec2> SpatialDataMap::getShortestPath(uvec2 playerMin, uvec2 playerMax,
         }
         if (exitLoop) break;
     }
-    vector<uvec2> returnPath;
+    pReturnPath->clear();
     while (exitLoop && !(currPos.x == player.x && currPos.y == player.y)) {
-        returnPath.push_back(uvec2(m_pSpatialMap[(int)currPos.x][(int)currPos.y].parentX,
+        pReturnPath->push_back(uvec2(m_pSpatialMap[(int)currPos.x][(int)currPos.y].parentX,
             m_pSpatialMap[(int)currPos.x][(int)currPos.y].parentY));
         int temp = (int)currPos.x;
         if (m_pSpatialMap[temp][(int)currPos.y].parentX == -1 ||
@@ -477,7 +492,6 @@ vector<uvec2> SpatialDataMap::getShortestPath(uvec2 playerMin, uvec2 playerMax,
         currPos.x = (float)m_pSpatialMap[temp][(int)currPos.y].parentX;
         currPos.y = (float)m_pSpatialMap[temp][(int)currPos.y].parentY;
     }
-    return returnPath;
 }
 vector<vec2> emptyVectorArray; // bad practice but saves us having to reinstacate every frame
 vector<vec2> SpatialDataMap::makePath(sSpatialCell dest) {
@@ -699,7 +713,7 @@ void SpatialDataMap::drawMap()
         glUseProgram(SHADER_MANAGER->getProgram(ShaderManager::eShaderType::DEBUG_SHDR));
 
         // Set the color for the Spacial Map Outline
-        SHADER_MANAGER->setUniformVec4(ShaderManager::eShaderType::DEBUG_SHDR, "vColor", &GRID_COLOR);
+        SHADER_MANAGER->setUniformVec4(ShaderManager::eShaderType::DEBUG_SHDR, ShaderManager::DEBUG_COLOR, &GRID_COLOR);
 
         // Draw the Map
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_iMapIndicesBuffer);
@@ -725,7 +739,7 @@ void SpatialDataMap::drawMap()
                         vColor = (vColor * 0.5f) + (SPOT_COLOR * 0.5f);
 
                     // Set the blended color.
-                    SHADER_MANAGER->setUniformVec4(ShaderManager::eShaderType::DEBUG_SHDR, "vColor", &vColor);
+                    SHADER_MANAGER->setUniformVec4(ShaderManager::eShaderType::DEBUG_SHDR, ShaderManager::DEBUG_COLOR, &vColor);
                     glDrawElementsInstanced(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_INT, (void*)((i << 2) * sizeof(unsigned int)), 1);
                     ++i;    // Increment to next set of indices in the GPU
                     vColor = DYNAMIC_COLOR;
@@ -747,7 +761,7 @@ void SpatialDataMap::drawMap()
             else if (!m_pSpatialMap[m_pPopulatedSquareReference[j].first][m_pPopulatedSquareReference[j].second].pLocalSpotLights.empty())
                 vColor = (vColor * 0.5f) + (SPOT_COLOR * 0.5f);
 
-            SHADER_MANAGER->setUniformVec4(ShaderManager::eShaderType::DEBUG_SHDR, "vColor", &vColor);
+            SHADER_MANAGER->setUniformVec4(ShaderManager::eShaderType::DEBUG_SHDR, ShaderManager::DEBUG_COLOR, &vColor);
             glDrawElementsInstanced(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_INT, (void*)((j << 2) * sizeof(unsigned int)), 1);
             vColor = vec4(1.0f);
         }
@@ -791,6 +805,202 @@ bool SpatialDataMap::getMapIndices(const Entity* vEntity, unsigned int* iXMin, u
     return bReturnValue; // Tell the caller whether the data is valid or not (Is it out of range?)
 }
 
+/*
+    Bake the Potentially Visible Set: whether each pair of cells can see each
+    other, i.e. whether a ray between sample points of the two cells gets
+    through without crossing an occluder cell. An occluder cell is fully
+    covered by a Static Entity that fills the heights between PVS_BOTTOM and
+    PVS_TOP, like the pillars of the arena; the low walls the cameras look
+    over don't hide anything. Pairs with no occluder in the rectangle between
+    them are visible without casting any ray.
+*/
+void SpatialDataMap::computeVisibility()
+{
+    if (!m_bIsInitialized)
+        return;
+
+    // Local Variables
+    unsigned int iCells = m_iMaxX * m_iMaxY;
+    unsigned int iSumRow = m_iMaxY + 1;
+    unsigned int iOccluders = 0;
+    vector<bool> pOccluders(iCells, false);
+    vector<unsigned int> pOccluderSums(static_cast<size_t>(m_iMaxX + 1) * iSumRow, 0);  // Occluders in the cells before (x, y)
+#ifndef NDEBUG
+    high_resolution_clock::time_point pStart = high_resolution_clock::now();
+#endif
+
+    // Find the Occluder cells
+    for (unsigned int x = 0; x < m_iMaxX; ++x)
+    {
+        for (unsigned int y = 0; y < m_iMaxY; ++y)
+        {
+            const sSpatialCell& sCell = m_pSpatialMap[x][y];
+            vec2 vCellMax = sCell.vOriginPos + vec2(m_fTileSize);
+            for (const StaticEntity* pEntity : sCell.pLocalEntities)
+            {
+                vec3 vNegativeOffset(0.0f), vPositiveOffset(0.0f), vPosition = pEntity->getPosition();
+                pEntity->getSpatialDimensions(&vNegativeOffset, &vPositiveOffset);
+                vNegativeOffset += vPosition;
+                vPositiveOffset += vPosition;
+                if (vNegativeOffset.x <= sCell.vOriginPos.x && vNegativeOffset.z <= sCell.vOriginPos.y &&
+                    vPositiveOffset.x >= vCellMax.x && vPositiveOffset.z >= vCellMax.y &&
+                    vNegativeOffset.y <= PVS_BOTTOM && vPositiveOffset.y >= PVS_TOP)
+                {
+                    pOccluders[x * m_iMaxY + y] = true;
+                    ++iOccluders;
+                    break;
+                }
+            }
+
+            pOccluderSums[(x + 1) * iSumRow + y + 1] = (pOccluders[x * m_iMaxY + y] ? 1 : 0) + pOccluderSums[x * iSumRow + y + 1]
+                                                     + pOccluderSums[(x + 1) * iSumRow + y] - pOccluderSums[x * iSumRow + y];
+        }
+    }
+
+    // Without occluders, everything is visible from everywhere.
+    m_pVisibleCells.assign(static_cast<size_t>(iCells) * iCells, true);
+    m_bVisibilityBaked = iOccluders > 0;
+    if (!m_bVisibilityBaked)
+        return;
+
+    unsigned int iHiddenPairs = 0;
+    for (unsigned int iCellA = 0; iCellA < iCells; ++iCellA)
+    {
+        unsigned int xA = iCellA / m_iMaxY, yA = iCellA % m_iMaxY;
+        for (unsigned int iCellB = iCellA + 1; iCellB < iCells; ++iCellB)
+        {
+            unsigned int xB = iCellB / m_iMaxY, yB = iCellB % m_iMaxY;
+            unsigned int xMin = std::min(xA, xB), xMax = std::max(xA, xB) + 1;
+            unsigned int yMin = std::min(yA, yB), yMax = std::max(yA, yB) + 1;
+            unsigned int iBetween = pOccluderSums[xMax * iSumRow + yMax] - pOccluderSums[xMin * iSumRow + yMax]
+                                  - pOccluderSums[xMax * iSumRow + yMin] + pOccluderSums[xMin * iSumRow + yMin]
+                                  - (pOccluders[iCellA] ? 1 : 0) - (pOccluders[iCellB] ? 1 : 0);
+            if (0 == iBetween)
+                continue;
+
+            bool bVisible = false;
+            for (const vec2& vSampleA : PVS_SAMPLES)
+            {
+                vec2 vStart = vec2(xA, yA) + vSampleA;
+                for (const vec2& vSampleB : PVS_SAMPLES)
+                {
+                    vec2 vEnd = vec2(xB, yB) + vSampleB;
+                    if (traceVisibility(&vStart, &vEnd, &pOccluders))
+                    {
+                        bVisible = true;
+                        break;
+                    }
+                }
+                if (bVisible)
+                    break;
+            }
+
+            if (!bVisible)
+            {
+                m_pVisibleCells[static_cast<size_t>(iCellA) * iCells + iCellB] = false;
+                m_pVisibleCells[static_cast<size_t>(iCellB) * iCells + iCellA] = false;
+                ++iHiddenPairs;
+            }
+        }
+    }
+
+#ifndef NDEBUG
+    cout << "Potentially Visible Set: " << iOccluders << " occluder cells, " << iHiddenPairs << " of "
+         << (static_cast<unsigned long long>(iCells) * (iCells - 1) / 2) << " cell pairs hidden, baked in "
+         << duration<double, milli>(high_resolution_clock::now() - pStart).count() << " ms" << endl;
+#endif
+}
+
+/*
+    Walk the cells a segment crosses, in cell units, and check that none of
+    the cells between its ends is an occluder. Every step crosses into the
+    next cell along one axis, so the walk takes as many steps as the cells
+    of its ends are apart.
+*/
+bool SpatialDataMap::traceVisibility(const vec2* vStart, const vec2* vEnd, const vector<bool>* pOccluders) const
+{
+    // Local Variables
+    ivec2 vCell = ivec2(floor(*vStart));
+    ivec2 vEndCell = ivec2(floor(*vEnd));
+    vec2 vDirection = *vEnd - *vStart;
+    ivec2 vStep = ivec2(sign(vDirection));
+    vec2 vNextBoundary, vBoundaryDelta;    // Along the segment (0 to 1): to the next cell boundary of each axis and between boundaries
+
+    for (unsigned int iAxis = 0; iAxis < 2; ++iAxis)
+    {
+        if (0 == vStep[iAxis])
+            vNextBoundary[iAxis] = vBoundaryDelta[iAxis] = FLT_MAX;
+        else
+        {
+            float fBoundary = static_cast<float>(vStep[iAxis] > 0 ? vCell[iAxis] + 1 : vCell[iAxis]);
+            vNextBoundary[iAxis] = (fBoundary - (*vStart)[iAxis]) / vDirection[iAxis];
+            vBoundaryDelta[iAxis] = abs(1.0f / vDirection[iAxis]);
+        }
+    }
+
+    for (int iSteps = abs(vEndCell.x - vCell.x) + abs(vEndCell.y - vCell.y); iSteps > 1; --iSteps)
+    {
+        if (vNextBoundary.x < vNextBoundary.y)
+        {
+            vCell.x += vStep.x;
+            vNextBoundary.x += vBoundaryDelta.x;
+        }
+        else
+        {
+            vCell.y += vStep.y;
+            vNextBoundary.y += vBoundaryDelta.y;
+        }
+
+        if (vCell.x >= 0 && vCell.y >= 0 && vCell.x < static_cast<int>(m_iMaxX) && vCell.y < static_cast<int>(m_iMaxY) &&
+            (*pOccluders)[vCell.x * m_iMaxY + vCell.y])
+            return false;
+    }
+
+    return true;
+}
+
+/*
+    The cell of the Potentially Visible Set a camera sees from, or -1 if it
+    can't be culled with it: nothing hides anything, or the camera is outside
+    the map or the heights the set holds between.
+*/
+int SpatialDataMap::getVisibilityCell(const vec3* vViewPosition) const
+{
+    if (!m_bVisibilityBaked || vViewPosition->y < PVS_BOTTOM || vViewPosition->y > PVS_TOP)
+        return -1;
+
+    vec2 vCell = (vec2(vViewPosition->x, vViewPosition->z) - m_vOriginPos) / m_fTileSize;
+    if (vCell.x < 0.0f || vCell.y < 0.0f || vCell.x >= m_iMaxX || vCell.y >= m_iMaxY)
+        return -1;
+
+    return static_cast<int>(vCell.x) * m_iMaxY + static_cast<int>(vCell.y);
+}
+
+/*
+    Whether a bounding sphere may be seen from a cell: if any cell under it is
+    visible from there. Spheres reaching out of the map or of the heights the
+    set holds between are always visible.
+*/
+bool SpatialDataMap::isPotentiallyVisible(int iViewCell, const vec4* vBoundingSphere) const
+{
+    if (iViewCell < 0 || vBoundingSphere->y - vBoundingSphere->w < PVS_BOTTOM || vBoundingSphere->y + vBoundingSphere->w > PVS_TOP)
+        return true;
+
+    vec2 vCenter = vec2(vBoundingSphere->x, vBoundingSphere->z) - m_vOriginPos;
+    vec2 vMin = (vCenter - vec2(vBoundingSphere->w)) / m_fTileSize;
+    vec2 vMax = (vCenter + vec2(vBoundingSphere->w)) / m_fTileSize;
+    if (vMin.x < 0.0f || vMin.y < 0.0f || vMax.x >= m_iMaxX || vMax.y >= m_iMaxY)
+        return true;
+
+    size_t iRow = static_cast<size_t>(iViewCell) * m_iMaxX * m_iMaxY;
+    for (unsigned int x = static_cast<unsigned int>(vMin.x); x <= static_cast<unsigned int>(vMax.x); ++x)
+        for (unsigned int y = static_cast<unsigned int>(vMin.y); y <= static_cast<unsigned int>(vMax.y); ++y)
+            if (m_pVisibleCells[iRow + x * m_iMaxY + y])
+                return true;
+
+    return false;
+}
+
 // Generates the VBOs for the Grid outline in debug mode.
 void SpatialDataMap::generateGridVBOs()
 {
@@ -1,5 +1,6 @@
 #include "Texture.h"
 #include "stb_image.h"
+#include "DataStructures/AssetPreloader.h"
 
 // Default Constructor, init everything to 0
 Texture::Texture( const string& sFileName, Texture::manager_cookie )
@@ -33,6 +34,7 @@ void Texture::genCubeMap(const vector<string>* sFileNames)
     // Local Variables
     unsigned char* data = nullptr;
     int iWidth, iHeight, nrChannels;
+    AssetPreloader::sImage sPreloadedImage;
 
     // Generate Texture
     glGenTextures(1, &m_TextureName);
@@ -47,7 +49,14 @@ void Texture::genCubeMap(const vector<string>* sFileNames)
     //      5 - Negative Z (Front)
     for (GLuint i = 0; i < sFileNames->size(); ++i)
     {
-        data = stbi_load((*sFileNames)[i].c_str(), &iWidth, &iHeight, &nrChannels, 0);
+        if (ASSET_PRELOADER->takeImage((*sFileNames)[i], &sPreloadedImage))
+        {
+            data = sPreloadedImage.pPixels;
+            iWidth = sPreloadedImage.iWidth;
+            iHeight = sPreloadedImage.iHeight;
+        }
+        else
+            data = stbi_load((*sFileNames)[i].c_str(), &iWidth, &iHeight, &nrChannels, 0);
 
         if (nullptr != data)
         {
@@ -97,14 +106,21 @@ void Texture::genMipMaps()
 }
 
 // Bind Texture for Drawing to a specified shader.
-void Texture::bindTexture( ShaderManager::eShaderType eType, string sVarName, unsigned int iIndex)
+void Texture::bindTexture( ShaderManager::eShaderType eType, const string& sVarName, unsigned int iIndex)
 {
     glActiveTexture( GL_TEXTURE0 + m_TextureName );
     glBindTexture( GL_TEXTURE_2D, m_TextureName );
     SHADER_MANAGER->setUniformInt( eType, sVarName, m_TextureName, iIndex );
 }
 
-void Texture::bindTextureAsCubeMap(ShaderManager::eShaderType eType, string sVarName)
+void Texture::bindTexture( ShaderManager::eShaderType eType, ShaderManager::eUniform eVar, unsigned int iIndex)
+{
+    glActiveTexture( GL_TEXTURE0 + m_TextureName );
+    glBindTexture( GL_TEXTURE_2D, m_TextureName );
+    SHADER_MANAGER->setUniformInt( eType, eVar, m_TextureName, iIndex );
+}
+
+void Texture::bindTextureAsCubeMap(ShaderManager::eShaderType eType, const string& sVarName)
 {
     glActiveTexture(GL_TEXTURE0 + m_TextureName);
     glBindTexture(GL_TEXTURE_CUBE_MAP, m_TextureName);
@@ -112,7 +128,7 @@ void Texture::bindTextureAsCubeMap(ShaderManager::eShaderType eType, string sVar
 }
 
 // Binds Texture to all Shaders
-void Texture::bindTextureAllShaders(string sVarName, unsigned int iIndex)
+void Texture::bindTextureAllShaders(const string& sVarName, unsigned int iIndex)
 {
     glActiveTexture(GL_TEXTURE0 + m_TextureName);
     glBindTexture(GL_TEXTURE_2D, m_TextureName);
@@ -153,11 +153,11 @@ Texture* TextureManager::genTexture(const vec4* vColor)
     return pReturnTexture;
 }
 
-Texture* TextureManager::genDepthBuffer(unsigned int iWidth, unsigned int iHeight)
+Texture* TextureManager::genDepthBuffer(unsigned int iWidth, unsigned int iHeight, const string& sName)
 {
     // Attempt to grab it from the texture cache if it already exists
     Texture* pReturnTexture = nullptr;
-    string sHashValue = "DepthBuffer" + to_string(iWidth) + to_string(iHeight);
+    string sHashValue = sName + to_string(iWidth) + to_string(iHeight);
 
     if (m_pTextureCache.end() != m_pTextureCache.find(sHashValue))
     {
@@ -299,22 +299,23 @@ void UserInterface::renderText(int text, GLfloat x, GLfloat y, GLfloat scale, ve
 */
 void UserInterface::renderText(string text, GLfloat x, GLfloat y, GLfloat scale, vec3 color)
 {
-    // Vector for storing VBO data.
-    vector<vec4> vTextOutput;
+    // Vector for storing VBO data. Transient: allocated from the Frame Arena
+    frame_vector<vec4> vTextOutput;
+    vTextOutput.reserve(text.size() * 6);   // 6 vertices per character
 
     // Set up OpenGL for Rendering
     glBindVertexArray(m_iVertexArray);
     glUseProgram(m_pShdrMngr->getProgram(ShaderManager::eShaderType::UI_SHDR));
-    m_pShdrMngr->setUniformVec3(ShaderManager::eShaderType::UI_SHDR, "textColor", &color);
+    m_pShdrMngr->setUniformVec3(ShaderManager::eShaderType::UI_SHDR, ShaderManager::UI_TEXT_COLOR, &color);
     // Is text, not an image. This distinguishment needs to be made since images and
     // text share the same shader.
-    m_pShdrMngr->setUniformBool(ShaderManager::eShaderType::UI_SHDR, "isImage", false);
-    m_pShdrMngr->setUniformBool(ShaderManager::eShaderType::UI_SHDR, "backgroundImage", false);
+    m_pShdrMngr->setUniformBool(ShaderManager::eShaderType::UI_SHDR, ShaderManager::UI_IS_IMAGE, false);
+    m_pShdrMngr->setUniformBool(ShaderManager::eShaderType::UI_SHDR, ShaderManager::UI_BACKGROUND_IMAGE, false);
 
     // Bind Texture.
     glActiveTexture(GL_TEXTURE0 + m_iTextureBuffer);
     glBindTexture(GL_TEXTURE_2D, m_iTextureBuffer);
-    SHADER_MANAGER->setUniformInt(ShaderManager::eShaderType::UI_SHDR, "text", m_iTextureBuffer);
+    SHADER_MANAGER->setUniformInt(ShaderManager::eShaderType::UI_SHDR, ShaderManager::UI_TEXT, m_iTextureBuffer);
 
     // Iterate through all Characters
     string::const_iterator c;
@@ -396,12 +397,12 @@ void UserInterface::debugFont()
     glUseProgram(m_pShdrMngr->getProgram(ShaderManager::eShaderType::UI_SHDR));
     // Is text, not an image. This distinguishment needs to be made since images and
     // text share the same shader.
-    m_pShdrMngr->setUniformBool(ShaderManager::eShaderType::UI_SHDR, "isImage", false);
+    m_pShdrMngr->setUniformBool(ShaderManager::eShaderType::UI_SHDR, ShaderManager::UI_IS_IMAGE, false);
 
     // Bind Texture.
     glActiveTexture(GL_TEXTURE0 + m_iTextureBuffer);
     glBindTexture(GL_TEXTURE_2D, m_iTextureBuffer);
-    SHADER_MANAGER->setUniformInt(ShaderManager::eShaderType::UI_SHDR, "text", m_iTextureBuffer);
+    SHADER_MANAGER->setUniformInt(ShaderManager::eShaderType::UI_SHDR, ShaderManager::UI_TEXT, m_iTextureBuffer);
 
     vec4 vCorners[4] = {
         vec4(0.0f,  0.0f,  0.0f, 1.0f),
@@ -465,8 +466,8 @@ void UserInterface::renderImage(const eImage image, GLfloat x, GLfloat y, GLfloa
     glUseProgram(m_pShdrMngr->getProgram(ShaderManager::eShaderType::UI_SHDR));
     // Is an image, not text. This distinguishment needs to be made since images and
     // text share the same shader.
-    m_pShdrMngr->setUniformBool(ShaderManager::eShaderType::UI_SHDR, "isImage", true);
-    m_pShdrMngr->setUniformBool(ShaderManager::eShaderType::UI_SHDR, "backgroundImage", false);
+    m_pShdrMngr->setUniformBool(ShaderManager::eShaderType::UI_SHDR, ShaderManager::UI_IS_IMAGE, true);
+    m_pShdrMngr->setUniformBool(ShaderManager::eShaderType::UI_SHDR, ShaderManager::UI_BACKGROUND_IMAGE, false);
 
     vec4 vCorners[4] = {
     vec4(x           ,            y, 0.0f, 1.0f),
@@ -475,7 +476,7 @@ void UserInterface::renderImage(const eImage image, GLfloat x, GLfloat y, GLfloa
     vec4(x + iImage_x, y + iImage_y, 1.0f, 0.0f)
     };
 
-    texture->bindTexture(ShaderManager::eShaderType::UI_SHDR, "text");
+    texture->bindTexture(ShaderManager::eShaderType::UI_SHDR, ShaderManager::UI_TEXT);
 
     // Update content of VBO memory
     glBindBuffer(GL_ARRAY_BUFFER, m_iVertexBuffer);
@@ -513,8 +514,8 @@ void UserInterface::renderBackgroundImage(const eImage image)
     glUseProgram(m_pShdrMngr->getProgram(ShaderManager::eShaderType::UI_SHDR));
     // Is an image, not text. This distinguishment needs to be made since images and
     // text share the same shader.
-    m_pShdrMngr->setUniformBool(ShaderManager::eShaderType::UI_SHDR, "isImage", true);
-    m_pShdrMngr->setUniformBool(ShaderManager::eShaderType::UI_SHDR, "backgroundImage", true);
+    m_pShdrMngr->setUniformBool(ShaderManager::eShaderType::UI_SHDR, ShaderManager::UI_IS_IMAGE, true);
+    m_pShdrMngr->setUniformBool(ShaderManager::eShaderType::UI_SHDR, ShaderManager::UI_BACKGROUND_IMAGE, true);
 
     vec4 vCorners[4] = {
         vec4(-1.0f, -1.0f, 0.0f, 1.0f), /*Bottom Left*/
@@ -523,7 +524,7 @@ void UserInterface::renderBackgroundImage(const eImage image)
         vec4(1.0f,  1.0f,  1.0f, 0.0f), /*Top Right*/
     };
 
-    texture->bindTexture(ShaderManager::eShaderType::UI_SHDR, "text");
+    texture->bindTexture(ShaderManager::eShaderType::UI_SHDR, ShaderManager::UI_TEXT);
 
     // Update content of VBO memory
     glBindBuffer(GL_ARRAY_BUFFER, m_iVertexBuffer);
@@ -78,6 +78,24 @@ int FuncUtils::random(int range)
     return distribution(random_generator);
 }
 
+/*
+    Get the generator used by random() so its state can be saved.
+    @return the random number generator
+*/
+const std::mt19937& FuncUtils::getRandomGenerator()
+{
+    return random_generator;
+}
+
+/*
+    Restore the state of the generator used by random().
+    @param generator    state to restore
+*/
+void FuncUtils::setRandomGenerator(const std::mt19937& generator)
+{
+    random_generator = generator;
+}
+
 /*
 Convert a float to string, given a specified number of decimal places.
 
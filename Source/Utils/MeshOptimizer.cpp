@@ -0,0 +1,528 @@
+#include "Utils/MeshOptimizer.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+using namespace glm;
+
+/***********\
+ * Defines *
+\***********/
+#define UNUSED_VERTEX           0xFFFFFFFF
+// Forsyth's scoring parameters, tuned for caches of 16-32 vertices.
+#define SIMULATED_CACHE_SIZE    32
+#define CACHE_DECAY_POWER       1.5f
+#define LAST_TRIANGLE_SCORE     0.75f
+#define VALENCE_BOOST_SCALE     2.0f
+#define VALENCE_BOOST_POWER     0.5f
+
+/*
+    Score of a vertex: high if it is in the cache (but not part of the last
+    triangle, which wouldn't add anything), plus a boost for vertices with few
+    triangles left so they are finished off and don't get left behind.
+*/
+static float getVertexScore(int iCachePosition, unsigned int iRemainingTriangles)
+{
+    float fScore = 0.0f;
+    if (0 == iRemainingTriangles)
+        return -1.0f;
+
+    if (iCachePosition >= 0)
+    {
+        if (iCachePosition < 3)
+            fScore = LAST_TRIANGLE_SCORE;
+        else
+            fScore = pow(1.0f - (static_cast<float>(iCachePosition - 3) / (SIMULATED_CACHE_SIZE - 3)), CACHE_DECAY_POWER);
+    }
+
+    return fScore + (VALENCE_BOOST_SCALE * pow(static_cast<float>(iRemainingTriangles), -VALENCE_BOOST_POWER));
+}
+
+/*
+    Greedily emit the triangle with the best score, where the score of a
+    triangle is the sum of the scores of its vertices. Only triangles that use
+    a vertex in the simulated cache are considered after each step, so this
+    runs in linear time.
+
+    @param pIndices     triangle list to reorder in place
+    @param iVertexCount number of vertices referenced by pIndices
+*/
+void MeshOptimizer::optimizeVertexCache(vector<unsigned int>* pIndices, unsigned int iVertexCount)
+{
+    unsigned int iTriangleCount = static_cast<unsigned int>(pIndices->size() / 3);
+    unsigned int pCache[SIMULATED_CACHE_SIZE + 3], pNewCache[SIMULATED_CACHE_SIZE + 3];
+    unsigned int iCacheCount = 0, iNewCacheCount, iNextUnemitted = 0;
+    int iBestTriangle = -1;
+    float fBestScore = -1.0f;
+    if (0 == iTriangleCount)
+        return;
+
+    // Vertex -> Triangle adjacency; each vertex keeps its remaining triangles first.
+    vector<unsigned int> pRemaining(iVertexCount, 0), pOffsets(iVertexCount + 1, 0), pAdjacency(iTriangleCount * 3);
+    for (unsigned int iVertex : *pIndices)
+        ++pRemaining[iVertex];
+    for (unsigned int i = 0; i < iVertexCount; ++i)
+        pOffsets[i + 1] = pOffsets[i] + pRemaining[i];
+
+    vector<unsigned int> pFill(pOffsets.begin(), pOffsets.end() - 1);
+    for (unsigned int i = 0; i < iTriangleCount * 3; ++i)
+        pAdjacency[pFill[(*pIndices)[i]]++] = i / 3;
+
+    // Initial Scores
+    vector<int> pCachePositions(iVertexCount, -1);
+    vector<float> pVertexScores(iVertexCount), pTriangleScores(iTriangleCount, 0.0f);
+    vector<bool> pEmitted(iTriangleCount, false);
+    for (unsigned int i = 0; i < iVertexCount; ++i)
+        pVertexScores[i] = getVertexScore(-1, pRemaining[i]);
+    for (unsigned int i = 0; i < iTriangleCount * 3; ++i)
+    {
+        pTriangleScores[i / 3] += pVertexScores[(*pIndices)[i]];
+        if (pTriangleScores[i / 3] > fBestScore)
+        {
+            fBestScore = pTriangleScores[i / 3];
+            iBestTriangle = i / 3;
+        }
+    }
+
+    vector<unsigned int> pOutput;
+    pOutput.reserve(pIndices->size());
+    while (pOutput.size() < pIndices->size())
+    {
+        // Nothing in the cache has triangles left: continue with the next unemitted triangle.
+        if (iBestTriangle < 0)
+        {
+            while (pEmitted[iNextUnemitted])
+                ++iNextUnemitted;
+            iBestTriangle = iNextUnemitted;
+        }
+
+        // Emit the triangle and remove it from the adjacency of its vertices.
+        const unsigned int* pTriangle = &(*pIndices)[iBestTriangle * 3];
+        pEmitted[iBestTriangle] = true;
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            unsigned int iVertex = pTriangle[i];
+            unsigned int* pVertexTriangles = &pAdjacency[pOffsets[iVertex]];
+            pOutput.push_back(iVertex);
+
+            for (unsigned int j = 0; j < pRemaining[iVertex]; ++j)
+            {
+                if (pVertexTriangles[j] == static_cast<unsigned int>(iBestTriangle))
+                {
+                    pVertexTriangles[j] = pVertexTriangles[--pRemaining[iVertex]];
+                    break;
+                }
+            }
+        }
+
+        // Move the vertices of the triangle to the front of the cache.
+        iNewCacheCount = 0;
+        for (unsigned int i = 0; i < 3; ++i)
+            pNewCache[iNewCacheCount++] = pTriangle[i];
+        for (unsigned int i = 0; i < iCacheCount; ++i)
+        {
+            if (pCache[i] != pTriangle[0] && pCache[i] != pTriangle[1] && pCache[i] != pTriangle[2])
+                pNewCache[iNewCacheCount++] = pCache[i];
+        }
+
+        // Rescore the vertices whose position changed, including those that fell out of the cache.
+        for (unsigned int i = 0; i < iNewCacheCount; ++i)
+        {
+            unsigned int iVertex = pNewCache[i];
+            pCachePositions[iVertex] = (i < SIMULATED_CACHE_SIZE) ? static_cast<int>(i) : -1;
+
+            float fNewScore = getVertexScore(pCachePositions[iVertex], pRemaining[iVertex]);
+            float fDelta = fNewScore - pVertexScores[iVertex];
+            pVertexScores[iVertex] = fNewScore;
+            for (unsigned int j = 0; j < pRemaining[iVertex]; ++j)
+                pTriangleScores[pAdjacency[pOffsets[iVertex] + j]] += fDelta;
+        }
+
+        iCacheCount = std::min(iNewCacheCount, static_cast<unsigned int>(SIMULATED_CACHE_SIZE));
+        memcpy(pCache, pNewCache, iCacheCount * sizeof(unsigned int));
+
+        // Next triangle: the best one that uses a cached vertex.
+        iBestTriangle = -1;
+        fBestScore = -1.0f;
+        for (unsigned int i = 0; i < iCacheCount; ++i)
+        {
+            unsigned int iVertex = pCache[i];
+            for (unsigned int j = 0; j < pRemaining[iVertex]; ++j)
+            {
+                unsigned int iTriangle = pAdjacency[pOffsets[iVertex] + j];
+                if (pTriangleScores[iTriangle] > fBestScore)
+                {
+                    fBestScore = pTriangleScores[iTriangle];
+                    iBestTriangle = static_cast<int>(iTriangle);
+                }
+            }
+        }
+    }
+
+    pIndices->swap(pOutput);
+}
+
+/*
+    Renumber the vertices in the order they are first used.
+
+    @param pIndices     triangle list to remap in place
+    @param iVertexCount number of vertices referenced by pIndices
+    @param pNewOrder    receives the old index of every new vertex
+*/
+void MeshOptimizer::optimizeVertexFetch(vector<unsigned int>* pIndices, unsigned int iVertexCount, vector<unsigned int>* pNewOrder)
+{
+    vector<unsigned int> pRemap(iVertexCount, UNUSED_VERTEX);
+    pNewOrder->clear();
+    pNewOrder->reserve(iVertexCount);
+
+    for (unsigned int& iIndex : *pIndices)
+    {
+        if (UNUSED_VERTEX == pRemap[iIndex])
+        {
+            pRemap[iIndex] = static_cast<unsigned int>(pNewOrder->size());
+            pNewOrder->push_back(iIndex);
+        }
+        iIndex = pRemap[iIndex];
+    }
+}
+
+/*
+    Error quadric of a vertex: the sum of the squared distances to the planes
+    of the triangles collapsed into it, as a symmetric 4x4 matrix. The planes
+    are weighted by the area of their triangles; the error is the weighted
+    average so it can be compared to a distance.
+*/
+struct sQuadric
+{
+    double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2, w;
+
+    void addPlane(const dvec3& vNormal, double dDistance, double dWeight)
+    {
+        a2 += dWeight * vNormal.x * vNormal.x; ab += dWeight * vNormal.x * vNormal.y;
+        ac += dWeight * vNormal.x * vNormal.z; ad += dWeight * vNormal.x * dDistance;
+        b2 += dWeight * vNormal.y * vNormal.y; bc += dWeight * vNormal.y * vNormal.z;
+        bd += dWeight * vNormal.y * dDistance; c2 += dWeight * vNormal.z * vNormal.z;
+        cd += dWeight * vNormal.z * dDistance; d2 += dWeight * dDistance * dDistance;
+        w += dWeight;
+    }
+
+    void add(const sQuadric& sOther)
+    {
+        a2 += sOther.a2; ab += sOther.ab; ac += sOther.ac; ad += sOther.ad; b2 += sOther.b2;
+        bc += sOther.bc; bd += sOther.bd; c2 += sOther.c2; cd += sOther.cd; d2 += sOther.d2;
+        w += sOther.w;
+    }
+
+    double evaluate(const vec3& vPoint) const
+    {
+        double x = vPoint.x, y = vPoint.y, z = vPoint.z;
+        if (w <= 0.0)
+            return 0.0;
+
+        return ((a2 * x * x) + (2.0 * ab * x * y) + (2.0 * ac * x * z) + (2.0 * ad * x)
+            + (b2 * y * y) + (2.0 * bc * y * z) + (2.0 * bd * y)
+            + (c2 * z * z) + (2.0 * cd * z) + d2) / w;
+    }
+};
+
+// Candidate collapse of position iFrom onto position iTo.
+struct sCollapse
+{
+    double dCost;
+    unsigned int iFrom, iTo;
+    bool operator<(const sCollapse& sOther) const { return dCost < sOther.dCost; }
+};
+
+static unsigned long long getEdgeKey(unsigned int iA, unsigned int iB)
+{
+    return (static_cast<unsigned long long>(std::min(iA, iB)) << 32) | std::max(iA, iB);
+}
+
+/*
+    True if moving iFrom onto iTo turns one of the triangles around iFrom over.
+    Triangles that contain both collapse and are removed.
+*/
+static bool collapseFlips(const vector<unsigned int>& pTriangles, const vector<unsigned int>& pOffsets,
+                          const vector<unsigned int>& pAdjacency, const vector<vec3>& pPositions,
+                          unsigned int iFrom, unsigned int iTo)
+{
+    for (unsigned int i = pOffsets[iFrom]; i < pOffsets[iFrom + 1]; ++i)
+    {
+        const unsigned int* pTriangle = &pTriangles[pAdjacency[i] * 3];
+        if (pTriangle[0] == iTo || pTriangle[1] == iTo || pTriangle[2] == iTo)
+            continue;
+
+        vec3 vCorners[3], vMoved[3];
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            vCorners[j] = pPositions[pTriangle[j]];
+            vMoved[j] = (pTriangle[j] == iFrom) ? pPositions[iTo] : vCorners[j];
+        }
+
+        vec3 vOldNormal = cross(vCorners[1] - vCorners[0], vCorners[2] - vCorners[0]);
+        vec3 vNewNormal = cross(vMoved[1] - vMoved[0], vMoved[2] - vMoved[0]);
+        if (dot(vOldNormal, vNewNormal) <= 0.0f)
+            return true;
+    }
+
+    return false;
+}
+
+/*
+    Simplification works on the positions only, so vertices that differ only
+    in their normals or uvs stay welded together. Collapses are applied in
+    passes: all candidate collapses are sorted by cost and the cheapest ones
+    that don't touch the neighbourhood of another collapse in the same pass are
+    applied, until the target or the error limit is reached. The triangles are
+    then mapped back to the vertices: a corner that moved takes the vertex of
+    its new position with the closest normal and uv.
+*/
+void MeshOptimizer::simplify(const vector<unsigned int>& pIndices, const vector<vec3>& pPositions,
+                             const vector<unsigned int>& pVertexPositions, const float* pVertexData, unsigned int iVertexStride,
+                             unsigned int iTargetIndexCount, float fMaxError, vector<unsigned int>* pOutput)
+{
+    unsigned int iPositionCount = static_cast<unsigned int>(pPositions.size());
+    unsigned int iVertexCount = static_cast<unsigned int>(pVertexPositions.size());
+    unsigned int iTriangleCount = static_cast<unsigned int>(pIndices.size() / 3);
+    unsigned int iTargetTriangleCount = iTargetIndexCount / 3;
+    vec3 vMinimum(FLT_MAX), vMaximum(-FLT_MAX);
+
+    // Triangles on the positions, their planes and the bounds they cover.
+    vector<unsigned int> pTriangles(iTriangleCount * 3);
+    vector<sQuadric> pQuadrics(iPositionCount, sQuadric());
+    for (unsigned int i = 0; i < iTriangleCount * 3; ++i)
+    {
+        pTriangles[i] = pVertexPositions[pIndices[i]];
+        vMinimum = min(vMinimum, pPositions[pTriangles[i]]);
+        vMaximum = max(vMaximum, pPositions[pTriangles[i]]);
+    }
+    for (unsigned int i = 0; i < iTriangleCount; ++i)
+    {
+        const unsigned int* pTriangle = &pTriangles[i * 3];
+        dvec3 vA(pPositions[pTriangle[0]]), vB(pPositions[pTriangle[1]]), vC(pPositions[pTriangle[2]]);
+        dvec3 vNormal = cross(vB - vA, vC - vA);
+        double dArea = length(vNormal);
+        if (dArea <= 0.0)
+            continue;
+
+        vNormal /= dArea;
+        for (unsigned int j = 0; j < 3; ++j)
+            pQuadrics[pTriangle[j]].addPlane(vNormal, -dot(vNormal, vA), dArea * 0.5);
+    }
+
+    // Borders and non-manifold edges aren't used by exactly two triangles; their positions are locked.
+    unordered_map<unsigned long long, unsigned int> pEdgeUses;
+    vector<bool> pLocked(iPositionCount, false);
+    pEdgeUses.reserve(iTriangleCount * 2);
+    for (unsigned int i = 0; i < iTriangleCount * 3; ++i)
+        ++pEdgeUses[getEdgeKey(pTriangles[i], pTriangles[(i % 3 == 2) ? (i - 2) : (i + 1)])];
+    for (const pair<const unsigned long long, unsigned int>& pEdge : pEdgeUses)
+    {
+        if (2 != pEdge.second)
+        {
+            pLocked[static_cast<unsigned int>(pEdge.first >> 32)] = true;
+            pLocked[static_cast<unsigned int>(pEdge.first & 0xFFFFFFFF)] = true;
+        }
+    }
+
+    double dErrorLimit = static_cast<double>(fMaxError) * length(vMaximum - vMinimum);
+    dErrorLimit *= dErrorLimit;
+    vector<unsigned int> pRemap(iPositionCount), pOffsets, pAdjacency, pFill;
+    vector<sCollapse> pCollapses;
+    vector<bool> pTouched;
+    for (unsigned int i = 0; i < iPositionCount; ++i)
+        pRemap[i] = i;
+
+    while (iTriangleCount > iTargetTriangleCount)
+    {
+        // Position -> Triangle adjacency of the remaining triangles.
+        pOffsets.assign(iPositionCount + 1, 0);
+        pAdjacency.resize(iTriangleCount * 3);
+        for (unsigned int i = 0; i < iTriangleCount * 3; ++i)
+            ++pOffsets[pTriangles[i] + 1];
+        for (unsigned int i = 0; i < iPositionCount; ++i)
+            pOffsets[i + 1] += pOffsets[i];
+        pFill.assign(pOffsets.begin(), pOffsets.end() - 1);
+        for (unsigned int i = 0; i < iTriangleCount * 3; ++i)
+            pAdjacency[pFill[pTriangles[i]]++] = i / 3;
+
+        // Both directions of every edge, cheapest first.
+        pCollapses.clear();
+        for (unsigned int i = 0; i < iTriangleCount * 3; ++i)
+        {
+            unsigned int iFrom = pTriangles[i], iTo = pTriangles[(i % 3 == 2) ? (i - 2) : (i + 1)];
+            for (unsigned int j = 0; j < 2; ++j, std::swap(iFrom, iTo))
+            {
+                if (!pLocked[iFrom])
+                {
+                    sQuadric sCombined = pQuadrics[iFrom];
+                    sCombined.add(pQuadrics[iTo]);
+                    sCollapse sCandidate = { sCombined.evaluate(pPositions[iTo]), iFrom, iTo };
+                    pCollapses.push_back(sCandidate);
+                }
+            }
+        }
+        std::sort(pCollapses.begin(), pCollapses.end());
+
+        unsigned int iRemoved = 0, iCollapsed = 0;
+        pTouched.assign(iPositionCount, false);
+        for (const sCollapse& sCandidate : pCollapses)
+        {
+            if (sCandidate.dCost > dErrorLimit || (iTriangleCount - iRemoved) <= iTargetTriangleCount)
+                break;
+            if (pTouched[sCandidate.iFrom] || pTouched[sCandidate.iTo]
+                || collapseFlips(pTriangles, pOffsets, pAdjacency, pPositions, sCandidate.iFrom, sCandidate.iTo))
+                continue;
+
+            // Lock the neighbourhood of the collapse for the rest of the pass.
+            for (unsigned int i = pOffsets[sCandidate.iFrom]; i < pOffsets[sCandidate.iFrom + 1]; ++i)
+            {
+                const unsigned int* pTriangle = &pTriangles[pAdjacency[i] * 3];
+                if (pTriangle[0] == sCandidate.iTo || pTriangle[1] == sCandidate.iTo || pTriangle[2] == sCandidate.iTo)
+                    ++iRemoved;
+                for (unsigned int j = 0; j < 3; ++j)
+                    pTouched[pTriangle[j]] = true;
+            }
+
+            pRemap[sCandidate.iFrom] = sCandidate.iTo;
+            pQuadrics[sCandidate.iTo].add(pQuadrics[sCandidate.iFrom]);
+            ++iCollapsed;
+        }
+
+        if (0 == iCollapsed)
+            break;
+
+        // Move the collapsed corners and drop the triangles that became degenerate.
+        unsigned int iWrite = 0;
+        for (unsigned int i = 0; i < iTriangleCount * 3; i += 3)
+        {
+            unsigned int iA = pRemap[pTriangles[i]], iB = pRemap[pTriangles[i + 1]], iC = pRemap[pTriangles[i + 2]];
+            if (iA != iB && iB != iC && iA != iC)
+            {
+                pTriangles[iWrite++] = iA;
+                pTriangles[iWrite++] = iB;
+                pTriangles[iWrite++] = iC;
+            }
+        }
+        iTriangleCount = iWrite / 3;
+    }
+
+    // Position -> Vertex lookup to map the moved corners back to vertices.
+    pOffsets.assign(iPositionCount + 1, 0);
+    pAdjacency.resize(iVertexCount);
+    for (unsigned int i = 0; i < iVertexCount; ++i)
+        ++pOffsets[pVertexPositions[i] + 1];
+    for (unsigned int i = 0; i < iPositionCount; ++i)
+        pOffsets[i + 1] += pOffsets[i];
+    pFill.assign(pOffsets.begin(), pOffsets.end() - 1);
+    for (unsigned int i = 0; i < iVertexCount; ++i)
+        pAdjacency[pFill[pVertexPositions[i]]++] = i;
+
+    pOutput->clear();
+    pOutput->reserve(iTriangleCount * 3);
+    for (unsigned int i = 0; i < pIndices.size(); i += 3)
+    {
+        unsigned int pCorners[3];
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            pCorners[j] = pVertexPositions[pIndices[i + j]];
+            while (pRemap[pCorners[j]] != pCorners[j])
+                pCorners[j] = pRemap[pCorners[j]];
+        }
+        if (pCorners[0] == pCorners[1] || pCorners[1] == pCorners[2] || pCorners[0] == pCorners[2])
+            continue;
+
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            unsigned int iVertex = pIndices[i + j];
+            if (pVertexPositions[iVertex] != pCorners[j])
+            {
+                const float* pAttributes = pVertexData + (iVertex * iVertexStride);
+                float fBestDistance = FLT_MAX;
+                for (unsigned int k = pOffsets[pCorners[j]]; k < pOffsets[pCorners[j] + 1]; ++k)
+                {
+                    const float* pCandidate = pVertexData + (pAdjacency[k] * iVertexStride);
+                    float fDistance = 0.0f;
+                    for (unsigned int l = 3; l < iVertexStride; ++l)
+                        fDistance += (pCandidate[l] - pAttributes[l]) * (pCandidate[l] - pAttributes[l]);
+                    if (fDistance < fBestDistance)
+                    {
+                        fBestDistance = fDistance;
+                        iVertex = pAdjacency[k];
+                    }
+                }
+            }
+            pOutput->push_back(iVertex);
+        }
+    }
+}
+
+/*
+    Simulate a FIFO post-transform cache. A vertex is in the cache if fewer
+    than iCacheSize misses happened since it was last loaded.
+
+    @return cache misses per triangle
+*/
+float MeshOptimizer::computeACMR(const vector<unsigned int>& pIndices, unsigned int iVertexCount, unsigned int iCacheSize)
+{
+    vector<unsigned int> pLoadedAt(iVertexCount, UNUSED_VERTEX);
+    unsigned int iMisses = 0;
+    if (pIndices.size() < 3)
+        return 0.0f;
+
+    for (unsigned int iIndex : pIndices)
+    {
+        if (UNUSED_VERTEX == pLoadedAt[iIndex] || (iMisses - pLoadedAt[iIndex]) >= iCacheSize)
+            pLoadedAt[iIndex] = iMisses++;
+    }
+
+    return static_cast<float>(iMisses) / (pIndices.size() / 3);
+}
+
+unsigned int MeshOptimizer::getQuantizedStride(bool bNormals, bool bUVs)
+{
+    return sizeof(vec3) + (bNormals ? sizeof(unsigned int) : 0) + (bUVs ? sizeof(unsigned int) : 0);
+}
+
+/*
+    Quantized Layout:
+        vec3            position
+        unsigned int    normal as 10:10:10:2 snorm, if bNormals
+        unsigned int    uv as 2 half floats, if bUVs
+*/
+void MeshOptimizer::quantizeVertices(const float* pVertexData, unsigned int iVertexCount, bool bNormals, bool bUVs, vector<unsigned char>* pOutput)
+{
+    unsigned int iInputStride = 3 + (bNormals ? 3 : 0) + (bUVs ? 2 : 0);
+    unsigned int iOutputStride = getQuantizedStride(bNormals, bUVs);
+    pOutput->resize(iVertexCount * iOutputStride);
+    unsigned char* pWrite = pOutput->data();
+
+    for (unsigned int i = 0; i < iVertexCount; ++i, pVertexData += iInputStride)
+    {
+        const float* pRead = pVertexData;
+        memcpy(pWrite, pRead, sizeof(vec3));
+        pWrite += sizeof(vec3);
+        pRead += 3;
+
+        if (bNormals)
+        {
+            vec3 vNormal(pRead[0], pRead[1], pRead[2]);
+            float fLength = length(vNormal);
+            unsigned int iPacked = packSnorm3x10_1x2(vec4((fLength > 0.0f) ? (vNormal / fLength) : vNormal, 0.0f));
+            memcpy(pWrite, &iPacked, sizeof(unsigned int));
+            pWrite += sizeof(unsigned int);
+            pRead += 3;
+        }
+
+        if (bUVs)
+        {
+            unsigned int iPacked = packHalf2x16(vec2(pRead[0], pRead[1]));
+            memcpy(pWrite, &iPacked, sizeof(unsigned int));
+            pWrite += sizeof(unsigned int);
+        }
+    }
+}
@@ -3,15 +3,25 @@
 #include "EntityManager.h"
 #include "GameManager.h"
 #include "InputHandler.h"
+#include "InputRecorder.h"
 #include "Menus/MenuManager.h"
 #include "SceneLoader.h"
 #include "ShaderManager.h"
 #include "Physics/PhysicsManager.h"
 #include "SoundManager.h"
+#include "DataStructures/StreamBuffer.h"
+#include "DataStructures/CookedMesh.h"
+#include "DataStructures/AssetPreloader.h"
+#include "ParticlePool.h"
+#include "FramePacer.h"
 
 // This sets the window title
 #define PROGRAM_NAME "Hover Wars"
 
+// Size of the hidden window in headless mode, or without a monitor
+#define HEADLESS_WIDTH      1920
+#define HEADLESS_HEIGHT     1080
+
 // Function Prototypes
 void ErrorCallback(int error, const char* description);
 void WindowResizeCallback(GLFWwindow* window, int iWidth, int iHeight);
@@ -21,6 +31,8 @@ bool initializeWindow(GLFWwindow** rWindow, int* iHeight, int* iWidth, const cha
 void initializeWindow();
 void initializeGLEW();
 bool initializeManagers();
+bool parseArguments(int argc, char* argv[]);
+void parseWindowArguments(int argc, char* argv[]);
 void cleanup();
 
 // These are not local variables to main so that other functions can better
@@ -29,11 +41,13 @@ GLFWwindow* m_window = 0;
 GameManager* m_gameManager = 0;
 InputHandler* m_inputHandler = 0;
 SoundManager* m_soundManager = 0;
+InputRecorder* m_inputRecorder = 0;
 int iRunning;
 int iWindowHeight, iWindowWidth;
+bool bEGLContext = false;
 
 // Main entry point for the Graphics System
-int main()
+int main(int argc, char* argv[])
 {
     iRunning = glfwInit();
 
@@ -44,11 +58,12 @@ int main()
     }
     else
     {
+        parseWindowArguments(argc, argv);
         initializeWindow();
         initializeGLEW();
         if (iRunning) // only succeeds if both glfw and glew are successful
         {
-            if (initializeManagers())
+            if (initializeManagers() && parseArguments(argc, argv))
             {
                 m_gameManager->startRendering();
             }
@@ -91,6 +106,9 @@ bool initializeManagers()
     // Initialize the InputHandler for mouse, keyboard, controllers
     m_inputHandler = InputHandler::getInstance(m_window);
 
+    // Records or replays input if requested from the command line
+    m_inputRecorder = INPUT_RECORDER;
+
     // Initialize Sound
     m_soundManager = SOUND_MANAGER;
     m_soundManager->loadFiles();
@@ -114,9 +132,187 @@ void cleanup()
     if (nullptr != m_soundManager)
         delete m_soundManager;
 
+    if (nullptr != m_inputRecorder)     // Closes any recording in progress
+        delete m_inputRecorder;
+
     glfwDestroyWindow(m_window);
 }
 
+/*
+    The window is created before the managers and before the rest of the
+    arguments are parsed, so the arguments choosing how it's created are
+    picked out first. parseArguments skips them.
+*/
+void parseWindowArguments(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        string sArgument = argv[i];
+        if ("--headless" == sArgument)
+            GameManager::setHeadless(true);
+        else if ("--egl" == sArgument)
+            bEGLContext = true;
+    }
+}
+
+/*
+    Handle command line arguments.
+        --record <file>     record all input of this session to a file
+        --replay <file>     replay a session previously recorded with --record
+        --simulation-rate <steps per second>
+                            rate the game is simulated at, independent of the frame rate
+        --frame-rate <30 | 60 | 120 | uncapped>
+                            rate the frames are drawn at (60 by default)
+        --vsync             wait for the display refresh on the buffer swap instead of sleeping
+                            to the frame rate
+        --no-persistent-buffers
+                            stream per-frame vertex data by orphaning buffers instead of
+                            persistently mapping them, as on drivers without ARB_buffer_storage
+        --no-uniform-cache  look up every uniform and bind its program to set it, to compare the
+                            GL submission time in the frame stats with the cached uniforms
+        --no-static-shadow-cache
+                            draw every shadow caster into the shadow map each frame instead of
+                            copying the cached shadows of the static scene
+        --no-multi-view     draw each split screen on its own instead of drawing the opaque scene
+                            once for every screen
+        --no-occlusion-culling
+                            draw what the pillars of the arena hide instead of culling it with the
+                            potentially visible set of the spatial map
+        --bloom-quality <gaussian | low | medium | high>
+                            blur the bloom with the full resolution Gaussian blur or a mip chain
+                            going down to 1/4, 1/8 or 1/16 resolution (medium by default)
+        --benchmark-bloom   print the GPU time of the bloom of each quality tier and split screen layout
+        --headless          draw to a frame buffer in a hidden window instead of to the screen
+        --egl               create the GL context through EGL, e.g. for Mesa's software rasterizer
+        --benchmark-render <screens> <frames>
+                            draw a game with that many screens and fixed cameras for a number of
+                            frames and print the CPU time spent issuing each stage of the frame
+        --dump-frame <file> write the last frame of --benchmark-render to a PPM image (headless only)
+
+    @return false if the program should not continue
+*/
+bool parseArguments(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        string sArgument = argv[i];
+        if (("--record" == sArgument || "--replay" == sArgument) && (i + 1) < argc)
+        {
+            string sFileName = argv[++i];
+            if (!("--record" == sArgument ? m_inputRecorder->startRecording(sFileName)
+                                          : m_inputRecorder->startReplay(sFileName)))
+                return false;
+        }
+        else if ("--simulation-rate" == sArgument && (i + 1) < argc)
+        {
+            ENTITY_MANAGER->setSimulationRate(static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10)));
+        }
+        else if ("--frame-rate" == sArgument && (i + 1) < argc)
+        {
+            if (!FramePacer::setTargetRate(argv[++i]))
+                return false;
+        }
+        else if ("--vsync" == sArgument)
+        {
+            FramePacer::setVSyncEnabled(true);
+        }
+        else if ("--no-persistent-buffers" == sArgument)
+        {
+            StreamBuffer::setPersistentMappingEnabled(false);
+        }
+        else if ("--no-uniform-cache" == sArgument)
+        {
+            ShaderManager::setUniformCacheEnabled(false);
+        }
+        else if ("--no-static-shadow-cache" == sArgument)
+        {
+            EntityManager::setStaticShadowCacheEnabled(false);
+        }
+        else if ("--no-multi-view" == sArgument)
+        {
+            EntityManager::setMultiViewEnabled(false);
+        }
+        else if ("--no-occlusion-culling" == sArgument)
+        {
+            EntityManager::setOcclusionCullingEnabled(false);
+        }
+        else if ("--bloom-quality" == sArgument && (i + 1) < argc)
+        {
+            if (!GameManager::setBloomQuality(argv[++i]))
+                return false;
+        }
+        else if ("--headless" == sArgument || "--egl" == sArgument)
+        {
+            // Applied when the window was created
+        }
+        else if ("--dump-frame" == sArgument && (i + 1) < argc)
+        {
+            GameManager::setFrameDumpFile(argv[++i]);
+        }
+        else if ("--benchmark-render" == sArgument && (i + 2) < argc)
+        {
+            unsigned int iScreens = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+            unsigned int iFrames = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+            m_gameManager->runRenderBenchmark(iScreens, iFrames);
+            return false;
+        }
+        else if ("--benchmark-bloom" == sArgument)
+        {
+            m_gameManager->runBloomBenchmark();
+            return false;
+        }
+        else if ("--benchmark-obj" == sArgument && (i + 1) < argc)
+        {
+            // Only measures the load times, the game isn't started.
+            string sDirectory = argv[++i];
+            ObjParser::runBenchmark(sDirectory);
+            CookedMesh::runBenchmark(sDirectory);
+            return false;
+        }
+        else if ("--mesh-report" == sArgument && (i + 1) < argc)
+        {
+            ObjParser::runOptimizationReport(argv[++i]);
+            return false;
+        }
+        else if ("--no-quantized-meshes" == sArgument)
+        {
+            CookedMesh::setQuantizationEnabled(false);
+        }
+        else if ("--cook-meshes" == sArgument && (i + 1) < argc)
+        {
+            CookedMesh::cookDirectory(argv[++i]);
+            return false;
+        }
+        else if ("--serial-asset-loading" == sArgument)
+        {
+            AssetPreloader::setParallelLoadingEnabled(false);
+        }
+        else if ("--benchmark-scene" == sArgument && (i + 1) < argc)
+        {
+            AssetPreloader::runBenchmark(argv[++i]);
+            return false;
+        }
+        else if ("--benchmark-particles" == sArgument)
+        {
+            ParticlePool::runBenchmark();
+            return false;
+        }
+        else
+        {
+            cout << "Unknown argument \"" << sArgument << "\"." << endl
+                 << "Usage: [--record <file> | --replay <file>] [--simulation-rate <steps per second>] [--no-persistent-buffers] [--no-quantized-meshes]" << endl
+                 << "       [--frame-rate <30 | 60 | 120 | uncapped>] [--vsync]" << endl
+                 << "       [--no-uniform-cache] [--no-static-shadow-cache] [--no-multi-view] [--no-occlusion-culling]" << endl
+                 << "       [--bloom-quality <gaussian | low | medium | high>]" << endl
+                 << "       [--serial-asset-loading] [--benchmark-obj <directory>] [--benchmark-scene <scene file>]" << endl
+                 << "       [--mesh-report <directory>] [--cook-meshes <directory>] [--benchmark-particles] [--benchmark-bloom]" << endl
+                 << "       [--headless] [--egl] [--dump-frame <file>] [--benchmark-render <screens> <frames>]" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
 // For reporting GLFW errors
 void ErrorCallback(int error, const char* description)
 {
@@ -130,7 +326,32 @@ void ErrorCallback(int error, const char* description)
 bool initializeWindow(GLFWwindow** rWindow, int* iHeight, int* iWidth, const char* cTitle)
 {
     GLFWmonitor* pMonitor = glfwGetPrimaryMonitor();
-    const GLFWvidmode* mode = glfwGetVideoMode(pMonitor);
+    const GLFWvidmode* mode = nullptr != pMonitor ? glfwGetVideoMode(pMonitor) : nullptr;
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (bEGLContext)
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+
+    // Headless: a hidden window of a fixed size, only there for its GL context
+    if (GameManager::isHeadless() || nullptr == mode)
+    {
+        if (nullptr == mode)
+            GameManager::setHeadless(true);
+        glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+        *iHeight = HEADLESS_HEIGHT;
+        *iWidth = HEADLESS_WIDTH;
+        (*rWindow) = glfwCreateWindow(*iWidth, *iHeight, cTitle, nullptr, nullptr);
+        if (!*rWindow)
+        {
+            cout << "Program failed to create a hidden GLFW window" << endl;
+            return false;
+        }
+        glfwMakeContextCurrent(*rWindow);
+        return true;
+    }
 
     // Set Window Hints based on
     glfwWindowHint(GLFW_RED_BITS, mode->redBits);
@@ -146,11 +367,6 @@ bool initializeWindow(GLFWwindow** rWindow, int* iHeight, int* iWidth, const cha
     *iHeight = mode->height;
     *iWidth = mode->width;
 
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
 #ifdef NDEBUG
     // Full screen with cursor hidden
     (*rWindow) = glfwCreateWindow(mode->width, mode->height, cTitle, pMonitor, nullptr);